@@ -0,0 +1,96 @@
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "arrow/array/builder_primitive.h"
+#include "arrow/io/memory.h"
+#include "arrow/ipc/writer.h"
+#include "arrow/memory_pool.h"
+#include "arrow/record_batch.h"
+#include "benchmark/benchmark.h"
+#include "duckdb/web/arrow_stream_buffer.h"
+
+using namespace duckdb::web;
+
+namespace {
+
+/// The number of rows per record batch
+constexpr int64_t BATCH_ROWS = 64 << 10;
+
+/// Write an IPC stream with int64 columns
+std::shared_ptr<arrow::Buffer> WriteStream(size_t batch_count) {
+    auto schema = arrow::schema({arrow::field("a", arrow::int64()), arrow::field("b", arrow::int64())});
+    std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+    for (size_t i = 0; i < batch_count; ++i) {
+        std::vector<std::shared_ptr<arrow::Array>> columns;
+        for (size_t c = 0; c < 2; ++c) {
+            arrow::Int64Builder builder;
+            builder.Reserve(BATCH_ROWS).ok();
+            for (int64_t v = 0; v < BATCH_ROWS; ++v) builder.UnsafeAppend(v * (c + 1));
+            columns.push_back(builder.Finish().ValueOrDie());
+        }
+        batches.push_back(arrow::RecordBatch::Make(schema, BATCH_ROWS, columns));
+    }
+    auto out = arrow::io::BufferOutputStream::Create().ValueOrDie();
+    auto options = arrow::ipc::IpcWriteOptions::Defaults();
+    options.use_threads = false;
+    arrow::ipc::WriteRecordBatchStream(batches, options, out.get()).ok();
+    return out->Finish().ValueOrDie();
+}
+
+/// Decode a stream that is passed as borrowed chunks, the decoder copies the bytes
+void BM_ArrowIPCDecode_BorrowedChunks(benchmark::State& state) {
+    auto stream = WriteStream(16);
+    size_t chunk_size = state.range(0);
+    int64_t pool_bytes = 0;
+    for (auto _ : state) {
+        arrow::ProxyMemoryPool pool{arrow::default_memory_pool()};
+        auto options = arrow::ipc::IpcReadOptions::Defaults();
+        options.memory_pool = &pool;
+        BufferingArrowIPCStreamDecoder decoder{std::make_shared<ArrowIPCStreamBuffer>(), options};
+        for (size_t ofs = 0; ofs < static_cast<size_t>(stream->size()); ofs += chunk_size) {
+            auto n = std::min<size_t>(stream->size() - ofs, chunk_size);
+            decoder.Consume(stream->data() + ofs, n).ok();
+        }
+        benchmark::DoNotOptimize(decoder.buffer()->batches().size());
+        pool_bytes = pool.max_memory();
+    }
+    state.counters["pool_bytes"] = pool_bytes;
+    state.SetBytesProcessed(state.iterations() * stream->size());
+}
+
+/// Decode a stream that is passed as owned chunks, the batches reference the chunks
+void BM_ArrowIPCDecode_OwnedChunks(benchmark::State& state) {
+    auto stream = WriteStream(16);
+    size_t chunk_size = state.range(0);
+    int64_t pool_bytes = 0;
+    for (auto _ : state) {
+        // Chunks are allocated by the caller, e.g. by JavaScript in the wasm heap
+        state.PauseTiming();
+        std::vector<std::shared_ptr<arrow::Buffer>> chunks;
+        for (size_t ofs = 0; ofs < static_cast<size_t>(stream->size()); ofs += chunk_size) {
+            auto n = std::min<size_t>(stream->size() - ofs, chunk_size);
+            std::unique_ptr<char[]> memory{new char[n]};
+            std::memcpy(memory.get(), stream->data() + ofs, n);
+            chunks.push_back(std::make_shared<ArrowOwnedBuffer>(std::move(memory), n));
+        }
+        state.ResumeTiming();
+
+        arrow::ProxyMemoryPool pool{arrow::default_memory_pool()};
+        auto options = arrow::ipc::IpcReadOptions::Defaults();
+        options.memory_pool = &pool;
+        BufferingArrowIPCStreamDecoder decoder{std::make_shared<ArrowIPCStreamBuffer>(), options};
+        for (auto& chunk : chunks) {
+            decoder.Consume(std::move(chunk)).ok();
+        }
+        benchmark::DoNotOptimize(decoder.buffer()->batches().size());
+        pool_bytes = pool.max_memory();
+    }
+    state.counters["pool_bytes"] = pool_bytes;
+    state.SetBytesProcessed(state.iterations() * stream->size());
+}
+
+}  // namespace
+
+BENCHMARK(BM_ArrowIPCDecode_BorrowedChunks)->Arg(64 << 10)->Arg(16 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ArrowIPCDecode_OwnedChunks)->Arg(64 << 10)->Arg(16 << 20)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,81 @@
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "duckdb/web/io/async_reader.h"
+
+using namespace duckdb::web::io;
+namespace fs = std::filesystem;
+
+namespace {
+
+/// The size of the benchmark file
+constexpr size_t FILE_SIZE = 256 << 20;
+/// The size of a read
+constexpr size_t READ_SIZE = 4 << 10;
+/// The number of reads per iteration
+constexpr size_t READ_COUNT = 4096;
+
+/// Create the benchmark file once
+const fs::path& GetBenchmarkFile() {
+    static fs::path path = []() {
+        auto tmp = fs::current_path() / ".tmp";
+        if (!fs::is_directory(tmp)) fs::create_directory(tmp);
+        auto file = tmp / "async_read_bench";
+        if (!fs::exists(file) || fs::file_size(file) != FILE_SIZE) {
+            std::ofstream output(file, std::ios::binary);
+            std::vector<char> chunk(1 << 20);
+            std::mt19937 rng{42};
+            for (size_t i = 0; i < FILE_SIZE; i += chunk.size()) {
+                for (auto& c : chunk) c = static_cast<char>(rng());
+                output.write(chunk.data(), chunk.size());
+            }
+        }
+        return file;
+    }();
+    return path;
+}
+
+/// Read random pages with a reader
+void RunRandomReads(benchmark::State& state, AsyncReader& reader) {
+    auto file = AsyncFile::Open(GetBenchmarkFile().c_str());
+    std::vector<char> buffer(READ_COUNT * READ_SIZE);
+    std::vector<AsyncReader::Request> requests;
+    std::mt19937 rng{7};
+    for (size_t i = 0; i < READ_COUNT; ++i) {
+        auto offset = (rng() % (FILE_SIZE / READ_SIZE)) * READ_SIZE;
+        requests.push_back({file->GetFD(), buffer.data() + i * READ_SIZE, READ_SIZE, offset});
+    }
+    for (auto _ : state) {
+        size_t bytes = 0;
+        reader.Read(nonstd::span<const AsyncReader::Request>{requests.data(), requests.size()},
+                    [&](size_t, int64_t result) { bytes += result; });
+        benchmark::DoNotOptimize(bytes);
+    }
+    state.SetBytesProcessed(state.iterations() * READ_COUNT * READ_SIZE);
+}
+
+/// Read random pages with blocking preads
+void BM_AsyncRead_PRead(benchmark::State& state) {
+    auto reader = AsyncReader::CreatePRead();
+    RunRandomReads(state, *reader);
+}
+
+/// Read random pages through io_uring with different queue depths
+void BM_AsyncRead_IOUring(benchmark::State& state) {
+    auto reader = AsyncReader::CreateIOUring(state.range(0));
+    if (!reader) {
+        state.SkipWithError("io_uring is not available");
+        return;
+    }
+    RunRandomReads(state, *reader);
+}
+
+}  // namespace
+
+BENCHMARK(BM_AsyncRead_PRead)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AsyncRead_IOUring)->RangeMultiplier(4)->Range(1, 256)->Unit(benchmark::kMillisecond);
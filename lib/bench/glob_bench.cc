@@ -0,0 +1,58 @@
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "duckdb/web/io/glob.h"
+#include "duckdb/web/io/path_trie.h"
+
+using namespace duckdb::web::io;
+
+namespace {
+
+/// Generate hive-partitioned file paths
+std::vector<std::string> GeneratePaths(size_t n) {
+    std::vector<std::string> paths;
+    paths.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        paths.push_back("/data/year=" + std::to_string(2000 + i % 20) + "/month=" + std::to_string(i % 12) + "/part-" +
+                        std::to_string(i) + ".parquet");
+    }
+    return paths;
+}
+
+/// The glob that selects a single partition
+constexpr const char* PARTITION_GLOB = "/data/year=2010/month=*/*.parquet";
+
+/// Match all paths against a regex
+void BM_Glob_Regex(benchmark::State& state) {
+    auto paths = GeneratePaths(state.range(0));
+    for (auto _ : state) {
+        auto glob = glob_to_regex(PARTITION_GLOB);
+        size_t matches = 0;
+        for (auto& path : paths) {
+            matches += std::regex_match(path, glob);
+        }
+        benchmark::DoNotOptimize(matches);
+    }
+}
+
+/// Match the paths below the literal prefix with a compiled matcher
+void BM_Glob_PathTrie(benchmark::State& state) {
+    auto paths = GeneratePaths(state.range(0));
+    PathTrie trie;
+    for (auto& path : paths) {
+        trie.Insert(path);
+    }
+    for (auto _ : state) {
+        GlobMatcher glob{PARTITION_GLOB};
+        size_t matches = 0;
+        trie.VisitPrefix(glob.GetLiteralPrefix(), [&](std::string_view path) { matches += glob.Matches(path); });
+        benchmark::DoNotOptimize(matches);
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_Glob_Regex)->Arg(1000)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Glob_PathTrie)->Arg(1000)->Arg(100000)->Unit(benchmark::kMillisecond);
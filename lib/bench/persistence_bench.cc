@@ -0,0 +1,110 @@
+#include <filesystem>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "duckdb/web/webdb.h"
+
+using namespace duckdb::web;
+namespace fs = std::filesystem;
+
+namespace {
+
+fs::path PrepareDirectory(std::string_view name) {
+    auto dir = fs::current_path() / ".tmp" / "bench" / name;
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    return dir;
+}
+
+void CreateTable(WebDB::Connection& conn, size_t rows) {
+    auto query = "CREATE TABLE foo AS (SELECT v, v::VARCHAR AS s FROM generate_series(1, " + std::to_string(rows) +
+                 ") t(v))";
+    conn.RunQuery(query).ValueOrDie();
+}
+
+/// Persist every commit through a read-write database file
+void BM_CommitLatency_ReadWrite(benchmark::State& state) {
+    auto dir = PrepareDirectory("commit_rw");
+    auto path = dir / "bench.db";
+    WebDB db{NATIVE};
+    auto status = db.Open(std::string{"{\"path\":\""} + path.string() + "\",\"accessMode\":3}");
+    if (!status.ok()) {
+        state.SkipWithError(status.message().c_str());
+        return;
+    }
+    WebDB::Connection conn{db};
+    CreateTable(conn, state.range(0));
+    conn.RunQuery("CHECKPOINT").ValueOrDie();
+
+    size_t i = 0;
+    for (auto _ : state) {
+        conn.RunQuery("INSERT INTO foo VALUES (" + std::to_string(i++) + ", 'x')").ValueOrDie();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/// Persist every commit by exporting the whole in-memory database
+void BM_CommitLatency_ExportImport(benchmark::State& state) {
+    auto dir = PrepareDirectory("commit_export");
+    WebDB db{NATIVE};
+    WebDB::Connection conn{db};
+    CreateTable(conn, state.range(0));
+
+    size_t i = 0;
+    for (auto _ : state) {
+        conn.RunQuery("INSERT INTO foo VALUES (" + std::to_string(i++) + ", 'x')").ValueOrDie();
+        auto out = dir / std::to_string(i);
+        conn.RunQuery("EXPORT DATABASE '" + out.string() + "' (FORMAT PARQUET)").ValueOrDie();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/// Restore the state by importing an exported database
+void BM_Restore_Import(benchmark::State& state) {
+    auto dir = PrepareDirectory("restore_import");
+    auto out = dir / "export";
+    {
+        WebDB db{NATIVE};
+        WebDB::Connection conn{db};
+        CreateTable(conn, state.range(0));
+        conn.RunQuery("EXPORT DATABASE '" + out.string() + "' (FORMAT PARQUET)").ValueOrDie();
+    }
+    for (auto _ : state) {
+        WebDB db{NATIVE};
+        WebDB::Connection conn{db};
+        conn.RunQuery("IMPORT DATABASE '" + out.string() + "'").ValueOrDie();
+    }
+}
+
+/// Restore the state by opening a database file
+void BM_Restore_ReadWrite(benchmark::State& state) {
+    auto dir = PrepareDirectory("restore_rw");
+    auto path = dir / "bench.db";
+    auto args = std::string{"{\"path\":\""} + path.string() + "\",\"accessMode\":3}";
+    {
+        WebDB db{NATIVE};
+        if (auto status = db.Open(args); !status.ok()) {
+            state.SkipWithError(status.message().c_str());
+            return;
+        }
+        WebDB::Connection conn{db};
+        CreateTable(conn, state.range(0));
+        conn.RunQuery("CHECKPOINT").ValueOrDie();
+    }
+    for (auto _ : state) {
+        WebDB db{NATIVE};
+        if (auto status = db.Open(args); !status.ok()) {
+            state.SkipWithError(status.message().c_str());
+            break;
+        }
+        WebDB::Connection conn{db};
+        conn.RunQuery("SELECT count(*) FROM foo").ValueOrDie();
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_CommitLatency_ReadWrite)->Arg(10000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_CommitLatency_ExportImport)->Arg(10000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Restore_Import)->Arg(10000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Restore_ReadWrite)->Arg(10000)->Arg(1000000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,67 @@
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "duckdb/web/webdb.h"
+
+using namespace duckdb::web;
+
+namespace {
+
+/// A TPC-H Q1-style aggregation
+constexpr const char* PRICING_SUMMARY = R"SQL(
+    SELECT l_returnflag, l_linestatus, sum(l_quantity) AS sum_qty, sum(l_extendedprice) AS sum_base_price,
+           sum(l_extendedprice * (1 - l_discount)) AS sum_disc_price, avg(l_quantity) AS avg_qty,
+           count(*) AS count_order
+    FROM lineitem
+    WHERE l_shipdate <= DATE '1998-12-01' - INTERVAL 90 DAY
+    GROUP BY l_returnflag, l_linestatus
+    ORDER BY l_returnflag, l_linestatus
+)SQL";
+/// A TPC-H Q3-style join
+constexpr const char* SHIPPING_PRIORITY = R"SQL(
+    SELECT l_orderkey, sum(l_extendedprice * (1 - l_discount)) AS revenue, o_orderdate, o_shippriority
+    FROM orders, lineitem
+    WHERE l_orderkey = o_orderkey AND o_orderdate < DATE '1995-03-15' AND l_shipdate > DATE '1995-03-15'
+    GROUP BY l_orderkey, o_orderdate, o_shippriority
+    ORDER BY revenue DESC, o_orderdate
+    LIMIT 10
+)SQL";
+
+/// Create small TPC-H-style tables so that planning dominates the query time
+void CreateTables(WebDB::Connection& conn) {
+    conn.RunQuery(R"SQL(
+        CREATE TABLE orders AS
+        SELECT v AS o_orderkey, DATE '1992-01-01' + (v % 2500)::INTEGER AS o_orderdate,
+               (v % 5)::INTEGER AS o_shippriority
+        FROM generate_series(0, 999) t(v)
+    )SQL")
+        .ValueOrDie();
+    conn.RunQuery(R"SQL(
+        CREATE TABLE lineitem AS
+        SELECT v % 1000 AS l_orderkey, (v % 50)::DOUBLE AS l_quantity, (v % 1000)::DOUBLE * 1.5 AS l_extendedprice,
+               (v % 10)::DOUBLE / 100 AS l_discount, chr(65 + (v % 3)::INTEGER) AS l_returnflag,
+               chr(70 + (v % 2)::INTEGER) AS l_linestatus, DATE '1992-01-01' + (v % 2500)::INTEGER AS l_shipdate
+        FROM generate_series(0, 9999) t(v)
+    )SQL")
+        .ValueOrDie();
+}
+
+/// Run repeated TPC-H-style queries with the given plan cache size
+void BM_PlanCache_RepeatedQueries(benchmark::State& state) {
+    WebDB db{NATIVE};
+    db.Open("{\"planCacheSize\": " + std::to_string(state.range(0)) + "}").ok();
+    WebDB::Connection conn{db};
+    CreateTables(conn);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(conn.RunQuery(PRICING_SUMMARY).ValueOrDie());
+        benchmark::DoNotOptimize(conn.RunQuery(SHIPPING_PRIORITY).ValueOrDie());
+    }
+    auto& stats = conn.plan_cache_statistics();
+    state.counters["hits"] = stats.hits;
+    state.counters["planning_us_saved"] =
+        benchmark::Counter(stats.planning_micros_saved, benchmark::Counter::kAvgIterations);
+}
+
+}  // namespace
+
+BENCHMARK(BM_PlanCache_RepeatedQueries)->ArgName("planCacheSize")->Arg(0)->Arg(32)->Unit(benchmark::kMicrosecond);
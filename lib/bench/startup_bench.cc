@@ -0,0 +1,54 @@
+#include <filesystem>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "duckdb/web/webdb.h"
+
+using namespace duckdb::web;
+namespace fs = std::filesystem;
+
+namespace {
+
+/// Create a database and run a first trivial query
+void BM_Startup_TimeToFirstQuery(benchmark::State& state) {
+    for (auto _ : state) {
+        WebDB db{NATIVE};
+        WebDB::Connection conn{db};
+        benchmark::DoNotOptimize(conn.RunQuery("SELECT 1").ValueOrDie());
+    }
+}
+
+/// Create a database and run a first parquet query, which includes loading the extension
+void BM_Startup_TimeToFirstParquetQuery(benchmark::State& state) {
+    auto dir = fs::current_path() / ".tmp" / "bench";
+    fs::create_directories(dir);
+    auto data = dir / "startup.parquet";
+    {
+        WebDB db{NATIVE};
+        WebDB::Connection conn{db};
+        conn.RunQuery("COPY (SELECT v FROM generate_series(1, 1000) t(v)) TO '" + data.string() + "' (FORMAT PARQUET)")
+            .ValueOrDie();
+    }
+    auto query = "SELECT count(*) FROM parquet_scan('" + data.string() + "')";
+    for (auto _ : state) {
+        WebDB db{NATIVE};
+        WebDB::Connection conn{db};
+        benchmark::DoNotOptimize(conn.RunQuery(query).ValueOrDie());
+    }
+}
+
+/// Reset an existing database and run a first trivial query
+void BM_Startup_ResetToFirstQuery(benchmark::State& state) {
+    WebDB db{NATIVE};
+    for (auto _ : state) {
+        db.Reset().ok();
+        WebDB::Connection conn{db};
+        benchmark::DoNotOptimize(conn.RunQuery("SELECT 1").ValueOrDie());
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_Startup_TimeToFirstQuery)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Startup_TimeToFirstParquetQuery)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Startup_ResetToFirstQuery)->Unit(benchmark::kMillisecond);
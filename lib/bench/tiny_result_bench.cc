@@ -0,0 +1,39 @@
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "duckdb/web/webdb.h"
+
+using namespace duckdb::web;
+
+namespace {
+
+/// The database options with compact results enabled (after) and disabled (before)
+const char* CompactResultArgs(bool compact) { return compact ? "{}" : R"JSON({"compactResultSize": 0})JSON"; }
+
+/// Run a query that returns a single row
+void BM_TinyResult_RunQuery(benchmark::State& state) {
+    WebDB db{NATIVE};
+    db.Open(CompactResultArgs(state.range(0))).ok();
+    WebDB::Connection conn{db};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(conn.RunQuery("SELECT 42::INTEGER AS v, 'foo' AS s").ValueOrDie());
+    }
+}
+
+/// Run a prepared statement that returns a single scalar
+void BM_TinyResult_RunPreparedStatement(benchmark::State& state) {
+    WebDB db{NATIVE};
+    db.Open(CompactResultArgs(state.range(0))).ok();
+    WebDB::Connection conn{db};
+    auto stmt = conn.CreatePreparedStatement("SELECT ?::INTEGER + 1 AS v").ValueOrDie();
+    int64_t i = 0;
+    for (auto _ : state) {
+        auto args = "[" + std::to_string(i++) + "]";
+        benchmark::DoNotOptimize(conn.RunPreparedStatement(stmt, args).ValueOrDie());
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_TinyResult_RunQuery)->ArgName("compact")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_TinyResult_RunPreparedStatement)->ArgName("compact")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
@@ -72,6 +72,7 @@ target_include_directories(
   INTERFACE ${DUCKDB_SOURCE_DIR}/third_party/miniz
   INTERFACE ${DUCKDB_SOURCE_DIR}/third_party/thrift
   INTERFACE ${DUCKDB_SOURCE_DIR}/third_party/zstd
+  INTERFACE ${DUCKDB_SOURCE_DIR}/third_party/zstd/include
   INTERFACE ${DUCKDB_SOURCE_DIR}/extension/parquet/include)
 
 add_dependencies(duckdb duckdb_ep)
@@ -7,6 +7,7 @@
 #include "arrow/array/array_nested.h"
 #include "arrow/array/builder_primitive.h"
 #include "arrow/buffer.h"
+#include "arrow/memory_pool.h"
 #include "arrow/record_batch.h"
 #include "arrow/result.h"
 #include "arrow/status.h"
@@ -105,10 +106,10 @@ std::shared_ptr<arrow::Array> castScalarArray(const std::shared_ptr<arrow::Array
 
 /// Helper to cast scalar types in arrow schema and return the same schema if nothing changes
 std::shared_ptr<arrow::Schema> patchSchema(const std::shared_ptr<arrow::Schema>& schema, const WebDBConfig& config);
-/// Helper to cast a record batch
-arrow::Result<std::shared_ptr<arrow::RecordBatch>> patchRecordBatch(const std::shared_ptr<arrow::RecordBatch>& batch,
-                                                                    const std::shared_ptr<arrow::Schema>& schema,
-                                                                    const WebDBConfig& config);
+/// Helper to cast a record batch, the casted columns are allocated from the given pool
+arrow::Result<std::shared_ptr<arrow::RecordBatch>> patchRecordBatch(
+    const std::shared_ptr<arrow::RecordBatch>& batch, const std::shared_ptr<arrow::Schema>& schema,
+    const WebDBConfig& config, arrow::MemoryPool* pool = arrow::default_memory_pool());
 
 }  // namespace web
 }  // namespace duckdb
@@ -0,0 +1,154 @@
+#ifndef INCLUDE_DUCKDB_WEB_ARROW_MEMORY_POOL_H_
+#define INCLUDE_DUCKDB_WEB_ARROW_MEMORY_POOL_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "arrow/memory_pool.h"
+#include "arrow/status.h"
+#include "duckdb/web/memory_governor.h"
+#include "rapidjson/document.h"
+
+namespace duckdb {
+namespace web {
+
+/// The arrow memory pool of the web layer.
+///
+/// Small allocations are served from size classes of powers of two.
+/// Every size class carves its blocks from slabs and keeps freed blocks for the next allocation.
+/// Builders that grow their buffers therefore reuse the blocks of earlier batches instead of reallocating.
+/// Large allocations are passed through to the backing pool.
+///
+/// Queries and imports open an arena scope.
+/// When the outermost scope ends, all slabs without live blocks are released in bulk,
+/// apart from a small reserve that keeps the next query warm.
+class ArrowMemoryPool : public arrow::MemoryPool, public MemoryConsumer {
+   public:
+    /// The smallest block size
+    static constexpr size_t MIN_BLOCK_SIZE = 64;
+    /// The largest block size
+    static constexpr size_t MAX_BLOCK_SIZE = 256 << 10;
+    /// The number of size classes
+    static constexpr size_t SIZE_CLASS_COUNT = 13;
+    /// The size of a slab
+    static constexpr size_t SLAB_SIZE = 1 << 20;
+    /// The bytes of empty slabs that are kept when an arena ends
+    static constexpr size_t RETAINED_SLAB_BYTES = 4 << 20;
+
+    /// An arena scope
+    class Arena {
+        /// The pool
+        ArrowMemoryPool &pool_;
+
+       public:
+        /// Constructor
+        Arena(ArrowMemoryPool &pool) : pool_(pool) { pool_.EnterArena(); }
+        /// Delete copy constructor
+        Arena(const Arena &) = delete;
+        /// Destructor
+        ~Arena() { pool_.LeaveArena(); }
+    };
+
+    /// The pool statistics
+    struct Statistics {
+        /// The bytes that are currently allocated
+        int64_t bytes_allocated = 0;
+        /// The peak of the allocated bytes
+        int64_t bytes_peak = 0;
+        /// The bytes that are held by slabs and large allocations
+        size_t bytes_reserved = 0;
+        /// The number of allocations
+        size_t allocations = 0;
+        /// The number of allocations that reused a cached block
+        size_t cache_hits = 0;
+    };
+
+   protected:
+    /// A slab of blocks of a single size class
+    struct Slab {
+        /// The data
+        uint8_t *data = nullptr;
+        /// The size class
+        size_t size_class = 0;
+        /// The number of blocks
+        size_t block_count = 0;
+        /// The next block that was never handed out
+        size_t next_block = 0;
+        /// The freed blocks
+        std::vector<uint8_t *> free_blocks = {};
+        /// The number of live blocks
+        size_t live_blocks = 0;
+        /// Does the slab have free blocks?
+        bool available = false;
+    };
+
+    /// The mutex
+    mutable std::mutex pool_mutex_ = {};
+    /// The backing pool
+    arrow::MemoryPool *backing_pool_;
+    /// The slabs ordered by address
+    std::map<uintptr_t, std::unique_ptr<Slab>> slabs_ = {};
+    /// The slabs with free blocks per size class
+    std::array<std::vector<Slab *>, SIZE_CLASS_COUNT> available_slabs_ = {};
+    /// The statistics
+    Statistics stats_ = {};
+    /// The number of open arenas
+    size_t arena_depth_ = 0;
+
+    /// Get the size class of an allocation
+    static size_t GetSizeClass(int64_t size);
+    /// Get the block size of a size class
+    static size_t GetBlockSize(size_t size_class) { return MIN_BLOCK_SIZE << size_class; }
+    /// Allocate a block
+    arrow::Status AllocateBlock(size_t size_class, uint8_t **out, std::unique_lock<std::mutex> &guard);
+    /// Free a block
+    void FreeBlock(size_t size_class, uint8_t *block, std::unique_lock<std::mutex> &guard);
+    /// Release empty slabs until at most `retain` bytes of empty slabs are left, returns the released bytes
+    size_t ReleaseEmptySlabs(size_t retain, std::unique_lock<std::mutex> &guard);
+    /// Enter an arena
+    void EnterArena();
+    /// Leave an arena
+    void LeaveArena();
+
+   public:
+    /// Constructor
+    ArrowMemoryPool(arrow::MemoryPool *backing_pool = arrow::default_memory_pool());
+    /// Destructor
+    ~ArrowMemoryPool() override;
+
+    /// Allocate a new memory region of at least size bytes
+    arrow::Status Allocate(int64_t size, uint8_t **out) override;
+    /// Resize an already allocated memory section
+    arrow::Status Reallocate(int64_t old_size, int64_t new_size, uint8_t **ptr) override;
+    /// Free an allocated region
+    void Free(uint8_t *buffer, int64_t size) override;
+    /// Release all empty slabs
+    void ReleaseUnused() override;
+    /// The number of bytes that are currently allocated
+    int64_t bytes_allocated() const override;
+    /// The peak of the allocated bytes
+    int64_t max_memory() const override;
+    /// The name of the backend
+    std::string backend_name() const override { return "duckdb-web"; }
+
+    /// Get the statistics
+    Statistics GetStatistics();
+    /// Write the statistics as JSON
+    rapidjson::Value WriteStatistics(rapidjson::Document &doc);
+
+    /// Get the bytes that are held by slabs and large allocations
+    size_t GetMemoryUsage() override;
+    /// Release empty slabs, returns the released bytes
+    size_t ReclaimMemory(size_t bytes) override;
+};
+
+}  // namespace web
+}  // namespace duckdb
+
+#endif
@@ -1,5 +1,10 @@
+#ifndef INCLUDE_DUCKDB_WEB_ARROW_STREAM_BUFFER_H_
+#define INCLUDE_DUCKDB_WEB_ARROW_STREAM_BUFFER_H_
+
+#include <memory>
 #include <string>
 
+#include "arrow/buffer.h"
 #include "arrow/c/bridge.h"
 #include "arrow/ipc/reader.h"
 #include "arrow/record_batch.h"
@@ -16,7 +21,17 @@
 namespace duckdb {
 namespace web {
 
-struct ArrowIPCStreamBuffer : public arrow::ipc::Listener {
+/// An arrow buffer that owns a heap allocation.
+/// Chunks that are handed over as owned buffers are referenced by the decoded batches instead of being copied.
+struct ArrowOwnedBuffer : public arrow::Buffer {
+    /// The memory
+    std::unique_ptr<char[]> memory;
+    /// Constructor
+    ArrowOwnedBuffer(std::unique_ptr<char[]> memory, size_t size)
+        : arrow::Buffer(reinterpret_cast<const uint8_t*>(memory.get()), size), memory(std::move(memory)) {}
+};
+
+struct ArrowIPCStreamBuffer : public arrow::ipc::Listener, public std::enable_shared_from_this<ArrowIPCStreamBuffer> {
    protected:
     /// The schema
     std::shared_ptr<arrow::Schema> schema_;
@@ -35,6 +50,12 @@ struct ArrowIPCStreamBuffer : public arrow::ipc::Listener {
    public:
     /// Constructor
     ArrowIPCStreamBuffer();
+    /// Constructor for batches that were read already
+    ArrowIPCStreamBuffer(std::shared_ptr<arrow::Schema> schema,
+                         std::vector<std::shared_ptr<arrow::RecordBatch>> batches);
+
+    /// Read all batches of a reader, the batches are referenced and not copied
+    static arrow::Result<std::shared_ptr<ArrowIPCStreamBuffer>> ReadFrom(arrow::RecordBatchReader& reader);
 
     /// Is end of stream?
     bool is_eos() const { return is_eos_; }
@@ -42,6 +63,8 @@ struct ArrowIPCStreamBuffer : public arrow::ipc::Listener {
     auto& schema() const { return schema_; }
     /// Return the batches
     auto& batches() const { return batches_; }
+    /// Get the bytes of all buffers that are referenced by the batches
+    size_t GetByteSize() const;
 };
 
 struct ArrowIPCStreamBufferReader : public arrow::RecordBatchReader {
@@ -62,10 +85,16 @@ struct ArrowIPCStreamBufferReader : public arrow::RecordBatchReader {
     /// Read the next record batch in the stream. Return null for batch when reaching end of stream
     arrow::Status ReadNext(std::shared_ptr<arrow::RecordBatch>* batch) override;
 
-    /// Create arrow array stream wrapper
+    /// Create arrow array stream wrapper for a std::shared_ptr<arrow::RecordBatchReader>*.
+    /// The reader is consumed by the scan.
     static std::unique_ptr<duckdb::ArrowArrayStreamWrapper> CreateArrayStreamFromSharedPtrPtr(
         uintptr_t this_ptr, std::pair<std::unordered_map<idx_t, string>, std::vector<string>>& project_columns,
         duckdb::TableFilterCollection* filters);
+    /// Create arrow array stream wrapper for an ArrowIPCStreamBuffer*.
+    /// Every scan reads the buffered batches with a new reader.
+    static std::unique_ptr<duckdb::ArrowArrayStreamWrapper> CreateArrayStreamFromBufferPtr(
+        uintptr_t buffer_ptr, std::pair<std::unordered_map<idx_t, string>, std::vector<string>>& project_columns,
+        duckdb::TableFilterCollection* filters);
 };
 
 struct BufferingArrowIPCStreamDecoder : public arrow::ipc::StreamDecoder {
@@ -76,10 +105,13 @@ struct BufferingArrowIPCStreamDecoder : public arrow::ipc::StreamDecoder {
    public:
     /// Constructor
     BufferingArrowIPCStreamDecoder(
-        std::shared_ptr<ArrowIPCStreamBuffer> buffer = std::make_shared<ArrowIPCStreamBuffer>());
+        std::shared_ptr<ArrowIPCStreamBuffer> buffer = std::make_shared<ArrowIPCStreamBuffer>(),
+        arrow::ipc::IpcReadOptions options = arrow::ipc::IpcReadOptions::Defaults());
     /// Get the buffer
     auto& buffer() const { return buffer_; }
 };
 
 }  // namespace web
 }  // namespace duckdb
+
+#endif
@@ -33,22 +33,58 @@ constexpr uint32_t STATIC_WEBDB_FEATURES = (0
 #endif
 );
 
+/// The access mode of a database.
+/// Values match duckdb::AccessMode.
+enum class WebDBAccessMode : uint8_t {
+    /// Read-only for database files, read-write for in-memory databases
+    AUTOMATIC = 1,
+    /// Open the database read-only
+    READ_ONLY = 2,
+    /// Open the database read-write
+    READ_WRITE = 3,
+};
+
 struct FileSystemConfig {
     /// Allow falling back to full HTTP reads if the server does not support range requests
     bool allow_full_http_reads = true;
+    /// The time in microseconds a file sync waits for concurrent syncs before flushing.
+    /// All syncs that arrive within this window are merged into a single runtime sync.
+    uint32_t sync_window_micros = 0;
+    /// The number of bytes at the end of a remote file that are fetched speculatively when opening it.
+    /// The tail is fetched together with the file size and holds the footers of Parquet and Arrow files.
+    uint32_t speculative_tail_size = 64 << 10;
+    /// The bytes of compressed temporary files that are kept in memory, 0 if unlimited.
+    uint64_t temp_budget = 0;
+    /// The file that receives temporary files beyond the budget, empty to fail instead.
+    /// The file must resolve to the native protocol.
+    std::string temp_overflow_file = "";
 };
 
 struct WebDBConfig {
     /// The database path
     std::string path = "";
+    /// The access mode
+    WebDBAccessMode access_mode = WebDBAccessMode::AUTOMATIC;
     /// Emit BigInt values?
     /// This depends on the browser supporting BigInt64Array.
     bool emit_bigint = false;
     /// The thread count
     uint32_t maximum_threads = 1;
+    /// The memory budget in bytes that is shared by the page buffer, the readaheads, the results and DuckDB.
+    /// 0 leaves every subsystem at its default limit.
+    uint64_t memory_budget = 0;
+    /// The byte size up to which a result of a single chunk is returned as compact Arrow IPC stream without file
+    /// footer, 0 always returns Arrow IPC files.
+    uint32_t compact_result_size = 64 << 10;
+    /// The number of query plans that every connection caches by query text, 0 disables the plan cache
+    uint32_t plan_cache_size = 32;
     /// The filesystem
     FileSystemConfig filesystem = {
         .allow_full_http_reads = true,
+        .sync_window_micros = 0,
+        .speculative_tail_size = 64 << 10,
+        .temp_budget = 0,
+        .temp_overflow_file = "",
     };
 
     /// Read from a document
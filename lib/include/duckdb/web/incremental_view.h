@@ -0,0 +1,90 @@
+#ifndef INCLUDE_DUCKDB_WEB_INCREMENTAL_VIEW_H_
+#define INCLUDE_DUCKDB_WEB_INCREMENTAL_VIEW_H_
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "arrow/status.h"
+#include "rapidjson/document.h"
+
+namespace duckdb {
+namespace web {
+
+/// A view that maintains decomposable aggregates over an append-only table.
+///
+/// The view keeps partial aggregates per group in a temporary state table: sums and counts for SUM, COUNT and AVG,
+/// and extremes for MIN and MAX.
+/// A fold aggregates only the appended rows and appends their partial aggregates to the state table.
+/// The view merges the partial aggregates of every group, and the state is compacted to a single row per group
+/// after COMPACTION_FOLDS folds.
+/// The state only reflects rows that were folded in. Other modifications of the table require creating the view again.
+class IncrementalView {
+   public:
+    /// The number of folds after which the state is compacted
+    static constexpr size_t COMPACTION_FOLDS = 16;
+
+    /// An aggregate function
+    enum class AggregateFunction { SUM, COUNT, MIN, MAX, AVG };
+    /// An aggregate
+    struct Aggregate {
+        /// The function
+        AggregateFunction function;
+        /// The aggregated column, empty for COUNT(*)
+        std::string column;
+        /// The output name
+        std::string name;
+    };
+
+   protected:
+    /// The view name
+    std::string name_ = "";
+    /// The schema name of the table
+    std::string schema_name_ = "main";
+    /// The table name
+    std::string table_name_ = "";
+    /// The group columns
+    std::vector<std::string> groups_ = {};
+    /// The aggregates
+    std::vector<Aggregate> aggregates_ = {};
+    /// The folds since the last compaction
+    size_t folds_ = 0;
+
+    /// Encode the group columns
+    std::string EncodeGroups() const;
+    /// Encode a query that computes the partial aggregates of a relation
+    std::string EncodePartialAggregates(std::string_view relation) const;
+    /// Encode a query that merges the partial aggregates of the state table
+    std::string EncodeMergedAggregates(bool final) const;
+
+   public:
+    /// Get the view name
+    auto& name() const { return name_; }
+    /// Get the schema name of the table
+    auto& schema_name() const { return schema_name_; }
+    /// Get the table name
+    auto& table_name() const { return table_name_; }
+    /// Get the aggregates
+    auto& aggregates() const { return aggregates_; }
+    /// Get the folds since the last compaction
+    auto folds() const { return folds_; }
+    /// Get the quoted name of the state table
+    std::string GetStateTable() const;
+
+    /// Read the view definition from a document
+    arrow::Status ReadFrom(const rapidjson::Document& doc);
+    /// Encode the statements that (re)create the state table and the view
+    std::vector<std::string> EncodeCreate() const;
+    /// Encode the statements that fold the rows of a relation into the state table
+    std::vector<std::string> EncodeFold(std::string_view relation) const;
+    /// Count a fold once its statements were executed successfully
+    void CommitFold();
+    /// Encode the statements that drop the view and the state table
+    std::vector<std::string> EncodeDrop() const;
+};
+
+}  // namespace web
+}  // namespace duckdb
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef INCLUDE_DUCKDB_WEB_IO_ASYNC_READER_H_
+#define INCLUDE_DUCKDB_WEB_IO_ASYNC_READER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string_view>
+
+#include "nonstd/span.h"
+
+namespace duckdb {
+namespace web {
+namespace io {
+
+/// A local file that is read with an async reader.
+/// Only available in native builds.
+class AsyncFile {
+   protected:
+    /// The file descriptor
+    int fd_;
+
+    /// Constructor
+    explicit AsyncFile(int fd) : fd_(fd) {}
+
+   public:
+    /// Destructor
+    ~AsyncFile();
+    /// Delete copy constructor
+    AsyncFile(const AsyncFile& other) = delete;
+    /// Delete copy assignment
+    AsyncFile& operator=(const AsyncFile& other) = delete;
+
+    /// Get the file descriptor
+    auto GetFD() const { return fd_; }
+
+    /// Open a local file for reading, returns nullptr if the file cannot be opened
+    static std::unique_ptr<AsyncFile> Open(std::string_view path);
+};
+
+/// Reads batches of file ranges with many reads in flight.
+///
+/// On Linux, reads are submitted through io_uring and complete out of order.
+/// Kernels without io_uring fall back to blocking preads.
+class AsyncReader {
+   public:
+    /// A read request
+    struct Request {
+        /// The file
+        int fd = -1;
+        /// The output buffer
+        char* buffer = nullptr;
+        /// The number of bytes to read
+        uint32_t size = 0;
+        /// The file offset
+        uint64_t offset = 0;
+    };
+    /// Called when a request completed with the number of bytes read or a negative errno.
+    /// Short reads are only reported at the end of the file.
+    /// The callback must not throw.
+    using CompletionCallback = std::function<void(size_t request_id, int64_t result)>;
+
+    /// Destructor
+    virtual ~AsyncReader() = default;
+
+    /// Get the name of the backend
+    virtual std::string_view GetName() const = 0;
+    /// Get the maximum number of reads in flight
+    virtual size_t GetQueueDepth() const = 0;
+    /// Read a batch of requests and wait for all of them
+    virtual void Read(nonstd::span<const Request> requests, const CompletionCallback& done) = 0;
+
+    /// Create the best available reader, returns nullptr if reads cannot be issued asynchronously
+    static std::unique_ptr<AsyncReader> Create(size_t queue_depth);
+    /// Create an io_uring reader, returns nullptr if io_uring is not available
+    static std::unique_ptr<AsyncReader> CreateIOUring(size_t queue_depth);
+    /// Create a reader that issues blocking preads
+    static std::unique_ptr<AsyncReader> CreatePRead();
+};
+
+}  // namespace io
+}  // namespace web
+}  // namespace duckdb
+
+#endif
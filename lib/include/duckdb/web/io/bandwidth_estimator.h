@@ -0,0 +1,98 @@
+#ifndef INCLUDE_DUCKDB_WEB_IO_BANDWIDTH_ESTIMATOR_H_
+#define INCLUDE_DUCKDB_WEB_IO_BANDWIDTH_ESTIMATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "duckdb/web/io/readahead_buffer.h"
+#include "rapidjson/document.h"
+
+namespace duckdb {
+namespace web {
+namespace io {
+
+/// A running estimate of the request latency and the throughput of a data origin.
+///
+/// Every completed read is a sample of `latency + bytes / bandwidth`.
+/// Small reads are dominated by the latency, large reads by the bandwidth.
+/// Both are tracked as exponentially weighted moving averages.
+class OriginEstimator {
+   public:
+    /// Reads up to this size update the latency, larger reads update the bandwidth
+    static constexpr uint64_t LATENCY_SAMPLE_LIMIT = 64 << 10;
+    /// The weight of a new sample
+    static constexpr double SAMPLE_WEIGHT = 0.2;
+    /// The number of samples of both kinds before the estimate is trusted
+    static constexpr uint64_t MIN_SAMPLES = 2;
+
+    /// An estimate
+    struct Estimate {
+        /// The request latency in seconds
+        double latency = 0.0;
+        /// The bandwidth in bytes per second
+        double bandwidth = 0.0;
+        /// The number of latency samples
+        uint64_t latency_samples = 0;
+        /// The number of bandwidth samples
+        uint64_t bandwidth_samples = 0;
+
+        /// Is the estimate based on enough samples?
+        bool IsReliable() const { return latency_samples >= MIN_SAMPLES && bandwidth_samples >= MIN_SAMPLES; }
+        /// Get the bandwidth-delay product in bytes
+        uint64_t GetBandwidthDelayProduct() const { return static_cast<uint64_t>(latency * bandwidth); }
+        /// Derive the readahead sizes.
+        /// A read head should be a multiple of the bandwidth-delay product to amortize the latency.
+        ReadAheadPolicy GetReadAheadPolicy() const;
+    };
+
+   protected:
+    /// The origin
+    const std::string origin_;
+    /// The mutex
+    mutable std::mutex mutex_ = {};
+    /// The current estimate
+    Estimate estimate_ = {};
+
+   public:
+    /// Constructor
+    OriginEstimator(std::string origin) : origin_(std::move(origin)) {}
+
+    /// Get the origin
+    auto& GetOrigin() const { return origin_; }
+    /// Record a completed read
+    void Record(uint64_t bytes, double seconds);
+    /// Get the current estimate
+    Estimate Get() const;
+    /// Write the estimate as JSON
+    rapidjson::Value WriteInfo(rapidjson::Document& doc) const;
+};
+
+/// The estimators of all data origins
+class BandwidthEstimator {
+   protected:
+    /// The mutex
+    mutable std::mutex mutex_ = {};
+    /// The estimators by origin, never erased
+    std::unordered_map<std::string, std::unique_ptr<OriginEstimator>> origins_ = {};
+
+   public:
+    /// Resolve the origin of a data URL.
+    /// URLs are grouped by scheme and host, all other paths share the "file" origin.
+    static std::string ResolveOrigin(std::string_view data_url);
+
+    /// Get the estimator of an origin, creates it if necessary
+    OriginEstimator& Resolve(std::string_view origin);
+    /// Find the estimator of an origin
+    const OriginEstimator* Find(std::string_view origin) const;
+};
+
+}  // namespace io
+}  // namespace web
+}  // namespace duckdb
+
+#endif
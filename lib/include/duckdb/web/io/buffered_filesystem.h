@@ -2,12 +2,16 @@
 #define INCLUDE_DUCKDB_WEB_BUFFERED_FILESYSTEM_H_
 
 #include <cstddef>
+#include <optional>
+#include <string_view>
 #include <unordered_map>
 
 #include "duckdb/common/constants.hpp"
 #include "duckdb/common/file_system.hpp"
 #include "duckdb/web/io/file_page_buffer.h"
+#include "duckdb/web/io/temp_filesystem.h"
 #include "duckdb/web/utils/parallel.h"
+#include "nonstd/span.h"
 
 namespace duckdb {
 namespace web {
@@ -57,6 +61,13 @@ class BufferedFileSystem : public duckdb::FileSystem {
     LightMutex directory_mutex_;
     /// The files that are passed through
     std::unordered_map<std::string, FileConfig> file_configs_;
+    /// The filesystem of the temp directory (if any)
+    std::shared_ptr<TempFileSystem> temp_filesystem_;
+
+    /// Resolve the filesystem of a path
+    duckdb::FileSystem &ResolveFileSystem(std::string_view path) {
+        return (temp_filesystem_ && IsTempPath(path)) ? *temp_filesystem_ : filesystem_;
+    }
 
    public:
     /// Constructor
@@ -64,10 +75,15 @@ class BufferedFileSystem : public duckdb::FileSystem {
     /// Destructor
     virtual ~BufferedFileSystem() {}
 
+    /// Serve the temp directory from a temp filesystem
+    void SetTempFileSystem(std::shared_ptr<TempFileSystem> temp_fs) { temp_filesystem_ = std::move(temp_fs); }
     /// Pass through a file
     void RegisterFile(std::string_view file, FileConfig config = {.force_direct_io = false});
     /// Try to drop a file
     bool TryDropFile(std::string_view file);
+    /// Try to drop multiple files under a single lock, returns the first file that is still buffered (if any).
+    /// No file is dropped if one of them is still buffered.
+    std::optional<std::string_view> TryDropFiles(nonstd::span<const std::string_view> files);
     /// Drop a file
     void DropFiles();
 
@@ -99,25 +115,29 @@ class BufferedFileSystem : public duckdb::FileSystem {
     void Truncate(duckdb::FileHandle &handle, int64_t new_size) override;
 
     /// Check if a directory exists
-    bool DirectoryExists(const string &directory) override { return filesystem_.DirectoryExists(directory); }
+    bool DirectoryExists(const string &directory) override {
+        return ResolveFileSystem(directory).DirectoryExists(directory);
+    }
     /// Create a directory if it does not exist
-    void CreateDirectory(const std::string &directory) override { return filesystem_.CreateDirectory(directory); }
+    void CreateDirectory(const std::string &directory) override {
+        return ResolveFileSystem(directory).CreateDirectory(directory);
+    }
     /// Recursively remove a directory and all files in it
     void RemoveDirectory(const std::string &directory) override;
     /// List files in a directory, invoking the callback method for each one with (filename, is_dir)
     bool ListFiles(const std::string &directory, const std::function<void(std::string, bool)> &callback) override {
-        return filesystem_.ListFiles(directory, callback);
+        return ResolveFileSystem(directory).ListFiles(directory, callback);
     }
     /// Move a file from source path to the target, StorageManager relies on this being an atomic action for ACID
     /// properties
     void MoveFile(const std::string &source, const std::string &target) override;
     /// Check if a file exists
-    bool FileExists(const std::string &filename) override { return filesystem_.FileExists(filename); }
+    bool FileExists(const std::string &filename) override { return ResolveFileSystem(filename).FileExists(filename); }
     /// Remove a file from disk
     void RemoveFile(const std::string &filename) override;
 
     /// Runs a glob on the file system, returning a list of matching files
-    std::vector<std::string> Glob(const std::string &path) override { return filesystem_.Glob(path); }
+    std::vector<std::string> Glob(const std::string &path) override { return ResolveFileSystem(path).Glob(path); }
 
     /// Set the file pointer of a file handle to a specified location. Reads and writes will happen from this location
     void Seek(duckdb::FileHandle &handle, idx_t location) override;
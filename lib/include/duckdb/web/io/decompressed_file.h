@@ -0,0 +1,69 @@
+#ifndef INCLUDE_DUCKDB_WEB_IO_DECOMPRESSED_FILE_H_
+#define INCLUDE_DUCKDB_WEB_IO_DECOMPRESSED_FILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+#include "duckdb/common/file_system.hpp"
+
+namespace duckdb {
+namespace web {
+namespace io {
+
+/// A compression codec of a file
+enum class CompressionCodec : uint8_t {
+    NONE = 0,
+    GZIP = 1,
+    ZSTD = 2,
+};
+
+/// Resolve the compression codec of a file.
+/// AUTO_DETECT infers the codec from the file extension.
+CompressionCodec ResolveCompressionCodec(std::string_view path, duckdb::FileCompressionType compression);
+
+/// A read-only, randomly accessible view on the decompressed contents of a compressed file.
+///
+/// gzip files are decoded sequentially and remember a checkpoint of the inflate state every few megabytes
+/// (zran-style). A read starts at the closest checkpoint or continues a sequential scan without rewinding.
+/// zstd files are split into their frames that are decoded independently and in parallel.
+/// Decoded frames are cached within a fixed byte budget, large frames are streamed instead of being cached.
+///
+/// The index is built lazily by the first read that needs it.
+/// Reads are serialized, decompressed pages are expected to be cached by the caller.
+class DecompressedFile {
+   protected:
+    /// The filesystem
+    duckdb::FileSystem& filesystem_;
+    /// The compressed file
+    duckdb::FileHandle& handle_;
+    /// The size of the compressed file
+    uint64_t compressed_size_;
+
+    /// Read compressed bytes
+    size_t ReadCompressed(void* out, size_t n, uint64_t offset);
+
+   public:
+    /// Constructor
+    DecompressedFile(duckdb::FileSystem& filesystem, duckdb::FileHandle& handle);
+    /// Destructor
+    virtual ~DecompressedFile() = default;
+
+    /// Get the decompressed size.
+    /// This may have to scan the whole file once.
+    virtual uint64_t GetSize() = 0;
+    /// Read at most n decompressed bytes at an offset, returns the number of bytes read
+    virtual uint64_t Read(char* out, uint64_t n, uint64_t offset) = 0;
+
+    /// Open a decompressed view on a file handle.
+    /// The handle must outlive the view.
+    static std::unique_ptr<DecompressedFile> Open(duckdb::FileSystem& filesystem, duckdb::FileHandle& handle,
+                                                  CompressionCodec codec, size_t threads = 1);
+};
+
+}  // namespace io
+}  // namespace web
+}  // namespace duckdb
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef INCLUDE_DUCKDB_WEB_IO_FILE_PAGE_BUFFER_H
 #define INCLUDE_DUCKDB_WEB_IO_FILE_PAGE_BUFFER_H
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
@@ -19,8 +20,12 @@
 
 #include "duckdb/common/constants.hpp"
 #include "duckdb/common/file_system.hpp"
+#include "duckdb/web/io/async_reader.h"
+#include "duckdb/web/io/decompressed_file.h"
 #include "duckdb/web/io/file_page_defaults.h"
+#include "duckdb/web/io/mapped_file.h"
 #include "duckdb/web/io/web_filesystem.h"
+#include "duckdb/web/memory_governor.h"
 #include "duckdb/web/utils/parallel.h"
 #include "nonstd/span.h"
 
@@ -53,7 +58,7 @@ namespace io {
 ///      Buffer    HTTP Ranges  FileReaderSync
 ///
 
-class FilePageBuffer {
+class FilePageBuffer : public MemoryConsumer {
    public:
     /// A directory guard
     using DirectoryGuard = std::unique_lock<LightMutex>;
@@ -80,6 +85,14 @@ class FilePageBuffer {
         std::string path = {};
         /// The file
         std::unique_ptr<duckdb::FileHandle> handle = nullptr;
+        /// The compression codec
+        CompressionCodec codec = CompressionCodec::NONE;
+        /// The decompressed view on the file (if compressed)
+        std::unique_ptr<DecompressedFile> decompressed = nullptr;
+        /// The memory mapping of the file (if mapped)
+        std::unique_ptr<MappedFile> mapped = nullptr;
+        /// The local file for async reads (if any)
+        std::unique_ptr<AsyncFile> async_file = nullptr;
 
         /// This latch ensures that reads and writes are blocked during truncation.
         SharedMutex file_latch = {};
@@ -180,10 +193,14 @@ class FilePageBuffer {
         BufferFrame* frame_;
         /// The frame guard
         FrameGuardVariant frame_guard_;
+        /// The mapped data (if the file is memory-mapped)
+        nonstd::span<char> mapped_data_ = {};
 
         /// The constructor
         explicit BufferRef(FileRef& file_ref, SharedFileGuard&& file_guard, BufferFrame& frame,
                            FrameGuardVariant frame_guard);
+        /// The constructor for memory-mapped data
+        explicit BufferRef(FileRef& file_ref, SharedFileGuard&& file_guard, nonstd::span<char> mapped_data);
 
        public:
         /// Move constructor
@@ -191,9 +208,11 @@ class FilePageBuffer {
             : file_(other.file_),
               file_guard_(std::move(other.file_guard_)),
               frame_(other.frame_),
-              frame_guard_(std::move(other.frame_guard_)) {
+              frame_guard_(std::move(other.frame_guard_)),
+              mapped_data_(other.mapped_data_) {
             other.file_ = nullptr;
             other.frame_ = nullptr;
+            other.mapped_data_ = {};
         }
         /// Destructor
         ~BufferRef() { Release(); }
@@ -204,14 +223,18 @@ class FilePageBuffer {
             file_guard_ = std::move(other.file_guard_);
             frame_ = std::move(other.frame_);
             frame_guard_ = std::move(other.frame_guard_);
+            mapped_data_ = other.mapped_data_;
             other.file_ = nullptr;
             other.frame_ = nullptr;
+            other.mapped_data_ = {};
             return *this;
         }
         /// Is set?
-        operator bool() const { return !!frame_; }
+        operator bool() const { return !!frame_ || !!mapped_data_.data(); }
+        /// Is the data memory-mapped?
+        bool IsMapped() const { return !!mapped_data_.data(); }
         /// Access the data
-        auto GetData() { return frame_->GetData(); }
+        auto GetData() { return frame_ ? frame_->GetData() : mapped_data_; }
         /// Mark as dirty
         void MarkAsDirty();
         /// Release the file ref
@@ -266,11 +289,19 @@ class FilePageBuffer {
         auto& GetHandle() const { return *file_->handle; }
         /// Get the size
         auto GetSize() const { return file_->file_size; }
+        /// Get the compression codec
+        auto GetCodec() const { return file_->codec; }
         /// Release the file ref
         bool Release(bool keep_dangling = true);
 
         /// Fix file exclusively
         BufferRef FixPage(uint64_t page_id, bool exclusive);
+        /// Fix a byte range of a memory-mapped file without copying.
+        /// Returns an empty buffer ref if the file is not mapped.
+        BufferRef FixRange(uint64_t offset, uint64_t n);
+        /// Load the run of missing pages that starts at a page with batched async reads.
+        /// Stops at the first buffered page, does nothing if async reads are not configured.
+        void LoadPages(uint64_t first_page_id, uint64_t page_count);
         /// Flush the file
         void Flush();
         /// Truncate the file
@@ -286,8 +317,10 @@ class FilePageBuffer {
    protected:
     /// The page size
     const uint64_t page_size_bits;
-    /// The page capacity
-    const uint64_t page_capacity;
+    /// The page capacity, lowered by the memory limit
+    std::atomic<uint64_t> page_capacity;
+    /// The page capacity without memory limit
+    const uint64_t max_page_capacity;
 
     /// The actual filesystem
     std::shared_ptr<duckdb::FileSystem> filesystem;
@@ -315,6 +348,12 @@ class FilePageBuffer {
 
     /// The file statistics
     std::shared_ptr<io::FileStatisticsRegistry> file_statistics_;
+    /// The number of threads that decompress files
+    size_t decompression_threads_ = 1;
+    /// Map read-only local files into memory?
+    bool memory_mapping_ = false;
+    /// The reader for batched async page loads (if any)
+    std::unique_ptr<AsyncReader> async_reader_ = nullptr;
 
     /// Lock the directory
     inline auto Lock() { return std::unique_lock{directory_latch}; }
@@ -348,27 +387,49 @@ class FilePageBuffer {
     uint64_t GetPageSize() const { return 1 << page_size_bits; }
     /// Get the page shift
     auto GetPageSizeShift() const { return page_size_bits; }
+    /// Get the page capacity
+    uint64_t GetPageCapacity() const { return page_capacity; }
     /// Get a page id from an offset
     uint64_t GetPageIDFromOffset(uint64_t offset) { return offset >> page_size_bits; }
     /// Configure file statistics
     void ConfigureFileStatistics(std::shared_ptr<FileStatisticsRegistry> registry);
     /// Collect file statistics
     void CollectFileStatistics(std::string_view path, std::shared_ptr<FileStatisticsCollector> collector);
-
-    /// Open a file
+    /// Configure the number of threads that decompress files
+    void ConfigureDecompression(size_t threads) { decompression_threads_ = std::max<size_t>(1, threads); }
+    /// Configure whether read-only files are memory-mapped.
+    /// Must only be enabled if the filesystem serves local files.
+    void ConfigureMemoryMapping(bool enabled) { memory_mapping_ = enabled; }
+    /// Configure the reader for batched async page loads.
+    /// Must only be set if the filesystem serves local files.
+    void ConfigureAsyncReads(std::unique_ptr<AsyncReader> reader) { async_reader_ = std::move(reader); }
+
+    /// Open a file.
+    /// Compressed files are read-only and the pages hold the decompressed contents.
     std::unique_ptr<FileRef> OpenFile(std::string_view path, uint8_t flags,
-                                      duckdb::FileLockType lock_type = duckdb::FileLockType::NO_LOCK);
+                                      duckdb::FileLockType lock_type = duckdb::FileLockType::NO_LOCK,
+                                      CompressionCodec codec = CompressionCodec::NONE);
     /// Is buffered
     bool BuffersFile(std::string_view path);
     /// Flush file matching name to disk
     void FlushFile(std::string_view path);
     /// Flush all outstanding frames to disk
     void FlushFiles();
+    /// Can a file be dropped?
+    bool CanDropFile(std::string_view file_name);
     /// Try to drop a specific file
     bool TryDropFile(std::string_view file_name);
     /// Drop dangling files
     void DropDanglingFiles();
 
+    /// Get the bytes of all frames and free frame buffers
+    size_t GetMemoryUsage() override;
+    /// Lower the page capacity to a memory limit and evict the pages that no longer fit.
+    /// A limit of 0 restores the initial page capacity.
+    void SetMemoryLimit(size_t bytes) override;
+    /// Drop free frame buffers and evict unused pages, returns the released bytes
+    size_t ReclaimMemory(size_t bytes) override;
+
     /// Returns the page ids of all pages that are in the FIFO list in FIFO order.
     std::vector<uint64_t> GetFIFOList() const;
     /// Returns the page ids of all pages that are in the LRU list in LRU order.
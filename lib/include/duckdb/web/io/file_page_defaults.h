@@ -9,6 +9,8 @@ namespace io {
 
 constexpr size_t DEFAULT_FILE_PAGE_CAPACITY = 10000;
 constexpr size_t DEFAULT_FILE_PAGE_SHIFT = 12;  // 4KB pages
+constexpr size_t MINIMUM_FILE_PAGE_CAPACITY = 64;
+constexpr size_t DEFAULT_ASYNC_QUEUE_DEPTH = 64;
 
 }  // namespace io
 }  // namespace web
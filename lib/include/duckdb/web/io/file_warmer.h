@@ -0,0 +1,185 @@
+#ifndef INCLUDE_DUCKDB_WEB_IO_FILE_WARMER_H_
+#define INCLUDE_DUCKDB_WEB_IO_FILE_WARMER_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifndef DUCKDB_NO_THREADS
+#include <thread>
+#endif
+
+#include "arrow/result.h"
+#include "duckdb/web/io/file_page_buffer.h"
+#include "rapidjson/document.h"
+
+namespace duckdb {
+namespace web {
+namespace io {
+
+/// What a warm-up loads
+enum class WarmUpMode : uint8_t {
+    /// Explicit byte ranges
+    RANGES = 0,
+    /// The file header and the footer of Parquet and Arrow files
+    METADATA = 1,
+    /// The whole file
+    ALL = 2,
+};
+
+/// The state of a warm-up
+enum class WarmUpState : uint8_t {
+    QUEUED = 0,
+    RUNNING = 1,
+    DONE = 2,
+    CANCELLED = 3,
+    FAILED = 4,
+};
+
+/// A byte range of a file
+struct WarmUpRange {
+    /// The offset
+    uint64_t offset = 0;
+    /// The length
+    uint64_t length = 0;
+};
+
+/// The progress of a warm-up
+struct WarmUpProgress {
+    /// The state
+    WarmUpState state = WarmUpState::QUEUED;
+    /// The bytes that were loaded
+    uint64_t bytes_loaded = 0;
+    /// The bytes that will be loaded, known once the warm-up is running
+    uint64_t bytes_total = 0;
+    /// The error (if failed)
+    std::string error = "";
+
+    /// Is the warm-up finished?
+    bool IsFinished() const { return state != WarmUpState::QUEUED && state != WarmUpState::RUNNING; }
+    /// Write the progress as JSON
+    rapidjson::Value WriteInfo(rapidjson::Document& doc) const;
+};
+
+/// Loads file ranges into the page buffer ahead of the queries that need them.
+///
+/// Warm-ups are processed in chunks of pages, ordered by priority and then by age.
+/// With threads, a background thread works through the queue.
+/// Without threads, callers advance the queue explicitly with Step(), e.g. whenever the progress is polled.
+/// A warm-up never loads more than half of the page capacity to not evict the pages of running queries.
+class FileWarmer {
+   public:
+    /// The number of pages that are loaded at once
+    static constexpr uint64_t CHUNK_PAGES = 16;
+    /// The number of bytes at the start of a file that hold metadata
+    static constexpr uint64_t METADATA_HEAD_SIZE = 16 << 10;
+    /// The number of bytes at the end of a file that hold metadata if the format is unknown
+    static constexpr uint64_t METADATA_TAIL_SIZE = 64 << 10;
+    /// The number of finished warm-ups that keep their progress
+    static constexpr size_t MAX_FINISHED = 64;
+
+   protected:
+    /// A warm-up
+    struct WarmUp {
+        /// The warm-up id
+        size_t id = 0;
+        /// The file path
+        std::string path = {};
+        /// The mode
+        WarmUpMode mode = WarmUpMode::RANGES;
+        /// The requested ranges
+        std::vector<WarmUpRange> ranges = {};
+        /// The priority, higher values are loaded first
+        int32_t priority = 0;
+        /// The page runs [begin, end), resolved when the warm-up starts
+        std::vector<std::pair<uint64_t, uint64_t>> page_runs = {};
+        /// Were the page runs resolved?
+        bool resolved = false;
+        /// Is a chunk being loaded?
+        bool loading = false;
+        /// Was the warm-up cancelled while loading?
+        bool cancelled = false;
+        /// The next page run
+        size_t next_run = 0;
+        /// The next page in the run
+        uint64_t next_page = 0;
+        /// The progress
+        WarmUpProgress progress = {};
+    };
+
+    /// The page buffer
+    std::shared_ptr<FilePageBuffer> buffer_;
+    /// The mutex
+    std::mutex mutex_ = {};
+    /// The condition variable, signaled when work is queued or a chunk finishes
+    std::condition_variable cv_ = {};
+    /// The warm-ups by id
+    std::map<size_t, std::shared_ptr<WarmUp>> warm_ups_ = {};
+    /// The ids of the finished warm-ups in finishing order
+    std::vector<size_t> finished_ = {};
+    /// The next warm-up id
+    size_t next_id_ = 1;
+    /// Is the warmer shutting down?
+    bool stopping_ = false;
+    /// Should a background thread process the queue?
+    bool background_ = false;
+#ifndef DUCKDB_NO_THREADS
+    /// The background thread (if any)
+    std::thread worker_ = {};
+#endif
+
+    /// Find the next warm-up that has work left
+    std::shared_ptr<WarmUp> FindNext();
+    /// Mark a warm-up as finished
+    void Finish(WarmUp& warm_up, WarmUpState state, std::string error = "");
+    /// Resolve the page runs of a warm-up
+    std::vector<std::pair<uint64_t, uint64_t>> ResolvePageRuns(const WarmUp& warm_up, FilePageBuffer::FileRef& file);
+    /// Load the next chunk of a warm-up
+    void LoadChunk(WarmUp& warm_up, std::unique_lock<std::mutex>& guard);
+    /// Run the background thread
+    void Work();
+
+   public:
+    /// Constructor
+    FileWarmer(std::shared_ptr<FilePageBuffer> buffer, bool background = true);
+    /// Destructor
+    ~FileWarmer();
+    /// Delete copy constructor
+    FileWarmer(const FileWarmer&) = delete;
+
+    /// Does a background thread process the queue?
+    bool HasBackgroundThread() const;
+    /// Enqueue a warm-up and return its id
+    size_t Enqueue(std::string_view path, WarmUpMode mode, std::vector<WarmUpRange> ranges = {},
+                   int32_t priority = 0);
+    /// Cancel a warm-up, returns false if the warm-up is unknown
+    bool Cancel(size_t id);
+    /// Cancel all warm-ups of a file and wait until none of them holds the file
+    void CancelFile(std::string_view path);
+    /// Cancel all warm-ups and wait until none of them holds a file
+    void CancelAll();
+    /// Get the progress of a warm-up
+    std::optional<WarmUpProgress> GetProgress(size_t id);
+    /// Load the next chunk of the queue, returns whether work remains
+    bool Step();
+    /// Wait until a warm-up is finished, works through the queue if there is no background thread
+    std::optional<WarmUpProgress> Wait(size_t id);
+
+    /// Parse the target of a warm-up.
+    /// Accepts "metadata", "all" or an array of [offset, length] pairs.
+    static arrow::Result<std::pair<WarmUpMode, std::vector<WarmUpRange>>> ParseTarget(std::string_view target_json);
+};
+
+}  // namespace io
+}  // namespace web
+}  // namespace duckdb
+
+#endif
@@ -3,7 +3,9 @@
 
 #include <initializer_list>
 #include <regex>
+#include <string>
 #include <string_view>
+#include <vector>
 
 namespace duckdb {
 namespace web {
@@ -26,6 +28,30 @@ struct GlobToRegexOptions {
 
 std::regex glob_to_regex(std::string_view glob, GlobToRegexOptions options = {});
 
+/// A compiled glob matcher.
+/// Matches the same inputs as glob_to_regex with the default options: '*' matches any sequence of characters
+/// (including '/'), a backslash escapes the next character and everything else is a literal.
+class GlobMatcher {
+   protected:
+    /// The literals between the wildcards
+    std::vector<std::string> literals_;
+    /// Does the glob start with a wildcard?
+    bool leading_wildcard_ = false;
+    /// Does the glob end with a wildcard?
+    bool trailing_wildcard_ = false;
+
+   public:
+    /// Constructor
+    explicit GlobMatcher(std::string_view glob);
+
+    /// Get the unescaped literal prefix that all matches start with, this is the whole literal of a literal glob
+    std::string_view GetLiteralPrefix() const;
+    /// Is the glob a plain literal?
+    bool IsLiteral() const { return !leading_wildcard_ && !trailing_wildcard_ && literals_.size() <= 1; }
+    /// Match a text
+    bool Matches(std::string_view text) const;
+};
+
 }  // namespace io
 }  // namespace web
 }  // namespace duckdb
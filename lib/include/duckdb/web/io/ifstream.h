@@ -58,9 +58,11 @@ class InputFileStreamBuffer : public std::streambuf {
 
    public:
     /// Constructor
-    InputFileStreamBuffer(std::shared_ptr<FilePageBuffer> file_page_buffer, std::string_view path)
+    InputFileStreamBuffer(std::shared_ptr<FilePageBuffer> file_page_buffer, std::string_view path,
+                          CompressionCodec codec = CompressionCodec::NONE)
         : file_page_buffer_(std::move(file_page_buffer)),
-          file_(file_page_buffer_->OpenFile(path, duckdb::FileFlags::FILE_FLAGS_READ, duckdb::FileLockType::NO_LOCK)),
+          file_(file_page_buffer_->OpenFile(path, duckdb::FileFlags::FILE_FLAGS_READ, duckdb::FileLockType::NO_LOCK,
+                                            codec)),
           buffer_(file_->FixPage(0, false)),
           data_end_(file_->GetSize()),
           next_page_id_(1) {
@@ -71,7 +73,7 @@ class InputFileStreamBuffer : public std::streambuf {
     InputFileStreamBuffer(const InputFileStreamBuffer& other)
         : file_page_buffer_(other.file_page_buffer_),
           file_(other.file_page_buffer_->OpenFile(other.file_->GetPath(), duckdb::FileFlags::FILE_FLAGS_READ,
-                                                  duckdb::FileLockType::NO_LOCK)),
+                                                  duckdb::FileLockType::NO_LOCK, other.file_->GetCodec())),
           buffer_(other.file_->FixPage(other.next_page_id_ - 1, false)),
           data_end_(other.data_end_),
           next_page_id_(other.next_page_id_) {
@@ -97,8 +99,9 @@ class InputFileStream : public std::istream {
 
    public:
     /// Constructor
-    InputFileStream(std::shared_ptr<FilePageBuffer> file_page_buffer, std::string_view path)
-        : buffer_(std::move(file_page_buffer), path), std::istream(&buffer_) {}
+    InputFileStream(std::shared_ptr<FilePageBuffer> file_page_buffer, std::string_view path,
+                    CompressionCodec codec = CompressionCodec::NONE)
+        : buffer_(std::move(file_page_buffer), path, codec), std::istream(&buffer_) {}
     /// Copy constructor
     InputFileStream(const InputFileStream& other) : buffer_(other.buffer_), std::istream(&buffer_){};
     /// Scan a slice of the file
@@ -0,0 +1,56 @@
+#ifndef INCLUDE_DUCKDB_WEB_IO_MAPPED_FILE_H_
+#define INCLUDE_DUCKDB_WEB_IO_MAPPED_FILE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+#include "nonstd/span.h"
+
+namespace duckdb {
+namespace web {
+namespace io {
+
+/// A read-only memory mapping of a local file.
+/// Only available in native builds, WebAssembly has no mmap for files outside the module memory.
+class MappedFile {
+   protected:
+    /// The mapped data
+    char* data_ = nullptr;
+    /// The mapped size
+    uint64_t size_ = 0;
+    /// The page that was read last
+    std::atomic<uint64_t> last_page_ = 0;
+    /// The number of pages that were read sequentially
+    std::atomic<uint64_t> sequential_pages_ = 0;
+
+    /// Constructor
+    MappedFile(char* data, uint64_t size);
+
+   public:
+    /// Destructor
+    ~MappedFile();
+    /// Delete copy constructor
+    MappedFile(const MappedFile& other) = delete;
+    /// Delete copy assignment
+    MappedFile& operator=(const MappedFile& other) = delete;
+
+    /// Get the mapped data
+    auto GetData() const { return nonstd::span<char>{data_, size_}; }
+    /// Get the mapped size
+    auto GetSize() const { return size_; }
+
+    /// Notify the mapping about a read of a page.
+    /// Sequential reads ask the kernel to read ahead, random reads disable the readahead.
+    void Advise(uint64_t page_id, uint64_t page_size);
+
+    /// Map a local file, returns nullptr if the file cannot be mapped
+    static std::unique_ptr<MappedFile> Open(std::string_view path);
+};
+
+}  // namespace io
+}  // namespace web
+}  // namespace duckdb
+
+#endif
@@ -1,33 +1,52 @@
 #ifndef INCLUDE_DUCKDB_WEB_IO_MEMORY_FILESYSTEM_H_
 #define INCLUDE_DUCKDB_WEB_IO_MEMORY_FILESYSTEM_H_
 
-#include <unordered_set>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #include "arrow/status.h"
 #include "duckdb/common/constants.hpp"
 #include "duckdb/common/file_system.hpp"
+#include "duckdb/web/utils/parallel.h"
+#include "nonstd/span.h"
 
 namespace duckdb {
 namespace web {
 namespace io {
 
+/// A filesystem that keeps files in memory.
+///
+/// Files are stored as a list of fixed-size segments.
+/// Appends allocate new segments without moving the existing bytes and reads can scan the segments in place.
+/// Every file has a reader/writer latch, the file index is protected by a separate latch.
+/// Removed files stay readable through their open handles until the last handle is closed.
 class MemoryFileSystem : public duckdb::FileSystem {
+   public:
+    /// The size of a file segment
+    static constexpr size_t SEGMENT_SIZE = 64 << 10;
+
    protected:
     class FileHandle;
 
     /// A file buffer
     struct FileBuffer {
-        /// The file name
-        size_t file_id;
+        /// The file latch
+        SharedMutex file_latch = {};
         /// The file path
-        std::string file_path;
-        /// The buffer
-        std::vector<char> buffer;
-        /// The file handles
-        std::unordered_set<FileHandle *> handles;
-
-        /// Constructor
-        FileBuffer(size_t id, std::string path, std::vector<char> buffer);
+        std::string file_path = "";
+        /// The file size
+        uint64_t file_size = 0;
+        /// The segments
+        std::vector<std::unique_ptr<char[]>> segments = {};
+        /// The number of open handles
+        size_t handle_count = 0;
+        /// Was the file removed while it was still opened?
+        bool removed = false;
     };
 
     /// A file handle
@@ -35,40 +54,56 @@ class MemoryFileSystem : public duckdb::FileSystem {
         friend class MemoryFileSystem;
 
        protected:
-        /// The filesystem
-        MemoryFileSystem &file_system_;
         /// The file buffer
-        FileBuffer &buffer_;
+        std::shared_ptr<FileBuffer> buffer_;
         /// The position
-        size_t position_;
+        uint64_t position_;
 
         /// Close the file
         void Close() override;
 
        public:
         /// Constructor
-        FileHandle(MemoryFileSystem &file_system, FileBuffer &buffer, size_t position);
+        FileHandle(MemoryFileSystem &file_system, std::shared_ptr<FileBuffer> buffer);
         /// Delete copy constructor
         FileHandle(const FileHandle &) = delete;
         /// Destructor
-        virtual ~FileHandle() {}
+        ~FileHandle() override;
     };
 
-   public:
+    /// The directory latch
+    LightMutex directory_latch_ = {};
     /// The files
-    std::unordered_map<size_t, std::unique_ptr<FileBuffer>> files = {};
-    /// The file paths
-    std::unordered_map<std::string_view, FileBuffer *> file_paths = {};
-    /// The next file id
-    size_t next_file_id = 0;
+    std::unordered_map<std::string, std::shared_ptr<FileBuffer>> files_ = {};
+    /// The bytes of all segments
+    std::atomic<uint64_t> allocated_bytes_ = 0;
+
+    /// Resolve the buffer of an open file
+    static FileBuffer &GetBuffer(duckdb::FileHandle &handle);
+    /// Resize a file, requires the exclusive file latch
+    void ResizeBuffer(FileBuffer &buffer, uint64_t new_size);
+    /// Read from a file, requires the shared file latch
+    uint64_t ReadBuffer(FileBuffer &buffer, char *out, uint64_t n, uint64_t offset);
+    /// Write to a file, requires the exclusive file latch
+    void WriteBuffer(FileBuffer &buffer, const char *in, uint64_t n, uint64_t offset);
+    /// Release the segments of a file, requires the exclusive file latch
+    void ReleaseBuffer(FileBuffer &buffer);
 
+   public:
     /// Constructor
     MemoryFileSystem() {}
     /// Destructor
-    virtual ~MemoryFileSystem() {}
+    ~MemoryFileSystem() override {}
 
     /// Register a file buffer
     arrow::Status RegisterFileBuffer(std::string file_name, std::vector<char> file_buffer);
+    /// Get the bytes of all file segments
+    uint64_t GetAllocatedBytes() const { return allocated_bytes_.load(); }
+    /// Scan a byte range of an open file without copying it.
+    /// The callback receives the bytes segment by segment, the spans are only valid during the callback.
+    /// Returns the number of scanned bytes.
+    uint64_t ScanSpans(duckdb::FileHandle &handle, uint64_t offset, uint64_t n,
+                       const std::function<void(nonstd::span<const char>)> &callback);
 
     /// Open a file
     std::unique_ptr<duckdb::FileHandle> OpenFile(const string &path, uint8_t flags, FileLockType lock,
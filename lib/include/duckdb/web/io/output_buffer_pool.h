@@ -0,0 +1,117 @@
+#ifndef INCLUDE_DUCKDB_WEB_IO_OUTPUT_BUFFER_POOL_H_
+#define INCLUDE_DUCKDB_WEB_IO_OUTPUT_BUFFER_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "arrow/buffer.h"
+#include "arrow/io/interfaces.h"
+#include "arrow/memory_pool.h"
+#include "arrow/result.h"
+#include "arrow/status.h"
+
+namespace duckdb {
+namespace web {
+namespace io {
+
+/// A pool of output buffers.
+///
+/// Acquired buffers return to the pool when their last reference is released,
+/// e.g. when a result buffer was copied out by JS and the response buffer is cleared.
+/// The pool only retains buffers up to a byte limit, buffers that are released after the pool was destroyed are
+/// freed.
+class OutputBufferPool {
+   public:
+    /// The smallest buffer capacity
+    static constexpr size_t MIN_BUFFER_CAPACITY = 64 << 10;
+    /// The default limit of the retained bytes
+    static constexpr size_t DEFAULT_RETAINED_BYTES = 32 << 20;
+
+   protected:
+    /// The shared pool state
+    struct State {
+        /// The mutex
+        std::mutex mutex = {};
+        /// The memory pool of the buffers
+        arrow::MemoryPool* memory_pool = nullptr;
+        /// The limit of the retained bytes
+        size_t retained_limit = 0;
+        /// The bytes of the free buffers
+        size_t retained_bytes = 0;
+        /// The free buffers by capacity
+        std::multimap<int64_t, std::unique_ptr<arrow::ResizableBuffer>> free_buffers = {};
+        /// The number of acquisitions that reused a buffer
+        size_t reuse_count = 0;
+
+        /// Return a released buffer to the pool
+        void Recycle(std::unique_ptr<arrow::ResizableBuffer> buffer);
+    };
+
+    /// The state, shared with the deleters of the acquired buffers
+    std::shared_ptr<State> state_;
+
+   public:
+    /// Constructor
+    OutputBufferPool(arrow::MemoryPool* memory_pool = arrow::default_memory_pool(),
+                     size_t retained_limit = DEFAULT_RETAINED_BYTES);
+    /// Delete copy constructor
+    OutputBufferPool(const OutputBufferPool&) = delete;
+
+    /// Acquire an empty buffer with at least the given capacity
+    arrow::Result<std::shared_ptr<arrow::ResizableBuffer>> Acquire(int64_t capacity);
+    /// Get the bytes of the free buffers
+    size_t GetRetainedBytes();
+    /// Get the number of acquisitions that reused a buffer
+    size_t GetReuseCount();
+    /// Free all retained buffers, returns the released bytes
+    size_t Clear();
+};
+
+/// An output stream that writes into pooled buffers.
+///
+/// The stream never reallocates written bytes.
+/// When the current buffer is full, writing continues in a new buffer that is as large as everything written so far.
+/// Finish returns the single buffer as is and only concatenates if the stream grew beyond its first buffer.
+/// Callers that can estimate the output size reserve it upfront to stay within a single buffer.
+class PooledOutputStream : public arrow::io::OutputStream {
+   protected:
+    /// The buffer pool
+    OutputBufferPool& pool_;
+    /// The buffers, the size of a buffer is the number of written bytes
+    std::vector<std::shared_ptr<arrow::ResizableBuffer>> buffers_ = {};
+    /// The position
+    int64_t position_ = 0;
+    /// Is the stream closed?
+    bool closed_ = false;
+
+    /// Append a buffer with at least the given capacity
+    arrow::Status AppendBuffer(int64_t capacity);
+
+   public:
+    /// Constructor
+    PooledOutputStream(OutputBufferPool& pool);
+
+    /// Make sure that the next `nbytes` can be written without switching buffers
+    arrow::Status Reserve(int64_t nbytes);
+    /// Write bytes
+    arrow::Status Write(const void* data, int64_t nbytes) override;
+    using arrow::io::OutputStream::Write;
+    /// Close the stream
+    arrow::Status Close() override;
+    /// Is the stream closed?
+    bool closed() const override { return closed_; }
+    /// Return the position in this stream
+    arrow::Result<int64_t> Tell() const override { return position_; }
+    /// Close the stream and return the written bytes as a single buffer
+    arrow::Result<std::shared_ptr<arrow::Buffer>> Finish();
+};
+
+}  // namespace io
+}  // namespace web
+}  // namespace duckdb
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef INCLUDE_DUCKDB_WEB_IO_PATH_TRIE_H_
+#define INCLUDE_DUCKDB_WEB_IO_PATH_TRIE_H_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace duckdb {
+namespace web {
+namespace io {
+
+/// A trie over the '/'-separated components of file paths.
+/// Paths that share a literal prefix can be enumerated without looking at any other path.
+class PathTrie {
+   protected:
+    /// A trie node
+    struct Node {
+        /// The children, ordered by their component
+        std::map<std::string, std::unique_ptr<Node>, std::less<>> children = {};
+        /// Does a path end at this node?
+        bool terminal = false;
+    };
+
+    /// The root node
+    Node root_ = {};
+    /// The number of paths
+    size_t size_ = 0;
+
+    /// Visit all paths in a subtree
+    static void VisitSubtree(const Node& node, std::string& path, const std::function<void(std::string_view)>& fn);
+
+   public:
+    /// Get the number of paths
+    auto size() const { return size_; }
+    /// Insert a path, returns whether the path was new
+    bool Insert(std::string_view path);
+    /// Erase a path, returns whether the path existed
+    bool Erase(std::string_view path);
+    /// Erase all paths
+    void Clear();
+    /// Visit all paths that start with a prefix in lexicographic component order
+    void VisitPrefix(std::string_view prefix, const std::function<void(std::string_view)>& fn) const;
+};
+
+}  // namespace io
+}  // namespace web
+}  // namespace duckdb
+
+#endif
@@ -6,12 +6,14 @@
 #include <limits>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <unordered_set>
 
 #include "arrow/status.h"
 #include "duckdb/common/constants.hpp"
 #include "duckdb/common/file_system.hpp"
 #include "duckdb/web/io/file_stats.h"
+#include "duckdb/web/utils/parallel.h"
 
 namespace duckdb {
 namespace web {
@@ -22,6 +24,14 @@ constexpr size_t READAHEAD_BASE = 1 << 14;     // 16 KB
 constexpr size_t READAHEAD_MAXIMUM = 1 << 24;  // 16 MB
 constexpr size_t READ_HEAD_COUNT = 10;         // (READ_HEAD_COUNT * READAHEAD_MAXIMUM) bytes
 
+/// The sizes of read heads
+struct ReadAheadPolicy {
+    /// The size of the first readahead
+    size_t base = READAHEAD_BASE;
+    /// The maximum readahead
+    size_t maximum = READAHEAD_MAXIMUM;
+};
+
 /// A readahead buffer that is meant to be maintained per thread
 class ReadAheadBuffer {
    protected:
@@ -50,6 +60,11 @@ class ReadAheadBuffer {
     std::atomic<uint64_t> invalidation_mask_ = 0;
     /// The read heads
     std::list<ReadHead> read_heads_ = {};
+    /// The latch that is held while reading.
+    /// The owning thread is the only reader, other threads only try to lock it to release the buffers.
+    LightMutex read_latch_ = {};
+    /// The bytes that are allocated by the read heads
+    std::atomic<size_t> memory_usage_ = 0;
 
    public:
     /// Constructor
@@ -69,6 +84,22 @@ class ReadAheadBuffer {
             }
         }
     }
+    /// Get the bytes that are allocated by the read heads
+    size_t GetMemoryUsage() const { return memory_usage_.load(); }
+    /// Release the buffers of read heads that exceed a capacity, returns the released bytes.
+    /// Called from other threads, skips the buffer if its thread is reading right now.
+    size_t Release(size_t max_capacity = 0) {
+        std::unique_lock<LightMutex> read_guard{read_latch_, std::try_to_lock};
+        if (!read_guard.owns_lock()) return 0;
+        size_t released = 0;
+        for (auto& head : read_heads_) {
+            if (head.buffer_capacity <= max_capacity) continue;
+            released += head.buffer_capacity;
+            head = ReadHead{};
+        }
+        memory_usage_ -= released;
+        return released;
+    }
     /// Erase a file
     void Drop(uint64_t file_id) {
         for (auto iter = read_heads_.begin(); iter != read_heads_.end(); ++iter) {
@@ -80,16 +111,19 @@ class ReadAheadBuffer {
     /// Read up to nr_bytes bytes into the buffer
     template <typename Fn>
     int64_t Read(uint32_t file_id, uint64_t file_size, void* buffer, int64_t nr_bytes, duckdb::idx_t offset, Fn read_fn,
-                 FileStatisticsCollector* stats = nullptr) {
+                 FileStatisticsCollector* stats = nullptr, const ReadAheadPolicy& policy = {}) {
+        std::unique_lock<LightMutex> read_guard{read_latch_};
         // First apply all invalidations
         ApplyInvalidations();
         // Helper to allocate buffer in the read head
-        auto allocate = [](ReadHead& head, size_t size) {
+        auto allocate = [this](ReadHead& head, size_t size) {
             if (size <= head.buffer_capacity) {
                 head.buffer_size = size;
                 return;
             }
             head.buffer = nullptr;
+            memory_usage_ -= head.buffer_capacity;
+            memory_usage_ += size;
             head.buffer = std::unique_ptr<char[]>(new char[size]);
             head.buffer_size = size;
             head.buffer_capacity = size;
@@ -126,8 +160,8 @@ class ReadAheadBuffer {
             // Accelerate readahead if read occurs exactly at end
             if (offset == end) {
                 // Update read head
-                iter->speed = std::max<size_t>(
-                    std::min<size_t>(iter->speed * READAHEAD_ACCELERATION, READAHEAD_MAXIMUM), READAHEAD_BASE);
+                iter->speed = std::max<size_t>(std::min<size_t>(iter->speed * READAHEAD_ACCELERATION, policy.maximum),
+                                               policy.base);
                 allocate(*iter, iter->speed);
 
                 // Perform read
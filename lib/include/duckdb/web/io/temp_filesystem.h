@@ -0,0 +1,242 @@
+#ifndef INCLUDE_DUCKDB_WEB_IO_TEMP_FILESYSTEM_H_
+#define INCLUDE_DUCKDB_WEB_IO_TEMP_FILESYSTEM_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "duckdb/common/constants.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/web/memory_governor.h"
+
+namespace duckdb {
+namespace web {
+namespace io {
+
+/// The directory that DuckDB spills temporary blocks to.
+/// Paths in this directory are served by the temp filesystem and never reach the page buffer or the runtime.
+constexpr std::string_view TEMP_DIRECTORY = "tmp://duckdb";
+
+/// Does a path belong to the temp directory?
+inline bool IsTempPath(std::string_view path) {
+    return path.substr(0, TEMP_DIRECTORY.size()) == TEMP_DIRECTORY &&
+           (path.size() == TEMP_DIRECTORY.size() || path[TEMP_DIRECTORY.size()] == '/');
+}
+
+/// An in-memory filesystem for the temporary files of out-of-core operators.
+///
+/// Files are split into segments that are compressed with zstd once they are no longer accessed.
+/// Each file keeps a single uncompressed segment to serve sequential reads and writes.
+/// The compressed segments are kept in memory within a byte budget.
+/// Segments beyond the budget are moved to an overflow file of the inner filesystem (if configured),
+/// otherwise writes fail once the budget is exhausted.
+/// Released space in the overflow file is tracked as free extents that are reused by later spills, the file is
+/// truncated once all of its segments are gone.
+class TempFileSystem : public duckdb::FileSystem, public MemoryConsumer {
+   public:
+    /// The uncompressed size of a segment
+    static constexpr size_t SEGMENT_SIZE = 256 << 10;
+    /// The zstd compression level
+    static constexpr int COMPRESSION_LEVEL = 1;
+
+   protected:
+    /// A segment of a file
+    struct Segment {
+        /// The bytes (if resident)
+        std::unique_ptr<char[]> data = nullptr;
+        /// The stored size
+        size_t stored_size = 0;
+        /// Are the bytes compressed?
+        bool compressed = false;
+        /// The offset in the overflow file (if spilled)
+        std::optional<uint64_t> overflow_offset = std::nullopt;
+    };
+
+    /// A temporary file
+    struct TempFile {
+        /// The mutex
+        std::mutex file_mutex = {};
+        /// The path
+        std::string path = "";
+        /// The file size
+        uint64_t file_size = 0;
+        /// The segments
+        std::vector<Segment> segments = {};
+        /// The uncompressed segment (if any)
+        std::unique_ptr<char[]> cached_segment = nullptr;
+        /// The id of the uncompressed segment
+        size_t cached_segment_id = 0;
+        /// Was the uncompressed segment modified?
+        bool cached_segment_dirty = false;
+        /// The number of open handles
+        size_t handle_count = 0;
+        /// Was the file removed while it was still opened?
+        bool removed = false;
+    };
+
+    /// A file handle
+    class TempFileHandle : public duckdb::FileHandle {
+        friend class TempFileSystem;
+
+       protected:
+        /// The file
+        std::shared_ptr<TempFile> file_;
+        /// The position
+        uint64_t position_ = 0;
+
+        /// Close the file
+        void Close() override;
+
+       public:
+        /// Constructor
+        TempFileHandle(TempFileSystem &file_system, std::shared_ptr<TempFile> file);
+        /// Delete copy constructor
+        TempFileHandle(const TempFileHandle &) = delete;
+        /// Destructor
+        ~TempFileHandle() override;
+    };
+
+    /// The filesystem that holds the overflow file (if any)
+    duckdb::FileSystem *overflow_filesystem_ = nullptr;
+    /// The path of the overflow file
+    std::string overflow_path_ = "";
+    /// The memory budget of the resident segments, 0 if unlimited
+    size_t budget_ = 0;
+    /// The bytes of the resident segments and the uncompressed segments
+    std::atomic<size_t> memory_usage_ = 0;
+
+    /// The directory mutex
+    std::mutex directory_mutex_ = {};
+    /// The files
+    std::unordered_map<std::string, std::shared_ptr<TempFile>> files_ = {};
+
+    /// The overflow mutex
+    std::mutex overflow_mutex_ = {};
+    /// The overflow file (if opened)
+    std::unique_ptr<duckdb::FileHandle> overflow_file_ = nullptr;
+    /// The end of the used space in the overflow file
+    uint64_t overflow_end_ = 0;
+    /// The number of segments in the overflow file
+    size_t overflow_segments_ = 0;
+    /// The free extents in the overflow file, sizes by offset
+    std::map<uint64_t, uint64_t> overflow_free_ = {};
+
+    /// Allocate an extent in the overflow file, requires the overflow mutex
+    uint64_t AllocateOverflow(uint64_t size);
+    /// Free an extent in the overflow file, requires the overflow mutex
+    void FreeOverflow(uint64_t offset, uint64_t size);
+
+    /// Load a segment into the uncompressed segment of a file.
+    /// Segments that are overwritten entirely are not decompressed.
+    char *LoadSegment(TempFile &file, size_t segment_id, bool overwrite, std::unique_lock<std::mutex> &file_guard);
+    /// Compress the uncompressed segment of a file and release it
+    void StoreCachedSegment(TempFile &file, std::unique_lock<std::mutex> &file_guard);
+    /// Move a resident segment to the overflow file, returns the released bytes
+    size_t SpillSegment(Segment &segment);
+    /// Release a segment
+    void ReleaseSegment(Segment &segment);
+    /// Release all segments of a file
+    void ReleaseFile(TempFile &file, std::unique_lock<std::mutex> &file_guard);
+    /// Resize a file
+    void ResizeFile(TempFile &file, uint64_t new_size, std::unique_lock<std::mutex> &file_guard);
+    /// Read from a file
+    uint64_t ReadFile(TempFile &file, char *buffer, uint64_t n, uint64_t offset);
+    /// Write to a file
+    void WriteFile(TempFile &file, const char *buffer, uint64_t n, uint64_t offset);
+    /// Close a handle of a file
+    void CloseFile(TempFile &file);
+    /// Resolve an open file
+    static TempFile &GetFile(duckdb::FileHandle &handle);
+
+   public:
+    /// Constructor
+    TempFileSystem(size_t budget = 0, duckdb::FileSystem *overflow_filesystem = nullptr,
+                   std::string overflow_path = "");
+    /// Destructor
+    ~TempFileSystem() override;
+
+    /// Get the bytes of the resident segments and the uncompressed segments
+    size_t GetMemoryUsage() override { return memory_usage_.load(); }
+    /// Move resident segments to the overflow file, returns the released bytes
+    size_t ReclaimMemory(size_t bytes) override;
+    /// Get the size of the used space in the overflow file
+    uint64_t GetOverflowSize();
+    /// Get the bytes of the free extents in the overflow file
+    uint64_t GetOverflowFreeBytes();
+
+   public:
+    /// Open a file
+    std::unique_ptr<duckdb::FileHandle> OpenFile(const string &path, uint8_t flags, FileLockType lock,
+                                                 FileCompressionType compression,
+                                                 FileOpener *opener = nullptr) override;
+    /// Read exactly nr_bytes from the specified location in the file. Fails if nr_bytes could not be read. This is
+    /// equivalent to calling SetFilePointer(location) followed by calling Read().
+    void Read(duckdb::FileHandle &handle, void *buffer, int64_t nr_bytes, duckdb::idx_t location) override;
+    /// Write exactly nr_bytes to the specified location in the file. Fails if nr_bytes could not be read. This is
+    /// equivalent to calling SetFilePointer(location) followed by calling Write().
+    void Write(duckdb::FileHandle &handle, void *buffer, int64_t nr_bytes, duckdb::idx_t location) override;
+    /// Read nr_bytes from the specified file into the buffer, moving the file pointer forward by nr_bytes. Returns the
+    /// amount of bytes read.
+    int64_t Read(duckdb::FileHandle &handle, void *buffer, int64_t nr_bytes) override;
+    /// Write nr_bytes from the buffer into the file, moving the file pointer forward by nr_bytes.
+    int64_t Write(duckdb::FileHandle &handle, void *buffer, int64_t nr_bytes) override;
+
+    /// Returns the file size of a file handle, returns -1 on error
+    int64_t GetFileSize(duckdb::FileHandle &handle) override;
+    /// Returns the file last modified time of a file handle, returns timespec with zero on all attributes on error
+    time_t GetLastModifiedTime(duckdb::FileHandle &handle) override;
+    /// Truncate a file to a maximum size of new_size, new_size should be smaller than or equal to the current size of
+    /// the file
+    void Truncate(duckdb::FileHandle &handle, int64_t new_size) override;
+
+    /// Check if a directory exists
+    bool DirectoryExists(const std::string &directory) override;
+    /// Create a directory if it does not exist
+    void CreateDirectory(const std::string &directory) override;
+    /// Recursively remove a directory and all files in it
+    void RemoveDirectory(const std::string &directory) override;
+    /// List files in a directory, invoking the callback method for each one with (filename, is_dir)
+    bool ListFiles(const std::string &directory, const std::function<void(std::string, bool)> &callback) override;
+    /// Move a file from source path to the target, StorageManager relies on this being an atomic action for ACID
+    /// properties
+    void MoveFile(const std::string &source, const std::string &target) override;
+    /// Check if a file exists
+    bool FileExists(const std::string &filename) override;
+    /// Remove a file from disk
+    void RemoveFile(const std::string &filename) override;
+    /// Sync a file handle to disk
+    void FileSync(duckdb::FileHandle &handle) override;
+
+    /// Runs a glob on the file system, returning a list of matching files
+    std::vector<std::string> Glob(const std::string &path) override;
+
+    /// Set the file pointer of a file handle to a specified location. Reads and writes will happen from this location
+    void Seek(duckdb::FileHandle &handle, idx_t location) override;
+    /// Reset a file to the beginning (equivalent to Seek(handle, 0) for simple files)
+    void Reset(duckdb::FileHandle &handle) override;
+    /// Get the current position within the file
+    idx_t SeekPosition(duckdb::FileHandle &handle) override;
+    /// Whether or not we can seek into the file
+    bool CanSeek() override;
+    /// Whether or not the FS handles plain files on disk. This is relevant for certain optimizations, as random reads
+    /// in a file on-disk are much cheaper than e.g. random reads in a file over the network
+    bool OnDiskFile(duckdb::FileHandle &handle) override;
+
+   protected:
+    /// Return the name of the filesytem. Used for forming diagnosis messages.
+    std::string GetName() const override;
+};
+
+}  // namespace io
+}  // namespace web
+}  // namespace duckdb
+
+#endif
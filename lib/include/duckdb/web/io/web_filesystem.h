@@ -2,10 +2,13 @@
 #define INCLUDE_DUCKDB_WEB_IO_WEB_FILESYSTEM_H_
 
 #include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <mutex>
 #include <optional>
 #include <shared_mutex>
 #include <stack>
+#include <vector>
 
 #include "arrow/io/buffered.h"
 #include "arrow/result.h"
@@ -13,8 +16,11 @@
 #include "duckdb/common/constants.hpp"
 #include "duckdb/common/file_system.hpp"
 #include "duckdb/web/config.h"
+#include "duckdb/web/io/bandwidth_estimator.h"
 #include "duckdb/web/io/file_stats.h"
+#include "duckdb/web/io/path_trie.h"
 #include "duckdb/web/io/readahead_buffer.h"
+#include "duckdb/web/memory_governor.h"
 #include "duckdb/web/utils/parallel.h"
 #include "duckdb/web/utils/wasm_response.h"
 #include "nonstd/span.h"
@@ -23,7 +29,7 @@ namespace duckdb {
 namespace web {
 namespace io {
 
-class WebFileSystem : public duckdb::FileSystem {
+class WebFileSystem : public duckdb::FileSystem, public MemoryConsumer {
    public:
     /// The data protocol
     enum DataProtocol : uint8_t {
@@ -32,6 +38,20 @@ class WebFileSystem : public duckdb::FileSystem {
         HTTP = 3,
     };
 
+    /// The path prefix of scratch files.
+    /// Scratch files are unregistered BUFFER files that are created on demand and live until they are removed.
+    static constexpr std::string_view SCRATCH_PREFIX = "memory://";
+
+    /// A file URL of a batched registration
+    struct FileURL {
+        /// The file name
+        std::string_view file_name;
+        /// The file URL
+        std::string_view file_url;
+        /// The file size (if known)
+        std::optional<uint64_t> file_size;
+    };
+
     /// A simple buffer.
     /// It might be worth to make this chunked eventually.
     class DataBuffer {
@@ -74,6 +94,9 @@ class WebFileSystem : public duckdb::FileSystem {
         SharedMutex file_mutex_ = {};
         /// The file size
         uint64_t file_size_ = 0;
+        /// Is the file pinned without a handle?
+        /// Pinned files stay registered when their last handle is closed.
+        bool pinned_ = false;
 
         /// XXX Make chunked to upgrade from url to cached version
         std::optional<DataBuffer> data_buffer_ = std::nullopt;
@@ -81,9 +104,33 @@ class WebFileSystem : public duckdb::FileSystem {
         std::optional<uint32_t> data_fd_ = std::nullopt;
         /// The data URL (if any)
         std::optional<std::string> data_url_ = std::nullopt;
+        /// The tail of the file that was fetched speculatively when opening it (if any).
+        /// Only kept for files that were never opened for writing, writes would invalidate it under a shared latch.
+        std::optional<DataBuffer> speculative_tail_ = std::nullopt;
+        /// The bytes of the speculative tail, readable without the file latch for memory accounting
+        std::atomic<size_t> speculative_tail_bytes_ = 0;
+        /// Was the file ever opened for writing?
+        bool opened_for_writing_ = false;
+        /// Was the file opened through the runtime and is the file size known?
+        bool opened_ = false;
 
         /// The file stats
         std::shared_ptr<io::FileStatisticsCollector> file_stats_ = nullptr;
+        /// The estimator of the data origin (if resolved)
+        std::atomic<io::OriginEstimator *> origin_estimator_ = nullptr;
+
+        /// The sync mutex.
+        /// Concurrent syncs are grouped: the first caller becomes the leader and issues a single runtime sync that
+        /// covers all writes that finished before it was issued. Later callers either piggyback or wait for the next.
+        std::mutex sync_mutex_ = {};
+        /// The sync condition variable
+        std::condition_variable sync_cv_ = {};
+        /// The write epoch, incremented after every completed write or truncation
+        std::atomic<uint64_t> write_epoch_ = 0;
+        /// The write epoch that is known to be durable
+        uint64_t synced_epoch_ = 0;
+        /// Is there a runtime sync in flight?
+        bool sync_in_flight_ = false;
 
        public:
         /// Constructor
@@ -106,6 +153,18 @@ class WebFileSystem : public duckdb::FileSystem {
         auto &GetDataProtocol() const { return data_protocol_; }
         /// Get the data URL
         auto &GetDataURL() const { return data_url_; }
+        /// Get the origin of the file data
+        std::string GetDataOrigin() const;
+        /// Resolve the estimator of the data origin
+        io::OriginEstimator &ResolveOriginEstimator();
+        /// Read from the runtime and record the read with the origin estimator
+        int64_t ReadFromRuntime(void *buffer, size_t n, uint64_t offset);
+        /// Read from the speculative tail, returns 0 if the offset is not covered
+        size_t ReadFromSpeculativeTail(void *buffer, size_t n, uint64_t offset);
+        /// Keep a speculative tail, requires the exclusive file latch
+        void SetSpeculativeTail(DataBuffer tail);
+        /// Drop the speculative tail, requires the exclusive file latch, returns the released bytes
+        size_t DropSpeculativeTail();
     };
 
     class WebFileHandle : public duckdb::FileHandle {
@@ -150,10 +209,16 @@ class WebFileSystem : public duckdb::FileSystem {
     std::unordered_map<uint32_t, std::shared_ptr<WebFile>> files_by_id_ = {};
     /// The files by path
     std::unordered_map<std::string, std::shared_ptr<WebFile>> files_by_name_ = {};
+    /// The file paths, indexed by their components for globbing
+    PathTrie file_paths_ = {};
     /// The next file id
     uint32_t next_file_id_ = 0;
     /// The thread-local readahead buffers
     std::unordered_map<uint32_t, std::unique_ptr<ReadAheadBuffer>> readahead_buffers_ = {};
+    /// The maximum size of a read head, lowered by the memory limit
+    std::atomic<size_t> readahead_maximum_ = READAHEAD_MAXIMUM;
+    /// The bandwidth estimates of the data origins
+    io::BandwidthEstimator bandwidth_estimator_ = {};
     /// The file statistics
     std::shared_ptr<io::FileStatisticsRegistry> file_statistics_;
 
@@ -176,6 +241,8 @@ class WebFileSystem : public duckdb::FileSystem {
     inline WebFile *GetFile(uint32_t file_id) const {
         return files_by_id_.count(file_id) ? files_by_id_.at(file_id).get() : nullptr;
     }
+    /// Resolve the data protocol of a file, either registered or inferred from its name
+    DataProtocol ResolveDataProtocol(std::string_view file_name);
     /// Set a file descriptor
     arrow::Status SetFileDescriptor(uint32_t file_id, uint32_t file_descriptor);
     /// Write the file info as JSON
@@ -185,11 +252,26 @@ class WebFileSystem : public duckdb::FileSystem {
     /// Register a file URL
     arrow::Result<std::unique_ptr<WebFileHandle>> RegisterFileURL(std::string_view file_name, std::string_view file_url,
                                                                   std::optional<uint64_t> file_size);
+    /// Check that a batch of file URLs can be registered once the caller unpinned its files.
+    /// `pinned` tells whether the caller holds a handle of a file.
+    arrow::Status CheckFileURLs(nonstd::span<const FileURL> files,
+                                const std::function<bool(std::string_view)> &pinned);
+    /// Register multiple file URLs under a single lock.
+    /// Returns one handle per file or no handles at all if the files are pinned without handles.
+    arrow::Result<std::vector<std::unique_ptr<WebFileHandle>>> RegisterFileURLs(nonstd::span<const FileURL> files,
+                                                                                bool defer_handles = false);
     /// Register a file buffer
     arrow::Result<std::unique_ptr<WebFileHandle>> RegisterFileBuffer(std::string_view file_name,
                                                                      DataBuffer file_buffer);
     /// Try to drop a specific file
     bool TryDropFile(std::string_view file_name);
+    /// Unpin a file that was pinned without a handle
+    void UnpinFile(std::string_view file_name);
+    /// Decode a batch of file URLs.
+    /// The batch starts with the uint32 number of files, followed by one record per file:
+    /// uint32 name length, uint32 url length, uint64 file size (UINT64_MAX if unknown), name bytes, url bytes.
+    /// All integers are little-endian. The returned views point into the batch.
+    static arrow::Result<std::vector<FileURL>> DecodeFileURLs(nonstd::span<const char> batch);
     /// Drop all files without references (including buffers)
     void DropDanglingFiles();
     /// Configure file statistics
@@ -197,6 +279,14 @@ class WebFileSystem : public duckdb::FileSystem {
     /// Collect file statistics
     void CollectFileStatistics(std::string_view path, std::shared_ptr<FileStatisticsCollector> collector);
 
+    /// Get the bytes of all readahead buffers and speculative tails
+    size_t GetMemoryUsage() override;
+    /// Split a memory limit among the read heads of all threads.
+    /// A limit of 0 restores the default readahead maximum.
+    void SetMemoryLimit(size_t bytes) override;
+    /// Release readahead buffers and speculative tails, returns the released bytes
+    size_t ReclaimMemory(size_t bytes) override;
+
    public:
     /// Open a file
     std::unique_ptr<duckdb::FileHandle> OpenFile(const string &url, uint8_t flags, FileLockType lock,
@@ -262,6 +352,14 @@ class WebFileSystem : public duckdb::FileSystem {
    public:
     /// Get a web filesystem
     static WebFileSystem *Get();
+    /// Get the config
+    auto &GetConfig() const { return *config_; }
+#ifndef EMSCRIPTEN
+    /// Get the number of syncs that reached the native test runtime
+    static size_t GetNativeRuntimeSyncCount();
+    /// Get the number of reads that reached the native test runtime
+    static size_t GetNativeRuntimeReadCount();
+#endif
 
    protected:
     /// Return the name of the filesytem. Used for forming diagnosis messages.
@@ -4,6 +4,7 @@
 #include <memory>
 
 #include "arrow/array/builder_nested.h"
+#include "arrow/memory_pool.h"
 #include "arrow/type.h"
 #include "arrow/type_traits.h"
 #include "rapidjson/document.h"
@@ -22,6 +23,8 @@ class ArrayParser {
    protected:
     /// The data type
     std::shared_ptr<arrow::DataType> type_;
+    /// The memory pool of the builders
+    arrow::MemoryPool* pool_ = arrow::default_memory_pool();
 
    public:
     virtual ~ArrayParser() = default;
@@ -47,13 +50,15 @@ class ArrayParser {
         return builder->Finish();
     }
 
-    /// Resolve an array parser
-    static arrow::Result<std::shared_ptr<ArrayParser>> Resolve(const std::shared_ptr<arrow::DataType>& type);
+    /// Resolve an array parser that allocates its arrays from the given pool
+    static arrow::Result<std::shared_ptr<ArrayParser>> Resolve(
+        const std::shared_ptr<arrow::DataType>& type, arrow::MemoryPool* pool = arrow::default_memory_pool());
 };
 
 /// Parse an array from json
 arrow::Result<std::shared_ptr<arrow::Array>> ArrayFromJSON(const std::shared_ptr<arrow::DataType>& type,
-                                                           std::string_view json);
+                                                           std::string_view json,
+                                                           arrow::MemoryPool* pool = arrow::default_memory_pool());
 
 }  // namespace json
 }  // namespace web
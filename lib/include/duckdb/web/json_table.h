@@ -42,6 +42,8 @@ class TableReader : public arrow::RecordBatchReader {
    protected:
     /// The batch size
     const size_t batch_size_ = 1024;
+    /// The memory pool of the batches
+    arrow::MemoryPool* pool_ = arrow::default_memory_pool();
     /// The input file stream
     std::unique_ptr<io::InputFileStream> table_file_ = {};
     /// The table type
@@ -50,7 +52,8 @@ class TableReader : public arrow::RecordBatchReader {
     std::shared_ptr<arrow::Schema> schema_ = nullptr;
 
     /// Table reader
-    TableReader(std::unique_ptr<io::InputFileStream> table, TableType type, size_t batch_size);
+    TableReader(std::unique_ptr<io::InputFileStream> table, TableType type, size_t batch_size,
+                arrow::MemoryPool* pool);
 
    public:
     /// Virtual destructor
@@ -62,9 +65,10 @@ class TableReader : public arrow::RecordBatchReader {
     /// Rewind the table reader
     virtual arrow::Status Rewind() = 0;
 
-    /// Create a table reader
-    static arrow::Result<std::shared_ptr<TableReader>> Resolve(std::unique_ptr<io::InputFileStream> table,
-                                                               TableType type, size_t batch_size = 1024);
+    /// Create a table reader that allocates its batches from the given pool
+    static arrow::Result<std::shared_ptr<TableReader>> Resolve(
+        std::unique_ptr<io::InputFileStream> table, TableType type, size_t batch_size = 1024,
+        arrow::MemoryPool* pool = arrow::default_memory_pool());
     /// Arrow array stream factory function
     static std::unique_ptr<duckdb::ArrowArrayStreamWrapper> CreateArrayStreamFromSharedPtrPtr(
         uintptr_t this_ptr, std::pair<std::unordered_map<idx_t, string>, std::vector<string>>& project_columns,
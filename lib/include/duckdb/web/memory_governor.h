@@ -0,0 +1,98 @@
+#ifndef INCLUDE_DUCKDB_WEB_MEMORY_GOVERNOR_H_
+#define INCLUDE_DUCKDB_WEB_MEMORY_GOVERNOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "rapidjson/document.h"
+
+namespace duckdb {
+namespace web {
+
+/// A subsystem that holds memory within the budget of the memory governor
+class MemoryConsumer {
+   public:
+    /// Destructor
+    virtual ~MemoryConsumer() = default;
+    /// Get the bytes that are currently held
+    virtual size_t GetMemoryUsage() = 0;
+    /// Limit the bytes that are held from now on, a limit of 0 removes the limit
+    virtual void SetMemoryLimit(size_t bytes) {}
+    /// Release memory, returns the released bytes
+    virtual size_t ReclaimMemory(size_t bytes) { return 0; }
+};
+
+/// Divides a single memory budget among the subsystems of a database.
+///
+/// Consumers register with a share of the budget that becomes their memory limit.
+/// Consumers without a share only report their usage.
+/// Whatever is neither reserved by the limited consumers nor held by the others is left for the DuckDB buffer manager.
+/// When the reported usage exceeds the budget, memory is reclaimed from the consumers in registration order.
+class MemoryGovernor {
+   public:
+    /// The memory that is left for the database at least
+    static constexpr size_t MINIMUM_DATABASE_MEMORY = 16 << 20;
+
+   protected:
+    /// A registered consumer
+    struct Registration {
+        /// The name
+        std::string name;
+        /// The consumer
+        MemoryConsumer* consumer;
+        /// The share of the budget, 0 if the consumer only reports its usage
+        double share;
+        /// The memory limit, 0 if unlimited
+        size_t limit;
+    };
+
+    /// The mutex
+    std::mutex mutex_ = {};
+    /// The budget in bytes, 0 if unlimited
+    size_t budget_ = 0;
+    /// The registered consumers
+    std::vector<Registration> consumers_ = {};
+
+    /// Get the limit of a share
+    size_t GetLimit(double share) const;
+    /// Get the bytes that are held by all consumers
+    size_t GetUsage(std::unique_lock<std::mutex>& guard);
+    /// Reclaim memory from the consumers in registration order
+    size_t Reclaim(size_t bytes, std::unique_lock<std::mutex>& guard);
+
+   public:
+    /// Constructor
+    MemoryGovernor(size_t budget = 0);
+    /// Delete copy constructor
+    MemoryGovernor(const MemoryGovernor&) = delete;
+
+    /// Get the budget
+    size_t GetBudget();
+    /// Set the budget and update the limits of all consumers
+    void SetBudget(size_t budget);
+    /// Register a consumer
+    void Register(std::string_view name, MemoryConsumer& consumer, double share = 0.0);
+    /// Unregister a consumer
+    void Unregister(MemoryConsumer& consumer);
+
+    /// Get the bytes that are held by all consumers
+    size_t GetUsage();
+    /// Get the memory that is left for the database, 0 if unlimited
+    size_t GetDatabaseMemory();
+    /// Reclaim memory from the consumers, returns the released bytes
+    size_t Reclaim(size_t bytes);
+    /// Reclaim memory until every consumer is within its limit and the usage fits the budget
+    size_t Enforce();
+
+    /// Write the budget and the usage of all consumers as JSON
+    rapidjson::Value WriteInfo(rapidjson::Document& doc);
+};
+
+}  // namespace web
+}  // namespace duckdb
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef INCLUDE_DUCKDB_WEB_RESULT_CURSOR_H_
+#define INCLUDE_DUCKDB_WEB_RESULT_CURSOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "arrow/buffer.h"
+#include "arrow/memory_pool.h"
+#include "arrow/record_batch.h"
+#include "arrow/result.h"
+#include "arrow/status.h"
+#include "arrow/type.h"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/web/io/output_buffer_pool.h"
+
+namespace duckdb {
+namespace web {
+
+/// A query result that is materialized into a temporary file for random access to its rows.
+///
+/// Every record batch is appended to the file as a self-contained Arrow IPC stream, batches with dictionaries can
+/// therefore be read without their predecessors.
+/// An index with the first row of every batch finds the batches of a row range with a binary search.
+/// Only the batches of the fetched rows are read back, the most recently read batch is kept for neighboring fetches.
+class ResultCursor {
+   protected:
+    /// A batch in the file
+    struct BatchEntry {
+        /// The first row
+        uint64_t first_row;
+        /// The number of rows
+        uint64_t row_count;
+        /// The file offset
+        uint64_t file_offset;
+        /// The byte size
+        uint64_t byte_size;
+    };
+
+    /// The filesystem
+    duckdb::FileSystem& filesystem_;
+    /// The path of the file
+    std::string path_;
+    /// The file
+    std::unique_ptr<duckdb::FileHandle> file_ = nullptr;
+    /// The schema
+    std::shared_ptr<arrow::Schema> schema_;
+    /// The memory pool
+    arrow::MemoryPool* memory_pool_;
+    /// The batches
+    std::vector<BatchEntry> batches_ = {};
+    /// The number of rows
+    uint64_t row_count_ = 0;
+    /// The file size
+    uint64_t file_size_ = 0;
+    /// The id of the most recently read batch
+    size_t cached_batch_id_ = 0;
+    /// The most recently read batch (if any)
+    std::shared_ptr<arrow::RecordBatch> cached_batch_ = nullptr;
+
+    /// Read a batch from the file
+    arrow::Result<std::shared_ptr<arrow::RecordBatch>> ReadBatch(size_t batch_id);
+
+   public:
+    /// Constructor
+    ResultCursor(duckdb::FileSystem& filesystem, std::string path, std::shared_ptr<arrow::Schema> schema,
+                 arrow::MemoryPool* memory_pool = arrow::default_memory_pool());
+    /// Delete copy constructor
+    ResultCursor(const ResultCursor&) = delete;
+    /// Destructor, removes the file
+    ~ResultCursor();
+
+    /// Get the schema
+    auto& schema() const { return schema_; }
+    /// Get the number of rows
+    auto row_count() const { return row_count_; }
+    /// Get the number of batches
+    auto batch_count() const { return batches_.size(); }
+    /// Get the file size
+    auto file_size() const { return file_size_; }
+
+    /// Create the file of a cursor
+    arrow::Status Open();
+    /// Append a record batch
+    arrow::Status Append(const arrow::RecordBatch& batch);
+    /// Fetch up to `count` rows starting at row `offset` as Arrow IPC stream
+    arrow::Result<std::shared_ptr<arrow::Buffer>> FetchRows(uint64_t offset, uint64_t count,
+                                                            io::OutputBufferPool& buffers);
+};
+
+}  // namespace web
+}  // namespace duckdb
+
+#endif
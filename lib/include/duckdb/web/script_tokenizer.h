@@ -0,0 +1,80 @@
+#ifndef INCLUDE_DUCKDB_WEB_SCRIPT_TOKENIZER_H_
+#define INCLUDE_DUCKDB_WEB_SCRIPT_TOKENIZER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "arrow/buffer.h"
+#include "arrow/result.h"
+
+namespace duckdb {
+namespace web {
+
+/// A tokenizer that keeps the tokens of a script and updates them incrementally.
+///
+/// Editors tokenize a script once and then only send their edits.
+/// An edit is re-tokenized starting a few tokens before the edit, since the edit can extend or merge preceding
+/// tokens, up to the first token after the edit that starts a token of the previous text again.
+/// From there on, the old tokens are valid and only shifted by the size difference of the edit.
+///
+/// Both calls return an update of the token list in a buffer that is reused by the next call.
+/// The update starts with four little-endian uint32 values: the index of the first replaced token, the number of
+/// replaced tokens, the number of inserted tokens and the (signed) offset shift of all tokens after the inserted ones.
+/// It is followed by the uint32 byte offsets and the uint8 types of the inserted tokens.
+class ScriptTokenizer {
+   public:
+    /// The tokens of a script
+    struct Tokens {
+        /// The byte offsets
+        std::vector<uint32_t> offsets = {};
+        /// The token types
+        std::vector<uint8_t> types = {};
+
+        /// Get the number of tokens
+        size_t size() const { return offsets.size(); }
+        /// Clear the tokens
+        void clear() {
+            offsets.clear();
+            types.clear();
+        }
+    };
+
+    /// The number of tokens before an edit that are tokenized again
+    static constexpr size_t RESTART_TOKENS = 3;
+    /// The number of tokens after an edit that are tokenized first
+    static constexpr size_t WINDOW_TOKENS = 8;
+
+   protected:
+    /// The script text
+    std::string text_ = {};
+    /// The tokens
+    Tokens tokens_ = {};
+    /// The encoded update, reused across calls
+    std::vector<uint8_t> update_ = {};
+
+    /// Tokenize a range of the script
+    void TokenizeRange(size_t begin, size_t end, Tokens& out) const;
+    /// Encode an update
+    std::shared_ptr<arrow::Buffer> EncodeUpdate(size_t index, size_t removed, const Tokens& inserted, size_t begin,
+                                                size_t end, int64_t shift);
+
+   public:
+    /// Get the script text
+    auto& text() const { return text_; }
+    /// Get the tokens
+    auto& tokens() const { return tokens_; }
+
+    /// Tokenize a script
+    std::shared_ptr<arrow::Buffer> Tokenize(std::string_view text);
+    /// Replace `removed` bytes at `offset` with the `inserted` text and tokenize the edit
+    arrow::Result<std::shared_ptr<arrow::Buffer>> Retokenize(size_t offset, size_t removed, std::string_view inserted);
+};
+
+}  // namespace web
+}  // namespace duckdb
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef INCLUDE_DUCKDB_WEB_SNAPSHOT_H_
+#define INCLUDE_DUCKDB_WEB_SNAPSHOT_H_
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+#include "arrow/buffer.h"
+#include "arrow/result.h"
+#include "arrow/status.h"
+#include "duckdb/common/file_system.hpp"
+#include "nonstd/span.h"
+#include "rapidjson/document.h"
+
+namespace duckdb {
+namespace web {
+namespace snapshot {
+
+/// The default chunk size for copying and compressing snapshots
+constexpr size_t DEFAULT_SNAPSHOT_CHUNK_SIZE = 1 << 20;
+
+/// The snapshot compression
+enum class SnapshotCompression : uint32_t {
+    NONE = 0,
+    ZSTD = 1,
+};
+
+/// The snapshot options
+struct SnapshotOptions {
+    /// The compression
+    SnapshotCompression compression = SnapshotCompression::NONE;
+    /// The compression level
+    int compression_level = 3;
+    /// The chunk size
+    size_t chunk_size = DEFAULT_SNAPSHOT_CHUNK_SIZE;
+
+    /// Read from a document
+    arrow::Status ReadFrom(const rapidjson::Document& doc);
+};
+
+/// A decoded snapshot image
+struct SnapshotImage {
+    /// The data
+    std::unique_ptr<char[]> data = nullptr;
+    /// The size
+    size_t size = 0;
+};
+
+/// Copy a whole file into a buffer.
+/// The file is split into chunks that are read with positional reads by up to `threads` threads.
+arrow::Result<std::shared_ptr<arrow::Buffer>> ReadFile(duckdb::FileSystem& fs, std::string_view path, size_t threads,
+                                                       size_t chunk_size = DEFAULT_SNAPSHOT_CHUNK_SIZE);
+/// Write a whole buffer to a file.
+arrow::Status WriteFile(duckdb::FileSystem& fs, std::string_view path, nonstd::span<const char> data,
+                        size_t chunk_size = DEFAULT_SNAPSHOT_CHUNK_SIZE);
+
+/// Is a compressed snapshot?
+bool IsCompressed(nonstd::span<const char> data);
+/// Compress a database image.
+/// Chunks are compressed as independent frames so that they can be encoded and decoded in parallel.
+arrow::Result<std::shared_ptr<arrow::Buffer>> Compress(nonstd::span<const char> data, const SnapshotOptions& options,
+                                                       size_t threads);
+/// Decompress a compressed snapshot
+arrow::Result<SnapshotImage> Decompress(nonstd::span<const char> data, size_t threads);
+
+}  // namespace snapshot
+}  // namespace web
+}  // namespace duckdb
+
+#endif
@@ -14,7 +14,7 @@ struct SpinMutex {
             ;
     }
     void unlock() { flag.clear(); }
-    bool try_lock() { return flag.test_and_set(); }
+    bool try_lock() { return !flag.test_and_set(std::memory_order_acquire); }
 };
 
 }  // namespace web
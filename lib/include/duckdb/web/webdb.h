@@ -1,9 +1,12 @@
 #ifndef INCLUDE_DUCKDB_WEB_WEBDB_H_
 #define INCLUDE_DUCKDB_WEB_WEBDB_H_
 
+#include <atomic>
 #include <cstring>
 #include <duckdb/main/prepared_statement.hpp>
 #include <initializer_list>
+#include <list>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -14,24 +17,79 @@
 #include "duckdb/main/query_result.hpp"
 #include "duckdb/parser/parser.hpp"
 #include "duckdb/web/arrow_insert_options.h"
+#include "duckdb/web/arrow_memory_pool.h"
 #include "duckdb/web/config.h"
 #include "duckdb/web/environment.h"
+#include "duckdb/web/incremental_view.h"
 #include "duckdb/web/io/buffered_filesystem.h"
 #include "duckdb/web/io/file_page_buffer.h"
 #include "duckdb/web/io/file_stats.h"
+#include "duckdb/web/io/file_warmer.h"
+#include "duckdb/web/io/output_buffer_pool.h"
+#include "duckdb/web/io/temp_filesystem.h"
 #include "duckdb/web/io/web_filesystem.h"
+#include "duckdb/web/memory_governor.h"
+#include "duckdb/web/result_cursor.h"
+#include "duckdb/web/script_tokenizer.h"
 #include "nonstd/span.h"
 
+struct ArrowArrayStream;
+
 namespace duckdb {
 namespace web {
 
+struct ArrowIPCStreamBuffer;
 struct BufferingArrowIPCStreamDecoder;
 
 class WebDB {
    public:
     /// A connection
-    class Connection {
+    class Connection : public MemoryConsumer {
+       public:
+        /// The statistics of the plan cache
+        struct PlanCacheStatistics {
+            /// The queries that reused a cached plan
+            uint64_t hits = 0;
+            /// The queries that were planned and cached
+            uint64_t misses = 0;
+            /// The plans that were evicted
+            uint64_t evictions = 0;
+            /// The plans that were dropped after catalog changes or failures
+            uint64_t invalidations = 0;
+            /// The planning time that cache hits saved
+            uint64_t planning_micros_saved = 0;
+        };
+
        protected:
+        /// The arrow schema of a result
+        struct ResultSchema {
+            /// The result types
+            std::vector<duckdb::LogicalType> types;
+            /// The result names
+            std::vector<std::string> names;
+            /// The imported schema
+            std::shared_ptr<arrow::Schema> schema;
+            /// The patched schema
+            std::shared_ptr<arrow::Schema> patched_schema;
+            /// The serialized IPC message of the patched schema
+            std::shared_ptr<arrow::Buffer> schema_message;
+            /// Can results be returned as compact IPC stream?
+            bool compact;
+        };
+        /// A cached plan of a query text
+        struct CachedPlan {
+            /// The query text
+            std::string text;
+            /// The prepared statement
+            std::unique_ptr<duckdb::PreparedStatement> statement;
+            /// The result schema
+            std::shared_ptr<ResultSchema> schema;
+            /// The catalog epoch at planning time
+            uint64_t catalog_epoch;
+            /// The time it took to plan the query
+            uint64_t planning_micros;
+        };
+
         /// The webdb
         WebDB& webdb_;
         /// The connection
@@ -45,18 +103,68 @@ class WebDB {
         std::shared_ptr<arrow::Schema> current_schema_patched_ = nullptr;
         /// The currently active prepared statements
         std::unordered_map<size_t, std::unique_ptr<duckdb::PreparedStatement>> prepared_statements_ = {};
+        /// The cached result schemas of the prepared statements
+        std::unordered_map<size_t, std::shared_ptr<ResultSchema>> prepared_schemas_ = {};
         /// The next prepared statement id
         size_t next_prepared_statement_id_ = 0;
+        /// The cached plans, most recently used first
+        std::list<CachedPlan> plan_cache_ = {};
+        /// The cached plans by query text
+        std::unordered_map<std::string_view, std::list<CachedPlan>::iterator> plan_cache_index_ = {};
+        /// The plan cache statistics
+        PlanCacheStatistics plan_cache_stats_ = {};
         /// The current arrow ipc input stream
         std::optional<ArrowInsertOptions> arrow_insert_options_ = std::nullopt;
         /// The current arrow ipc input stream
         std::unique_ptr<BufferingArrowIPCStreamDecoder> arrow_ipc_stream_;
+        /// The batches of the arrow views, referenced by the temporary views of this connection
+        std::unordered_map<std::string, std::shared_ptr<ArrowIPCStreamBuffer>> arrow_views_ = {};
+        /// The bytes of the arrow views, read by the memory governor of other connections
+        std::atomic<size_t> arrow_view_bytes_ = 0;
+        /// The bytes of the pending arrow ipc input stream, read by the memory governor of other connections
+        std::atomic<size_t> arrow_ipc_bytes_ = 0;
+        /// The recycled buffers of serialized results
+        io::OutputBufferPool output_buffers_;
+        /// The size of the last materialized result, used as size estimate for the next one
+        int64_t last_result_size_ = 0;
+        /// The open cursors
+        std::unordered_map<size_t, std::unique_ptr<ResultCursor>> cursors_ = {};
+        /// The next cursor id
+        size_t next_cursor_id_ = 0;
+        /// The incremental views, folded on every arrow insert into their table
+        std::unordered_map<std::string, IncrementalView> incremental_views_ = {};
+
+        /// Insert the record batches of a reader into a table
+        arrow::Status InsertArrowRecordBatches(std::shared_ptr<arrow::RecordBatchReader> reader,
+                                               const ArrowInsertOptions& options);
+        /// Insert the record batches of a reader into a table and fold them into incremental views
+        arrow::Status InsertAndFoldArrowRecordBatches(std::shared_ptr<arrow::RecordBatchReader> reader,
+                                                      const ArrowInsertOptions& options,
+                                                      const std::vector<IncrementalView*>& views);
 
-        // Fully materialize a given result set and return it as an Arrow Buffer
+        // Execute a query text with a cached plan (if possible)
+        arrow::Result<std::unique_ptr<duckdb::QueryResult>> ExecuteQuery(std::string_view text,
+                                                                         std::shared_ptr<ResultSchema>& schema);
+        // Import the arrow schema of a result set
+        arrow::Result<std::shared_ptr<ResultSchema>> ImportResultSchema(duckdb::QueryResult& result);
+        // Resolve the cached arrow schema of a prepared statement result
+        arrow::Result<std::shared_ptr<ResultSchema>> ResolvePreparedSchema(size_t statement_id,
+                                                                           duckdb::QueryResult& result);
+        // Import a data chunk as patched record batch
+        arrow::Result<std::shared_ptr<arrow::RecordBatch>> ImportChunk(duckdb::DataChunk& chunk,
+                                                                       const ResultSchema& schema);
+        // Fully materialize a given result set and return it as an Arrow Buffer.
+        // Results of a single small chunk are returned as Arrow IPC stream, all others as Arrow IPC file.
         arrow::Result<std::shared_ptr<arrow::Buffer>> MaterializeQueryResult(
-            std::unique_ptr<duckdb::QueryResult> result);
+            std::unique_ptr<duckdb::QueryResult> result, std::shared_ptr<ResultSchema> schema = nullptr);
         // Setup streaming of a result set and return the schema as an Arrow Buffer
-        arrow::Result<std::shared_ptr<arrow::Buffer>> StreamQueryResult(std::unique_ptr<duckdb::QueryResult> result);
+        arrow::Result<std::shared_ptr<arrow::Buffer>> StreamQueryResult(std::unique_ptr<duckdb::QueryResult> result,
+                                                                        std::shared_ptr<ResultSchema> schema = nullptr);
+        // Execute a query text with a cached plan, returns nullptr if the text is not a cacheable query
+        arrow::Result<std::unique_ptr<duckdb::QueryResult>> ExecuteCachedPlan(std::string_view text,
+                                                                              std::shared_ptr<ResultSchema>& schema);
+        // Drop the cached plans of all connections before the catalog might change
+        void InvalidatePlans();
         // Execute a prepared statement by setting up all arguments and returning the query result
         arrow::Result<std::unique_ptr<duckdb::QueryResult>> ExecutePreparedStatement(size_t statement_id,
                                                                                      std::string_view args_json);
@@ -67,10 +175,23 @@ class WebDB {
         /// Destructor
         ~Connection();
 
-        /// Get a connection
-        auto& connection() { return connection_; }
+        /// Get a connection.
+        /// Raw queries bypass the lazy extension loading, the extensions are loaded eagerly instead.
+        auto& connection() {
+            webdb_.LoadParquetExtension();
+            return connection_;
+        }
         /// Get the filesystem
         duckdb::FileSystem& filesystem();
+        /// Get the plan cache statistics
+        auto& plan_cache_statistics() { return plan_cache_stats_; }
+        /// Get the bytes of the arrow batches that are held by views and pending inserts and of the recycled result
+        /// buffers
+        size_t GetMemoryUsage() override;
+        /// Free the recycled result buffers
+        size_t ReclaimMemory(size_t bytes) override;
+        /// Drop the cached plans of this connection
+        void ClearPlanCache();
 
         /// Run a query and return an arrow buffer
         arrow::Result<std::shared_ptr<arrow::Buffer>> RunQuery(std::string_view text);
@@ -78,6 +199,21 @@ class WebDB {
         arrow::Result<std::shared_ptr<arrow::Buffer>> SendQuery(std::string_view text);
         /// Fetch query results and return an arrow buffer
         arrow::Result<std::shared_ptr<arrow::Buffer>> FetchQueryResults();
+        /// Run all statements of a script and return their results in a single batch.
+        /// The batch starts with the uint32 number of results and 4 bytes of padding, followed by one record per
+        /// executed statement: uint32 arrow status code, uint32 byte length, the Arrow IPC result if the status code is
+        /// 0 or the error message otherwise, and padding to a multiple of 8 bytes.
+        /// All integers are little-endian. If stop_on_error is set, the batch ends with the first failed statement.
+        arrow::Result<std::shared_ptr<arrow::Buffer>> RunBatch(std::string_view script, bool stop_on_error = true);
+
+        /// Run a query and materialize its result into a cursor in the temporary storage, returns the cursor id
+        arrow::Result<size_t> OpenCursor(std::string_view text);
+        /// Get the number of rows of a cursor
+        arrow::Result<uint64_t> GetCursorRowCount(size_t cursor_id);
+        /// Fetch up to `count` rows starting at row `offset` of a cursor and return them as Arrow IPC stream
+        arrow::Result<std::shared_ptr<arrow::Buffer>> FetchRows(size_t cursor_id, uint64_t offset, uint64_t count);
+        /// Close a cursor and remove its temporary file
+        arrow::Status CloseCursor(size_t cursor_id);
 
         /// Prepare a statement and return its identifier
         arrow::Result<size_t> CreatePreparedStatement(std::string_view text);
@@ -92,6 +228,26 @@ class WebDB {
 
         /// Insert an arrow record batch from an IPC stream
         arrow::Status InsertArrowFromIPCStream(nonstd::span<const uint8_t> stream, std::string_view options);
+        /// Insert an arrow record batch from an IPC stream.
+        /// The decoded batches reference the chunk instead of copying it.
+        arrow::Status InsertArrowFromIPCStream(std::shared_ptr<arrow::Buffer> stream, std::string_view options);
+        /// Insert the record batches of a reader without serializing them
+        arrow::Status InsertArrowFromRecordBatchReader(std::shared_ptr<arrow::RecordBatchReader> reader,
+                                                       std::string_view options);
+        /// Insert the record batches of an arrow C stream, takes ownership of the stream
+        arrow::Status InsertArrowFromArrayStream(ArrowArrayStream* stream, std::string_view options);
+        /// Create a temporary view over the record batches of a reader.
+        /// The view references the batches without copying them and lives as long as the connection.
+        arrow::Status CreateArrowView(std::string_view name, std::shared_ptr<arrow::RecordBatchReader> reader);
+        /// Create a temporary view over the record batches of an arrow C stream, takes ownership of the stream
+        arrow::Status CreateArrowView(std::string_view name, ArrowArrayStream* stream);
+        /// Drop an arrow view and release its batches
+        arrow::Status DropArrowView(std::string_view name);
+        /// Create an incremental aggregate view from a json definition.
+        /// The view is maintained on every arrow insert of this connection into its table.
+        arrow::Status CreateIncrementalView(std::string_view definition);
+        /// Drop an incremental view and its state
+        arrow::Status DropIncrementalView(std::string_view name);
         /// Insert csv data from a path
         arrow::Status InsertCSVFromPath(std::string_view path, std::string_view options);
         /// Insert json data from a path
@@ -101,19 +257,53 @@ class WebDB {
    protected:
     /// The config
     std::shared_ptr<WebDBConfig> config_;
+    /// The memory governor, destroyed last since the consumers are owned by the database
+    MemoryGovernor memory_governor_ = {};
+    /// The arrow memory pool, destroyed after the database since results and views hold arrow buffers
+    ArrowMemoryPool arrow_memory_pool_ = {};
     /// The buffer manager
     std::shared_ptr<io::FilePageBuffer> file_page_buffer_;
     /// The buffered filesystem
     io::BufferedFileSystem* buffered_filesystem_;
+    /// The temporary files of the database
+    std::shared_ptr<io::TempFileSystem> temp_filesystem_ = nullptr;
     /// The (shared) database
     std::shared_ptr<duckdb::DuckDB> database_;
     /// The connections
     std::unordered_map<Connection*, std::unique_ptr<Connection>> connections_;
+    /// The catalog epoch, bumped before statements that might change the catalog and before files are registered or
+    /// dropped.
+    /// Connections drop cached plans of older epochs.
+    std::atomic<uint64_t> catalog_epoch_ = 0;
+    /// The mutex that serializes extension loading
+    std::mutex extension_mutex_ = {};
+    /// Is the parquet extension loaded?
+    /// Extensions are loaded lazily by the first query that needs them.
+    std::atomic<bool> parquet_extension_loaded_ = false;
+    /// The tokens of the last script that was tokenized incrementally
+    ScriptTokenizer script_tokenizer_ = {};
 
     /// The file statistics (if any)
     std::shared_ptr<io::FileStatisticsRegistry> file_stats_ = {};
     /// The pinned web files (if any)
     std::unordered_map<std::string_view, std::unique_ptr<io::WebFileSystem::WebFileHandle>> pinned_web_files_ = {};
+    /// The file warmer, destroyed first since it holds file refs of the page buffer
+    std::unique_ptr<io::FileWarmer> file_warmer_ = nullptr;
+
+    /// Close the current database and all its connections
+    void CloseDatabase();
+    /// Open the database of a config, the config is adopted once the database is opened
+    arrow::Status OpenDatabase(const WebDBConfig& config);
+    /// Create a database and replace the current one if it was opened
+    arrow::Status CreateDatabase(const WebDBConfig& config, duckdb::AccessMode access_mode);
+    /// Reopen the previous database after a failed open, falls back to an in-memory database
+    void RecoverDatabase(const WebDBConfig& previous);
+    /// Load the parquet extension (if not loaded yet)
+    void LoadParquetExtension();
+    /// Load the extensions that a failed query might have missed, returns whether the query should be retried
+    bool LoadExtensionsAfterError(std::string_view error);
+    /// Copy an in-memory database into a checkpointed database image
+    arrow::Result<std::shared_ptr<arrow::Buffer>> ExportInMemoryDatabase();
 
    public:
     /// Constructor
@@ -125,18 +315,36 @@ class WebDB {
 
     /// Get the filesystem
     auto& filesystem() { return database_->GetFileSystem(); }
-    /// Get the database
-    auto& database() { return *database_; }
+    /// Get the database.
+    /// Raw queries bypass the lazy extension loading, the extensions are loaded eagerly instead.
+    auto& database() {
+        LoadParquetExtension();
+        return *database_;
+    }
     /// Get the buffer manager
     auto& file_page_buffer() { return *file_page_buffer_; }
+    /// Get the memory governor
+    auto& memory_governor() { return memory_governor_; }
+    /// Get the arrow memory pool
+    auto& arrow_memory_pool() { return arrow_memory_pool_; }
+    /// Get the temporary files
+    auto& temp_filesystem() { return *temp_filesystem_; }
 
     /// Get the version
     std::string_view GetVersion();
     /// Get the feature flags
     uint32_t GetFeatureFlags();
 
+    /// Load the extensions that a query text refers to
+    void LoadExtensionsFor(std::string_view text);
+
     /// Tokenize a script and return tokens as json
     std::string Tokenize(std::string_view text);
+    /// Tokenize a script and return the packed tokens, the script is kept for incremental updates
+    std::shared_ptr<arrow::Buffer> TokenizeBinary(std::string_view text);
+    /// Apply an edit to the last tokenized script and return the packed token update
+    arrow::Result<std::shared_ptr<arrow::Buffer>> RetokenizeBinary(size_t offset, size_t removed,
+                                                                   std::string_view inserted);
 
     /// Create a connection
     Connection* Connect();
@@ -150,6 +358,9 @@ class WebDB {
     /// Register a file URL
     arrow::Status RegisterFileURL(std::string_view file_name, std::string_view file_url,
                                   std::optional<uint64_t> file_size);
+    /// Register a batch of file URLs.
+    /// See io::WebFileSystem::DecodeFileURLs for the batch encoding.
+    arrow::Status RegisterFileURLs(nonstd::span<const char> batch, bool defer_handles = false);
     /// Register a file URL
     arrow::Status RegisterFileBuffer(std::string_view file_name, std::unique_ptr<char[]> buffer, size_t buffer_length);
     /// Glob all known file infos
@@ -173,11 +384,30 @@ class WebDB {
     /// Copy a file to a path
     arrow::Status CopyFileToPath(std::string_view path, std::string_view out);
 
+    /// Export a snapshot of the database
+    arrow::Result<std::shared_ptr<arrow::Buffer>> ExportSnapshot(std::string_view options_json = "");
+    /// Open a database snapshot as buffered file
+    arrow::Status OpenSnapshot(std::string_view file_name, std::unique_ptr<char[]> buffer, size_t buffer_length,
+                               std::string_view args_json = "");
+
     /// Collect file statistics
     arrow::Status CollectFileStatistics(std::string_view path, bool enable);
     /// Export file statistics
     arrow::Result<std::shared_ptr<arrow::Buffer>> ExportFileStatistics(std::string_view path);
 
+    /// Load file ranges into the page buffer ahead of queries, returns the warm-up id.
+    /// The target is "metadata", "all" or an array of [offset, length] pairs.
+    arrow::Result<size_t> WarmFile(std::string_view path, std::string_view target_json, int32_t priority = 0);
+    /// Get the progress of a warm-up as JSON
+    arrow::Result<std::string> GetWarmUpProgress(size_t warm_up_id);
+    /// Cancel a warm-up
+    arrow::Status CancelWarmUp(size_t warm_up_id);
+
+    /// Get the memory budget and the usage of all subsystems as JSON
+    arrow::Result<std::string> GetMemoryInfo();
+    /// Release memory of the page buffer and the readaheads, returns the released bytes
+    arrow::Result<size_t> ReclaimMemory(size_t bytes);
+
     /// Get the static webdb instance
     static arrow::Result<std::reference_wrapper<WebDB>> Get();
     /// Create the default webdb database
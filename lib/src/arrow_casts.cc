@@ -32,15 +32,15 @@ std::shared_ptr<arrow::Schema> patchSchema(const std::shared_ptr<arrow::Schema>&
 }
 
 /// Helper to cast a record batch
-arrow::Result<std::shared_ptr<arrow::RecordBatch>> patchRecordBatch(const std::shared_ptr<arrow::RecordBatch>& batch,
-                                                                    const std::shared_ptr<arrow::Schema>& schema,
-                                                                    const WebDBConfig& config) {
+arrow::Result<std::shared_ptr<arrow::RecordBatch>> patchRecordBatch(
+    const std::shared_ptr<arrow::RecordBatch>& batch, const std::shared_ptr<arrow::Schema>& schema,
+    const WebDBConfig& config, arrow::MemoryPool* pool) {
     // Schema the same?
     if (batch->schema() == schema) return batch;
 
     // Build a double array
-    auto buildDoubleArray = [](auto& array) -> arrow::Result<std::shared_ptr<arrow::Array>> {
-        arrow::DoubleBuilder builder;
+    auto buildDoubleArray = [pool](auto& array) -> arrow::Result<std::shared_ptr<arrow::Array>> {
+        arrow::DoubleBuilder builder{pool};
         ARROW_RETURN_NOT_OK(builder.Resize(array.length()));
         for (auto iter = array.begin(); iter != array.end(); ++iter) {
             if (!(*iter).has_value()) {
@@ -0,0 +1,242 @@
+#include "duckdb/web/arrow_memory_pool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace duckdb {
+namespace web {
+
+namespace {
+
+/// The address of zero-size allocations
+alignas(64) uint8_t ZERO_SIZE_AREA[1];
+
+}  // namespace
+
+/// Constructor
+ArrowMemoryPool::ArrowMemoryPool(arrow::MemoryPool *backing_pool) : backing_pool_(backing_pool) {}
+
+/// Destructor
+ArrowMemoryPool::~ArrowMemoryPool() {
+    for (auto &[address, slab] : slabs_) {
+        backing_pool_->Free(slab->data, SLAB_SIZE);
+    }
+}
+
+/// Get the size class of an allocation
+size_t ArrowMemoryPool::GetSizeClass(int64_t size) {
+    size_t size_class = 0;
+    for (auto block_size = MIN_BLOCK_SIZE; block_size < static_cast<size_t>(size); block_size <<= 1) {
+        ++size_class;
+    }
+    return size_class;
+}
+
+/// Allocate a block
+arrow::Status ArrowMemoryPool::AllocateBlock(size_t size_class, uint8_t **out, std::unique_lock<std::mutex> &guard) {
+    auto &available = available_slabs_[size_class];
+    auto block_size = GetBlockSize(size_class);
+
+    // Allocate a new slab if no slab has a free block
+    if (available.empty()) {
+        uint8_t *data = nullptr;
+        ARROW_RETURN_NOT_OK(backing_pool_->Allocate(SLAB_SIZE, &data));
+        auto slab = std::make_unique<Slab>();
+        slab->data = data;
+        slab->size_class = size_class;
+        slab->block_count = SLAB_SIZE / block_size;
+        slab->available = true;
+        available.push_back(slab.get());
+        slabs_.insert({reinterpret_cast<uintptr_t>(data), std::move(slab)});
+        stats_.bytes_reserved += SLAB_SIZE;
+    }
+
+    // Prefer cached blocks
+    auto *slab = available.back();
+    if (!slab->free_blocks.empty()) {
+        *out = slab->free_blocks.back();
+        slab->free_blocks.pop_back();
+        ++stats_.cache_hits;
+    } else {
+        *out = slab->data + slab->next_block++ * block_size;
+    }
+    ++slab->live_blocks;
+    if (slab->free_blocks.empty() && slab->next_block == slab->block_count) {
+        slab->available = false;
+        available.pop_back();
+    }
+    return arrow::Status::OK();
+}
+
+/// Free a block
+void ArrowMemoryPool::FreeBlock(size_t size_class, uint8_t *block, std::unique_lock<std::mutex> &guard) {
+    auto iter = slabs_.upper_bound(reinterpret_cast<uintptr_t>(block));
+    assert(iter != slabs_.begin());
+    auto &slab = *std::prev(iter)->second;
+    assert(slab.size_class == size_class);
+    slab.free_blocks.push_back(block);
+    --slab.live_blocks;
+    if (!slab.available) {
+        slab.available = true;
+        available_slabs_[slab.size_class].push_back(&slab);
+    }
+}
+
+/// Release empty slabs
+size_t ArrowMemoryPool::ReleaseEmptySlabs(size_t retain, std::unique_lock<std::mutex> &guard) {
+    size_t empty = 0;
+    for (auto &available : available_slabs_) {
+        for (auto *slab : available) {
+            empty += (slab->live_blocks == 0) ? SLAB_SIZE : 0;
+        }
+    }
+    size_t released = 0;
+    for (auto &available : available_slabs_) {
+        for (auto iter = available.begin(); iter != available.end() && empty - released > retain;) {
+            auto *slab = *iter;
+            if (slab->live_blocks > 0) {
+                ++iter;
+                continue;
+            }
+            iter = available.erase(iter);
+            backing_pool_->Free(slab->data, SLAB_SIZE);
+            slabs_.erase(reinterpret_cast<uintptr_t>(slab->data));
+            released += SLAB_SIZE;
+        }
+    }
+    stats_.bytes_reserved -= released;
+    return released;
+}
+
+/// Enter an arena
+void ArrowMemoryPool::EnterArena() {
+    std::unique_lock<std::mutex> guard{pool_mutex_};
+    ++arena_depth_;
+}
+
+/// Leave an arena
+void ArrowMemoryPool::LeaveArena() {
+    std::unique_lock<std::mutex> guard{pool_mutex_};
+    if (--arena_depth_ == 0) {
+        ReleaseEmptySlabs(RETAINED_SLAB_BYTES, guard);
+    }
+}
+
+/// Allocate a new memory region of at least size bytes
+arrow::Status ArrowMemoryPool::Allocate(int64_t size, uint8_t **out) {
+    if (size < 0) return arrow::Status::Invalid("negative malloc size");
+    if (size == 0) {
+        *out = ZERO_SIZE_AREA;
+        return arrow::Status::OK();
+    }
+    std::unique_lock<std::mutex> guard{pool_mutex_};
+    if (static_cast<size_t>(size) > MAX_BLOCK_SIZE) {
+        ARROW_RETURN_NOT_OK(backing_pool_->Allocate(size, out));
+        stats_.bytes_reserved += size;
+    } else {
+        ARROW_RETURN_NOT_OK(AllocateBlock(GetSizeClass(size), out, guard));
+    }
+    ++stats_.allocations;
+    stats_.bytes_allocated += size;
+    stats_.bytes_peak = std::max(stats_.bytes_peak, stats_.bytes_allocated);
+    return arrow::Status::OK();
+}
+
+/// Resize an already allocated memory section
+arrow::Status ArrowMemoryPool::Reallocate(int64_t old_size, int64_t new_size, uint8_t **ptr) {
+    if (new_size < 0) return arrow::Status::Invalid("negative realloc size");
+    auto old_small = static_cast<size_t>(old_size) <= MAX_BLOCK_SIZE;
+    auto new_small = static_cast<size_t>(new_size) <= MAX_BLOCK_SIZE;
+
+    // Stay in the block if the size class does not change
+    if (old_size > 0 && new_size > 0 && old_small && new_small && GetSizeClass(old_size) == GetSizeClass(new_size)) {
+        std::unique_lock<std::mutex> guard{pool_mutex_};
+        stats_.bytes_allocated += new_size - old_size;
+        stats_.bytes_peak = std::max(stats_.bytes_peak, stats_.bytes_allocated);
+        return arrow::Status::OK();
+    }
+
+    // Let the backing pool resize large allocations in place
+    if (!old_small && !new_small) {
+        std::unique_lock<std::mutex> guard{pool_mutex_};
+        ARROW_RETURN_NOT_OK(backing_pool_->Reallocate(old_size, new_size, ptr));
+        stats_.bytes_reserved += new_size - old_size;
+        stats_.bytes_allocated += new_size - old_size;
+        stats_.bytes_peak = std::max(stats_.bytes_peak, stats_.bytes_allocated);
+        return arrow::Status::OK();
+    }
+
+    // Move the bytes otherwise
+    uint8_t *out = nullptr;
+    ARROW_RETURN_NOT_OK(Allocate(new_size, &out));
+    std::memcpy(out, *ptr, std::min(old_size, new_size));
+    Free(*ptr, old_size);
+    *ptr = out;
+    return arrow::Status::OK();
+}
+
+/// Free an allocated region
+void ArrowMemoryPool::Free(uint8_t *buffer, int64_t size) {
+    if (buffer == ZERO_SIZE_AREA) return;
+    std::unique_lock<std::mutex> guard{pool_mutex_};
+    if (static_cast<size_t>(size) > MAX_BLOCK_SIZE) {
+        backing_pool_->Free(buffer, size);
+        stats_.bytes_reserved -= size;
+    } else {
+        FreeBlock(GetSizeClass(size), buffer, guard);
+    }
+    stats_.bytes_allocated -= size;
+}
+
+/// Release all empty slabs
+void ArrowMemoryPool::ReleaseUnused() {
+    std::unique_lock<std::mutex> guard{pool_mutex_};
+    ReleaseEmptySlabs(0, guard);
+}
+
+/// The number of bytes that are currently allocated
+int64_t ArrowMemoryPool::bytes_allocated() const {
+    std::unique_lock<std::mutex> guard{pool_mutex_};
+    return stats_.bytes_allocated;
+}
+
+/// The peak of the allocated bytes
+int64_t ArrowMemoryPool::max_memory() const {
+    std::unique_lock<std::mutex> guard{pool_mutex_};
+    return stats_.bytes_peak;
+}
+
+/// Get the statistics
+ArrowMemoryPool::Statistics ArrowMemoryPool::GetStatistics() {
+    std::unique_lock<std::mutex> guard{pool_mutex_};
+    return stats_;
+}
+
+/// Write the statistics as JSON
+rapidjson::Value ArrowMemoryPool::WriteStatistics(rapidjson::Document &doc) {
+    auto stats = GetStatistics();
+    auto &allocator = doc.GetAllocator();
+    rapidjson::Value value{rapidjson::kObjectType};
+    value.AddMember("bytesAllocated", static_cast<double>(stats.bytes_allocated), allocator);
+    value.AddMember("bytesPeak", static_cast<double>(stats.bytes_peak), allocator);
+    value.AddMember("bytesReserved", static_cast<double>(stats.bytes_reserved), allocator);
+    value.AddMember("allocations", static_cast<double>(stats.allocations), allocator);
+    value.AddMember("cacheHits", static_cast<double>(stats.cache_hits), allocator);
+    return value;
+}
+
+/// Get the bytes that are held by slabs and large allocations
+size_t ArrowMemoryPool::GetMemoryUsage() {
+    std::unique_lock<std::mutex> guard{pool_mutex_};
+    return stats_.bytes_reserved;
+}
+
+/// Release empty slabs
+size_t ArrowMemoryPool::ReclaimMemory(size_t bytes) {
+    std::unique_lock<std::mutex> guard{pool_mutex_};
+    return ReleaseEmptySlabs(0, guard);
+}
+
+}  // namespace web
+}  // namespace duckdb
@@ -1,5 +1,6 @@
 #include "duckdb/web/arrow_stream_buffer.h"
 
+#include <functional>
 #include <iostream>
 
 namespace duckdb {
@@ -7,6 +8,42 @@ namespace web {
 
 /// Constructor
 ArrowIPCStreamBuffer::ArrowIPCStreamBuffer() : schema_(nullptr), batches_(), is_eos_(false) {}
+/// Constructor for batches that were read already
+ArrowIPCStreamBuffer::ArrowIPCStreamBuffer(std::shared_ptr<arrow::Schema> schema,
+                                           std::vector<std::shared_ptr<arrow::RecordBatch>> batches)
+    : schema_(std::move(schema)), batches_(std::move(batches)), is_eos_(true) {}
+/// Read all batches of a reader
+arrow::Result<std::shared_ptr<ArrowIPCStreamBuffer>> ArrowIPCStreamBuffer::ReadFrom(arrow::RecordBatchReader& reader) {
+    std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+    while (true) {
+        std::shared_ptr<arrow::RecordBatch> batch;
+        ARROW_RETURN_NOT_OK(reader.ReadNext(&batch));
+        if (!batch) break;
+        batches.push_back(std::move(batch));
+    }
+    return std::make_shared<ArrowIPCStreamBuffer>(reader.schema(), std::move(batches));
+}
+/// Get the bytes of all buffers that are referenced by the batches
+size_t ArrowIPCStreamBuffer::GetByteSize() const {
+    std::function<size_t(const arrow::ArrayData&)> array_size = [&](const arrow::ArrayData& data) {
+        size_t n = 0;
+        for (auto& buffer : data.buffers) {
+            if (buffer) n += buffer->size();
+        }
+        for (auto& child : data.child_data) {
+            if (child) n += array_size(*child);
+        }
+        if (data.dictionary) n += array_size(*data.dictionary);
+        return n;
+    };
+    size_t n = 0;
+    for (auto& batch : batches_) {
+        for (auto& column : batch->column_data()) {
+            n += array_size(*column);
+        }
+    }
+    return n;
+}
 /// Decoded a schema
 arrow::Status ArrowIPCStreamBuffer::OnSchemaDecoded(std::shared_ptr<arrow::Schema> s) {
     schema_ = s;
@@ -46,7 +83,7 @@ std::unique_ptr<duckdb::ArrowArrayStreamWrapper> ArrowIPCStreamBufferReader::Cre
     assert(this_ptr != 0);
 
     // Rewind the reader
-    auto reader = reinterpret_cast<std::shared_ptr<ArrowIPCStreamBufferReader>*>(this_ptr);
+    auto reader = reinterpret_cast<std::shared_ptr<arrow::RecordBatchReader>*>(this_ptr);
 
     // Create arrow stream
     auto stream_wrapper = duckdb::make_unique<duckdb::ArrowArrayStreamWrapper>();
@@ -63,9 +100,22 @@ std::unique_ptr<duckdb::ArrowArrayStreamWrapper> ArrowIPCStreamBufferReader::Cre
     return stream_wrapper;
 }
 
+/// Arrow array stream factory function for buffered batches
+std::unique_ptr<duckdb::ArrowArrayStreamWrapper> ArrowIPCStreamBufferReader::CreateArrayStreamFromBufferPtr(
+    uintptr_t buffer_ptr, std::pair<std::unordered_map<idx_t, string>, std::vector<string>>& project_columns,
+    duckdb::TableFilterCollection* filters) {
+    assert(buffer_ptr != 0);
+
+    // Read the batches with a new reader
+    auto buffer = reinterpret_cast<ArrowIPCStreamBuffer*>(buffer_ptr)->shared_from_this();
+    std::shared_ptr<arrow::RecordBatchReader> reader = std::make_shared<ArrowIPCStreamBufferReader>(std::move(buffer));
+    return CreateArrayStreamFromSharedPtrPtr(reinterpret_cast<uintptr_t>(&reader), project_columns, filters);
+}
+
 /// Constructor
-BufferingArrowIPCStreamDecoder::BufferingArrowIPCStreamDecoder(std::shared_ptr<ArrowIPCStreamBuffer> buffer)
-    : buffer_(buffer), arrow::ipc::StreamDecoder(buffer) {}
+BufferingArrowIPCStreamDecoder::BufferingArrowIPCStreamDecoder(std::shared_ptr<ArrowIPCStreamBuffer> buffer,
+                                                               arrow::ipc::IpcReadOptions options)
+    : arrow::ipc::StreamDecoder(buffer, options), buffer_(buffer) {}
 
 }  // namespace web
 }  // namespace duckdb
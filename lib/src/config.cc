@@ -1,5 +1,7 @@
 #include "duckdb/web/config.h"
 
+#include <algorithm>
+
 #include "duckdb/web/arrow_casts.h"
 #include "duckdb/web/webdb.h"
 
@@ -29,12 +31,33 @@ WebDBConfig WebDBConfig::ReadFrom(std::string_view args_json) {
         auto bigint = duckdb_web_test_platform_feature(PlatformFeature::BIGINT64ARRAY);
         return {
             .path = ":memory:",
+            .access_mode = WebDBAccessMode::AUTOMATIC,
             .emit_bigint = bigint,
             .maximum_threads = 1,
-            .filesystem = FileSystemConfig{.allow_full_http_reads = true},
+            .memory_budget = 0,
+            .compact_result_size = 64 << 10,
+            .plan_cache_size = 32,
+            .filesystem = FileSystemConfig{.allow_full_http_reads = true,
+                                           .sync_window_micros = 0,
+                                           .speculative_tail_size = 64 << 10,
+                                           .temp_budget = 0,
+                                           .temp_overflow_file = ""},
         };
     }
     auto path = (!doc.HasMember("path") || !doc["path"].IsString()) ? ":memory:" : doc["path"].GetString();
+    auto access_mode = WebDBAccessMode::AUTOMATIC;
+    if (doc.HasMember("accessMode") && doc["accessMode"].IsUint()) {
+        switch (doc["accessMode"].GetUint()) {
+            case static_cast<uint8_t>(WebDBAccessMode::READ_ONLY):
+                access_mode = WebDBAccessMode::READ_ONLY;
+                break;
+            case static_cast<uint8_t>(WebDBAccessMode::READ_WRITE):
+                access_mode = WebDBAccessMode::READ_WRITE;
+                break;
+            default:
+                break;
+        }
+    }
     bool bigint;
     if (doc.HasMember("emitBigInt") && doc["emitBigInt"].IsBool()) {
         bigint = doc["emitBigInt"].GetBool();
@@ -45,14 +68,50 @@ WebDBConfig WebDBConfig::ReadFrom(std::string_view args_json) {
     if (doc.HasMember("maximumThreads") && doc["maximumThreads"].IsNumber()) {
         max_threads = doc["maximumThreads"].GetInt();
     }
+    uint64_t memory_budget = 0;
+    if (doc.HasMember("memoryBudget") && doc["memoryBudget"].IsNumber()) {
+        memory_budget = std::max<double>(0.0, doc["memoryBudget"].GetDouble());
+    }
+    uint32_t compact_result_size = 64 << 10;
+    if (doc.HasMember("compactResultSize") && doc["compactResultSize"].IsUint()) {
+        compact_result_size = doc["compactResultSize"].GetUint();
+    }
+    uint32_t plan_cache_size = 32;
+    if (doc.HasMember("planCacheSize") && doc["planCacheSize"].IsUint()) {
+        plan_cache_size = doc["planCacheSize"].GetUint();
+    }
     bool allow_full_http_reads = true;
     if (doc.HasMember("allowFullHTTPReads") && doc["allowFullHTTPReads"].IsBool()) {
         allow_full_http_reads = doc["allowFullHTTPReads"].GetBool();
     }
+    uint32_t sync_window_micros = 0;
+    if (doc.HasMember("syncWindowMicros") && doc["syncWindowMicros"].IsUint()) {
+        sync_window_micros = doc["syncWindowMicros"].GetUint();
+    }
+    uint32_t speculative_tail_size = 64 << 10;
+    if (doc.HasMember("speculativeTailSize") && doc["speculativeTailSize"].IsUint()) {
+        speculative_tail_size = doc["speculativeTailSize"].GetUint();
+    }
+    uint64_t temp_budget = 0;
+    if (doc.HasMember("tempBudget") && doc["tempBudget"].IsNumber()) {
+        temp_budget = std::max<double>(0.0, doc["tempBudget"].GetDouble());
+    }
+    std::string temp_overflow_file = "";
+    if (doc.HasMember("tempOverflowFile") && doc["tempOverflowFile"].IsString()) {
+        temp_overflow_file = doc["tempOverflowFile"].GetString();
+    }
     return {.path = path,
+            .access_mode = access_mode,
             .emit_bigint = bigint,
             .maximum_threads = max_threads,
-            .filesystem = FileSystemConfig{.allow_full_http_reads = allow_full_http_reads}};
+            .memory_budget = memory_budget,
+            .compact_result_size = compact_result_size,
+            .plan_cache_size = plan_cache_size,
+            .filesystem = FileSystemConfig{.allow_full_http_reads = allow_full_http_reads,
+                                           .sync_window_micros = sync_window_micros,
+                                           .speculative_tail_size = speculative_tail_size,
+                                           .temp_budget = temp_budget,
+                                           .temp_overflow_file = temp_overflow_file}};
 }
 
 }  // namespace web
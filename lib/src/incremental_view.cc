@@ -0,0 +1,242 @@
+#include "duckdb/web/incremental_view.h"
+
+#include <cctype>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "arrow/status.h"
+#include "rapidjson/document.h"
+
+namespace duckdb {
+namespace web {
+
+namespace {
+
+/// Quote an identifier
+std::string Quote(std::string_view name) {
+    std::string quoted = "\"";
+    for (auto c : name) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+    quoted += '"';
+    return quoted;
+}
+
+/// Get a string field
+arrow::Status ReadString(const rapidjson::Value& value, std::string_view field, std::string& out) {
+    if (!value.IsString()) return arrow::Status::Invalid("type mismatch for field '", field, "': expected string");
+    out = {value.GetString(), value.GetStringLength()};
+    return arrow::Status::OK();
+}
+
+/// The aggregate functions by name
+static std::unordered_map<std::string, IncrementalView::AggregateFunction> AGGREGATE_FUNCTIONS{
+    {"sum", IncrementalView::AggregateFunction::SUM}, {"count", IncrementalView::AggregateFunction::COUNT},
+    {"min", IncrementalView::AggregateFunction::MIN}, {"max", IncrementalView::AggregateFunction::MAX},
+    {"avg", IncrementalView::AggregateFunction::AVG},
+};
+
+/// Get the name of a partial aggregate column
+std::string GetPartialColumn(std::string_view partial, size_t aggregate_id) {
+    return Quote("__" + std::string{partial} + "_" + std::to_string(aggregate_id));
+}
+
+}  // namespace
+
+/// Get the quoted name of the state table
+std::string IncrementalView::GetStateTable() const { return Quote("__incremental_" + name_); }
+
+/// Read the view definition from a document
+arrow::Status IncrementalView::ReadFrom(const rapidjson::Document& doc) {
+    if (!doc.IsObject()) return arrow::Status::Invalid("incremental view definition must be an object");
+    for (auto iter = doc.MemberBegin(); iter != doc.MemberEnd(); ++iter) {
+        std::string_view field{iter->name.GetString(), iter->name.GetStringLength()};
+        auto& value = iter->value;
+        if (field == "name") {
+            ARROW_RETURN_NOT_OK(ReadString(value, field, name_));
+        } else if (field == "schema") {
+            ARROW_RETURN_NOT_OK(ReadString(value, field, schema_name_));
+        } else if (field == "table") {
+            ARROW_RETURN_NOT_OK(ReadString(value, field, table_name_));
+        } else if (field == "groupBy") {
+            if (!value.IsArray()) return arrow::Status::Invalid("type mismatch for field 'groupBy': expected array");
+            for (auto& group : value.GetArray()) {
+                ARROW_RETURN_NOT_OK(ReadString(group, field, groups_.emplace_back()));
+            }
+        } else if (field == "aggregates") {
+            if (!value.IsArray()) return arrow::Status::Invalid("type mismatch for field 'aggregates': expected array");
+            for (auto& entry : value.GetArray()) {
+                if (!entry.IsObject()) return arrow::Status::Invalid("aggregates must be objects");
+                std::string function_name;
+                Aggregate aggregate;
+                for (auto member = entry.MemberBegin(); member != entry.MemberEnd(); ++member) {
+                    std::string_view member_field{member->name.GetString(), member->name.GetStringLength()};
+                    if (member_field == "function") {
+                        ARROW_RETURN_NOT_OK(ReadString(member->value, member_field, function_name));
+                    } else if (member_field == "column") {
+                        ARROW_RETURN_NOT_OK(ReadString(member->value, member_field, aggregate.column));
+                    } else if (member_field == "name") {
+                        ARROW_RETURN_NOT_OK(ReadString(member->value, member_field, aggregate.name));
+                    }
+                }
+                for (auto& c : function_name) c = std::tolower(static_cast<unsigned char>(c));
+                auto function = AGGREGATE_FUNCTIONS.find(function_name);
+                if (function == AGGREGATE_FUNCTIONS.end()) {
+                    return arrow::Status::Invalid("unsupported aggregate function: '", function_name, "'");
+                }
+                aggregate.function = function->second;
+                if (aggregate.column.empty() && aggregate.function != AggregateFunction::COUNT) {
+                    return arrow::Status::Invalid("aggregate '", function_name, "' requires a column");
+                }
+                if (aggregate.name.empty()) {
+                    aggregate.name = function_name + "(" + (aggregate.column.empty() ? "*" : aggregate.column) + ")";
+                }
+                aggregates_.push_back(std::move(aggregate));
+            }
+        }
+    }
+    if (name_.empty()) return arrow::Status::Invalid("missing 'name' of the incremental view");
+    if (table_name_.empty()) return arrow::Status::Invalid("missing 'table' of the incremental view");
+    if (aggregates_.empty()) return arrow::Status::Invalid("incremental view without aggregates");
+    return arrow::Status::OK();
+}
+
+/// Encode the group columns
+std::string IncrementalView::EncodeGroups() const {
+    std::stringstream out;
+    for (size_t i = 0; i < groups_.size(); ++i) {
+        out << (i > 0 ? ", " : "") << Quote(groups_[i]);
+    }
+    return out.str();
+}
+
+/// Encode a query that computes the partial aggregates of a relation
+std::string IncrementalView::EncodePartialAggregates(std::string_view relation) const {
+    std::stringstream out;
+    out << "SELECT ";
+    for (auto& group : groups_) {
+        out << Quote(group) << ", ";
+    }
+    for (size_t i = 0; i < aggregates_.size(); ++i) {
+        auto& aggregate = aggregates_[i];
+        auto column = aggregate.column.empty() ? std::string{"*"} : Quote(aggregate.column);
+        out << (i > 0 ? ", " : "");
+        switch (aggregate.function) {
+            case AggregateFunction::SUM:
+                out << "SUM(" << column << ") AS " << GetPartialColumn("sum", i);
+                break;
+            case AggregateFunction::COUNT:
+                out << "COUNT(" << column << ") AS " << GetPartialColumn("count", i);
+                break;
+            case AggregateFunction::MIN:
+                out << "MIN(" << column << ") AS " << GetPartialColumn("min", i);
+                break;
+            case AggregateFunction::MAX:
+                out << "MAX(" << column << ") AS " << GetPartialColumn("max", i);
+                break;
+            case AggregateFunction::AVG:
+                out << "SUM(" << column << ") AS " << GetPartialColumn("sum", i) << ", COUNT(" << column << ") AS "
+                    << GetPartialColumn("count", i);
+                break;
+        }
+    }
+    out << " FROM " << relation;
+    if (!groups_.empty()) out << " GROUP BY " << EncodeGroups();
+    return out.str();
+}
+
+/// Encode a query that merges the partial aggregates of the state table.
+/// Final aggregates are named after the view columns, otherwise the partial aggregates are kept.
+std::string IncrementalView::EncodeMergedAggregates(bool final) const {
+    std::stringstream out;
+    out << "SELECT ";
+    for (auto& group : groups_) {
+        out << Quote(group) << ", ";
+    }
+    for (size_t i = 0; i < aggregates_.size(); ++i) {
+        auto& aggregate = aggregates_[i];
+        auto name = Quote(aggregate.name);
+        out << (i > 0 ? ", " : "");
+        switch (aggregate.function) {
+            case AggregateFunction::SUM: {
+                auto sum = GetPartialColumn("sum", i);
+                out << "SUM(" << sum << ") AS " << (final ? name : sum);
+                break;
+            }
+            case AggregateFunction::COUNT: {
+                auto count = GetPartialColumn("count", i);
+                out << "SUM(" << count << ")::BIGINT AS " << (final ? name : count);
+                break;
+            }
+            case AggregateFunction::MIN: {
+                auto min = GetPartialColumn("min", i);
+                out << "MIN(" << min << ") AS " << (final ? name : min);
+                break;
+            }
+            case AggregateFunction::MAX: {
+                auto max = GetPartialColumn("max", i);
+                out << "MAX(" << max << ") AS " << (final ? name : max);
+                break;
+            }
+            case AggregateFunction::AVG: {
+                auto sum = GetPartialColumn("sum", i);
+                auto count = GetPartialColumn("count", i);
+                if (final) {
+                    out << "SUM(" << sum << ")::DOUBLE / SUM(" << count << ") AS " << name;
+                } else {
+                    out << "SUM(" << sum << ") AS " << sum << ", SUM(" << count << ")::BIGINT AS " << count;
+                }
+                break;
+            }
+        }
+    }
+    out << " FROM " << GetStateTable();
+    if (!groups_.empty()) out << " GROUP BY " << EncodeGroups();
+    return out.str();
+}
+
+/// Encode the statements that (re)create the state table and the view
+std::vector<std::string> IncrementalView::EncodeCreate() const {
+    auto state = GetStateTable();
+    return {
+        "DROP TABLE IF EXISTS " + state,
+        "CREATE TEMPORARY TABLE " + state + " AS " +
+            EncodePartialAggregates(Quote(schema_name_) + "." + Quote(table_name_)),
+        "CREATE OR REPLACE TEMPORARY VIEW " + Quote(name_) + " AS " + EncodeMergedAggregates(true),
+    };
+}
+
+/// Encode the statements that fold the rows of a relation into the state table
+std::vector<std::string> IncrementalView::EncodeFold(std::string_view relation) const {
+    auto state = GetStateTable();
+    std::vector<std::string> statements{"INSERT INTO " + state + " " + EncodePartialAggregates(relation)};
+
+    // Compact the partial aggregates to a single row per group
+    if (folds_ + 1 >= COMPACTION_FOLDS) {
+        auto merged = Quote("__incremental_" + name_ + "_merged");
+        statements.push_back("CREATE TEMPORARY TABLE " + merged + " AS " + EncodeMergedAggregates(false));
+        statements.push_back("DELETE FROM " + state);
+        statements.push_back("INSERT INTO " + state + " SELECT * FROM " + merged);
+        statements.push_back("DROP TABLE " + merged);
+    }
+    return statements;
+}
+
+/// Count a fold once its statements were executed successfully
+void IncrementalView::CommitFold() {
+    if (++folds_ >= COMPACTION_FOLDS) folds_ = 0;
+}
+
+/// Encode the statements that drop the view and the state table
+std::vector<std::string> IncrementalView::EncodeDrop() const {
+    return {
+        "DROP VIEW IF EXISTS " + Quote(name_),
+        "DROP TABLE IF EXISTS " + GetStateTable(),
+    };
+}
+
+}  // namespace web
+}  // namespace duckdb
@@ -50,6 +50,12 @@ arrow::Result<int64_t> ArrowInputFileStream::Read(int64_t nbytes, void* out) {
 
 /// Peek at most nbytes bytes from the file
 arrow::Result<ArrowInputFileStream::PageView> ArrowInputFileStream::PeekView(int64_t nbytes) {
+    // Memory-mapped files hand out the whole range without copying
+    if (auto range = file_->FixRange(file_position_, nbytes)) {
+        auto data = range.GetData();
+        return PageView{std::move(range), data};
+    }
+
     // Determine page & offset
     auto page_id = file_position_ >> file_page_buffer_->GetPageSizeShift();
     auto skip_here = file_position_ - page_id * file_page_buffer_->GetPageSize();
@@ -0,0 +1,306 @@
+#include "duckdb/web/io/async_reader.h"
+
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/web/utils/scope_guard.h"
+
+#ifndef EMSCRIPTEN
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && !defined(EMSCRIPTEN) && __has_include(<linux/io_uring.h>)
+#define WEBDB_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace duckdb {
+namespace web {
+namespace io {
+
+/// Destructor
+AsyncFile::~AsyncFile() {
+#ifndef EMSCRIPTEN
+    if (fd_ >= 0) ::close(fd_);
+#endif
+}
+
+/// Open a local file for reading
+std::unique_ptr<AsyncFile> AsyncFile::Open(std::string_view path) {
+#ifndef EMSCRIPTEN
+    std::string path_buf{path};
+    auto fd = ::open(path_buf.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+    return std::unique_ptr<AsyncFile>(new AsyncFile(fd));
+#else
+    return nullptr;
+#endif
+}
+
+namespace {
+
+#ifndef EMSCRIPTEN
+
+/// A reader that issues blocking preads one after the other
+class PReadReader : public AsyncReader {
+   public:
+    /// Get the name of the backend
+    std::string_view GetName() const override { return "pread"; }
+    /// Get the maximum number of reads in flight
+    size_t GetQueueDepth() const override { return 1; }
+    /// Read a batch of requests
+    void Read(nonstd::span<const Request> requests, const CompletionCallback& done) override {
+        for (size_t i = 0; i < requests.size(); ++i) {
+            auto& request = requests[i];
+            int64_t result = 0;
+            while (result < request.size) {
+                auto n = ::pread(request.fd, request.buffer + result, request.size - result, request.offset + result);
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0) {
+                    result = -errno;
+                    break;
+                }
+                if (n == 0) break;
+                result += n;
+            }
+            done(i, result);
+        }
+    }
+};
+
+#endif
+
+#ifdef WEBDB_IO_URING
+
+/// A reader that submits reads through an io_uring
+class IOUringReader : public AsyncReader {
+   protected:
+    /// The mutex, a ring is only used by one batch at a time
+    std::mutex mutex_ = {};
+    /// The ring file descriptor
+    int ring_fd_ = -1;
+    /// The queue depth
+    size_t queue_depth_ = 0;
+    /// The submission ring
+    void* sq_ring_ = MAP_FAILED;
+    /// The submission ring size
+    size_t sq_ring_size_ = 0;
+    /// The completion ring
+    void* cq_ring_ = MAP_FAILED;
+    /// The completion ring size
+    size_t cq_ring_size_ = 0;
+    /// The submission queue entries
+    io_uring_sqe* sqes_ = nullptr;
+    /// The size of the submission queue entries
+    size_t sqes_size_ = 0;
+
+    /// The submission ring fields
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_mask_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    /// The completion ring fields
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned* cq_mask_ = nullptr;
+    io_uring_cqe* cqes_ = nullptr;
+
+    /// Wait for the completions of submitted reads without reporting them
+    void Drain(size_t in_flight) {
+        while (in_flight > 0) {
+            auto rc = ::syscall(__NR_io_uring_enter, ring_fd_, 0u, 1u, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (rc < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                // The kernel might still write into the buffers of the caller, there is no safe way to continue
+                std::terminate();
+            }
+            auto cq_head = *cq_head_;
+            auto cq_tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+            for (; cq_head != cq_tail && in_flight > 0; ++cq_head) --in_flight;
+            __atomic_store_n(cq_head_, cq_head, __ATOMIC_RELEASE);
+        }
+    }
+
+   public:
+    /// Destructor
+    ~IOUringReader() override {
+        if (sqes_) ::munmap(sqes_, sqes_size_);
+        if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) ::munmap(cq_ring_, cq_ring_size_);
+        if (sq_ring_ != MAP_FAILED) ::munmap(sq_ring_, sq_ring_size_);
+        if (ring_fd_ >= 0) ::close(ring_fd_);
+    }
+
+    /// Setup the ring
+    bool Setup(size_t queue_depth) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ring_fd_ = ::syscall(__NR_io_uring_setup, static_cast<unsigned>(queue_depth), &params);
+        if (ring_fd_ < 0) return false;
+        // IORING_OP_READ was added together with IORING_FEAT_RW_CUR_POS
+        if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) return false;
+        queue_depth_ = params.sq_entries;
+
+        // Map the rings
+        sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        auto single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+        sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                          IORING_OFF_SQ_RING);
+        if (sq_ring_ == MAP_FAILED) return false;
+        cq_ring_ = single_mmap ? sq_ring_
+                               : ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                        ring_fd_, IORING_OFF_CQ_RING);
+        if (cq_ring_ == MAP_FAILED) return false;
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        auto sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                           IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) return false;
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        // Resolve the ring fields
+        auto* sq = static_cast<char*>(sq_ring_);
+        sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        auto* cq = static_cast<char*>(cq_ring_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    /// Get the name of the backend
+    std::string_view GetName() const override { return "io_uring"; }
+    /// Get the maximum number of reads in flight
+    size_t GetQueueDepth() const override { return queue_depth_; }
+
+    /// Read a batch of requests
+    void Read(nonstd::span<const Request> requests, const CompletionCallback& done) override {
+        std::lock_guard<std::mutex> guard{mutex_};
+
+        // The bytes read per request, short reads are resubmitted
+        std::vector<uint32_t> progress(requests.size(), 0);
+        std::deque<size_t> resubmit;
+        size_t next_request = 0;
+        size_t in_flight = 0;
+        size_t unsubmitted = 0;
+
+        // Reads that are still in flight write into the buffers of the caller.
+        // Errors retract the entries that the kernel did not consume and wait for all others before propagating.
+        auto drain = sg::make_scope_guard([&]() noexcept {
+            __atomic_store_n(sq_tail_, *sq_tail_ - static_cast<unsigned>(unsubmitted), __ATOMIC_RELEASE);
+            Drain(in_flight - unsubmitted);
+        });
+        while (next_request < requests.size() || !resubmit.empty() || in_flight > 0) {
+            // Fill the submission queue
+            auto sq_mask = *sq_mask_;
+            auto sq_tail = *sq_tail_;
+            while (in_flight < queue_depth_ && (!resubmit.empty() || next_request < requests.size())) {
+                size_t request_id;
+                if (!resubmit.empty()) {
+                    request_id = resubmit.front();
+                    resubmit.pop_front();
+                } else {
+                    request_id = next_request++;
+                }
+                auto& request = requests[request_id];
+                auto done_bytes = progress[request_id];
+                auto index = sq_tail & sq_mask;
+                auto& sqe = sqes_[index];
+                std::memset(&sqe, 0, sizeof(sqe));
+                sqe.opcode = IORING_OP_READ;
+                sqe.fd = request.fd;
+                sqe.addr = reinterpret_cast<uint64_t>(request.buffer + done_bytes);
+                sqe.len = request.size - done_bytes;
+                sqe.off = request.offset + done_bytes;
+                sqe.user_data = request_id;
+                sq_array_[index] = index;
+                ++sq_tail;
+                ++in_flight;
+                ++unsubmitted;
+            }
+            __atomic_store_n(sq_tail_, sq_tail, __ATOMIC_RELEASE);
+
+            // Submit and wait for at least one completion
+            auto submitted = ::syscall(__NR_io_uring_enter, ring_fd_, static_cast<unsigned>(unsubmitted), 1u,
+                                       IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (submitted < 0) {
+                if (errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+                throw duckdb::IOException("io_uring_enter failed: %s", std::strerror(errno));
+            }
+            unsubmitted -= submitted;
+
+            // Reap the completions
+            auto cq_mask = *cq_mask_;
+            auto cq_head = *cq_head_;
+            auto cq_tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+            while (cq_head != cq_tail) {
+                auto& cqe = cqes_[cq_head & cq_mask];
+                auto request_id = static_cast<size_t>(cqe.user_data);
+                auto result = cqe.res;
+                // Release the entry before the callback runs, it might throw
+                __atomic_store_n(cq_head_, ++cq_head, __ATOMIC_RELEASE);
+                --in_flight;
+                if (result == -EAGAIN || result == -EINTR) {
+                    resubmit.push_back(request_id);
+                } else if (result < 0) {
+                    done(request_id, result);
+                } else {
+                    progress[request_id] += result;
+                    if (result > 0 && progress[request_id] < requests[request_id].size) {
+                        resubmit.push_back(request_id);
+                    } else {
+                        done(request_id, progress[request_id]);
+                    }
+                }
+            }
+        }
+        drain.dismiss();
+    }
+};
+
+#endif
+
+}  // namespace
+
+/// Create the best available reader
+std::unique_ptr<AsyncReader> AsyncReader::Create(size_t queue_depth) {
+    if (auto reader = CreateIOUring(queue_depth)) return reader;
+    return CreatePRead();
+}
+
+/// Create an io_uring reader
+std::unique_ptr<AsyncReader> AsyncReader::CreateIOUring(size_t queue_depth) {
+#ifdef WEBDB_IO_URING
+    auto reader = std::make_unique<IOUringReader>();
+    if (!reader->Setup(std::max<size_t>(1, queue_depth))) return nullptr;
+    return reader;
+#else
+    return nullptr;
+#endif
+}
+
+/// Create a reader that issues blocking preads
+std::unique_ptr<AsyncReader> AsyncReader::CreatePRead() {
+#ifndef EMSCRIPTEN
+    return std::make_unique<PReadReader>();
+#else
+    return nullptr;
+#endif
+}
+
+}  // namespace io
+}  // namespace web
+}  // namespace duckdb
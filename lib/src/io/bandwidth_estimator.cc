@@ -0,0 +1,104 @@
+#include "duckdb/web/io/bandwidth_estimator.h"
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace duckdb {
+namespace web {
+namespace io {
+
+namespace {
+
+/// The largest first readahead
+constexpr size_t READAHEAD_BASE_MAXIMUM = 1 << 20;  // 1 MB
+/// The number of bandwidth-delay products in a full read head
+constexpr size_t READAHEAD_BDP_FACTOR = 4;
+
+}  // namespace
+
+/// Derive the readahead sizes
+ReadAheadPolicy OriginEstimator::Estimate::GetReadAheadPolicy() const {
+    ReadAheadPolicy policy;
+    if (!IsReliable()) return policy;
+    // A read head of 4x the bandwidth-delay product spends at least 80% of its time transferring data.
+    // Fast local reads get small read heads, slow remote origins large ones.
+    auto bdp = GetBandwidthDelayProduct();
+    policy.maximum = std::clamp<size_t>(bdp * READAHEAD_BDP_FACTOR, READAHEAD_BASE, READAHEAD_MAXIMUM);
+    policy.base = std::clamp<size_t>(bdp / READAHEAD_BDP_FACTOR, READAHEAD_BASE / 4,
+                                     std::min(READAHEAD_BASE_MAXIMUM, policy.maximum));
+    return policy;
+}
+
+/// Record a completed read
+void OriginEstimator::Record(uint64_t bytes, double seconds) {
+    if (bytes == 0 || seconds <= 0) return;
+    std::unique_lock<std::mutex> guard{mutex_};
+    auto update = [](double& value, uint64_t& samples, double sample) {
+        value = (samples == 0) ? sample : (value * (1.0 - SAMPLE_WEIGHT) + sample * SAMPLE_WEIGHT);
+        ++samples;
+    };
+    if (bytes <= LATENCY_SAMPLE_LIMIT) {
+        update(estimate_.latency, estimate_.latency_samples, seconds);
+    } else {
+        // Subtract the latency but never attribute less than 10% of the time to the transfer
+        auto transfer = std::max(seconds - estimate_.latency, seconds * 0.1);
+        update(estimate_.bandwidth, estimate_.bandwidth_samples, static_cast<double>(bytes) / transfer);
+    }
+}
+
+/// Get the current estimate
+OriginEstimator::Estimate OriginEstimator::Get() const {
+    std::unique_lock<std::mutex> guard{mutex_};
+    return estimate_;
+}
+
+/// Write the estimate as JSON
+rapidjson::Value OriginEstimator::WriteInfo(rapidjson::Document& doc) const {
+    auto estimate = Get();
+    auto policy = estimate.GetReadAheadPolicy();
+    auto& allocator = doc.GetAllocator();
+    rapidjson::Value value;
+    value.SetObject();
+    value.AddMember("origin", rapidjson::Value{origin_.c_str(), static_cast<rapidjson::SizeType>(origin_.size())},
+                    allocator);
+    value.AddMember("latencyMs", estimate.latency * 1000.0, allocator);
+    value.AddMember("bytesPerSecond", estimate.bandwidth, allocator);
+    value.AddMember("latencySamples", static_cast<double>(estimate.latency_samples), allocator);
+    value.AddMember("bandwidthSamples", static_cast<double>(estimate.bandwidth_samples), allocator);
+    value.AddMember("bandwidthDelayProduct", static_cast<double>(estimate.GetBandwidthDelayProduct()), allocator);
+    value.AddMember("readAheadBase", static_cast<double>(policy.base), allocator);
+    value.AddMember("readAheadMaximum", static_cast<double>(policy.maximum), allocator);
+    return value;
+}
+
+/// Resolve the origin of a data URL
+std::string BandwidthEstimator::ResolveOrigin(std::string_view data_url) {
+    auto scheme_end = data_url.find("://");
+    if (scheme_end == std::string_view::npos) return "file";
+    auto host_end = data_url.find_first_of("/?#", scheme_end + 3);
+    return std::string{data_url.substr(0, host_end)};
+}
+
+/// Get the estimator of an origin
+OriginEstimator& BandwidthEstimator::Resolve(std::string_view origin) {
+    std::unique_lock<std::mutex> guard{mutex_};
+    std::string key{origin};
+    auto iter = origins_.find(key);
+    if (iter == origins_.end()) {
+        iter = origins_.insert({key, std::make_unique<OriginEstimator>(key)}).first;
+    }
+    return *iter->second;
+}
+
+/// Find the estimator of an origin
+const OriginEstimator* BandwidthEstimator::Find(std::string_view origin) const {
+    std::unique_lock<std::mutex> guard{mutex_};
+    auto iter = origins_.find(std::string{origin});
+    return iter == origins_.end() ? nullptr : iter->second.get();
+}
+
+}  // namespace io
+}  // namespace web
+}  // namespace duckdb
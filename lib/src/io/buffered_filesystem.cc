@@ -5,8 +5,10 @@
 #include <string>
 #include <vector>
 
+#include "duckdb/common/exception.hpp"
 #include "duckdb/common/file_system.hpp"
 #include "duckdb/web/io/buffered_filesystem.h"
+#include "duckdb/web/io/decompressed_file.h"
 #include "duckdb/web/io/file_page_buffer.h"
 #include "duckdb/web/io/web_filesystem.h"
 #include "duckdb/web/utils/parallel.h"
@@ -35,7 +37,8 @@ BufferedFileSystem::BufferedFileSystem(std::shared_ptr<FilePageBuffer> buffer_ma
     : file_page_buffer_(std::move(buffer_manager)),
       filesystem_(*file_page_buffer_->GetFileSystem()),
       directory_mutex_(),
-      file_configs_() {}
+      file_configs_(),
+      temp_filesystem_() {}
 
 /// Pass through a file
 void BufferedFileSystem::RegisterFile(std::string_view file, FileConfig config) {
@@ -53,6 +56,22 @@ bool BufferedFileSystem::TryDropFile(std::string_view file) {
     return true;
 }
 
+/// Try to drop multiple files
+std::optional<std::string_view> BufferedFileSystem::TryDropFiles(nonstd::span<const std::string_view> files) {
+    std::unique_lock<LightMutex> fs_guard{directory_mutex_};
+    for (auto file : files) {
+        if (!file_page_buffer_->CanDropFile(file)) return file;
+    }
+    for (auto file : files) {
+        if (file_page_buffer_->BuffersFile(file)) {
+            if (!file_page_buffer_->TryDropFile(file)) return file;
+            continue;
+        }
+        file_configs_.erase({std::string{file}});
+    }
+    return std::nullopt;
+}
+
 /// Drop all files
 void BufferedFileSystem::DropFiles() {
     std::unique_lock<LightMutex> fs_guard{directory_mutex_};
@@ -63,8 +82,19 @@ void BufferedFileSystem::DropFiles() {
 /// Open a file
 std::unique_ptr<duckdb::FileHandle> BufferedFileSystem::OpenFile(const string &path, uint8_t flags, FileLockType lock,
                                                                  FileCompressionType compression, FileOpener *opener) {
+    // Temporary files are never buffered
+    if (temp_filesystem_ && IsTempPath(path)) {
+        return temp_filesystem_->OpenFile(path, flags, lock, compression);
+    }
     std::unique_lock<LightMutex> fs_guard{directory_mutex_};
 
+    // Compressed files are always decompressed into the page buffer
+    auto codec = ResolveCompressionCodec(path, compression);
+    if (codec != CompressionCodec::NONE) {
+        auto file = file_page_buffer_->OpenFile(std::string_view{path}, flags, lock, codec);
+        return std::make_unique<BufferedFileHandle>(*this, std::move(file));
+    }
+
     // Bypass the buffering?
     auto iter = file_configs_.find(path);
     if ((flags & duckdb::FileFlags::FILE_FLAGS_DIRECT_IO) != 0 ||
@@ -73,7 +103,7 @@ std::unique_ptr<duckdb::FileHandle> BufferedFileSystem::OpenFile(const string &p
     }
 
     // Open in page buffer
-    auto file = file_page_buffer_->OpenFile(std::string_view{path}, flags, lock);  // XXX compression?
+    auto file = file_page_buffer_->OpenFile(std::string_view{path}, flags, lock);
     return std::make_unique<BufferedFileHandle>(*this, std::move(file));
 }
 
@@ -161,10 +191,12 @@ void BufferedFileSystem::FileSync(duckdb::FileHandle &handle) {
         return handle.Sync();
     }
 
-    // Flush the files in the page buffer
+    // Flush the dirty pages of the file and sync the inner file.
+    // Concurrent syncs are grouped by the inner filesystem.
     auto &file_hdl = static_cast<BufferedFileHandle &>(handle);
     auto &file = file_hdl.GetFile();
     file->Flush();
+    filesystem_.FileSync(file_hdl.GetFileHandle());
 }
 
 /// Returns the file size of a file handle, returns -1 on error
@@ -184,7 +216,7 @@ int64_t BufferedFileSystem::GetFileSize(duckdb::FileHandle &handle) {
 time_t BufferedFileSystem::GetLastModifiedTime(duckdb::FileHandle &handle) {
     // Direct I/O?
     if (&handle.file_system != this) {
-        return filesystem_.GetLastModifiedTime(handle);
+        return handle.file_system.GetLastModifiedTime(handle);
     }
     auto &buffered_hdl = static_cast<BufferedFileHandle &>(handle);
     return filesystem_.GetLastModifiedTime(buffered_hdl.GetFileHandle());
@@ -194,25 +226,38 @@ time_t BufferedFileSystem::GetLastModifiedTime(duckdb::FileHandle &handle) {
 void BufferedFileSystem::Truncate(duckdb::FileHandle &handle, int64_t new_size) {
     // Direct I/O?
     if (&handle.file_system != this) {
-        return filesystem_.Truncate(handle, new_size);
+        return handle.file_system.Truncate(handle, new_size);
     }
     auto &buffered_hdl = static_cast<BufferedFileHandle &>(handle);
     return buffered_hdl.GetFile()->Truncate(new_size);
 }
 /// Recursively remove a directory and all files in it
 void BufferedFileSystem::RemoveDirectory(const std::string &directory) {
-    return filesystem_.RemoveDirectory(directory);
+    return ResolveFileSystem(directory).RemoveDirectory(directory);
 }
 
 /// Move a file from source path to the target, StorageManager relies on this being an atomic action for ACID
 /// properties
 void BufferedFileSystem::MoveFile(const std::string &source, const std::string &target) {
-    // XXX Invalidate buffer manager!
+    if (temp_filesystem_ && IsTempPath(source) && IsTempPath(target)) {
+        return temp_filesystem_->MoveFile(source, target);
+    }
+    // Flush and drop the buffered pages of both files
+    if (!file_page_buffer_->TryDropFile(source) || !file_page_buffer_->TryDropFile(target)) {
+        throw duckdb::IOException("Cannot move file %s to %s while it is still opened", source.c_str(),
+                                  target.c_str());
+    }
     return filesystem_.MoveFile(source, target);
 }
 /// Remove a file from disk
 void BufferedFileSystem::RemoveFile(const std::string &filename) {
-    // XXX Invalidate buffer manager!
+    if (temp_filesystem_ && IsTempPath(filename)) {
+        return temp_filesystem_->RemoveFile(filename);
+    }
+    // Drop the buffered pages of the file
+    if (!file_page_buffer_->TryDropFile(filename)) {
+        throw duckdb::IOException("Cannot remove file %s while it is still opened", filename.c_str());
+    }
     return filesystem_.RemoveFile(filename);
 }
 
@@ -256,7 +301,7 @@ bool BufferedFileSystem::CanSeek() { return true; }
 bool BufferedFileSystem::OnDiskFile(duckdb::FileHandle &handle) {
     // Direct I/O?
     if (&handle.file_system != this) {
-        return filesystem_.OnDiskFile(handle);
+        return handle.file_system.OnDiskFile(handle);
     }
     return filesystem_.OnDiskFile(static_cast<BufferedFileHandle &>(handle).GetFileHandle());
 }
@@ -0,0 +1,684 @@
+#include "duckdb/web/io/decompressed_file.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "miniz.hpp"
+#include "zstd.h"
+
+namespace duckdb {
+namespace web {
+namespace io {
+
+namespace {
+
+/// The distance between two gzip checkpoints in decompressed bytes
+constexpr uint64_t GZIP_CHECKPOINT_DISTANCE = 4 << 20;
+/// The size of compressed gzip reads
+constexpr size_t GZIP_INPUT_SIZE = 64 << 10;
+/// The size of the inflate window
+constexpr size_t GZIP_WINDOW_SIZE = duckdb_miniz::TINFL_LZ_DICT_SIZE;
+/// The initial size of compressed zstd reads while indexing frames
+constexpr size_t ZSTD_INDEX_READ_SIZE = 1 << 20;
+/// The decompressed size of zstd frames that are streamed instead of being decoded and cached as a whole
+constexpr uint64_t ZSTD_STREAMED_FRAME_SIZE = 8 << 20;
+/// The decompressed bytes of the cached zstd frames
+constexpr uint64_t ZSTD_FRAME_CACHE_SIZE = 32 << 20;
+
+/// Does a string end with a suffix?
+bool EndsWith(std::string_view text, std::string_view suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+/// Decompress independent tasks on up to `threads` threads.
+/// Exceptions are rethrown on the calling thread.
+void ParallelFor(size_t tasks, size_t threads, const std::function<void(size_t)>& fn) {
+    std::vector<std::exception_ptr> errors(tasks);
+    std::atomic<size_t> next_task = 0;
+    auto work = [&]() {
+        for (auto task_id = next_task++; task_id < tasks; task_id = next_task++) {
+            try {
+                fn(task_id);
+            } catch (...) {
+                errors[task_id] = std::current_exception();
+            }
+        }
+    };
+    threads = std::max<size_t>(1, std::min(threads, tasks));
+#ifndef DUCKDB_NO_THREADS
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+#else
+    work();
+#endif
+    for (auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+/// The inflate state of a gzip file at a decompressed offset
+struct GzipState {
+    /// The compressed offset of the next input byte
+    uint64_t in_offset = 0;
+    /// The decompressed offset
+    uint64_t out_offset = 0;
+    /// Does a new gzip member start at the input offset?
+    bool member_start = true;
+    /// The inflate state
+    std::unique_ptr<duckdb_miniz::tinfl_decompressor> inflate = nullptr;
+    /// The inflate window that holds the last decompressed bytes
+    std::unique_ptr<uint8_t[]> window = nullptr;
+    /// The write offset in the window
+    size_t window_offset = 0;
+    /// The number of valid bytes in the window
+    size_t window_fill = 0;
+
+    /// Copy the state
+    void CopyFrom(const GzipState& other) {
+        in_offset = other.in_offset;
+        out_offset = other.out_offset;
+        member_start = other.member_start;
+        window_offset = other.window_offset;
+        window_fill = other.window_fill;
+        if (other.inflate) {
+            if (!inflate) inflate = std::make_unique<duckdb_miniz::tinfl_decompressor>();
+            *inflate = *other.inflate;
+        } else {
+            inflate.reset();
+        }
+        if (other.window) {
+            if (!window) window = std::unique_ptr<uint8_t[]>(new uint8_t[GZIP_WINDOW_SIZE]);
+            std::memcpy(window.get(), other.window.get(), GZIP_WINDOW_SIZE);
+        } else {
+            window_fill = 0;
+        }
+    }
+};
+
+/// A decompressed gzip file
+class GzipFile : public DecompressedFile {
+   protected:
+    /// The mutex
+    std::mutex mutex_ = {};
+    /// The checkpoints ordered by their decompressed offset
+    std::vector<GzipState> checkpoints_ = {};
+    /// The cursor of the sequential decoder
+    GzipState cursor_ = {};
+    /// Did the cursor reach the end of the file?
+    bool cursor_eof_ = false;
+    /// The decompressed size (if known)
+    std::optional<uint64_t> size_ = std::nullopt;
+    /// The input buffer
+    std::unique_ptr<uint8_t[]> input_ = std::unique_ptr<uint8_t[]>(new uint8_t[GZIP_INPUT_SIZE]);
+    /// The read position in the input buffer, corresponds to the input offset of the cursor
+    size_t input_pos_ = 0;
+    /// The end of the input buffer
+    size_t input_end_ = 0;
+
+    /// Is there more input after the input buffer?
+    bool HasMoreInput() const { return cursor_.in_offset + (input_end_ - input_pos_) < compressed_size_; }
+    /// Read a single input byte
+    bool ReadByte(uint8_t& byte);
+    /// Read a gzip member header, returns false at the end of the file
+    bool ReadMemberHeader();
+    /// Restore a checkpoint
+    void Restore(const GzipState& checkpoint);
+    /// Remember a checkpoint if the cursor passed the indexed range
+    void MaybeCheckpoint();
+    /// Copy bytes from the window of the cursor
+    void CopyFromWindow(char* out, uint64_t offset, uint64_t n);
+    /// Decompress the next chunk, returns false at the end of the file
+    template <typename Fn> bool Step(Fn emit);
+
+   public:
+    /// Constructor
+    GzipFile(duckdb::FileSystem& filesystem, duckdb::FileHandle& handle) : DecompressedFile(filesystem, handle) {
+        checkpoints_.emplace_back();
+    }
+
+    /// Get the decompressed size
+    uint64_t GetSize() override;
+    /// Read decompressed bytes
+    uint64_t Read(char* out, uint64_t n, uint64_t offset) override;
+};
+
+/// Read a single input byte
+bool GzipFile::ReadByte(uint8_t& byte) {
+    if (input_pos_ == input_end_) {
+        input_pos_ = 0;
+        input_end_ = std::min<uint64_t>(GZIP_INPUT_SIZE, compressed_size_ - cursor_.in_offset);
+        ReadCompressed(input_.get(), input_end_, cursor_.in_offset);
+        if (input_end_ == 0) return false;
+    }
+    byte = input_[input_pos_++];
+    ++cursor_.in_offset;
+    return true;
+}
+
+/// Read a gzip member header
+bool GzipFile::ReadMemberHeader() {
+    auto first_member = cursor_.in_offset == 0;
+    uint8_t header[10];
+    for (size_t i = 0; i < sizeof(header); ++i) {
+        if (!ReadByte(header[i])) {
+            if (!first_member) return false;
+            throw duckdb::IOException("truncated gzip header in file %s", handle_.path.c_str());
+        }
+        // Tolerate trailing garbage after the first member like gzip does
+        if (i == 1 && (header[0] != 0x1F || header[1] != 0x8B)) {
+            if (!first_member) return false;
+            throw duckdb::IOException("file %s is not a gzip file", handle_.path.c_str());
+        }
+    }
+    if (header[2] != 8) {
+        throw duckdb::IOException("unsupported gzip compression method in file %s", handle_.path.c_str());
+    }
+    auto skip = [&](size_t n) {
+        uint8_t byte;
+        for (size_t i = 0; i < n; ++i) {
+            if (!ReadByte(byte)) throw duckdb::IOException("truncated gzip header in file %s", handle_.path.c_str());
+        }
+    };
+    auto skip_string = [&]() {
+        uint8_t byte = 1;
+        while (byte != 0) {
+            if (!ReadByte(byte)) throw duckdb::IOException("truncated gzip header in file %s", handle_.path.c_str());
+        }
+    };
+    auto flags = header[3];
+    if (flags & 0x04) {
+        uint8_t xlen[2];
+        if (!ReadByte(xlen[0]) || !ReadByte(xlen[1])) {
+            throw duckdb::IOException("truncated gzip header in file %s", handle_.path.c_str());
+        }
+        skip(xlen[0] | (xlen[1] << 8));
+    }
+    if (flags & 0x08) skip_string();
+    if (flags & 0x10) skip_string();
+    if (flags & 0x02) skip(2);
+    return true;
+}
+
+/// Restore a checkpoint
+void GzipFile::Restore(const GzipState& checkpoint) {
+    cursor_.CopyFrom(checkpoint);
+    cursor_eof_ = false;
+    input_pos_ = 0;
+    input_end_ = 0;
+}
+
+/// Remember a checkpoint if the cursor passed the indexed range
+void GzipFile::MaybeCheckpoint() {
+    if (cursor_.out_offset < checkpoints_.back().out_offset + GZIP_CHECKPOINT_DISTANCE) return;
+    checkpoints_.emplace_back();
+    checkpoints_.back().CopyFrom(cursor_);
+}
+
+/// Copy bytes from the window of the cursor
+void GzipFile::CopyFromWindow(char* out, uint64_t offset, uint64_t n) {
+    auto back = cursor_.out_offset - offset;
+    assert(back <= cursor_.window_fill && n <= back);
+    auto pos = (cursor_.window_offset + GZIP_WINDOW_SIZE - back) & (GZIP_WINDOW_SIZE - 1);
+    auto first = std::min<uint64_t>(n, GZIP_WINDOW_SIZE - pos);
+    std::memcpy(out, cursor_.window.get() + pos, first);
+    std::memcpy(out + first, cursor_.window.get(), n - first);
+}
+
+/// Decompress the next chunk
+template <typename Fn> bool GzipFile::Step(Fn emit) {
+    if (cursor_eof_) return false;
+
+    // Start a new member?
+    if (cursor_.member_start) {
+        if (!ReadMemberHeader()) {
+            cursor_eof_ = true;
+            return false;
+        }
+        if (!cursor_.inflate) cursor_.inflate = std::make_unique<duckdb_miniz::tinfl_decompressor>();
+        if (!cursor_.window) cursor_.window = std::unique_ptr<uint8_t[]>(new uint8_t[GZIP_WINDOW_SIZE]);
+        tinfl_init(cursor_.inflate.get());
+        cursor_.member_start = false;
+    }
+
+    // Refill the input buffer
+    if (input_pos_ == input_end_) {
+        input_pos_ = 0;
+        input_end_ = std::min<uint64_t>(GZIP_INPUT_SIZE, compressed_size_ - cursor_.in_offset);
+        ReadCompressed(input_.get(), input_end_, cursor_.in_offset);
+    }
+
+    // Inflate into the circular window
+    size_t in_size = input_end_ - input_pos_;
+    size_t out_size = GZIP_WINDOW_SIZE - cursor_.window_offset;
+    auto flags = HasMoreInput() ? duckdb_miniz::TINFL_FLAG_HAS_MORE_INPUT : 0;
+    auto status = duckdb_miniz::tinfl_decompress(cursor_.inflate.get(), input_.get() + input_pos_, &in_size,
+                                                 cursor_.window.get(), cursor_.window.get() + cursor_.window_offset,
+                                                 &out_size, flags);
+    input_pos_ += in_size;
+    cursor_.in_offset += in_size;
+    if (out_size > 0) {
+        emit(cursor_.window.get() + cursor_.window_offset, out_size, cursor_.out_offset);
+        cursor_.out_offset += out_size;
+        cursor_.window_offset = (cursor_.window_offset + out_size) & (GZIP_WINDOW_SIZE - 1);
+        cursor_.window_fill = std::min<size_t>(GZIP_WINDOW_SIZE, cursor_.window_fill + out_size);
+    }
+
+    // Finished the member?
+    if (status == duckdb_miniz::TINFL_STATUS_DONE) {
+        // Skip the CRC32 and ISIZE trailer
+        uint8_t byte;
+        for (size_t i = 0; i < 8; ++i) {
+            if (!ReadByte(byte)) throw duckdb::IOException("truncated gzip trailer in file %s", handle_.path.c_str());
+        }
+        cursor_.member_start = true;
+    } else if (status < 0) {
+        throw duckdb::IOException("corrupt gzip data in file %s", handle_.path.c_str());
+    }
+    return true;
+}
+
+/// Get the decompressed size
+uint64_t GzipFile::GetSize() {
+    std::lock_guard<std::mutex> guard{mutex_};
+    if (size_) return *size_;
+    // Decompress the rest of the file to index it
+    if (cursor_.out_offset < checkpoints_.back().out_offset) Restore(checkpoints_.back());
+    while (Step([](const uint8_t*, size_t, uint64_t) {})) {
+        MaybeCheckpoint();
+    }
+    size_ = cursor_.out_offset;
+    return *size_;
+}
+
+/// Read decompressed bytes
+uint64_t GzipFile::Read(char* out, uint64_t n, uint64_t offset) {
+    std::lock_guard<std::mutex> guard{mutex_};
+    auto end = offset + n;
+    if (size_) end = std::min(end, *size_);
+    if (offset >= end) return 0;
+
+    // Can we continue with the cursor?
+    // The cursor may either be slightly ahead and still have the bytes in its window or behind the offset.
+    auto history_begin = cursor_.out_offset - cursor_.window_fill;
+    if (offset < history_begin || offset > cursor_.out_offset) {
+        auto iter = std::upper_bound(checkpoints_.begin(), checkpoints_.end(), offset,
+                                     [](uint64_t o, const GzipState& s) { return o < s.out_offset; });
+        assert(iter != checkpoints_.begin());
+        --iter;
+        if (cursor_.out_offset > offset || cursor_.out_offset < iter->out_offset) {
+            Restore(*iter);
+        }
+    }
+
+    // Copy the bytes that are still in the window
+    auto copied_until = offset;
+    if (offset < cursor_.out_offset) {
+        auto history = std::min(cursor_.out_offset, end) - offset;
+        CopyFromWindow(out, offset, history);
+        copied_until += history;
+    }
+
+    // Decompress the remaining bytes
+    while (copied_until < end) {
+        auto more = Step([&](const uint8_t* data, size_t data_size, uint64_t data_offset) {
+            auto begin = std::max(data_offset, copied_until);
+            auto until = std::min(data_offset + data_size, end);
+            if (begin >= until) return;
+            std::memcpy(out + (begin - offset), data + (begin - data_offset), until - begin);
+            copied_until = until;
+        });
+        MaybeCheckpoint();
+        if (!more) {
+            size_ = cursor_.out_offset;
+            break;
+        }
+    }
+    return copied_until - offset;
+}
+
+/// A zstd frame
+struct ZstdFrame {
+    /// The compressed offset
+    uint64_t compressed_offset;
+    /// The compressed size
+    uint64_t compressed_size;
+    /// The decompressed offset
+    uint64_t offset;
+    /// The decompressed size
+    uint64_t size;
+};
+
+/// A decompressed zstd file.
+/// Small frames are decoded in parallel and cached within a byte budget.
+/// Large frames are read with a streaming decoder that continues sequential reads and restarts the frame otherwise.
+class ZstdFile : public DecompressedFile {
+   protected:
+    using DStreamPtr = std::unique_ptr<duckdb_zstd::ZSTD_DStream, decltype(&duckdb_zstd::ZSTD_freeDStream)>;
+
+    /// The mutex
+    std::mutex mutex_ = {};
+    /// The number of threads
+    size_t threads_;
+    /// Were the frames indexed?
+    bool indexed_ = false;
+    /// The frames
+    std::vector<ZstdFrame> frames_ = {};
+    /// The decompressed size
+    uint64_t size_ = 0;
+    /// The decoded frames, most recently used first
+    std::list<std::pair<size_t, std::vector<char>>> decoded_frames_ = {};
+    /// The decompressed bytes of the decoded frames
+    uint64_t decoded_bytes_ = 0;
+
+    /// The streaming decoder (if any)
+    DStreamPtr stream_{nullptr, &duckdb_zstd::ZSTD_freeDStream};
+    /// The frame of the streaming decoder
+    size_t stream_frame_id_ = 0;
+    /// The compressed offset of the next input of the streaming decoder
+    uint64_t stream_in_offset_ = 0;
+    /// The decompressed offset of the streaming decoder
+    uint64_t stream_out_offset_ = 0;
+    /// Is the streaming decoder positioned in a frame?
+    bool stream_active_ = false;
+    /// The input buffer of the streaming decoder
+    std::vector<char> stream_input_ = {};
+    /// The read position in the input buffer
+    size_t stream_input_pos_ = 0;
+    /// The output buffer of the streaming decoder
+    std::vector<char> stream_output_ = {};
+
+    /// Index the frames
+    void IndexFrames();
+    /// Count the decompressed bytes of a frame with unknown size
+    uint64_t CountStreaming(const char* data, size_t n);
+    /// Read decompressed bytes of a large frame with the streaming decoder
+    void ReadStreaming(size_t frame_id, char* out, uint64_t begin, uint64_t end);
+    /// Find a decoded frame
+    std::vector<char>* FindDecodedFrame(size_t frame_id);
+    /// Is a frame streamed?
+    bool IsStreamed(const ZstdFrame& frame) const { return frame.size > ZSTD_STREAMED_FRAME_SIZE; }
+
+   public:
+    /// Constructor
+    ZstdFile(duckdb::FileSystem& filesystem, duckdb::FileHandle& handle, size_t threads)
+        : DecompressedFile(filesystem, handle), threads_(std::max<size_t>(1, threads)) {}
+
+    /// Get the decompressed size
+    uint64_t GetSize() override;
+    /// Read decompressed bytes
+    uint64_t Read(char* out, uint64_t n, uint64_t offset) override;
+};
+
+/// Count the decompressed bytes of a frame with unknown size
+uint64_t ZstdFile::CountStreaming(const char* data, size_t n) {
+    DStreamPtr stream{duckdb_zstd::ZSTD_createDStream(), &duckdb_zstd::ZSTD_freeDStream};
+    duckdb_zstd::ZSTD_initDStream(stream.get());
+    std::vector<char> buffer(duckdb_zstd::ZSTD_DStreamOutSize());
+    uint64_t size = 0;
+    duckdb_zstd::ZSTD_inBuffer in{data, n, 0};
+    while (true) {
+        duckdb_zstd::ZSTD_outBuffer out{buffer.data(), buffer.size(), 0};
+        auto rc = duckdb_zstd::ZSTD_decompressStream(stream.get(), &out, &in);
+        if (duckdb_zstd::ZSTD_isError(rc)) {
+            throw duckdb::IOException("corrupt zstd frame in file %s: %s", handle_.path.c_str(),
+                                      duckdb_zstd::ZSTD_getErrorName(rc));
+        }
+        size += out.pos;
+        if (rc == 0) break;
+        if (in.pos == in.size && out.pos == 0) {
+            throw duckdb::IOException("truncated zstd frame in file %s", handle_.path.c_str());
+        }
+    }
+    return size;
+}
+
+/// Read decompressed bytes of a large frame with the streaming decoder.
+/// Sequential reads continue the decoder, reads behind it restart the frame.
+void ZstdFile::ReadStreaming(size_t frame_id, char* out, uint64_t begin, uint64_t end) {
+    auto& frame = frames_[frame_id];
+    auto frame_end = frame.compressed_offset + frame.compressed_size;
+    if (!stream_active_ || stream_frame_id_ != frame_id || stream_out_offset_ > begin) {
+        if (!stream_) {
+            stream_.reset(duckdb_zstd::ZSTD_createDStream());
+            stream_input_.resize(duckdb_zstd::ZSTD_DStreamInSize());
+            stream_output_.resize(duckdb_zstd::ZSTD_DStreamOutSize());
+        }
+        duckdb_zstd::ZSTD_initDStream(stream_.get());
+        stream_frame_id_ = frame_id;
+        stream_in_offset_ = frame.compressed_offset;
+        stream_out_offset_ = frame.offset;
+        stream_input_pos_ = 0;
+        stream_input_.resize(0);
+        stream_active_ = true;
+    }
+    while (stream_out_offset_ < end) {
+        // Refill the input buffer
+        if (stream_input_pos_ == stream_input_.size()) {
+            stream_input_.resize(duckdb_zstd::ZSTD_DStreamInSize());
+            auto n = ReadCompressed(stream_input_.data(),
+                                    std::min<uint64_t>(stream_input_.size(), frame_end - stream_in_offset_),
+                                    stream_in_offset_);
+            stream_input_.resize(n);
+            stream_input_pos_ = 0;
+            stream_in_offset_ += n;
+        }
+        duckdb_zstd::ZSTD_inBuffer in{stream_input_.data(), stream_input_.size(), stream_input_pos_};
+        duckdb_zstd::ZSTD_outBuffer chunk{stream_output_.data(), stream_output_.size(), 0};
+        auto rc = duckdb_zstd::ZSTD_decompressStream(stream_.get(), &chunk, &in);
+        stream_input_pos_ = in.pos;
+        if (duckdb_zstd::ZSTD_isError(rc)) {
+            stream_active_ = false;
+            throw duckdb::IOException("corrupt zstd frame in file %s: %s", handle_.path.c_str(),
+                                      duckdb_zstd::ZSTD_getErrorName(rc));
+        }
+
+        // Copy the requested bytes of the chunk
+        auto chunk_begin = stream_out_offset_;
+        auto copy_begin = std::max(chunk_begin, begin);
+        auto copy_end = std::min(chunk_begin + chunk.pos, end);
+        if (copy_begin < copy_end) {
+            std::memcpy(out + (copy_begin - begin), stream_output_.data() + (copy_begin - chunk_begin),
+                        copy_end - copy_begin);
+        }
+        stream_out_offset_ += chunk.pos;
+        if (chunk.pos == 0 && in.pos == in.size && stream_in_offset_ >= frame_end) {
+            stream_active_ = false;
+            throw duckdb::IOException("truncated zstd frame in file %s", handle_.path.c_str());
+        }
+    }
+}
+
+/// Index the frames
+void ZstdFile::IndexFrames() {
+    if (indexed_) return;
+    std::vector<char> buffer;
+    uint64_t buffer_offset = 0;
+    size_t read_size = ZSTD_INDEX_READ_SIZE;
+    uint64_t offset = 0;
+    while (offset < compressed_size_) {
+        // Try to find the frame in the buffer
+        auto buffer_end = buffer_offset + buffer.size();
+        if (offset >= buffer_offset && offset < buffer_end) {
+            auto* frame_data = buffer.data() + (offset - buffer_offset);
+            auto avail = buffer_end - offset;
+            auto frame_size = duckdb_zstd::ZSTD_findFrameCompressedSize(frame_data, avail);
+            if (!duckdb_zstd::ZSTD_isError(frame_size)) {
+                auto size = duckdb_zstd::ZSTD_getFrameContentSize(frame_data, avail);
+                if (size == ZSTD_CONTENTSIZE_ERROR) {
+                    throw duckdb::IOException("corrupt zstd frame header in file %s", handle_.path.c_str());
+                }
+                if (size == ZSTD_CONTENTSIZE_UNKNOWN) {
+                    size = CountStreaming(frame_data, frame_size);
+                }
+                frames_.push_back({offset, frame_size, size_, size});
+                offset += frame_size;
+                size_ += size;
+                continue;
+            }
+            if (buffer_end >= compressed_size_) {
+                throw duckdb::IOException("corrupt zstd file %s: %s", handle_.path.c_str(),
+                                          duckdb_zstd::ZSTD_getErrorName(frame_size));
+            }
+            // The frame is larger than the buffer, read more
+            if (offset == buffer_offset) read_size *= 2;
+        }
+        buffer.resize(std::min<uint64_t>(read_size, compressed_size_ - offset));
+        buffer_offset = offset;
+        ReadCompressed(buffer.data(), buffer.size(), offset);
+    }
+    indexed_ = true;
+}
+
+/// Find a decoded frame
+std::vector<char>* ZstdFile::FindDecodedFrame(size_t frame_id) {
+    for (auto iter = decoded_frames_.begin(); iter != decoded_frames_.end(); ++iter) {
+        if (iter->first == frame_id) {
+            decoded_frames_.splice(decoded_frames_.begin(), decoded_frames_, iter);
+            return &decoded_frames_.front().second;
+        }
+    }
+    return nullptr;
+}
+
+/// Get the decompressed size
+uint64_t ZstdFile::GetSize() {
+    std::lock_guard<std::mutex> guard{mutex_};
+    IndexFrames();
+    return size_;
+}
+
+/// Read decompressed bytes
+uint64_t ZstdFile::Read(char* out, uint64_t n, uint64_t offset) {
+    std::lock_guard<std::mutex> guard{mutex_};
+    IndexFrames();
+    auto end = std::min(offset + n, size_);
+    if (offset >= end) return 0;
+
+    // Find the frames that overlap the range
+    auto first = std::upper_bound(frames_.begin(), frames_.end(), offset,
+                                  [](uint64_t o, const ZstdFrame& f) { return o < f.offset; }) -
+                 frames_.begin() - 1;
+    auto last = std::upper_bound(frames_.begin(), frames_.end(), end - 1,
+                                 [](uint64_t o, const ZstdFrame& f) { return o < f.offset; }) -
+                frames_.begin() - 1;
+
+    // Decode missing frames in parallel and read ahead with the remaining threads
+    auto decode_end = std::min<size_t>(frames_.size(), std::max<size_t>(last + 1, first + threads_));
+    std::vector<size_t> missing;
+    for (auto frame_id = static_cast<size_t>(first); frame_id < decode_end; ++frame_id) {
+        if (!IsStreamed(frames_[frame_id]) && !FindDecodedFrame(frame_id)) missing.push_back(frame_id);
+    }
+    if (!missing.empty()) {
+        // Read the compressed frames sequentially, decompress them in parallel
+        std::vector<std::vector<char>> compressed(missing.size());
+        std::vector<std::vector<char>> decoded(missing.size());
+        for (size_t i = 0; i < missing.size(); ++i) {
+            auto& frame = frames_[missing[i]];
+            compressed[i].resize(frame.compressed_size);
+            ReadCompressed(compressed[i].data(), frame.compressed_size, frame.compressed_offset);
+        }
+        ParallelFor(missing.size(), threads_, [&](size_t i) {
+            auto& frame = frames_[missing[i]];
+            decoded[i].resize(frame.size);
+            if (frame.size == 0) return;
+            auto rc = duckdb_zstd::ZSTD_decompress(decoded[i].data(), frame.size, compressed[i].data(),
+                                                   compressed[i].size());
+            if (duckdb_zstd::ZSTD_isError(rc) || rc != frame.size) {
+                throw duckdb::IOException("corrupt zstd frame in file %s", handle_.path.c_str());
+            }
+        });
+        for (size_t i = 0; i < missing.size(); ++i) {
+            decoded_bytes_ += decoded[i].size();
+            decoded_frames_.emplace_back(missing[i], std::move(decoded[i]));
+        }
+    }
+
+    // Copy the decoded bytes
+    auto writer = out;
+    for (auto frame_id = static_cast<size_t>(first); frame_id <= static_cast<size_t>(last); ++frame_id) {
+        auto& frame = frames_[frame_id];
+        auto begin = std::max(offset, frame.offset);
+        auto until = std::min(end, frame.offset + frame.size);
+        if (IsStreamed(frame)) {
+            ReadStreaming(frame_id, writer, begin, until);
+        } else {
+            auto* data = FindDecodedFrame(frame_id);
+            assert(data);
+            std::memcpy(writer, data->data() + (begin - frame.offset), until - begin);
+        }
+        writer += until - begin;
+    }
+
+    // Keep the most recently used frames within the cache budget.
+    // The frames of a single read may exceed it, they are at most one frame per thread.
+    while (decoded_frames_.size() > decode_end - first && decoded_bytes_ > ZSTD_FRAME_CACHE_SIZE) {
+        decoded_bytes_ -= decoded_frames_.back().second.size();
+        decoded_frames_.pop_back();
+    }
+    return end - offset;
+}
+
+}  // namespace
+
+/// Resolve the compression codec of a file
+CompressionCodec ResolveCompressionCodec(std::string_view path, duckdb::FileCompressionType compression) {
+    switch (compression) {
+        case duckdb::FileCompressionType::UNCOMPRESSED:
+            return CompressionCodec::NONE;
+        case duckdb::FileCompressionType::GZIP:
+            return CompressionCodec::GZIP;
+        default:
+            break;
+    }
+    if (EndsWith(path, ".gz") || EndsWith(path, ".gzip")) return CompressionCodec::GZIP;
+    if (EndsWith(path, ".zst") || EndsWith(path, ".zstd")) return CompressionCodec::ZSTD;
+    return CompressionCodec::NONE;
+}
+
+/// Constructor
+DecompressedFile::DecompressedFile(duckdb::FileSystem& filesystem, duckdb::FileHandle& handle)
+    : filesystem_(filesystem), handle_(handle), compressed_size_(filesystem.GetFileSize(handle)) {}
+
+/// Read compressed bytes
+size_t DecompressedFile::ReadCompressed(void* out, size_t n, uint64_t offset) {
+    n = std::min<uint64_t>(n, compressed_size_ - std::min(offset, compressed_size_));
+    if (n > 0) filesystem_.Read(handle_, out, n, offset);
+    return n;
+}
+
+/// Open a decompressed view on a file handle
+std::unique_ptr<DecompressedFile> DecompressedFile::Open(duckdb::FileSystem& filesystem, duckdb::FileHandle& handle,
+                                                         CompressionCodec codec, size_t threads) {
+    switch (codec) {
+        case CompressionCodec::GZIP:
+            return std::make_unique<GzipFile>(filesystem, handle);
+        case CompressionCodec::ZSTD:
+            return std::make_unique<ZstdFile>(filesystem, handle, threads);
+        case CompressionCodec::NONE:
+            break;
+    }
+    return nullptr;
+}
+
+}  // namespace io
+}  // namespace web
+}  // namespace duckdb
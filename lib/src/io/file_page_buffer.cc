@@ -1,5 +1,6 @@
 #include "duckdb/web/io/file_page_buffer.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <cstring>
@@ -63,15 +64,25 @@ FilePageBuffer::BufferRef::BufferRef(FileRef& file, SharedFileGuard&& file_guard
                                      FrameGuardVariant frame_guard)
     : file_(&file), file_guard_(std::move(file_guard)), frame_(&frame), frame_guard_(std::move(frame_guard)) {}
 
+/// Constructor
+FilePageBuffer::BufferRef::BufferRef(FileRef& file, SharedFileGuard&& file_guard, nonstd::span<char> mapped_data)
+    : file_(&file), file_guard_(std::move(file_guard)), frame_(nullptr), frame_guard_(), mapped_data_(mapped_data) {}
+
 /// Mark a buffer ref as dirty
 void FilePageBuffer::BufferRef::MarkAsDirty() {
-    if ((file_->file_->file_flags & duckdb::FileFlags::FILE_FLAGS_WRITE) == 0) {
+    if ((file_->file_->file_flags & duckdb::FileFlags::FILE_FLAGS_WRITE) == 0 || !frame_) {
         throw std::runtime_error("File is not opened in write mode");
     }
     frame_->is_dirty = true;
 }
 /// Release a buffer ref
 void FilePageBuffer::BufferRef::Release() {
+    // Mapped data only holds the file guard
+    if (mapped_data_.data()) {
+        mapped_data_ = {};
+        if (file_guard_.owns_lock()) file_guard_.unlock();
+        return;
+    }
     if (!frame_) return;
     // Decrease user count and mark as dirty with directory latch.
     // Destructor will then release the frame guard variant.
@@ -96,7 +107,8 @@ void FilePageBuffer::FileRef::LoadFrame(FilePageBuffer::BufferFrame& frame, File
     auto page_size = buffer_.GetPageSize();
 
     // Determine the actual size of the frame
-    frame.data_size = std::min<uint64_t>(file_->file_size - page_id * page_size, buffer_.GetPageSize());
+    auto page_begin = std::min<uint64_t>(file_->file_size, page_id * page_size);
+    frame.data_size = std::min<uint64_t>(file_->file_size - page_begin, buffer_.GetPageSize());
     frame.is_dirty = false;
 
     // Register a page load
@@ -107,7 +119,11 @@ void FilePageBuffer::FileRef::LoadFrame(FilePageBuffer::BufferFrame& frame, File
     // Read data into frame
     assert(frame.data_size <= buffer_.GetPageSize());
     dir_guard.unlock();
-    buffer_.filesystem->Read(GetHandle(), frame.buffer.get(), frame.data_size, page_id * page_size);
+    if (file_->decompressed) {
+        file_->decompressed->Read(frame.buffer.get(), frame.data_size, page_id * page_size);
+    } else {
+        buffer_.filesystem->Read(GetHandle(), frame.buffer.get(), frame.data_size, page_id * page_size);
+    }
     dir_guard.lock();
 
     // Register as loaded
@@ -207,16 +223,39 @@ void FilePageBuffer::FileRef::Flush(FileGuardRefVariant file_guard) {
 /// Constructor
 FilePageBuffer::FilePageBuffer(std::shared_ptr<duckdb::FileSystem> filesystem, uint64_t page_capacity,
                                uint64_t page_size_bits)
-    : page_size_bits(page_size_bits), page_capacity(page_capacity), filesystem(std::move(filesystem)) {}
+    : page_size_bits(page_size_bits),
+      page_capacity(page_capacity),
+      max_page_capacity(page_capacity),
+      filesystem(std::move(filesystem)) {}
 
 /// Destructor
 FilePageBuffer::~FilePageBuffer() { FlushFiles(); }
 
 std::unique_ptr<FilePageBuffer::FileRef> FilePageBuffer::OpenFile(std::string_view path, uint8_t flags,
-                                                                  duckdb::FileLockType lock_type) {
+                                                                  duckdb::FileLockType lock_type,
+                                                                  CompressionCodec codec) {
     DEBUG_TRACE();
+    // Compressed files can only be read
+    if (codec != CompressionCodec::NONE && (flags & duckdb::FileFlags::FILE_FLAGS_WRITE) != 0) {
+        std::string path_buf{path};
+        throw duckdb::IOException("Compressed file %s cannot be opened for writing", path_buf.c_str());
+    }
     auto dir_guard = Lock();
 
+    // Index compressed files without holding the directory latch.
+    // The decompressed size is only known after scanning the file once.
+    std::unique_ptr<duckdb::FileHandle> compressed_handle;
+    std::unique_ptr<DecompressedFile> decompressed;
+    uint64_t decompressed_size = 0;
+    while (codec != CompressionCodec::NONE && !decompressed && files_by_name.find(path) == files_by_name.end()) {
+        dir_guard.unlock();
+        std::string path_buf{path};
+        compressed_handle = filesystem->OpenFile(path_buf.c_str(), flags);
+        decompressed = DecompressedFile::Open(*filesystem, *compressed_handle, codec, decompression_threads_);
+        decompressed_size = decompressed->GetSize();
+        dir_guard.lock();
+    }
+
     // Already added?
     if (auto it = files_by_name.find(path); it != files_by_name.end()) {
         auto* file = it->second;
@@ -228,6 +267,12 @@ std::unique_ptr<FilePageBuffer::FileRef> FilePageBuffer::OpenFile(std::string_vi
             throw duckdb::IOException("File %s is already locked exclusively", path_buf.c_str());
         }
 
+        // Opened with a different compression?
+        if (file->codec != codec) {
+            std::string path_buf{path};
+            throw duckdb::IOException("File %s is already opened with a different compression", path_buf.c_str());
+        }
+
         // User requested truncation of existing file?
         if (flags == duckdb::FileFlags::FILE_FLAGS_FILE_CREATE_NEW) {
             std::string path_buf{path};
@@ -279,11 +324,26 @@ std::unique_ptr<FilePageBuffer::FileRef> FilePageBuffer::OpenFile(std::string_vi
     // Create file
     auto file_ptr = std::make_unique<BufferedFile>(file_id, path, flags, lock_type);
     auto& file = *file_ptr;
-    file.handle = filesystem->OpenFile(file.path.c_str(), flags);
+    file.handle = compressed_handle ? std::move(compressed_handle) : filesystem->OpenFile(file.path.c_str(), flags);
     assert(file.handle != nullptr);
+    file.codec = codec;
+    if (memory_mapping_ && codec == CompressionCodec::NONE && (flags & duckdb::FileFlags::FILE_FLAGS_WRITE) == 0) {
+        file.mapped = MappedFile::Open(file.path);
+    }
+    if (async_reader_ && codec == CompressionCodec::NONE && !file.mapped) {
+        file.async_file = AsyncFile::Open(file.path);
+    }
+    if (codec != CompressionCodec::NONE) {
+        file.decompressed = std::move(decompressed);
+        file.file_size = decompressed_size;
+    }
     files_by_name.insert({file.path, file_ptr.get()});
     files.insert({file_id, std::move(file_ptr)});
-    file.file_size = filesystem->GetFileSize(*file.handle);
+    if (codec == CompressionCodec::NONE) {
+        file.file_size = filesystem->GetFileSize(*file.handle);
+        // Don't trust a mapping that disagrees with the filesystem
+        if (file.mapped && file.mapped->GetSize() != file.file_size) file.mapped.reset();
+    }
 
     // Statistics tracking?
     if (file_statistics_) {
@@ -388,10 +448,113 @@ std::unique_ptr<char[]> FilePageBuffer::AllocateFrameBuffer(DirectoryGuard& dir_
 FilePageBuffer::BufferRef FilePageBuffer::FileRef::FixPage(uint64_t page_id, bool exclusive) {
     DEBUG_TRACE();
     auto file_guard = Lock(Shared);
+
+    // Serve memory-mapped files directly from the mapping
+    if (auto& mapped = file_->mapped; mapped && !exclusive) {
+        auto page_size = buffer_.GetPageSize();
+        auto page_begin = std::min<uint64_t>(mapped->GetSize(), page_id * page_size);
+        auto page_end = std::min<uint64_t>(mapped->GetSize(), page_begin + page_size);
+        mapped->Advise(page_id, page_size);
+        auto data = mapped->GetData().subspan(page_begin, page_end - page_begin);
+        return BufferRef{*this, std::move(file_guard), data};
+    }
+
     auto [frame_ptr, frame_guard] = FixPage(page_id, exclusive, file_guard);
     return BufferRef{*this, std::move(file_guard), *frame_ptr, std::move(frame_guard)};
 }
 
+/// Fix a byte range of a memory-mapped file
+FilePageBuffer::BufferRef FilePageBuffer::FileRef::FixRange(uint64_t offset, uint64_t n) {
+    DEBUG_TRACE();
+    auto file_guard = Lock(Shared);
+    auto& mapped = file_->mapped;
+    if (!mapped) return BufferRef{*this, SharedFileGuard{}, nonstd::span<char>{}};
+    auto begin = std::min<uint64_t>(mapped->GetSize(), offset);
+    auto end = std::min<uint64_t>(mapped->GetSize(), begin + n);
+    if (begin == end) return BufferRef{*this, SharedFileGuard{}, nonstd::span<char>{}};
+    mapped->Advise(offset >> buffer_.GetPageSizeShift(), buffer_.GetPageSize());
+    return BufferRef{*this, std::move(file_guard), mapped->GetData().subspan(begin, end - begin)};
+}
+
+/// Load the run of missing pages that starts at a page
+void FilePageBuffer::FileRef::LoadPages(uint64_t first_page_id, uint64_t page_count) {
+    DEBUG_TRACE();
+    auto file_guard = Lock(Shared);
+    auto& reader = buffer_.async_reader_;
+    if (!reader || !file_->async_file) return;
+    auto page_size = buffer_.GetPageSize();
+    auto page_shift = buffer_.GetPageSizeShift();
+    auto page_end = std::min<uint64_t>(first_page_id + page_count, (file_->file_size + page_size - 1) >> page_shift);
+    // Never claim more than half of the buffer with a single run
+    page_end = std::min<uint64_t>(page_end, first_page_id + std::max<uint64_t>(1, buffer_.page_capacity / 2));
+
+    // Create loading frames for the missing pages.
+    // Concurrent fixes of these pages block on the frame latch until the read completed.
+    std::vector<std::pair<BufferFrame*, std::unique_lock<SharedMutex>>> loads;
+    auto dir_guard = buffer_.Lock();
+    for (auto page_id = first_page_id; page_id < page_end; ++page_id) {
+        auto frame_id = BuildFrameID(file_->file_id, page_id);
+        if (buffer_.frames.count(frame_id)) break;
+        auto frame_buffer = buffer_.AllocateFrameBuffer(dir_guard);
+        if (buffer_.frames.count(frame_id)) {
+            buffer_.DonateFrameBuffer(std::move(frame_buffer), dir_guard);
+            break;
+        }
+        auto frame_ptr = std::make_unique<BufferFrame>(*file_, frame_id, buffer_.fifo.end(), buffer_.lru.end());
+        auto& frame = *frame_ptr;
+        frame.frame_state = FilePageBuffer::BufferFrame::State::LOADING;
+        frame.buffer = std::move(frame_buffer);
+        frame.data_size = std::min<uint64_t>(file_->file_size - (page_id << page_shift), page_size);
+        frame.is_dirty = false;
+        ++frame.num_users;
+        auto frame_guard = frame.Lock(Exclusive);
+        frame.fifo_position = buffer_.fifo.insert(buffer_.fifo.end(), &frame);
+        buffer_.frames.insert({frame_id, std::move(frame_ptr)});
+        if (file_->file_stats) {
+            file_->file_stats->RegisterPageLoad(page_id << page_shift, page_size);
+        }
+        loads.push_back({&frame, std::move(frame_guard)});
+    }
+    dir_guard.unlock();
+    if (loads.empty()) return;
+
+    // Submit all reads at once.
+    // Every frame becomes visible as loaded as soon as its own read completed.
+    std::vector<AsyncReader::Request> requests;
+    requests.reserve(loads.size());
+    for (auto& [frame, frame_guard] : loads) {
+        requests.push_back({file_->async_file->GetFD(), frame->buffer.get(), frame->data_size,
+                            ::GetPageID(frame->frame_id) << page_shift});
+    }
+    nonstd::span<const AsyncReader::Request> request_span{requests.data(), requests.size()};
+    reader->Read(request_span, [&](size_t load_id, int64_t result) {
+        auto& [frame, frame_guard] = loads[load_id];
+        auto dir_guard = buffer_.Lock();
+        --frame->num_users;
+        if (result == frame->data_size) {
+            frame->frame_state = FilePageBuffer::BufferFrame::State::LOADED;
+            frame_guard.unlock();
+            return;
+        }
+
+        // The read failed, drop the frame and leave the error to a regular fix of the page
+        frame->frame_state = FilePageBuffer::BufferFrame::State::NEW;
+        frame_guard.unlock();
+        if (frame->fifo_position != buffer_.fifo.end()) {
+            buffer_.fifo.erase(frame->fifo_position);
+            frame->fifo_position = buffer_.fifo.end();
+        }
+        if (frame->lru_position != buffer_.lru.end()) {
+            buffer_.lru.erase(frame->lru_position);
+            frame->lru_position = buffer_.lru.end();
+        }
+        if (frame->num_users == 0) {
+            buffer_.DonateFrameBuffer(std::move(frame->buffer), dir_guard);
+            buffer_.frames.erase(frame->frame_id);
+        }
+    });
+}
+
 /// Fix a page with existing file lock
 std::pair<FilePageBuffer::BufferFrame*, FilePageBuffer::FrameGuardVariant> FilePageBuffer::FileRef::FixPage(
     uint64_t page_id, bool exclusive, FileGuardRefVariant file_guard) {
@@ -419,14 +582,15 @@ std::pair<FilePageBuffer::BufferFrame*, FilePageBuffer::FrameGuardVariant> FileP
 
             // Is currently being loaded by another thread?
             // This might happen when multiple threads fix the same page concurrently.
-            if (frame->frame_state == FilePageBuffer::BufferFrame::NEW) {
+            if (frame->frame_state == FilePageBuffer::BufferFrame::NEW ||
+                frame->frame_state == FilePageBuffer::BufferFrame::LOADING) {
                 // Wait for other thread to finish.
                 // We acquire the frame latch exclusively to block on the loading.
                 dir_guard.unlock();
                 frame->Lock(Exclusive).unlock();
                 dir_guard.lock();
 
-                // Other thread failed to allocate a buffer for the frame?
+                // Other thread failed to allocate a buffer for the frame or to load it?
                 if (frame->frame_state == FilePageBuffer::BufferFrame::State::NEW) {
                     // Give up on that frame
                     --frame->num_users;
@@ -519,11 +683,23 @@ uint64_t FilePageBuffer::FileRef::Read(void* out, uint64_t n, duckdb::idx_t offs
     auto read_max = std::min<uint64_t>(n, std::max<uint64_t>(read_end, offset) - offset);
     if (read_max == 0) return 0;
 
+    // Copy memory-mapped files directly without a page frame
+    if (auto range = FixRange(offset, read_max)) {
+        auto data = range.GetData();
+        std::memcpy(static_cast<char*>(out), data.data(), data.size());
+        return data.size();
+    }
+
     // Determine page & offset
     auto page_id = offset >> buffer_.GetPageSizeShift();
     auto skip_here = offset - page_id * buffer_.GetPageSize();
     auto read_here = std::min<uint64_t>(read_max, buffer_.GetPageSize() - skip_here);
 
+    // Load the pages that the read spans with a single batch
+    if (skip_here + read_max > buffer_.GetPageSize()) {
+        LoadPages(page_id, (skip_here + read_max + buffer_.GetPageSize() - 1) >> buffer_.GetPageSizeShift());
+    }
+
     // Fix page
     auto page = FixPage(page_id, false);
     // Copy page data to buffer
@@ -551,10 +727,20 @@ uint64_t FilePageBuffer::FileRef::Write(void* in, uint64_t bytes, duckdb::idx_t
         return bytes;
     }
 
-    // Determine page & offset
+    // Write starts behind the end?
+    // Grow the file first, the write then becomes an append.
+    if (offset > file_->file_size) {
+        file_guard.unlock();
+        Truncate(offset);
+        return Write(in, bytes, offset);
+    }
+
+    // Determine page & offset.
+    // Writes that cross the end of the file are split, the caller appends the remainder.
     auto page_id = offset >> buffer_.GetPageSizeShift();
     auto skip_here = offset - page_id * buffer_.GetPageSize();
     auto write_here = std::min<uint64_t>(bytes, buffer_.GetPageSize() - skip_here);
+    write_here = std::min<uint64_t>(write_here, file_->file_size - offset);
 
     // Fix page
     auto [frame_ptr, frame_guard] = FixPage(page_id, true, file_guard);
@@ -630,6 +816,8 @@ void FilePageBuffer::FileRef::ReOpen(uint8_t flags, duckdb::FileLockType lock_ty
     // Swap the file handles
     std::swap(new_handle, file_->handle);
     file_->file_lock = lock_type;
+    // Writeable files are never mapped
+    file_->mapped.reset();
 }
 
 /// Buffers a file at a path.
@@ -643,6 +831,13 @@ bool FilePageBuffer::BuffersFile(std::string_view path) {
     return true;
 }
 
+/// Can a file be dropped?
+bool FilePageBuffer::CanDropFile(std::string_view path) {
+    auto dir_guard = Lock();
+    auto it = files_by_name.find(path);
+    return it == files_by_name.end() || it->second->num_users == 0;
+}
+
 /// Try to drop a file
 bool FilePageBuffer::TryDropFile(std::string_view path) {
     DEBUG_TRACE();
@@ -762,14 +957,62 @@ void FilePageBuffer::FileRef::Truncate(uint64_t new_size) {
         if (file->file_stats) file->file_stats->Resize(new_size);
     }
 
-    // Update all file frames
+    // Update all file frames.
+    // Bytes that become visible when growing the file are zeroed, matching the truncation of the file.
     auto dir_guard = buffer_.Lock();
     for (auto iter = file_->frames.begin(); iter != file_->frames.end(); ++iter) {
         auto& frame = **iter;
         auto page_id = GetPageID(frame.frame_id);
         auto page_begin = page_id * buffer_.GetPageSize();
-        frame.data_size = std::max<size_t>(new_size, page_begin) - page_begin;
+        auto new_data_size = std::min<uint64_t>(std::max<uint64_t>(new_size, page_begin) - page_begin,
+                                                buffer_.GetPageSize());
+        if (new_data_size > frame.data_size && frame.buffer) {
+            std::memset(frame.buffer.get() + frame.data_size, 0, new_data_size - frame.data_size);
+        }
+        frame.data_size = new_data_size;
+    }
+}
+
+/// Get the bytes of all frames and free frame buffers
+size_t FilePageBuffer::GetMemoryUsage() {
+    auto dir_guard = Lock();
+    return (frames.size() + free_buffers.size()) << page_size_bits;
+}
+
+/// Lower the page capacity to a memory limit
+void FilePageBuffer::SetMemoryLimit(size_t bytes) {
+    DEBUG_TRACE();
+    auto capacity = max_page_capacity;
+    if (bytes > 0) {
+        capacity = std::min<uint64_t>(max_page_capacity, std::max<uint64_t>(MINIMUM_FILE_PAGE_CAPACITY,
+                                                                             bytes >> page_size_bits));
+    }
+    auto dir_guard = Lock();
+    page_capacity = capacity;
+    // Drop the buffers that no longer fit
+    while (!free_buffers.empty() && (free_buffers.size() + frames.size()) > capacity) {
+        free_buffers.pop();
+    }
+    // Pages that are in use stay until they are unfixed
+    while (frames.size() > capacity) {
+        if (!EvictAnyBufferFrame(dir_guard)) break;
+    }
+}
+
+/// Drop free frame buffers and evict unused pages
+size_t FilePageBuffer::ReclaimMemory(size_t bytes) {
+    DEBUG_TRACE();
+    auto dir_guard = Lock();
+    size_t released = 0;
+    while (released < bytes && !free_buffers.empty()) {
+        free_buffers.pop();
+        released += GetPageSize();
+    }
+    while (released < bytes) {
+        if (!EvictAnyBufferFrame(dir_guard)) break;
+        released += GetPageSize();
     }
+    return released;
 }
 
 std::vector<uint64_t> FilePageBuffer::GetFIFOList() const {
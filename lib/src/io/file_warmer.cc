@@ -0,0 +1,421 @@
+#include "duckdb/web/io/file_warmer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <string>
+
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/web/io/decompressed_file.h"
+
+namespace duckdb {
+namespace web {
+namespace io {
+
+namespace {
+
+/// Get the name of a warm-up state
+const char* GetStateName(WarmUpState state) {
+    switch (state) {
+        case WarmUpState::QUEUED:
+            return "queued";
+        case WarmUpState::RUNNING:
+            return "running";
+        case WarmUpState::DONE:
+            return "done";
+        case WarmUpState::CANCELLED:
+            return "cancelled";
+        case WarmUpState::FAILED:
+            return "failed";
+    }
+    return "unknown";
+}
+
+/// Read exactly n bytes at an offset through the page buffer
+void ReadExactly(FilePageBuffer::FileRef& file, char* buffer, uint64_t n, uint64_t offset) {
+    while (n > 0) {
+        auto read = file.Read(buffer, n, offset);
+        if (read == 0) break;
+        buffer += read;
+        offset += read;
+        n -= read;
+    }
+}
+
+/// Read a little-endian 32 bit integer
+uint32_t ReadUInt32(const char* data) {
+    auto bytes = reinterpret_cast<const uint8_t*>(data);
+    return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+           (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+}  // namespace
+
+/// Write the progress as JSON
+rapidjson::Value WarmUpProgress::WriteInfo(rapidjson::Document& doc) const {
+    auto& allocator = doc.GetAllocator();
+    rapidjson::Value value;
+    value.SetObject();
+    value.AddMember("state", rapidjson::StringRef(GetStateName(state)), allocator);
+    value.AddMember("bytesLoaded", static_cast<double>(bytes_loaded), allocator);
+    value.AddMember("bytesTotal", static_cast<double>(bytes_total), allocator);
+    if (state == WarmUpState::FAILED) {
+        value.AddMember("error", rapidjson::Value{error.c_str(), static_cast<rapidjson::SizeType>(error.size())},
+                        allocator);
+    }
+    return value;
+}
+
+/// Constructor
+FileWarmer::FileWarmer(std::shared_ptr<FilePageBuffer> buffer, bool background) : buffer_(std::move(buffer)) {
+#ifndef DUCKDB_NO_THREADS
+    background_ = background;
+#else
+    (void)background;
+#endif
+}
+
+/// Destructor
+FileWarmer::~FileWarmer() {
+    CancelAll();
+#ifndef DUCKDB_NO_THREADS
+    {
+        std::unique_lock<std::mutex> guard{mutex_};
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) worker_.join();
+#endif
+}
+
+/// Does a background thread process the queue?
+bool FileWarmer::HasBackgroundThread() const { return background_; }
+
+/// Find the next warm-up that has work left
+std::shared_ptr<FileWarmer::WarmUp> FileWarmer::FindNext() {
+    std::shared_ptr<WarmUp> next = nullptr;
+    for (auto& [id, warm_up] : warm_ups_) {
+        if (warm_up->loading || warm_up->progress.IsFinished()) continue;
+        // The map is ordered by id, older warm-ups win ties
+        if (!next || warm_up->priority > next->priority) next = warm_up;
+    }
+    return next;
+}
+
+/// Mark a warm-up as finished
+void FileWarmer::Finish(WarmUp& warm_up, WarmUpState state, std::string error) {
+    warm_up.progress.state = state;
+    warm_up.progress.error = std::move(error);
+    finished_.push_back(warm_up.id);
+    // Forget the oldest finished warm-ups
+    if (finished_.size() > MAX_FINISHED) {
+        auto n = finished_.size() - MAX_FINISHED;
+        for (size_t i = 0; i < n; ++i) warm_ups_.erase(finished_[i]);
+        finished_.erase(finished_.begin(), finished_.begin() + n);
+    }
+}
+
+/// Resolve the page runs of a warm-up
+std::vector<std::pair<uint64_t, uint64_t>> FileWarmer::ResolvePageRuns(const WarmUp& warm_up,
+                                                                       FilePageBuffer::FileRef& file) {
+    auto file_size = file.GetSize();
+
+    // Resolve the byte ranges
+    std::vector<WarmUpRange> ranges;
+    switch (warm_up.mode) {
+        case WarmUpMode::RANGES:
+            ranges = warm_up.ranges;
+            break;
+        case WarmUpMode::ALL:
+            ranges.push_back({0, file_size});
+            break;
+        case WarmUpMode::METADATA: {
+            ranges.push_back({0, std::min(file_size, METADATA_HEAD_SIZE)});
+            // Parquet and Arrow files end with the footer length and a magic
+            char trailer[10];
+            if (file_size >= sizeof(trailer)) {
+                ReadExactly(file, trailer, sizeof(trailer), file_size - sizeof(trailer));
+            } else {
+                std::memset(trailer, 0, sizeof(trailer));
+            }
+            uint64_t footer_size = 0;
+            if (std::memcmp(trailer + 6, "PAR1", 4) == 0) {
+                footer_size = static_cast<uint64_t>(ReadUInt32(trailer + 2)) + 8;
+            } else if (std::memcmp(trailer + 4, "ARROW1", 6) == 0) {
+                footer_size = static_cast<uint64_t>(ReadUInt32(trailer)) + 10;
+            }
+            if (footer_size == 0 || footer_size > file_size) {
+                footer_size = std::min(file_size, METADATA_TAIL_SIZE);
+            }
+            ranges.push_back({file_size - footer_size, footer_size});
+            break;
+        }
+    }
+
+    // Translate the ranges to sorted and merged page runs
+    auto page_shift = buffer_->GetPageSizeShift();
+    auto page_size = buffer_->GetPageSize();
+    std::vector<std::pair<uint64_t, uint64_t>> runs;
+    for (auto& range : ranges) {
+        auto begin = std::min(range.offset, file_size);
+        auto end = std::min(file_size, begin + std::min(range.length, file_size - begin));
+        if (begin == end) continue;
+        runs.push_back({begin >> page_shift, (end + page_size - 1) >> page_shift});
+    }
+    std::sort(runs.begin(), runs.end());
+    std::vector<std::pair<uint64_t, uint64_t>> merged;
+    for (auto& run : runs) {
+        if (!merged.empty() && run.first <= merged.back().second) {
+            merged.back().second = std::max(merged.back().second, run.second);
+        } else {
+            merged.push_back(run);
+        }
+    }
+
+    // Never claim more than half of the page buffer
+    auto budget = std::max<uint64_t>(1, buffer_->GetPageCapacity() / 2);
+    for (size_t i = 0; i < merged.size(); ++i) {
+        auto pages = merged[i].second - merged[i].first;
+        if (pages >= budget) {
+            merged[i].second = merged[i].first + budget;
+            merged.resize(i + 1);
+            break;
+        }
+        budget -= pages;
+    }
+    return merged;
+}
+
+/// Load the next chunk of a warm-up
+void FileWarmer::LoadChunk(WarmUp& warm_up, std::unique_lock<std::mutex>& guard) {
+    warm_up.loading = true;
+    warm_up.progress.state = WarmUpState::RUNNING;
+    auto path = warm_up.path;
+    auto resolved = warm_up.resolved;
+    guard.unlock();
+
+    std::vector<std::pair<uint64_t, uint64_t>> page_runs;
+    uint64_t file_size = 0;
+    uint64_t bytes_loaded = 0;
+    std::string error;
+    try {
+        // Open the file the same way the buffered filesystem does
+        auto codec = ResolveCompressionCodec(path, duckdb::FileCompressionType::AUTO_DETECT);
+        auto file = buffer_->OpenFile(path, duckdb::FileFlags::FILE_FLAGS_READ, duckdb::FileLockType::NO_LOCK, codec);
+        file_size = file->GetSize();
+        if (!resolved) {
+            page_runs = ResolvePageRuns(warm_up, *file);
+        }
+
+        // Pick the chunk, the position is only modified by the loading thread
+        auto& runs = resolved ? warm_up.page_runs : page_runs;
+        if (warm_up.next_run < runs.size()) {
+            auto& run = runs[warm_up.next_run];
+            auto begin = std::max(run.first, warm_up.next_page);
+            auto end = std::min(run.second, begin + CHUNK_PAGES);
+
+            // Load missing pages with a single batch (if supported) and fix the rest one by one
+            file->LoadPages(begin, end - begin);
+            for (auto page_id = begin; page_id < end; ++page_id) {
+                file->FixPage(page_id, false);
+            }
+            auto page_shift = buffer_->GetPageSizeShift();
+            bytes_loaded = std::min(end << page_shift, file_size) - std::min(begin << page_shift, file_size);
+        }
+    } catch (std::exception& e) {
+        error = e.what();
+        if (error.empty()) error = "warming up the file failed";
+    }
+
+    guard.lock();
+    warm_up.loading = false;
+    if (!error.empty()) {
+        Finish(warm_up, WarmUpState::FAILED, std::move(error));
+        cv_.notify_all();
+        return;
+    }
+    if (!resolved) {
+        uint64_t total = 0;
+        auto page_shift = buffer_->GetPageSizeShift();
+        for (auto& run : page_runs) {
+            total += std::min(run.second << page_shift, file_size) - std::min(run.first << page_shift, file_size);
+        }
+        warm_up.page_runs = std::move(page_runs);
+        warm_up.progress.bytes_total = total;
+        warm_up.resolved = true;
+    }
+
+    // Advance to the next chunk
+    if (warm_up.next_run < warm_up.page_runs.size()) {
+        auto& run = warm_up.page_runs[warm_up.next_run];
+        auto begin = std::max(run.first, warm_up.next_page);
+        auto end = std::min(run.second, begin + CHUNK_PAGES);
+        warm_up.progress.bytes_loaded += bytes_loaded;
+        warm_up.next_page = end;
+        if (end == run.second) ++warm_up.next_run;
+    }
+    if (warm_up.cancelled) {
+        Finish(warm_up, WarmUpState::CANCELLED);
+    } else if (warm_up.next_run >= warm_up.page_runs.size()) {
+        Finish(warm_up, WarmUpState::DONE);
+    }
+    cv_.notify_all();
+}
+
+/// Run the background thread
+void FileWarmer::Work() {
+    std::unique_lock<std::mutex> guard{mutex_};
+    while (!stopping_) {
+        auto next = FindNext();
+        if (!next) {
+            cv_.wait(guard);
+            continue;
+        }
+        LoadChunk(*next, guard);
+    }
+}
+
+/// Enqueue a warm-up
+size_t FileWarmer::Enqueue(std::string_view path, WarmUpMode mode, std::vector<WarmUpRange> ranges,
+                           int32_t priority) {
+    std::unique_lock<std::mutex> guard{mutex_};
+    auto warm_up = std::make_shared<WarmUp>();
+    warm_up->id = next_id_++;
+    warm_up->path = std::string{path};
+    warm_up->mode = mode;
+    warm_up->ranges = std::move(ranges);
+    warm_up->priority = priority;
+    warm_ups_.insert({warm_up->id, warm_up});
+#ifndef DUCKDB_NO_THREADS
+    // Start the background thread lazily
+    if (background_ && !worker_.joinable()) {
+        worker_ = std::thread([this]() { Work(); });
+    }
+#endif
+    cv_.notify_all();
+    return warm_up->id;
+}
+
+/// Cancel a warm-up
+bool FileWarmer::Cancel(size_t id) {
+    std::unique_lock<std::mutex> guard{mutex_};
+    auto iter = warm_ups_.find(id);
+    if (iter == warm_ups_.end()) return false;
+    auto& warm_up = *iter->second;
+    if (warm_up.progress.IsFinished()) return true;
+    if (warm_up.loading) {
+        warm_up.cancelled = true;
+    } else {
+        Finish(warm_up, WarmUpState::CANCELLED);
+    }
+    return true;
+}
+
+/// Cancel all warm-ups of a file
+void FileWarmer::CancelFile(std::string_view path) {
+    std::unique_lock<std::mutex> guard{mutex_};
+    auto cancel = [&]() {
+        bool loading = false;
+        std::vector<std::shared_ptr<WarmUp>> pending;
+        for (auto& [id, warm_up] : warm_ups_) {
+            if (warm_up->path != path || warm_up->progress.IsFinished()) continue;
+            if (warm_up->loading) {
+                warm_up->cancelled = true;
+                loading = true;
+            } else {
+                pending.push_back(warm_up);
+            }
+        }
+        for (auto& warm_up : pending) Finish(*warm_up, WarmUpState::CANCELLED);
+        return !loading;
+    };
+    // Wait until no chunk of the file is being loaded
+    cv_.wait(guard, cancel);
+}
+
+/// Cancel all warm-ups
+void FileWarmer::CancelAll() {
+    std::unique_lock<std::mutex> guard{mutex_};
+    auto cancel = [&]() {
+        bool loading = false;
+        std::vector<std::shared_ptr<WarmUp>> pending;
+        for (auto& [id, warm_up] : warm_ups_) {
+            if (warm_up->progress.IsFinished()) continue;
+            if (warm_up->loading) {
+                warm_up->cancelled = true;
+                loading = true;
+            } else {
+                pending.push_back(warm_up);
+            }
+        }
+        for (auto& warm_up : pending) Finish(*warm_up, WarmUpState::CANCELLED);
+        return !loading;
+    };
+    cv_.wait(guard, cancel);
+}
+
+/// Get the progress of a warm-up
+std::optional<WarmUpProgress> FileWarmer::GetProgress(size_t id) {
+    std::unique_lock<std::mutex> guard{mutex_};
+    auto iter = warm_ups_.find(id);
+    if (iter == warm_ups_.end()) return std::nullopt;
+    return iter->second->progress;
+}
+
+/// Load the next chunk of the queue
+bool FileWarmer::Step() {
+    std::unique_lock<std::mutex> guard{mutex_};
+    auto next = FindNext();
+    if (!next) return false;
+    LoadChunk(*next, guard);
+    return FindNext() != nullptr;
+}
+
+/// Wait until a warm-up is finished
+std::optional<WarmUpProgress> FileWarmer::Wait(size_t id) {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> guard{mutex_};
+            auto iter = warm_ups_.find(id);
+            if (iter == warm_ups_.end()) return std::nullopt;
+            auto warm_up = iter->second;
+            if (warm_up->progress.IsFinished()) return warm_up->progress;
+            // Another thread is loading the last chunk
+            if (background_ || (warm_up->loading && !FindNext())) {
+                cv_.wait(guard);
+                continue;
+            }
+        }
+        Step();
+    }
+}
+
+/// Parse the target of a warm-up
+arrow::Result<std::pair<WarmUpMode, std::vector<WarmUpRange>>> FileWarmer::ParseTarget(std::string_view target_json) {
+    if (target_json == "metadata") return std::make_pair(WarmUpMode::METADATA, std::vector<WarmUpRange>{});
+    if (target_json == "all") return std::make_pair(WarmUpMode::ALL, std::vector<WarmUpRange>{});
+
+    rapidjson::Document doc;
+    rapidjson::ParseResult ok = doc.Parse(target_json.begin(), target_json.size());
+    if (!ok) return arrow::Status::Invalid("invalid warm-up target: ", target_json);
+    if (doc.IsString()) {
+        std::string_view mode{doc.GetString(), doc.GetStringLength()};
+        if (mode == "metadata") return std::make_pair(WarmUpMode::METADATA, std::vector<WarmUpRange>{});
+        if (mode == "all") return std::make_pair(WarmUpMode::ALL, std::vector<WarmUpRange>{});
+        return arrow::Status::Invalid("unknown warm-up mode: ", mode);
+    }
+    if (!doc.IsArray()) return arrow::Status::Invalid("warm-up target must be a mode or an array of ranges");
+    std::vector<WarmUpRange> ranges;
+    for (auto& range : doc.GetArray()) {
+        if (!range.IsArray() || range.Size() != 2 || !range[0].IsNumber() || !range[1].IsNumber() ||
+            range[0].GetDouble() < 0 || range[1].GetDouble() < 0) {
+            return arrow::Status::Invalid("warm-up ranges must be [offset, length] pairs");
+        }
+        ranges.push_back({static_cast<uint64_t>(range[0].GetDouble()), static_cast<uint64_t>(range[1].GetDouble())});
+    }
+    return std::make_pair(WarmUpMode::RANGES, std::move(ranges));
+}
+
+}  // namespace io
+}  // namespace web
+}  // namespace duckdb
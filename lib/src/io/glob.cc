@@ -123,6 +123,65 @@ std::regex glob_to_regex(std::string_view pattern, GlobToRegexOptions options) {
     }
 }
 
+/// Constructor
+GlobMatcher::GlobMatcher(std::string_view glob) {
+    std::string literal;
+    bool after_wildcard = false;
+    for (size_t i = 0; i < glob.size(); ++i) {
+        auto c = glob[i];
+        if (c == '*') {
+            if (i == 0) leading_wildcard_ = true;
+            if (!literal.empty()) literals_.push_back(std::move(literal));
+            literal.clear();
+            after_wildcard = true;
+            continue;
+        }
+        if (c == '\\' && (i + 1) < glob.size()) c = glob[++i];
+        literal += c;
+        after_wildcard = false;
+    }
+    if (!literal.empty() || literals_.empty()) literals_.push_back(std::move(literal));
+    trailing_wildcard_ = after_wildcard;
+}
+
+/// Get the literal prefix that all matches start with
+std::string_view GlobMatcher::GetLiteralPrefix() const {
+    if (leading_wildcard_) return {};
+    return literals_.front();
+}
+
+/// Match a text
+bool GlobMatcher::Matches(std::string_view text) const {
+    size_t begin = 0, end = text.size();
+    size_t first = 0, last = literals_.size();
+
+    // Anchor the first literal at the start
+    if (!leading_wildcard_) {
+        auto& prefix = literals_.front();
+        if (text.compare(0, prefix.size(), prefix) != 0) return false;
+        begin = prefix.size();
+        first = 1;
+        if (!trailing_wildcard_ && literals_.size() == 1) return begin == end;
+    }
+    // Anchor the last literal at the end
+    if (!trailing_wildcard_) {
+        auto& suffix = literals_.back();
+        if ((end - begin) < suffix.size() || text.compare(end - suffix.size(), suffix.size(), suffix) != 0) {
+            return false;
+        }
+        end -= suffix.size();
+        last -= 1;
+    }
+    // Find all other literals greedily from left to right
+    for (auto i = first; i < last; ++i) {
+        auto& literal = literals_[i];
+        auto pos = text.substr(0, end).find(literal, begin);
+        if (pos == std::string_view::npos) return false;
+        begin = pos + literal.size();
+    }
+    return true;
+}
+
 }  // namespace io
 }  // namespace web
 }  // namespace duckdb
@@ -6,10 +6,14 @@ namespace duckdb {
 namespace web {
 namespace io {
 
+/// The number of pages that are loaded ahead of sequential scans
+static constexpr uint64_t READAHEAD_PAGES = 64;
+
 bool InputFileStreamBuffer::NextPage() {
     auto page_id = next_page_id_++;
     if ((page_id << file_page_buffer_->GetPageSizeShift()) >= data_end_) return false;
     buffer_.Release();
+    file_->LoadPages(page_id, READAHEAD_PAGES);
     buffer_ = file_->FixPage(page_id, false);
     auto data = buffer_.GetData();
     auto data_offset = page_id << file_page_buffer_->GetPageSizeShift();
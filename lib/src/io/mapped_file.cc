@@ -0,0 +1,89 @@
+#include "duckdb/web/io/mapped_file.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#ifndef EMSCRIPTEN
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace duckdb {
+namespace web {
+namespace io {
+
+namespace {
+
+/// The number of sequential pages after which we ask the kernel to read ahead
+constexpr uint64_t SEQUENTIAL_READ_THRESHOLD = 4;
+/// The number of bytes that the kernel should read ahead of sequential reads
+constexpr uint64_t SEQUENTIAL_READAHEAD = 1 << 20;
+
+}  // namespace
+
+/// Constructor
+MappedFile::MappedFile(char* data, uint64_t size) : data_(data), size_(size) {}
+
+/// Destructor
+MappedFile::~MappedFile() {
+#ifndef EMSCRIPTEN
+    if (data_) ::munmap(data_, size_);
+#endif
+}
+
+/// Notify the mapping about a read of a page
+void MappedFile::Advise(uint64_t page_id, uint64_t page_size) {
+#ifndef EMSCRIPTEN
+    auto last_page = last_page_.exchange(page_id);
+    if (page_id == last_page) return;
+    if (page_id != last_page + 1) {
+        // Random access, stop reading ahead if we did before
+        if (sequential_pages_.exchange(0) >= SEQUENTIAL_READ_THRESHOLD) {
+            ::madvise(data_, size_, MADV_RANDOM);
+        }
+        return;
+    }
+    auto sequential = ++sequential_pages_;
+    if (sequential == SEQUENTIAL_READ_THRESHOLD) {
+        ::madvise(data_, size_, MADV_SEQUENTIAL);
+    }
+    // Ask for the next window whenever the reader crosses a readahead boundary
+    auto offset = (page_id + 1) * page_size;
+    if (sequential >= SEQUENTIAL_READ_THRESHOLD && offset < size_ && offset % SEQUENTIAL_READAHEAD < page_size) {
+        auto host_page_size = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+        auto begin = offset - offset % host_page_size;
+        auto end = std::min<uint64_t>(size_, offset + SEQUENTIAL_READAHEAD);
+        ::madvise(data_ + begin, end - begin, MADV_WILLNEED);
+    }
+#endif
+}
+
+/// Map a local file
+std::unique_ptr<MappedFile> MappedFile::Open(std::string_view path) {
+#ifndef EMSCRIPTEN
+    std::string path_buf{path};
+    auto fd = ::open(path_buf.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    auto size = static_cast<uint64_t>(st.st_size);
+    auto* data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping keeps the file alive
+    ::close(fd);
+    if (data == MAP_FAILED) return nullptr;
+    return std::unique_ptr<MappedFile>(new MappedFile(static_cast<char*>(data), size));
+#else
+    return nullptr;
+#endif
+}
+
+}  // namespace io
+}  // namespace web
+}  // namespace duckdb
@@ -1,117 +1,216 @@
 #include "duckdb/web/io/memory_filesystem.h"
 
-#include <iostream>
-#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <vector>
 
+#include "duckdb/common/exception.hpp"
 #include "duckdb/common/file_system.hpp"
-#include "duckdb/web/io/web_filesystem.h"
 
 namespace duckdb {
 namespace web {
 namespace io {
 
 /// Constructor
-MemoryFileSystem::FileBuffer::FileBuffer(size_t id, std::string path, std::vector<char> buffer)
-    : file_id(id), file_path(std::move(path)), buffer(std::move(buffer)), handles() {}
-/// Constructor
-MemoryFileSystem::FileHandle::FileHandle(MemoryFileSystem &file_system, FileBuffer &buffer, size_t position)
-    : duckdb::FileHandle(file_system, buffer.file_path),
-      file_system_(file_system),
-      buffer_(buffer),
-      position_(position) {}
+MemoryFileSystem::FileHandle::FileHandle(MemoryFileSystem &file_system, std::shared_ptr<FileBuffer> buffer)
+    : duckdb::FileHandle(file_system, buffer->file_path), buffer_(std::move(buffer)), position_(0) {}
 
-/// Constructor
+/// Destructor
+MemoryFileSystem::FileHandle::~FileHandle() { Close(); }
+
+/// Close the file
 void MemoryFileSystem::FileHandle::Close() {
-    if (buffer_.handles.erase(this) == 0) return;
-    if (buffer_.handles.empty()) {
-        auto file_id = buffer_.file_id;
-        auto file_path = std::move(buffer_.file_path);
-        file_system_.file_paths.erase(file_path);
-        file_system_.files.erase(file_id);
+    if (!buffer_) return;
+    std::unique_lock<SharedMutex> file_guard{buffer_->file_latch};
+    // Removed files are released with their last handle
+    if (--buffer_->handle_count == 0 && buffer_->removed) {
+        static_cast<MemoryFileSystem &>(file_system).ReleaseBuffer(*buffer_);
+    }
+    file_guard.unlock();
+    buffer_.reset();
+}
+
+/// Resolve the buffer of an open file
+MemoryFileSystem::FileBuffer &MemoryFileSystem::GetBuffer(duckdb::FileHandle &handle) {
+    auto &buffer = static_cast<FileHandle &>(handle).buffer_;
+    if (!buffer) throw duckdb::IOException("File %s is closed", handle.path.c_str());
+    return *buffer;
+}
+
+/// Resize a file
+void MemoryFileSystem::ResizeBuffer(FileBuffer &buffer, uint64_t new_size) {
+    auto segment_count = (new_size + SEGMENT_SIZE - 1) / SEGMENT_SIZE;
+    if (segment_count < buffer.segments.size()) {
+        allocated_bytes_ -= (buffer.segments.size() - segment_count) * SEGMENT_SIZE;
+        buffer.segments.resize(segment_count);
+    }
+    // Clear the cut-off bytes of the last segment so that they read as zeros when the file grows again
+    if (new_size < buffer.file_size && new_size % SEGMENT_SIZE != 0) {
+        auto tail = new_size % SEGMENT_SIZE;
+        std::memset(buffer.segments.back().get() + tail, 0, SEGMENT_SIZE - tail);
+    }
+    // Appends only allocate the new segments
+    while (buffer.segments.size() < segment_count) {
+        buffer.segments.push_back(std::unique_ptr<char[]>(new char[SEGMENT_SIZE]()));
+        allocated_bytes_ += SEGMENT_SIZE;
     }
+    buffer.file_size = new_size;
+}
+
+/// Read from a file
+uint64_t MemoryFileSystem::ReadBuffer(FileBuffer &buffer, char *out, uint64_t n, uint64_t offset) {
+    auto end = std::min(buffer.file_size, offset + n);
+    auto reader = offset;
+    while (reader < end) {
+        auto segment_offset = reader % SEGMENT_SIZE;
+        auto chunk = std::min<uint64_t>(SEGMENT_SIZE - segment_offset, end - reader);
+        std::memcpy(out, buffer.segments[reader / SEGMENT_SIZE].get() + segment_offset, chunk);
+        out += chunk;
+        reader += chunk;
+    }
+    return reader > offset ? reader - offset : 0;
+}
+
+/// Write to a file
+void MemoryFileSystem::WriteBuffer(FileBuffer &buffer, const char *in, uint64_t n, uint64_t offset) {
+    if (offset + n > buffer.file_size) {
+        ResizeBuffer(buffer, offset + n);
+    }
+    auto writer = offset;
+    auto end = offset + n;
+    while (writer < end) {
+        auto segment_offset = writer % SEGMENT_SIZE;
+        auto chunk = std::min<uint64_t>(SEGMENT_SIZE - segment_offset, end - writer);
+        std::memcpy(buffer.segments[writer / SEGMENT_SIZE].get() + segment_offset, in, chunk);
+        in += chunk;
+        writer += chunk;
+    }
+}
+
+/// Release the segments of a file
+void MemoryFileSystem::ReleaseBuffer(FileBuffer &buffer) {
+    allocated_bytes_ -= buffer.segments.size() * SEGMENT_SIZE;
+    buffer.segments.clear();
+    buffer.file_size = 0;
 }
 
 /// Register a file buffer
-arrow::Status MemoryFileSystem::RegisterFileBuffer(std::string name, std::vector<char> buffer) {
-    if (file_paths.count(name)) return arrow::Status::Invalid("file already registered");
-    auto file_buffer = std::make_unique<FileBuffer>(next_file_id++, std::move(name), std::move(buffer));
-    auto file_buffer_ptr = file_buffer.get();
-    auto file_id = file_buffer->file_id;
-    std::string_view file_path = file_buffer->file_path;
-    files.insert({file_id, std::move(file_buffer)});
-    file_paths.insert({file_path, file_buffer_ptr});
+arrow::Status MemoryFileSystem::RegisterFileBuffer(std::string name, std::vector<char> data) {
+    auto buffer = std::make_shared<FileBuffer>();
+    buffer->file_path = name;
+    WriteBuffer(*buffer, data.data(), data.size(), 0);
+
+    std::unique_lock<LightMutex> directory_guard{directory_latch_};
+    if (files_.count(name)) {
+        directory_guard.unlock();
+        ReleaseBuffer(*buffer);
+        return arrow::Status::Invalid("file already registered");
+    }
+    files_.insert({std::move(name), std::move(buffer)});
     return arrow::Status::OK();
 }
 
+/// Scan a byte range of an open file without copying it
+uint64_t MemoryFileSystem::ScanSpans(duckdb::FileHandle &handle, uint64_t offset, uint64_t n,
+                                     const std::function<void(nonstd::span<const char>)> &callback) {
+    auto &buffer = GetBuffer(handle);
+    std::shared_lock<SharedMutex> file_guard{buffer.file_latch};
+    auto end = std::min(buffer.file_size, offset + n);
+    auto reader = offset;
+    while (reader < end) {
+        auto segment_offset = reader % SEGMENT_SIZE;
+        auto chunk = std::min<uint64_t>(SEGMENT_SIZE - segment_offset, end - reader);
+        callback(nonstd::span<const char>{buffer.segments[reader / SEGMENT_SIZE].get() + segment_offset, chunk});
+        reader += chunk;
+    }
+    return reader > offset ? reader - offset : 0;
+}
+
 /// Open a file
 std::unique_ptr<duckdb::FileHandle> MemoryFileSystem::OpenFile(const string &path, uint8_t flags, FileLockType lock,
                                                                FileCompressionType compression, FileOpener *opener) {
     // Resolve the file buffer
-    auto file_iter = file_paths.find(path);
-    if (file_iter == file_paths.end()) throw new std::logic_error{"File is not registered"};
-    auto &file_buffer = *file_iter->second;
+    std::unique_lock<LightMutex> directory_guard{directory_latch_};
+    auto iter = files_.find(path);
+    if (iter == files_.end()) {
+        if ((flags & (duckdb::FileFlags::FILE_FLAGS_FILE_CREATE | duckdb::FileFlags::FILE_FLAGS_FILE_CREATE_NEW)) ==
+            0) {
+            throw duckdb::IOException("File %s is not registered", path.c_str());
+        }
+        auto buffer = std::make_shared<FileBuffer>();
+        buffer->file_path = path;
+        iter = files_.insert({path, std::move(buffer)}).first;
+    }
+    auto buffer = iter->second;
+    directory_guard.unlock();
 
     // Can the buffer be locked exclusively?
-    if (lock == duckdb::FileLockType::WRITE_LOCK && !file_buffer.handles.empty()) {
-        throw new std::logic_error{"Cannot lock file exclusively"};
+    std::unique_lock<SharedMutex> file_guard{buffer->file_latch};
+    if (lock == duckdb::FileLockType::WRITE_LOCK && buffer->handle_count > 0) {
+        throw duckdb::IOException("Cannot lock file %s exclusively", path.c_str());
+    }
+    if ((flags & duckdb::FileFlags::FILE_FLAGS_FILE_CREATE_NEW) != 0) {
+        ResizeBuffer(*buffer, 0);
     }
 
     // Register the handle and return it
-    auto handle = std::make_unique<MemoryFileSystem::FileHandle>(*this, file_buffer, 0);
-    file_buffer.handles.insert(handle.get());
+    ++buffer->handle_count;
+    auto handle = std::make_unique<MemoryFileSystem::FileHandle>(*this, buffer);
+    if ((flags & duckdb::FileFlags::FILE_FLAGS_APPEND) != 0) {
+        handle->position_ = buffer->file_size;
+    }
     return handle;
 }
 
 /// Read exactly nr_bytes from the specified location in the file. Fails if nr_bytes could not be read.
-void MemoryFileSystem::Read(duckdb::FileHandle &raw_handle, void *buffer, int64_t nr_bytes, duckdb::idx_t location) {
-    auto &handle = reinterpret_cast<FileHandle &>(raw_handle);
-    auto safe_loc = std::min<size_t>(handle.buffer_.buffer.size(), location);
-    auto available = handle.buffer_.buffer.size() - safe_loc;
-    if (available < nr_bytes) {
-        std::stringstream ss;
-        ss << "insufficient bytes available: loc=" << location << " size=" << handle.buffer_.buffer.size()
-           << " avail=" << available << " req=" << nr_bytes;
-        throw std::invalid_argument(ss.str());
-    }
-    std::memcpy(buffer, handle.buffer_.buffer.data() + safe_loc, nr_bytes);
-    handle.position_ = safe_loc + nr_bytes;
-}
-/// Write exactly nr_bytes to the specified location in the file. Fails if nr_bytes could not be read.
-void MemoryFileSystem::Write(duckdb::FileHandle &raw_handle, void *buffer, int64_t nr_bytes, duckdb::idx_t location) {
-    auto &handle = reinterpret_cast<FileHandle &>(raw_handle);
-    auto safe_loc = std::min<size_t>(handle.buffer_.buffer.size(), location);
-    auto available = handle.buffer_.buffer.size() - safe_loc;
-    if (available < nr_bytes) throw std::invalid_argument("insufficient bytes available");
-    std::memcpy(handle.buffer_.buffer.data() + safe_loc, buffer, nr_bytes);
-    handle.position_ = safe_loc + nr_bytes;
+void MemoryFileSystem::Read(duckdb::FileHandle &handle, void *buffer, int64_t nr_bytes, duckdb::idx_t location) {
+    auto &file = GetBuffer(handle);
+    std::shared_lock<SharedMutex> file_guard{file.file_latch};
+    auto n = ReadBuffer(file, static_cast<char *>(buffer), nr_bytes, location);
+    if (n < static_cast<uint64_t>(nr_bytes)) {
+        throw duckdb::IOException("insufficient bytes available: loc=%llu size=%llu req=%lld",
+                                  static_cast<unsigned long long>(location),
+                                  static_cast<unsigned long long>(file.file_size), static_cast<long long>(nr_bytes));
+    }
+    static_cast<FileHandle &>(handle).position_ = location + n;
+}
+/// Write exactly nr_bytes to the specified location in the file.
+void MemoryFileSystem::Write(duckdb::FileHandle &handle, void *buffer, int64_t nr_bytes, duckdb::idx_t location) {
+    auto &file = GetBuffer(handle);
+    std::unique_lock<SharedMutex> file_guard{file.file_latch};
+    WriteBuffer(file, static_cast<const char *>(buffer), nr_bytes, location);
+    static_cast<FileHandle &>(handle).position_ = location + nr_bytes;
 }
 
 /// Read nr_bytes from the specified file into the buffer, moving the file pointer forward by nr_bytes. Returns the
 /// amount of bytes read.
-int64_t MemoryFileSystem::Read(duckdb::FileHandle &raw_handle, void *buffer, int64_t nr_bytes) {
-    auto &handle = reinterpret_cast<FileHandle &>(raw_handle);
-    auto available = handle.buffer_.buffer.size() - handle.position_;
-    auto n = std::min<size_t>(nr_bytes, available);
-    std::memcpy(buffer, handle.buffer_.buffer.data() + handle.position_, n);
-    handle.position_ += n;
+int64_t MemoryFileSystem::Read(duckdb::FileHandle &handle, void *buffer, int64_t nr_bytes) {
+    auto &file = GetBuffer(handle);
+    auto &file_hdl = static_cast<FileHandle &>(handle);
+    std::shared_lock<SharedMutex> file_guard{file.file_latch};
+    auto n = ReadBuffer(file, static_cast<char *>(buffer), nr_bytes, file_hdl.position_);
+    file_hdl.position_ += n;
     return n;
 }
 
 /// Write nr_bytes from the buffer into the file, moving the file pointer forward by nr_bytes.
-int64_t MemoryFileSystem::Write(duckdb::FileHandle &raw_handle, void *buffer, int64_t nr_bytes) {
-    auto &handle = reinterpret_cast<FileHandle &>(raw_handle);
-    auto available = handle.buffer_.buffer.size() - handle.position_;
-    auto n = std::min<size_t>(nr_bytes, available);
-    std::memcpy(handle.buffer_.buffer.data() + handle.position_, buffer, n);
-    handle.position_ += nr_bytes;
-    return n;
+int64_t MemoryFileSystem::Write(duckdb::FileHandle &handle, void *buffer, int64_t nr_bytes) {
+    auto &file = GetBuffer(handle);
+    auto &file_hdl = static_cast<FileHandle &>(handle);
+    std::unique_lock<SharedMutex> file_guard{file.file_latch};
+    WriteBuffer(file, static_cast<const char *>(buffer), nr_bytes, file_hdl.position_);
+    file_hdl.position_ += nr_bytes;
+    return nr_bytes;
 }
 
 /// Returns the file size of a file handle, returns -1 on error
-int64_t MemoryFileSystem::GetFileSize(duckdb::FileHandle &raw_handle) {
-    return reinterpret_cast<FileHandle &>(raw_handle).buffer_.buffer.size();
+int64_t MemoryFileSystem::GetFileSize(duckdb::FileHandle &handle) {
+    auto &file = GetBuffer(handle);
+    std::shared_lock<SharedMutex> file_guard{file.file_latch};
+    return file.file_size;
 }
 
 /// Returns the file last modified time of a file handle, returns timespec with zero on all attributes on error
@@ -119,9 +218,10 @@ time_t MemoryFileSystem::GetLastModifiedTime(duckdb::FileHandle &handle) { retur
 
 /// Truncate a file to a maximum size of new_size, new_size should be smaller than or equal to the current size of
 /// the file
-void MemoryFileSystem::Truncate(duckdb::FileHandle &raw_handle, int64_t new_size) {
-    auto &handle = reinterpret_cast<FileHandle &>(raw_handle);
-    handle.buffer_.buffer.resize(new_size);
+void MemoryFileSystem::Truncate(duckdb::FileHandle &handle, int64_t new_size) {
+    auto &file = GetBuffer(handle);
+    std::unique_lock<SharedMutex> file_guard{file.file_latch};
+    ResizeBuffer(file, new_size);
 }
 
 /// Check if a directory exists
@@ -129,51 +229,75 @@ bool MemoryFileSystem::DirectoryExists(const std::string &directory) { return tr
 /// Create a directory if it does not exist
 void MemoryFileSystem::CreateDirectory(const std::string &directory) {}
 /// Recursively remove a directory and all files in it
-void MemoryFileSystem::RemoveDirectory(const std::string &directory) {}
+void MemoryFileSystem::RemoveDirectory(const std::string &directory) {
+    std::vector<std::string> paths;
+    ListFiles(directory, [&](std::string path, bool) { paths.push_back(std::move(path)); });
+    for (auto &path : paths) {
+        RemoveFile(path);
+    }
+}
 
 /// List files in a directory, invoking the callback method for each one with (filename, is_dir)
 bool MemoryFileSystem::ListFiles(const std::string &directory, const std::function<void(std::string, bool)> &callback) {
-    bool any = false;
-    for (auto &[path, buffer] : file_paths) {
-        if (std::equal(directory.begin(), directory.begin() + std::min(directory.size(), path.size()), path.begin())) {
-            callback(buffer->file_path, false);
-            any = true;
+    std::vector<std::string> paths;
+    {
+        std::unique_lock<LightMutex> directory_guard{directory_latch_};
+        for (auto &[path, buffer] : files_) {
+            if (path.compare(0, directory.size(), directory) == 0) {
+                paths.push_back(path);
+            }
         }
     }
-    return any;
+    for (auto &path : paths) {
+        callback(path, false);
+    }
+    return !paths.empty();
 }
 
 /// Move a file from source path to the target, StorageManager relies on this being an atomic action for ACID
 /// properties
 void MemoryFileSystem::MoveFile(const std::string &source, const std::string &target) {
-    auto file_paths_iter = file_paths.find(source);
-    if (file_paths_iter == file_paths.end()) throw new std::logic_error{"File does not exist"};
-    auto file_id = file_paths_iter->second->file_id;
-    file_paths.erase(file_paths_iter);
-    auto file_iter = files.find(file_id);
-    assert(file_iter != files.end());
-    auto file_buffer = std::move(file_iter->second);
-    auto file_buffer_ptr = file_buffer.get();
-    files.erase(file_iter);
-    file_buffer->file_path = target;
-    file_paths.insert({file_buffer->file_path, file_buffer.get()});
-    files.insert({file_id, std::move(file_buffer)});
+    std::unique_lock<LightMutex> directory_guard{directory_latch_};
+    auto iter = files_.find(source);
+    if (iter == files_.end()) throw duckdb::IOException("File %s does not exist", source.c_str());
+    auto buffer = std::move(iter->second);
+    files_.erase(iter);
+    // Replace the target, open handles keep it alive until they are closed
+    if (auto prev = files_.find(target); prev != files_.end()) {
+        std::unique_lock<SharedMutex> file_guard{prev->second->file_latch};
+        prev->second->removed = true;
+        if (prev->second->handle_count == 0) ReleaseBuffer(*prev->second);
+        file_guard.unlock();
+        files_.erase(prev);
+    }
+    {
+        std::unique_lock<SharedMutex> file_guard{buffer->file_latch};
+        buffer->file_path = target;
+    }
+    files_.insert({target, std::move(buffer)});
 }
 
 /// Check if a file exists
 bool MemoryFileSystem::FileExists(const std::string &filename) {
-    auto file_paths_iter = file_paths.find(filename);
-    return file_paths_iter != file_paths.end();
+    std::unique_lock<LightMutex> directory_guard{directory_latch_};
+    return files_.count(filename) != 0;
 }
 
 /// Remove a file from disk
 void MemoryFileSystem::RemoveFile(const std::string &filename) {
-    auto file_paths_iter = file_paths.find(filename);
-    if (file_paths_iter == file_paths.end()) throw new std::logic_error{"File does not exist"};
-    if (!file_paths_iter->second->handles.empty()) throw new std::logic_error{"Cannot remove a file with open handles"};
-    auto file_id = file_paths_iter->second->file_id;
-    file_paths.erase(file_paths_iter);
-    files.erase(file_id);
+    std::unique_lock<LightMutex> directory_guard{directory_latch_};
+    auto iter = files_.find(filename);
+    if (iter == files_.end()) throw duckdb::IOException("File %s does not exist", filename.c_str());
+    auto buffer = std::move(iter->second);
+    files_.erase(iter);
+    directory_guard.unlock();
+
+    // Open handles keep the file alive until they are closed
+    std::unique_lock<SharedMutex> file_guard{buffer->file_latch};
+    buffer->removed = true;
+    if (buffer->handle_count == 0) {
+        ReleaseBuffer(*buffer);
+    }
 }
 
 /// Sync a file handle to disk
@@ -182,8 +306,7 @@ void MemoryFileSystem::FileSync(duckdb::FileHandle &handle) {}
 /// Runs a glob on the file system, returning a list of matching files
 std::vector<std::string> MemoryFileSystem::Glob(const std::string &path) {
     // For now, just do exact matches
-    auto file_paths_iter = file_paths.find(path);
-    if (file_paths_iter == file_paths.end()) return {};
+    if (!FileExists(path)) return {};
     return {path};
 }
 
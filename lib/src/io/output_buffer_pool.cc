@@ -0,0 +1,167 @@
+#include "duckdb/web/io/output_buffer_pool.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace duckdb {
+namespace web {
+namespace io {
+
+/// Return a released buffer to the pool
+void OutputBufferPool::State::Recycle(std::unique_ptr<arrow::ResizableBuffer> buffer) {
+    std::unique_lock<std::mutex> guard{mutex};
+    auto capacity = buffer->capacity();
+    if (retained_bytes + capacity > retained_limit) return;
+    retained_bytes += capacity;
+    free_buffers.insert({capacity, std::move(buffer)});
+}
+
+/// Constructor
+OutputBufferPool::OutputBufferPool(arrow::MemoryPool* memory_pool, size_t retained_limit)
+    : state_(std::make_shared<State>()) {
+    state_->memory_pool = memory_pool;
+    state_->retained_limit = retained_limit;
+}
+
+/// Acquire an empty buffer with at least the given capacity
+arrow::Result<std::shared_ptr<arrow::ResizableBuffer>> OutputBufferPool::Acquire(int64_t capacity) {
+    // Round up to a power of two so that buffers of similar results can be reused
+    int64_t rounded = MIN_BUFFER_CAPACITY;
+    while (rounded < capacity) rounded <<= 1;
+
+    // Reuse a free buffer that is not much larger
+    std::unique_ptr<arrow::ResizableBuffer> buffer;
+    {
+        std::unique_lock<std::mutex> guard{state_->mutex};
+        auto iter = state_->free_buffers.lower_bound(rounded);
+        if (iter != state_->free_buffers.end() && iter->first <= 2 * rounded) {
+            buffer = std::move(iter->second);
+            state_->retained_bytes -= iter->first;
+            state_->free_buffers.erase(iter);
+            ++state_->reuse_count;
+        }
+    }
+    if (!buffer) {
+        ARROW_ASSIGN_OR_RAISE(buffer, arrow::AllocateResizableBuffer(0, state_->memory_pool));
+        ARROW_RETURN_NOT_OK(buffer->Reserve(rounded));
+    }
+    ARROW_RETURN_NOT_OK(buffer->Resize(0, false));
+
+    // Return the buffer to the pool when the last reference is released
+    std::weak_ptr<State> weak_state = state_;
+    return std::shared_ptr<arrow::ResizableBuffer>(buffer.release(), [weak_state](arrow::ResizableBuffer* released) {
+        std::unique_ptr<arrow::ResizableBuffer> owned{released};
+        if (auto state = weak_state.lock()) {
+            state->Recycle(std::move(owned));
+        }
+    });
+}
+
+/// Get the bytes of the free buffers
+size_t OutputBufferPool::GetRetainedBytes() {
+    std::unique_lock<std::mutex> guard{state_->mutex};
+    return state_->retained_bytes;
+}
+
+/// Get the number of acquisitions that reused a buffer
+size_t OutputBufferPool::GetReuseCount() {
+    std::unique_lock<std::mutex> guard{state_->mutex};
+    return state_->reuse_count;
+}
+
+/// Free all retained buffers
+size_t OutputBufferPool::Clear() {
+    std::multimap<int64_t, std::unique_ptr<arrow::ResizableBuffer>> released;
+    size_t released_bytes = 0;
+    {
+        std::unique_lock<std::mutex> guard{state_->mutex};
+        released.swap(state_->free_buffers);
+        released_bytes = state_->retained_bytes;
+        state_->retained_bytes = 0;
+    }
+    return released_bytes;
+}
+
+/// Constructor
+PooledOutputStream::PooledOutputStream(OutputBufferPool& pool) : pool_(pool) {}
+
+/// Append a buffer
+arrow::Status PooledOutputStream::AppendBuffer(int64_t capacity) {
+    ARROW_ASSIGN_OR_RAISE(auto buffer, pool_.Acquire(capacity));
+    buffers_.push_back(std::move(buffer));
+    return arrow::Status::OK();
+}
+
+/// Make sure that the next bytes can be written without switching buffers
+arrow::Status PooledOutputStream::Reserve(int64_t nbytes) {
+    if (closed_) return arrow::Status::Invalid("output stream is closed");
+    if (!buffers_.empty()) {
+        auto& buffer = *buffers_.back();
+        if (buffer.capacity() - buffer.size() >= nbytes) return arrow::Status::OK();
+
+        // Move a small prefix (e.g. a schema message) into the reserved buffer
+        if (buffers_.size() == 1 && position_ <= static_cast<int64_t>(OutputBufferPool::MIN_BUFFER_CAPACITY)) {
+            ARROW_ASSIGN_OR_RAISE(auto larger, pool_.Acquire(position_ + nbytes));
+            std::memcpy(larger->mutable_data(), buffer.data(), position_);
+            ARROW_RETURN_NOT_OK(larger->Resize(position_, false));
+            buffers_.back() = std::move(larger);
+            return arrow::Status::OK();
+        }
+    }
+    return AppendBuffer(nbytes);
+}
+
+/// Write bytes
+arrow::Status PooledOutputStream::Write(const void* data, int64_t nbytes) {
+    if (closed_) return arrow::Status::Invalid("output stream is closed");
+    auto* reader = static_cast<const uint8_t*>(data);
+    while (nbytes > 0) {
+        // Continue in a new buffer instead of reallocating the written bytes
+        if (buffers_.empty() || buffers_.back()->size() == buffers_.back()->capacity()) {
+            ARROW_RETURN_NOT_OK(AppendBuffer(std::max<int64_t>(position_, nbytes)));
+        }
+        auto& buffer = *buffers_.back();
+        auto n = std::min(nbytes, buffer.capacity() - buffer.size());
+        std::memcpy(buffer.mutable_data() + buffer.size(), reader, n);
+        ARROW_RETURN_NOT_OK(buffer.Resize(buffer.size() + n, false));
+        reader += n;
+        nbytes -= n;
+        position_ += n;
+    }
+    return arrow::Status::OK();
+}
+
+/// Close the stream
+arrow::Status PooledOutputStream::Close() {
+    closed_ = true;
+    return arrow::Status::OK();
+}
+
+/// Close the stream and return the written bytes
+arrow::Result<std::shared_ptr<arrow::Buffer>> PooledOutputStream::Finish() {
+    ARROW_RETURN_NOT_OK(Close());
+    if (buffers_.empty()) {
+        ARROW_RETURN_NOT_OK(AppendBuffer(0));
+    }
+    if (buffers_.size() == 1) {
+        std::shared_ptr<arrow::Buffer> result = std::move(buffers_.back());
+        buffers_.clear();
+        return result;
+    }
+
+    // Concatenate the buffers and release them to the pool right away
+    ARROW_ASSIGN_OR_RAISE(auto result, pool_.Acquire(position_));
+    auto* writer = result->mutable_data();
+    for (auto& buffer : buffers_) {
+        std::memcpy(writer, buffer->data(), buffer->size());
+        writer += buffer->size();
+        buffer.reset();
+    }
+    buffers_.clear();
+    ARROW_RETURN_NOT_OK(result->Resize(position_, false));
+    return std::shared_ptr<arrow::Buffer>{std::move(result)};
+}
+
+}  // namespace io
+}  // namespace web
+}  // namespace duckdb
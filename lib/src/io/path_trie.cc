@@ -0,0 +1,120 @@
+#include "duckdb/web/io/path_trie.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace duckdb {
+namespace web {
+namespace io {
+
+namespace {
+
+/// Split the next component off a path
+std::string_view NextComponent(std::string_view& path, bool& last) {
+    auto sep = path.find('/');
+    if (sep == std::string_view::npos) {
+        auto component = path;
+        path = {};
+        last = true;
+        return component;
+    }
+    auto component = path.substr(0, sep);
+    path = path.substr(sep + 1);
+    last = false;
+    return component;
+}
+
+}  // namespace
+
+/// Insert a path
+bool PathTrie::Insert(std::string_view path) {
+    auto* node = &root_;
+    for (bool last = false; !last;) {
+        auto component = NextComponent(path, last);
+        auto iter = node->children.find(component);
+        if (iter == node->children.end()) {
+            iter = node->children.emplace(std::string{component}, std::make_unique<Node>()).first;
+        }
+        node = iter->second.get();
+    }
+    if (node->terminal) return false;
+    node->terminal = true;
+    ++size_;
+    return true;
+}
+
+/// Erase a path
+bool PathTrie::Erase(std::string_view path) {
+    // Remember the path to prune empty nodes afterwards
+    std::vector<std::pair<Node*, std::string_view>> trail;
+    auto* node = &root_;
+    for (bool last = false; !last;) {
+        auto component = NextComponent(path, last);
+        auto iter = node->children.find(component);
+        if (iter == node->children.end()) return false;
+        trail.push_back({node, iter->first});
+        node = iter->second.get();
+    }
+    if (!node->terminal) return false;
+    node->terminal = false;
+    --size_;
+
+    // Prune nodes that became empty
+    for (auto iter = trail.rbegin(); iter != trail.rend(); ++iter) {
+        auto& [parent, component] = *iter;
+        auto child = parent->children.find(component);
+        if (child->second->terminal || !child->second->children.empty()) break;
+        parent->children.erase(child);
+    }
+    return true;
+}
+
+/// Erase all paths
+void PathTrie::Clear() {
+    root_.children.clear();
+    root_.terminal = false;
+    size_ = 0;
+}
+
+/// Visit all paths in a subtree
+void PathTrie::VisitSubtree(const Node& node, std::string& path, const std::function<void(std::string_view)>& fn) {
+    if (node.terminal) fn(path);
+    for (auto& [component, child] : node.children) {
+        auto prev = path.size();
+        path += '/';
+        path += component;
+        VisitSubtree(*child, path, fn);
+        path.resize(prev);
+    }
+}
+
+/// Visit all paths that start with a prefix
+void PathTrie::VisitPrefix(std::string_view prefix, const std::function<void(std::string_view)>& fn) const {
+    // Descend along all complete components of the prefix
+    std::string path;
+    auto* node = &root_;
+    bool last = false;
+    auto component = NextComponent(prefix, last);
+    for (; !last; component = NextComponent(prefix, last)) {
+        auto iter = node->children.find(component);
+        if (iter == node->children.end()) return;
+        if (node != &root_) path += '/';
+        path += iter->first;
+        node = iter->second.get();
+    }
+
+    // Visit all children that start with the partial last component
+    for (auto iter = node->children.lower_bound(component); iter != node->children.end(); ++iter) {
+        auto& [child_component, child] = *iter;
+        if (child_component.compare(0, component.size(), component) != 0) break;
+        auto child_path = path;
+        if (node != &root_) child_path += '/';
+        child_path += child_component;
+        VisitSubtree(*child, child_path, fn);
+    }
+}
+
+}  // namespace io
+}  // namespace web
+}  // namespace duckdb
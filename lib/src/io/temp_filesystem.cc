@@ -0,0 +1,551 @@
+#include "duckdb/web/io/temp_filesystem.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "zstd.h"
+
+namespace duckdb {
+namespace web {
+namespace io {
+
+/// Constructor
+TempFileSystem::TempFileHandle::TempFileHandle(TempFileSystem &file_system, std::shared_ptr<TempFile> file)
+    : duckdb::FileHandle(file_system, file->path), file_(std::move(file)), position_(0) {}
+
+/// Destructor
+TempFileSystem::TempFileHandle::~TempFileHandle() { Close(); }
+
+/// Close the file
+void TempFileSystem::TempFileHandle::Close() {
+    if (!file_) return;
+    static_cast<TempFileSystem &>(file_system).CloseFile(*file_);
+    file_.reset();
+}
+
+/// Constructor
+TempFileSystem::TempFileSystem(size_t budget, duckdb::FileSystem *overflow_filesystem, std::string overflow_path)
+    : overflow_filesystem_(overflow_filesystem), overflow_path_(std::move(overflow_path)), budget_(budget) {}
+
+/// Destructor
+TempFileSystem::~TempFileSystem() {
+    std::unique_lock<std::mutex> overflow_guard{overflow_mutex_};
+    if (overflow_file_) {
+        overflow_file_.reset();
+        overflow_filesystem_->RemoveFile(overflow_path_);
+    }
+}
+
+/// Resolve an open file
+TempFileSystem::TempFile &TempFileSystem::GetFile(duckdb::FileHandle &handle) {
+    auto &file = static_cast<TempFileHandle &>(handle).file_;
+    if (!file) throw duckdb::IOException("Temporary file %s is closed", handle.path.c_str());
+    return *file;
+}
+
+/// Allocate an extent in the overflow file, requires the overflow mutex
+uint64_t TempFileSystem::AllocateOverflow(uint64_t size) {
+    // Take the first free extent that fits
+    for (auto iter = overflow_free_.begin(); iter != overflow_free_.end(); ++iter) {
+        auto [offset, free] = *iter;
+        if (free < size) continue;
+        overflow_free_.erase(iter);
+        if (free > size) overflow_free_.insert({offset + size, free - size});
+        return offset;
+    }
+    // Append to the file otherwise
+    auto offset = overflow_end_;
+    overflow_end_ += size;
+    return offset;
+}
+
+/// Free an extent in the overflow file, requires the overflow mutex
+void TempFileSystem::FreeOverflow(uint64_t offset, uint64_t size) {
+    // Merge with the following extent
+    auto next = overflow_free_.lower_bound(offset);
+    if (next != overflow_free_.end() && next->first == offset + size) {
+        size += next->second;
+        next = overflow_free_.erase(next);
+    }
+    // Merge with the preceding extent
+    if (next != overflow_free_.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            offset = prev->first;
+            size += prev->second;
+            overflow_free_.erase(prev);
+        }
+    }
+    // Give back space at the end of the file
+    if (offset + size == overflow_end_) {
+        overflow_end_ = offset;
+        return;
+    }
+    overflow_free_.insert({offset, size});
+}
+
+/// Move a resident segment to the overflow file, returns the released bytes
+size_t TempFileSystem::SpillSegment(Segment &segment) {
+    if (!segment.data || !overflow_filesystem_ || overflow_path_.empty()) return 0;
+    std::unique_lock<std::mutex> overflow_guard{overflow_mutex_};
+    if (!overflow_file_) {
+        overflow_file_ = overflow_filesystem_->OpenFile(
+            overflow_path_,
+            duckdb::FileFlags::FILE_FLAGS_READ | duckdb::FileFlags::FILE_FLAGS_WRITE |
+                duckdb::FileFlags::FILE_FLAGS_FILE_CREATE_NEW,
+            duckdb::FileLockType::NO_LOCK, duckdb::FileCompressionType::UNCOMPRESSED);
+    }
+    auto offset = AllocateOverflow(segment.stored_size);
+    try {
+        overflow_file_->Write(segment.data.get(), segment.stored_size, offset);
+    } catch (...) {
+        FreeOverflow(offset, segment.stored_size);
+        throw;
+    }
+    segment.overflow_offset = offset;
+    ++overflow_segments_;
+    overflow_guard.unlock();
+
+    segment.data.reset();
+    memory_usage_ -= segment.stored_size;
+    return segment.stored_size;
+}
+
+/// Release a segment
+void TempFileSystem::ReleaseSegment(Segment &segment) {
+    if (segment.data) {
+        memory_usage_ -= segment.stored_size;
+    }
+    if (segment.overflow_offset) {
+        std::unique_lock<std::mutex> overflow_guard{overflow_mutex_};
+        // Truncate the overflow file once all of its segments are gone
+        if (--overflow_segments_ == 0) {
+            overflow_end_ = 0;
+            overflow_free_.clear();
+            overflow_filesystem_->Truncate(*overflow_file_, 0);
+        } else {
+            FreeOverflow(*segment.overflow_offset, segment.stored_size);
+        }
+    }
+    segment = Segment{};
+}
+
+/// Load a segment into the uncompressed segment of a file
+char *TempFileSystem::LoadSegment(TempFile &file, size_t segment_id, bool overwrite,
+                                  std::unique_lock<std::mutex> &file_guard) {
+    if (file.cached_segment && file.cached_segment_id == segment_id) {
+        return file.cached_segment.get();
+    }
+    StoreCachedSegment(file, file_guard);
+
+    // Allocate the uncompressed segment
+    auto buffer = std::unique_ptr<char[]>(new char[SEGMENT_SIZE]);
+    memory_usage_ += SEGMENT_SIZE;
+    file.cached_segment = std::move(buffer);
+    file.cached_segment_id = segment_id;
+    file.cached_segment_dirty = false;
+    auto *out = file.cached_segment.get();
+
+    // Segments that were never written are zero
+    auto &segment = file.segments[segment_id];
+    if (overwrite || (!segment.data && !segment.overflow_offset)) {
+        std::memset(out, 0, SEGMENT_SIZE);
+        return out;
+    }
+
+    // Read the stored bytes
+    const char *stored = segment.data.get();
+    std::unique_ptr<char[]> spilled;
+    if (!stored) {
+        spilled = std::unique_ptr<char[]>(new char[segment.stored_size]);
+        std::unique_lock<std::mutex> overflow_guard{overflow_mutex_};
+        overflow_file_->Read(spilled.get(), segment.stored_size, *segment.overflow_offset);
+        stored = spilled.get();
+    }
+
+    // Decompress the segment
+    if (!segment.compressed) {
+        std::memcpy(out, stored, segment.stored_size);
+        std::memset(out + segment.stored_size, 0, SEGMENT_SIZE - segment.stored_size);
+        return out;
+    }
+    auto n = duckdb_zstd::ZSTD_decompress(out, SEGMENT_SIZE, stored, segment.stored_size);
+    if (duckdb_zstd::ZSTD_isError(n)) {
+        throw duckdb::IOException("corrupt segment in temporary file %s: %s", file.path.c_str(),
+                                  duckdb_zstd::ZSTD_getErrorName(n));
+    }
+    std::memset(out + n, 0, SEGMENT_SIZE - n);
+    return out;
+}
+
+/// Compress the uncompressed segment of a file and release it
+void TempFileSystem::StoreCachedSegment(TempFile &file, std::unique_lock<std::mutex> &file_guard) {
+    if (!file.cached_segment) return;
+    if (file.cached_segment_dirty) {
+        auto segment_id = file.cached_segment_id;
+        auto segment_begin = segment_id * SEGMENT_SIZE;
+        auto n = std::min<uint64_t>(SEGMENT_SIZE, file.file_size - std::min(file.file_size, segment_begin));
+
+        // Compress the valid bytes, keep them raw if they are incompressible
+        auto bound = duckdb_zstd::ZSTD_compressBound(n);
+        auto compressed = std::unique_ptr<char[]>(new char[bound]);
+        auto compressed_size =
+            duckdb_zstd::ZSTD_compress(compressed.get(), bound, file.cached_segment.get(), n, COMPRESSION_LEVEL);
+        Segment next;
+        if (!duckdb_zstd::ZSTD_isError(compressed_size) && compressed_size < n) {
+            next.data = std::unique_ptr<char[]>(new char[compressed_size]);
+            std::memcpy(next.data.get(), compressed.get(), compressed_size);
+            next.stored_size = compressed_size;
+            next.compressed = true;
+        } else {
+            next.data = std::unique_ptr<char[]>(new char[n]);
+            std::memcpy(next.data.get(), file.cached_segment.get(), n);
+            next.stored_size = n;
+            next.compressed = false;
+        }
+
+        // Does the segment fit into the budget?
+        auto &prev = file.segments[segment_id];
+        auto prev_resident = prev.data ? prev.stored_size : 0;
+        auto usage = memory_usage_.load() - prev_resident - SEGMENT_SIZE;
+        auto spill = budget_ > 0 && usage + next.stored_size > budget_;
+        if (spill && (!overflow_filesystem_ || overflow_path_.empty())) {
+            throw duckdb::IOException("Temporary storage budget of %llu bytes exhausted while writing %s",
+                                      static_cast<unsigned long long>(budget_), file.path.c_str());
+        }
+        ReleaseSegment(prev);
+        memory_usage_ += next.stored_size;
+        prev = std::move(next);
+        if (spill) {
+            SpillSegment(prev);
+        }
+    }
+    file.cached_segment.reset();
+    file.cached_segment_dirty = false;
+    memory_usage_ -= SEGMENT_SIZE;
+}
+
+/// Release all segments of a file
+void TempFileSystem::ReleaseFile(TempFile &file, std::unique_lock<std::mutex> &file_guard) {
+    if (file.cached_segment) {
+        file.cached_segment.reset();
+        file.cached_segment_dirty = false;
+        memory_usage_ -= SEGMENT_SIZE;
+    }
+    for (auto &segment : file.segments) {
+        ReleaseSegment(segment);
+    }
+    file.segments.clear();
+    file.file_size = 0;
+}
+
+/// Resize a file
+void TempFileSystem::ResizeFile(TempFile &file, uint64_t new_size, std::unique_lock<std::mutex> &file_guard) {
+    auto segment_count = (new_size + SEGMENT_SIZE - 1) / SEGMENT_SIZE;
+    if (new_size < file.file_size) {
+        // Drop the uncompressed segment if it is cut off
+        if (file.cached_segment && file.cached_segment_id >= segment_count) {
+            file.cached_segment.reset();
+            file.cached_segment_dirty = false;
+            memory_usage_ -= SEGMENT_SIZE;
+        }
+        for (auto i = segment_count; i < file.segments.size(); ++i) {
+            ReleaseSegment(file.segments[i]);
+        }
+        file.segments.resize(segment_count);
+
+        // Clear the tail of the last segment so that it reads as zeros when the file grows again
+        auto tail = new_size % SEGMENT_SIZE;
+        if (tail != 0) {
+            auto *buffer = LoadSegment(file, segment_count - 1, false, file_guard);
+            std::memset(buffer + tail, 0, SEGMENT_SIZE - tail);
+            file.cached_segment_dirty = true;
+        }
+    } else {
+        file.segments.resize(segment_count);
+    }
+    file.file_size = new_size;
+}
+
+/// Read from a file
+uint64_t TempFileSystem::ReadFile(TempFile &file, char *buffer, uint64_t n, uint64_t offset) {
+    std::unique_lock<std::mutex> file_guard{file.file_mutex};
+    auto end = std::min(file.file_size, offset + n);
+    auto reader = offset;
+    while (reader < end) {
+        auto segment_id = reader / SEGMENT_SIZE;
+        auto segment_offset = reader % SEGMENT_SIZE;
+        auto chunk = std::min<uint64_t>(SEGMENT_SIZE - segment_offset, end - reader);
+        auto *segment = LoadSegment(file, segment_id, false, file_guard);
+        std::memcpy(buffer, segment + segment_offset, chunk);
+        buffer += chunk;
+        reader += chunk;
+    }
+    return reader > offset ? reader - offset : 0;
+}
+
+/// Write to a file
+void TempFileSystem::WriteFile(TempFile &file, const char *buffer, uint64_t n, uint64_t offset) {
+    std::unique_lock<std::mutex> file_guard{file.file_mutex};
+    if (offset + n > file.file_size) {
+        ResizeFile(file, offset + n, file_guard);
+    }
+    auto writer = offset;
+    auto end = offset + n;
+    while (writer < end) {
+        auto segment_id = writer / SEGMENT_SIZE;
+        auto segment_offset = writer % SEGMENT_SIZE;
+        auto chunk = std::min<uint64_t>(SEGMENT_SIZE - segment_offset, end - writer);
+        auto *segment = LoadSegment(file, segment_id, chunk == SEGMENT_SIZE, file_guard);
+        std::memcpy(segment + segment_offset, buffer, chunk);
+        file.cached_segment_dirty = true;
+        buffer += chunk;
+        writer += chunk;
+    }
+}
+
+/// Close a handle of a file
+void TempFileSystem::CloseFile(TempFile &file) {
+    std::unique_lock<std::mutex> file_guard{file.file_mutex};
+    if (--file.handle_count > 0) return;
+    // Release removed files, compress the others
+    if (file.removed) {
+        ReleaseFile(file, file_guard);
+        return;
+    }
+    try {
+        StoreCachedSegment(file, file_guard);
+    } catch (...) {
+        // Handles are closed in destructors, keep the segment uncompressed if it exceeds the budget
+    }
+}
+
+/// Move resident segments to the overflow file, returns the released bytes
+size_t TempFileSystem::ReclaimMemory(size_t bytes) {
+    if (!overflow_filesystem_ || overflow_path_.empty()) return 0;
+    std::vector<std::shared_ptr<TempFile>> files;
+    {
+        std::unique_lock<std::mutex> directory_guard{directory_mutex_};
+        for (auto &[path, file] : files_) {
+            files.push_back(file);
+        }
+    }
+    size_t released = 0;
+    for (auto &file : files) {
+        std::unique_lock<std::mutex> file_guard{file->file_mutex};
+        for (auto &segment : file->segments) {
+            if (released >= bytes) return released;
+            released += SpillSegment(segment);
+        }
+    }
+    return released;
+}
+
+/// Get the size of the used space in the overflow file
+uint64_t TempFileSystem::GetOverflowSize() {
+    std::unique_lock<std::mutex> overflow_guard{overflow_mutex_};
+    return overflow_end_;
+}
+
+/// Get the bytes of the free extents in the overflow file
+uint64_t TempFileSystem::GetOverflowFreeBytes() {
+    std::unique_lock<std::mutex> overflow_guard{overflow_mutex_};
+    uint64_t bytes = 0;
+    for (auto &[offset, size] : overflow_free_) bytes += size;
+    return bytes;
+}
+
+/// Open a file
+std::unique_ptr<duckdb::FileHandle> TempFileSystem::OpenFile(const string &path, uint8_t flags, FileLockType lock,
+                                                             FileCompressionType compression, FileOpener *opener) {
+    std::unique_lock<std::mutex> directory_guard{directory_mutex_};
+    auto iter = files_.find(path);
+    if (iter == files_.end()) {
+        if ((flags & (duckdb::FileFlags::FILE_FLAGS_FILE_CREATE | duckdb::FileFlags::FILE_FLAGS_FILE_CREATE_NEW)) ==
+            0) {
+            throw duckdb::IOException("Temporary file %s does not exist", path.c_str());
+        }
+        auto file = std::make_shared<TempFile>();
+        file->path = path;
+        iter = files_.insert({path, std::move(file)}).first;
+    }
+    auto file = iter->second;
+    directory_guard.unlock();
+
+    // Register the handle
+    std::unique_lock<std::mutex> file_guard{file->file_mutex};
+    if ((flags & duckdb::FileFlags::FILE_FLAGS_FILE_CREATE_NEW) != 0) {
+        ReleaseFile(*file, file_guard);
+    }
+    ++file->handle_count;
+    auto handle = std::make_unique<TempFileHandle>(*this, file);
+    if ((flags & duckdb::FileFlags::FILE_FLAGS_APPEND) != 0) {
+        handle->position_ = file->file_size;
+    }
+    return handle;
+}
+
+/// Read exactly nr_bytes from the specified location in the file. Fails if nr_bytes could not be read.
+void TempFileSystem::Read(duckdb::FileHandle &handle, void *buffer, int64_t nr_bytes, duckdb::idx_t location) {
+    auto n = ReadFile(GetFile(handle), static_cast<char *>(buffer), nr_bytes, location);
+    if (n < static_cast<uint64_t>(nr_bytes)) {
+        throw duckdb::IOException("Could not read %lld bytes at offset %llu from temporary file %s",
+                                  static_cast<long long>(nr_bytes), static_cast<unsigned long long>(location),
+                                  handle.path.c_str());
+    }
+    static_cast<TempFileHandle &>(handle).position_ = location + n;
+}
+
+/// Write exactly nr_bytes to the specified location in the file.
+void TempFileSystem::Write(duckdb::FileHandle &handle, void *buffer, int64_t nr_bytes, duckdb::idx_t location) {
+    WriteFile(GetFile(handle), static_cast<const char *>(buffer), nr_bytes, location);
+    static_cast<TempFileHandle &>(handle).position_ = location + nr_bytes;
+}
+
+/// Read nr_bytes from the specified file into the buffer, moving the file pointer forward by nr_bytes. Returns the
+/// amount of bytes read.
+int64_t TempFileSystem::Read(duckdb::FileHandle &handle, void *buffer, int64_t nr_bytes) {
+    auto &temp_hdl = static_cast<TempFileHandle &>(handle);
+    auto n = ReadFile(GetFile(handle), static_cast<char *>(buffer), nr_bytes, temp_hdl.position_);
+    temp_hdl.position_ += n;
+    return n;
+}
+
+/// Write nr_bytes from the buffer into the file, moving the file pointer forward by nr_bytes.
+int64_t TempFileSystem::Write(duckdb::FileHandle &handle, void *buffer, int64_t nr_bytes) {
+    auto &temp_hdl = static_cast<TempFileHandle &>(handle);
+    WriteFile(GetFile(handle), static_cast<const char *>(buffer), nr_bytes, temp_hdl.position_);
+    temp_hdl.position_ += nr_bytes;
+    return nr_bytes;
+}
+
+/// Returns the file size of a file handle, returns -1 on error
+int64_t TempFileSystem::GetFileSize(duckdb::FileHandle &handle) {
+    auto &file = GetFile(handle);
+    std::unique_lock<std::mutex> file_guard{file.file_mutex};
+    return file.file_size;
+}
+
+/// Returns the file last modified time of a file handle, returns timespec with zero on all attributes on error
+time_t TempFileSystem::GetLastModifiedTime(duckdb::FileHandle &handle) { return 0; }
+
+/// Truncate a file to a maximum size of new_size, new_size should be smaller than or equal to the current size of
+/// the file
+void TempFileSystem::Truncate(duckdb::FileHandle &handle, int64_t new_size) {
+    auto &file = GetFile(handle);
+    std::unique_lock<std::mutex> file_guard{file.file_mutex};
+    ResizeFile(file, new_size, file_guard);
+}
+
+/// Check if a directory exists
+bool TempFileSystem::DirectoryExists(const std::string &directory) { return IsTempPath(directory); }
+/// Create a directory if it does not exist
+void TempFileSystem::CreateDirectory(const std::string &directory) {}
+/// Recursively remove a directory and all files in it
+void TempFileSystem::RemoveDirectory(const std::string &directory) {
+    std::vector<std::string> paths;
+    ListFiles(directory, [&](std::string name, bool) { paths.push_back(JoinPath(directory, name)); });
+    for (auto &path : paths) {
+        RemoveFile(path);
+    }
+}
+
+/// List files in a directory, invoking the callback method for each one with (filename, is_dir)
+bool TempFileSystem::ListFiles(const std::string &directory, const std::function<void(std::string, bool)> &callback) {
+    auto prefix = directory;
+    if (prefix.empty() || prefix.back() != '/') prefix += '/';
+    std::vector<std::string> names;
+    {
+        std::unique_lock<std::mutex> directory_guard{directory_mutex_};
+        for (auto &[path, file] : files_) {
+            if (path.compare(0, prefix.size(), prefix) == 0) {
+                names.push_back(path.substr(prefix.size()));
+            }
+        }
+    }
+    for (auto &name : names) {
+        callback(name, false);
+    }
+    return true;
+}
+
+/// Move a file from source path to the target, StorageManager relies on this being an atomic action for ACID
+/// properties
+void TempFileSystem::MoveFile(const std::string &source, const std::string &target) {
+    std::unique_lock<std::mutex> directory_guard{directory_mutex_};
+    auto iter = files_.find(source);
+    if (iter == files_.end()) throw duckdb::IOException("Temporary file %s does not exist", source.c_str());
+    auto file = iter->second;
+    files_.erase(iter);
+    if (auto prev = files_.find(target); prev != files_.end()) {
+        std::unique_lock<std::mutex> file_guard{prev->second->file_mutex};
+        prev->second->removed = true;
+        if (prev->second->handle_count == 0) ReleaseFile(*prev->second, file_guard);
+        files_.erase(prev);
+    }
+    std::unique_lock<std::mutex> file_guard{file->file_mutex};
+    file->path = target;
+    files_.insert({target, std::move(file)});
+}
+
+/// Check if a file exists
+bool TempFileSystem::FileExists(const std::string &filename) {
+    std::unique_lock<std::mutex> directory_guard{directory_mutex_};
+    return files_.count(filename) != 0;
+}
+
+/// Remove a file from disk
+void TempFileSystem::RemoveFile(const std::string &filename) {
+    std::unique_lock<std::mutex> directory_guard{directory_mutex_};
+    auto iter = files_.find(filename);
+    if (iter == files_.end()) return;
+    auto file = std::move(iter->second);
+    files_.erase(iter);
+    directory_guard.unlock();
+
+    // Open handles keep the file alive until they are closed
+    std::unique_lock<std::mutex> file_guard{file->file_mutex};
+    file->removed = true;
+    if (file->handle_count == 0) {
+        ReleaseFile(*file, file_guard);
+    }
+}
+
+/// Sync a file handle to disk
+void TempFileSystem::FileSync(duckdb::FileHandle &handle) {}
+
+/// Runs a glob on the file system, returning a list of matching files
+std::vector<std::string> TempFileSystem::Glob(const std::string &path) {
+    std::unique_lock<std::mutex> directory_guard{directory_mutex_};
+    if (files_.count(path)) return {path};
+    return {};
+}
+
+/// Set the file pointer of a file handle to a specified location. Reads and writes will happen from this location
+void TempFileSystem::Seek(duckdb::FileHandle &handle, idx_t location) {
+    static_cast<TempFileHandle &>(handle).position_ = location;
+}
+/// Reset a file to the beginning (equivalent to Seek(handle, 0) for simple files)
+void TempFileSystem::Reset(duckdb::FileHandle &handle) { static_cast<TempFileHandle &>(handle).position_ = 0; }
+/// Get the current position within the file
+idx_t TempFileSystem::SeekPosition(duckdb::FileHandle &handle) {
+    return static_cast<TempFileHandle &>(handle).position_;
+}
+/// Whether or not we can seek into the file
+bool TempFileSystem::CanSeek() { return true; }
+/// Whether or not the FS handles plain files on disk
+bool TempFileSystem::OnDiskFile(duckdb::FileHandle &handle) { return false; }
+
+/// Return the name of the filesytem. Used for forming diagnosis messages.
+std::string TempFileSystem::GetName() const { return "TempFileSystem"; }
+
+}  // namespace io
+}  // namespace web
+}  // namespace duckdb
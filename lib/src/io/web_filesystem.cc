@@ -1,12 +1,18 @@
 #include "duckdb/web/io/web_filesystem.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <limits>
 #include <mutex>
 #include <regex>
 #include <shared_mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <unordered_set>
 #include <vector>
 
 #include "arrow/buffer.h"
@@ -61,6 +67,10 @@ static void ClearLocalStates() {
 #ifndef EMSCRIPTEN
 /// This is only used for tests.
 static std::unique_ptr<duckdb::FileSystem> NATIVE_FS = duckdb::FileSystem::CreateLocal();
+/// The number of syncs that reached the native runtime
+static std::atomic<size_t> NATIVE_SYNC_COUNT = 0;
+/// The number of reads that reached the native runtime
+static std::atomic<size_t> NATIVE_READ_COUNT = 0;
 /// Get or open a file and throw if something is off
 static duckdb::FileHandle &GetOrOpen(size_t file_id) {
     auto file = WebFileSystem::Get()->GetFile(file_id);
@@ -93,6 +103,10 @@ struct OpenedFile {
     double file_size;
     /// The file buffer
     double file_buffer;
+    /// The speculatively fetched tail of the file
+    double tail_buffer;
+    /// The size of the tail
+    double tail_size;
 };
 
 #ifdef EMSCRIPTEN
@@ -105,9 +119,23 @@ RT_FN(void *duckdb_web_fs_file_open(size_t file_id), {
     auto result = std::make_unique<OpenedFile>();
     result->file_size = file.GetFileSize();
     result->file_buffer = 0;
+    result->tail_buffer = 0;
+    result->tail_size = 0;
+    // Emulate the speculative tail of the browser runtime
+    auto file_size = static_cast<uint64_t>(result->file_size);
+    auto tail_size = std::min<uint64_t>(WebFileSystem::Get()->GetConfig().filesystem.speculative_tail_size, file_size);
+    if (tail_size > 0) {
+        auto tail = std::unique_ptr<char[]>(new char[tail_size]);
+        file.Read(tail.get(), tail_size, file_size - tail_size);
+        result->tail_buffer = static_cast<double>(reinterpret_cast<uintptr_t>(tail.release()));
+        result->tail_size = tail_size;
+    }
     return result.release();
 });
-RT_FN(void duckdb_web_fs_file_sync(size_t file_id), { NATIVE_FS->FileSync(GetOrOpen(file_id)); });
+RT_FN(void duckdb_web_fs_file_sync(size_t file_id), {
+    ++NATIVE_SYNC_COUNT;
+    NATIVE_FS->FileSync(GetOrOpen(file_id));
+});
 RT_FN(void duckdb_web_fs_file_close(size_t file_id), {
     auto &infos = GetLocalState();
     infos.handles.erase(file_id);
@@ -118,6 +146,7 @@ RT_FN(time_t duckdb_web_fs_file_get_last_modified_time(size_t file_id), {
     return NATIVE_FS->GetLastModifiedTime(file);
 });
 RT_FN(ssize_t duckdb_web_fs_file_read(size_t file_id, void *buffer, ssize_t bytes, double location), {
+    ++NATIVE_READ_COUNT;
     auto &file = GetOrOpen(file_id);
     auto file_size = file.GetFileSize();
     auto safe_offset = std::min<int64_t>(file_size, location);
@@ -152,6 +181,9 @@ RT_FN(void duckdb_web_fs_file_move(const char *from, size_t fromLen, const char
 RT_FN(bool duckdb_web_fs_file_exists(const char *path, size_t pathLen), {
     return NATIVE_FS->FileExists(std::string{path, pathLen});
 });
+RT_FN(void duckdb_web_fs_file_remove(const char *path, size_t pathLen), {
+    NATIVE_FS->RemoveFile(std::string{path, pathLen});
+});
 #undef RT_FN
 
 extern "C" void duckdb_web_fs_glob_add_path(const char *path) {
@@ -165,7 +197,7 @@ void WebFileSystem::DataBuffer::Resize(size_t n) {
     if (n > capacity_) {
         auto cap = std::max(capacity_ + capacity_ + capacity_ / 4, n);
         auto next = std::unique_ptr<char[]>(new char[cap]);
-        ::memcpy(next.get(), data_.get(), size_);
+        if (size_ > 0) ::memcpy(next.get(), data_.get(), size_);
         data_ = std::move(next);
         capacity_ = cap;
     } else if (n < (capacity_ / 2)) {
@@ -185,6 +217,13 @@ static WebFileSystem *WEBFS = nullptr;
 /// Get the static web filesystem
 WebFileSystem *WebFileSystem::Get() { return WEBFS; }
 
+#ifndef EMSCRIPTEN
+/// Get the number of syncs that reached the native test runtime
+size_t WebFileSystem::GetNativeRuntimeSyncCount() { return NATIVE_SYNC_COUNT; }
+/// Get the number of reads that reached the native test runtime
+size_t WebFileSystem::GetNativeRuntimeReadCount() { return NATIVE_READ_COUNT; }
+#endif
+
 /// Resolve readahead
 ReadAheadBuffer *WebFileSystem::WebFileHandle::ResolveReadAheadBuffer(std::shared_lock<SharedMutex> &file_guard) {
     auto tid = GetThreadID();
@@ -229,8 +268,8 @@ void WebFileSystem::WebFileHandle::Close() {
     }
     // Failed to lock exclusively?
     if (!have_file_lock) return;
-    // Is buffered file?
-    if (file.data_protocol_ == DataProtocol::BUFFER) return;
+    // Is buffered or pinned file?
+    if (file.data_protocol_ == DataProtocol::BUFFER || file.pinned_) return;
 
     // Close the file in the runtime
     fs_guard.unlock();
@@ -241,6 +280,7 @@ void WebFileSystem::WebFileHandle::Close() {
     auto file_id = file.file_id_;
     auto file_proto = file.data_protocol_;
     fs.files_by_name_.erase(file.file_name_);
+    fs.file_paths_.Erase(file.file_name_);
     auto iter = fs.files_by_id_.find(file.file_id_);
     auto tmp = std::move(iter->second);
     fs.files_by_id_.erase(iter);
@@ -260,6 +300,8 @@ static inline WebFileSystem::DataProtocol inferDataProtocol(std::string_view url
     auto proto = WebFileSystem::DataProtocol::BUFFER;
     if (hasPrefix(url, "http://") || hasPrefix(url, "https://")) {
         proto = WebFileSystem::DataProtocol::HTTP;
+    } else if (hasPrefix(url, WebFileSystem::SCRATCH_PREFIX)) {
+        proto = WebFileSystem::DataProtocol::BUFFER;
     } else if (hasPrefix(url, "file://")) {
         data_url = std::string_view{url}.substr(7);
         proto = WebFileSystem::DataProtocol::NATIVE;
@@ -296,9 +338,66 @@ rapidjson::Value WebFileSystem::WebFile::WriteInfo(rapidjson::Document &doc) con
     if (data_protocol_ == DataProtocol::HTTP && filesystem_.config_->filesystem.allow_full_http_reads) {
         value.AddMember("allowFullHttpReads", true, allocator);
     }
+    if (data_protocol_ == DataProtocol::HTTP && filesystem_.config_->filesystem.speculative_tail_size > 0) {
+        value.AddMember("speculativeTailSize", rapidjson::Value{filesystem_.config_->filesystem.speculative_tail_size},
+                        allocator);
+    }
+    if (data_protocol_ != DataProtocol::BUFFER) {
+        if (auto *estimator = filesystem_.bandwidth_estimator_.Find(GetDataOrigin())) {
+            value.AddMember("bandwidth", estimator->WriteInfo(doc), allocator);
+        }
+    }
     return value;
 }
 
+/// Get the origin of the file data
+std::string WebFileSystem::WebFile::GetDataOrigin() const {
+    auto url = data_url_ ? std::string_view{*data_url_} : std::string_view{file_name_};
+    return io::BandwidthEstimator::ResolveOrigin(url);
+}
+
+/// Resolve the estimator of the data origin
+io::OriginEstimator &WebFileSystem::WebFile::ResolveOriginEstimator() {
+    if (auto *estimator = origin_estimator_.load()) return *estimator;
+    // Estimators are never erased, concurrent resolvers get the same one
+    auto &estimator = filesystem_.bandwidth_estimator_.Resolve(GetDataOrigin());
+    origin_estimator_ = &estimator;
+    return estimator;
+}
+
+/// Read from the speculative tail
+size_t WebFileSystem::WebFile::ReadFromSpeculativeTail(void *buffer, size_t n, uint64_t offset) {
+    if (!speculative_tail_) return 0;
+    auto tail = speculative_tail_->Get();
+    auto tail_offset = file_size_ - std::min<uint64_t>(file_size_, tail.size());
+    if (offset < tail_offset || offset >= file_size_) return 0;
+    auto copy_here = std::min<uint64_t>(n, file_size_ - offset);
+    ::memcpy(buffer, tail.data() + (offset - tail_offset), copy_here);
+    return copy_here;
+}
+
+/// Keep a speculative tail
+void WebFileSystem::WebFile::SetSpeculativeTail(DataBuffer tail) {
+    speculative_tail_bytes_ = tail.Get().size();
+    speculative_tail_ = std::move(tail);
+}
+
+/// Drop the speculative tail
+size_t WebFileSystem::WebFile::DropSpeculativeTail() {
+    speculative_tail_.reset();
+    return speculative_tail_bytes_.exchange(0);
+}
+
+/// Read from the runtime and record the read with the origin estimator
+int64_t WebFileSystem::WebFile::ReadFromRuntime(void *buffer, size_t n, uint64_t offset) {
+    auto &estimator = ResolveOriginEstimator();
+    auto start = std::chrono::steady_clock::now();
+    auto bytes = duckdb_web_fs_file_read(file_id_, buffer, n, offset);
+    auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+    if (bytes > 0) estimator.Record(bytes, duration.count());
+    return bytes;
+}
+
 /// Constructor
 WebFileSystem::WebFileSystem(std::shared_ptr<WebDBConfig> config) : config_(std::move(config)) {
     assert(WEBFS == nullptr && "Can only register a single WebFileSystem at a time");
@@ -319,6 +418,61 @@ void WebFileSystem::InvalidateReadAheads(size_t file_id, std::unique_lock<Shared
     }
 }
 
+/// Get the bytes of all readahead buffers and speculative tails
+size_t WebFileSystem::GetMemoryUsage() {
+    std::unique_lock<LightMutex> fs_guard{fs_mutex_};
+    size_t usage = 0;
+    for (auto &ra : readahead_buffers_) {
+        usage += ra.second->GetMemoryUsage();
+    }
+    for (auto &[file_id, file] : files_by_id_) {
+        usage += file->speculative_tail_bytes_;
+    }
+    return usage;
+}
+
+/// Split a memory limit among the read heads of all threads
+void WebFileSystem::SetMemoryLimit(size_t bytes) {
+    auto maximum = READAHEAD_MAXIMUM;
+    if (bytes > 0) {
+        auto threads = std::max<size_t>(1, config_->maximum_threads);
+        maximum = std::clamp<size_t>(bytes / (threads * READ_HEAD_COUNT), READAHEAD_BASE, READAHEAD_MAXIMUM);
+    }
+    readahead_maximum_ = maximum;
+    // Release the read heads that exceed the new maximum
+    std::unique_lock<LightMutex> fs_guard{fs_mutex_};
+    for (auto &ra : readahead_buffers_) {
+        ra.second->Release(maximum);
+    }
+}
+
+/// Release readahead buffers and speculative tails
+size_t WebFileSystem::ReclaimMemory(size_t bytes) {
+    std::unique_lock<LightMutex> fs_guard{fs_mutex_};
+    size_t released = 0;
+    for (auto &ra : readahead_buffers_) {
+        if (released >= bytes) break;
+        released += ra.second->Release();
+    }
+    if (released >= bytes) return released;
+
+    // Collect the files with a tail, file latches are acquired before the filesystem latch
+    std::vector<std::shared_ptr<WebFile>> files;
+    for (auto &[file_id, file] : files_by_id_) {
+        if (file->speculative_tail_bytes_ > 0) files.push_back(file);
+    }
+    fs_guard.unlock();
+
+    // The tails are only a hint, skip files that are currently latched
+    for (auto &file : files) {
+        if (released >= bytes) break;
+        std::unique_lock<SharedMutex> file_guard{file->file_mutex_, std::try_to_lock};
+        if (!file_guard.owns_lock()) continue;
+        released += file->DropSpeculativeTail();
+    }
+    return released;
+}
+
 /// Register a file URL
 arrow::Result<std::unique_ptr<WebFileSystem::WebFileHandle>> WebFileSystem::RegisterFileURL(
     std::string_view file_name, std::string_view file_url, std::optional<uint64_t> file_size) {
@@ -344,11 +498,117 @@ arrow::Result<std::unique_ptr<WebFileSystem::WebFileHandle>> WebFileSystem::Regi
     // Register the file
     files_by_id_.insert({file_id, file});
     files_by_name_.insert({file->file_name_, file});
+    file_paths_.Insert(file->file_name_);
 
     // Build the file handle
     return std::make_unique<WebFileHandle>(file);
 }
 
+/// Check a batch of file URLs
+arrow::Status WebFileSystem::CheckFileURLs(nonstd::span<const FileURL> files,
+                                           const std::function<bool(std::string_view)> &pinned) {
+    DEBUG_TRACE();
+    std::unique_lock<LightMutex> fs_guard{fs_mutex_};
+    std::unordered_set<std::string_view> batch_names;
+    batch_names.reserve(files.size());
+    for (auto &[file_name, file_url, file_size] : files) {
+        if (!batch_names.insert(file_name).second) {
+            return arrow::Status::Invalid("File registered twice: ", file_name);
+        }
+        auto iter = files_by_name_.find(std::string{file_name});
+        if (iter == files_by_name_.end() || iter->second->data_url_ == file_url) continue;
+        // A different URL replaces the file only if unpinning drops it
+        auto &file = *iter->second;
+        auto handles = file.handle_count_ - (pinned(file_name) ? 1 : 0);
+        if (handles > 0 || file.data_protocol_ == DataProtocol::BUFFER) {
+            return arrow::Status::Invalid("File already registered: ", file_name);
+        }
+    }
+    return arrow::Status::OK();
+}
+
+/// Register multiple file URLs
+arrow::Result<std::vector<std::unique_ptr<WebFileSystem::WebFileHandle>>> WebFileSystem::RegisterFileURLs(
+    nonstd::span<const FileURL> files, bool defer_handles) {
+    DEBUG_TRACE();
+    std::unique_lock<LightMutex> fs_guard{fs_mutex_};
+
+    // Check all files before registering any of them
+    std::vector<std::shared_ptr<WebFile>> known_files(files.size());
+    std::unordered_set<std::string_view> batch_names;
+    batch_names.reserve(files.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        auto &[file_name, file_url, file_size] = files[i];
+        if (!batch_names.insert(file_name).second) {
+            return arrow::Status::Invalid("File registered twice: ", file_name);
+        }
+        auto iter = files_by_name_.find(std::string{file_name});
+        if (iter == files_by_name_.end()) continue;
+        if (iter->second->data_url_ != file_url) {
+            return arrow::Status::Invalid("File already registered: ", file_name);
+        }
+        known_files[i] = iter->second;
+    }
+
+    // Register all new files
+    files_by_id_.reserve(files_by_id_.size() + files.size());
+    files_by_name_.reserve(files_by_name_.size() + files.size());
+    std::vector<std::unique_ptr<WebFileHandle>> handles;
+    if (!defer_handles) handles.reserve(files.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        auto &[file_name, file_url, file_size] = files[i];
+        auto file = std::move(known_files[i]);
+        if (!file) {
+            auto file_id = AllocateFileID();
+            file = std::make_shared<WebFile>(*this, file_id, file_name, inferDataProtocol(file_url));
+            file->data_url_ = file_url;
+            file->file_size_ = file_size.value_or(0);
+            files_by_id_.insert({file_id, file});
+            files_by_name_.insert({file->file_name_, file});
+            file_paths_.Insert(file->file_name_);
+        }
+        // Pin the file either with a handle or with the pin flag
+        if (defer_handles) {
+            file->pinned_ = true;
+        } else {
+            handles.push_back(std::make_unique<WebFileHandle>(std::move(file)));
+        }
+    }
+    return handles;
+}
+
+/// Decode a batch of file URLs
+arrow::Result<std::vector<WebFileSystem::FileURL>> WebFileSystem::DecodeFileURLs(nonstd::span<const char> batch) {
+    auto read = [&](size_t offset, auto &value) {
+        if (batch.size() < offset || (batch.size() - offset) < sizeof(value)) return false;
+        std::memcpy(&value, batch.data() + offset, sizeof(value));
+        return true;
+    };
+    uint32_t count = 0;
+    if (!read(0, count)) return arrow::Status::Invalid("truncated file batch");
+    size_t offset = sizeof(count);
+    std::vector<FileURL> files;
+    files.reserve(std::min<size_t>(count, batch.size() / 16));
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t name_length = 0, url_length = 0;
+        uint64_t file_size = 0;
+        if (!read(offset, name_length) || !read(offset + 4, url_length) || !read(offset + 8, file_size)) {
+            return arrow::Status::Invalid("truncated file batch");
+        }
+        offset += 16;
+        if ((batch.size() - offset) < (static_cast<size_t>(name_length) + url_length)) {
+            return arrow::Status::Invalid("truncated file batch");
+        }
+        FileURL file;
+        file.file_name = std::string_view{batch.data() + offset, name_length};
+        file.file_url = std::string_view{batch.data() + offset + name_length, url_length};
+        if (file_size != std::numeric_limits<uint64_t>::max()) file.file_size = file_size;
+        offset += name_length + url_length;
+        files.push_back(file);
+    }
+    return files;
+}
+
 /// Register a file buffer
 arrow::Result<std::unique_ptr<WebFileSystem::WebFileHandle>> WebFileSystem::RegisterFileBuffer(
     std::string_view file_name, DataBuffer file_buffer) {
@@ -389,6 +649,7 @@ arrow::Result<std::unique_ptr<WebFileSystem::WebFileHandle>> WebFileSystem::Regi
     // Register the file
     files_by_id_.insert({file_id, file});
     files_by_name_.insert({file->file_name_, file});
+    file_paths_.Insert(file->file_name_);
 
     // Build the file handle
     return std::make_unique<WebFileHandle>(file);
@@ -403,6 +664,7 @@ void WebFileSystem::DropDanglingFiles() {
     for (auto &[file_id, file] : files_by_id_) {
         if (file->handle_count_ == 0) {
             files_by_name_.erase(file->file_name_);
+            file_paths_.Erase(file->file_name_);
             to_delete.push_back(file_id);
         }
     }
@@ -419,12 +681,39 @@ bool WebFileSystem::TryDropFile(std::string_view file_name) {
     if (iter == files_by_name_.end()) return true;
     if (iter->second->handle_count_ == 0) {
         files_by_id_.erase(iter->second->file_id_);
+        file_paths_.Erase(iter->second->file_name_);
         files_by_name_.erase(iter->second->file_name_);
         return true;
     }
     return false;
 }
 
+/// Unpin a file that was pinned without a handle
+void WebFileSystem::UnpinFile(std::string_view file_name) {
+    DEBUG_TRACE();
+    std::unique_lock<LightMutex> fs_guard{fs_mutex_};
+    auto iter = files_by_name_.find(std::string{file_name});
+    if (iter == files_by_name_.end() || !iter->second->pinned_) return;
+    auto file = iter->second;
+    file->pinned_ = false;
+    // Drop the file like the last handle would have done
+    if (file->handle_count_ > 0 || file->data_protocol_ == DataProtocol::BUFFER) return;
+    file_paths_.Erase(file->file_name_);
+    files_by_name_.erase(iter);
+    files_by_id_.erase(file->file_id_);
+    fs_guard.unlock();
+    duckdb_web_fs_file_close(file->file_id_);
+}
+
+/// Resolve the data protocol of a file
+WebFileSystem::DataProtocol WebFileSystem::ResolveDataProtocol(std::string_view file_name) {
+    std::unique_lock<LightMutex> fs_guard{fs_mutex_};
+    if (auto iter = files_by_name_.find(std::string{file_name}); iter != files_by_name_.end()) {
+        return iter->second->data_protocol_;
+    }
+    return inferDataProtocol(file_name);
+}
+
 /// Set a file descriptor
 arrow::Status WebFileSystem::SetFileDescriptor(uint32_t file_id, uint32_t file_descriptor) {
     DEBUG_TRACE();
@@ -508,15 +797,26 @@ std::unique_ptr<duckdb::FileHandle> WebFileSystem::OpenFile(const string &url, u
         // Determine url type
         DataProtocol data_proto = inferDataProtocol(url);
 
+        // Scratch files only exist in memory and must be created explicitly
+        if (data_proto == DataProtocol::BUFFER && (flags & duckdb::FileFlags::FILE_FLAGS_FILE_CREATE) == 0 &&
+            (flags & duckdb::FileFlags::FILE_FLAGS_FILE_CREATE_NEW) == 0) {
+            throw std::runtime_error("scratch file does not exist: " + url);
+        }
+
         // Create file
         file = std::make_shared<WebFile>(*this, AllocateFileID(), url, data_proto);
         auto file_id = file->file_id_;
-        file->data_url_ = url;
+        if (data_proto == DataProtocol::BUFFER) {
+            file->data_buffer_ = DataBuffer{nullptr, 0};
+        } else {
+            file->data_url_ = url;
+        }
 
         // Register in directory
         std::string file_name{file->file_name_};
         files_by_id_.insert({file_id, file});
         files_by_name_.insert({file_name, file});
+        file_paths_.Insert(file_name);
     } else {
         file = iter->second;
     }
@@ -525,6 +825,10 @@ std::unique_ptr<duckdb::FileHandle> WebFileSystem::OpenFile(const string &url, u
     // Lock the file
     fs_guard.unlock();
     std::unique_lock<SharedMutex> file_guard{file->file_mutex_};
+    if ((flags & duckdb::FileFlags::FILE_FLAGS_WRITE) != 0) {
+        file->opened_for_writing_ = true;
+        file->DropSpeculativeTail();
+    }
 
     // Try to open the file (if necessary)
     switch (file->data_protocol_) {
@@ -539,6 +843,8 @@ std::unique_ptr<duckdb::FileHandle> WebFileSystem::OpenFile(const string &url, u
             if (file->data_fd_.has_value()) break;
             // Otherwise treat as HTTP
         case DataProtocol::HTTP:
+            // Already opened and sized?
+            if (file->opened_ && (flags & duckdb::FileFlags::FILE_FLAGS_FILE_CREATE_NEW) == 0) break;
             try {
                 // Open the file
                 auto *opened = duckdb_web_fs_file_open(file->file_id_);
@@ -549,6 +855,20 @@ std::unique_ptr<duckdb::FileHandle> WebFileSystem::OpenFile(const string &url, u
                 auto owned = std::unique_ptr<OpenedFile>(static_cast<OpenedFile *>(opened));
                 file->file_size_ = owned->file_size;
 
+                // Did the runtime fetch the tail together with the file size?
+                // Metadata reads at the end of the file are then served without another round trip.
+                // Writable files never keep the tail.
+                auto *tail_ptr = reinterpret_cast<char *>(static_cast<uintptr_t>(owned->tail_buffer));
+                if (tail_ptr) {
+                    auto owned_tail = std::unique_ptr<char[]>(tail_ptr);
+                    auto tail_size = std::min<uint64_t>(owned->tail_size, file->file_size_);
+                    if (!file->opened_for_writing_) {
+                        file->SetSpeculativeTail(DataBuffer{std::move(owned_tail), static_cast<size_t>(tail_size)});
+                    }
+                } else {
+                    file->DropSpeculativeTail();
+                }
+
                 // Was the file fully copied into wasm memory?
                 // This can happen if the data source does not support HTTP range requests.
                 auto *buffer_ptr = reinterpret_cast<char *>(static_cast<uintptr_t>(owned->file_buffer));
@@ -558,6 +878,7 @@ std::unique_ptr<duckdb::FileHandle> WebFileSystem::OpenFile(const string &url, u
                     file->data_buffer_ = DataBuffer{std::move(owned_buffer), static_cast<size_t>(file->file_size_)};
                     // XXX Note that data_url is still set
                 }
+                file->opened_ = true;
 
                 // Truncate file?
                 if ((flags & duckdb::FileFlags::FILE_FLAGS_FILE_CREATE_NEW) != 0) {
@@ -570,6 +891,7 @@ std::unique_ptr<duckdb::FileHandle> WebFileSystem::OpenFile(const string &url, u
                 /// Something wen't wrong, abort opening the file
                 fs_guard.lock();
                 files_by_name_.erase(file->file_name_);
+                file_paths_.Erase(file->file_name_);
                 auto iter = files_by_id_.find(file->file_id_);
                 auto tmp = std::move(iter->second);
                 files_by_id_.erase(iter);
@@ -600,7 +922,9 @@ void WebFileSystem::Read(duckdb::FileHandle &handle, void *buffer, int64_t nr_by
     file_hdl.position_ = location;
     while (nr_bytes > 0 && location < file_size) {
         auto n = Read(handle, reader, nr_bytes);
+        if (n == 0) break;
         reader += n;
+        location += n;
         nr_bytes -= n;
     }
 }
@@ -633,16 +957,26 @@ int64_t WebFileSystem::Read(duckdb::FileHandle &handle, void *buffer, int64_t nr
         // Just read with the filesystem api
         case DataProtocol::NATIVE:
         case DataProtocol::HTTP: {
+            // Serve reads from the speculative tail
+            if (auto n = file.ReadFromSpeculativeTail(buffer, nr_bytes, file_hdl.position_); n > 0) {
+                if (file.file_stats_) {
+                    file.file_stats_->RegisterFileReadCached(file_hdl.position_, n);
+                }
+                file_hdl.position_ += n;
+                return n;
+            }
             if (auto ra = file_hdl.ResolveReadAheadBuffer(file_guard)) {
-                auto reader = [&](auto *out, size_t n, duckdb::idx_t ofs) {
-                    return duckdb_web_fs_file_read(file.file_id_, out, n, ofs);
-                };
+                auto reader = [&](auto *out, size_t n, duckdb::idx_t ofs) { return file.ReadFromRuntime(out, n, ofs); };
+                // Size the read heads after the bandwidth-delay product of the origin
+                auto policy = file.ResolveOriginEstimator().Get().GetReadAheadPolicy();
+                policy.maximum = std::min<size_t>(policy.maximum, readahead_maximum_);
+                policy.base = std::min<size_t>(policy.base, policy.maximum);
                 auto n = ra->Read(file.file_id_, file.file_size_, buffer, nr_bytes, file_hdl.position_, reader,
-                                  file.file_stats_.get());
+                                  file.file_stats_.get(), policy);
                 file_hdl.position_ += n;
                 return n;
             } else {
-                auto n = duckdb_web_fs_file_read(file.file_id_, buffer, nr_bytes, file_hdl.position_);
+                auto n = file.ReadFromRuntime(buffer, nr_bytes, file_hdl.position_);
                 // Register read
                 if (file.file_stats_) {
                     file.file_stats_->RegisterFileReadCold(file_hdl.position_, n);
@@ -658,10 +992,9 @@ int64_t WebFileSystem::Read(duckdb::FileHandle &handle, void *buffer, int64_t nr
 
 void WebFileSystem::Write(duckdb::FileHandle &handle, void *buffer, int64_t nr_bytes, duckdb::idx_t location) {
     auto &file_hdl = static_cast<WebFileHandle &>(handle);
-    auto file_size = file_hdl.file_->file_size_;
     auto writer = static_cast<char *>(buffer);
     file_hdl.position_ = location;
-    while (nr_bytes > 0 && location < file_size) {
+    while (nr_bytes > 0) {
         auto n = Write(handle, writer, nr_bytes);
         writer += n;
         nr_bytes -= n;
@@ -709,6 +1042,7 @@ int64_t WebFileSystem::Write(duckdb::FileHandle &handle, void *buffer, int64_t n
         case DataProtocol::NATIVE: {
             auto end = file_hdl.position_ + nr_bytes;
             size_t n;
+            assert(!file.speculative_tail_);
 
             // Write past end?
             if (end > file.file_size_) {
@@ -740,6 +1074,7 @@ int64_t WebFileSystem::Write(duckdb::FileHandle &handle, void *buffer, int64_t n
                 file_hdl.position_ = file_hdl.position_ + n;
             }
             bytes_read = n;
+            ++file.write_epoch_;
             break;
         }
         case DataProtocol::HTTP: {
@@ -795,6 +1130,8 @@ void WebFileSystem::Truncate(duckdb::FileHandle &handle, int64_t new_size) {
         case DataProtocol::NATIVE:
         case DataProtocol::HTTP: {
             duckdb_web_fs_file_truncate(file.file_id_, new_size);
+            file.DropSpeculativeTail();
+            ++file.write_epoch_;
             break;
         }
     }
@@ -836,27 +1173,114 @@ void WebFileSystem::MoveFile(const std::string &source, const std::string &targe
 bool WebFileSystem::FileExists(const std::string &filename) {
     auto iter = files_by_name_.find(filename);
     if (iter != files_by_name_.end()) return true;
+    if (hasPrefix(filename, SCRATCH_PREFIX)) return false;
     return duckdb_web_fs_file_exists(filename.c_str(), filename.size());
 }
 /// Remove a file from disk
 void WebFileSystem::RemoveFile(const std::string &filename) {
-    throw std::logic_error("WebFileSystem::RemoveFile not implemented");
+    DEBUG_TRACE();
+    std::unique_lock<LightMutex> fs_guard{fs_mutex_};
+    auto iter = files_by_name_.find(filename);
+    if (iter == files_by_name_.end()) {
+        fs_guard.unlock();
+        if (hasPrefix(filename, SCRATCH_PREFIX)) return;
+        duckdb_web_fs_file_remove(filename.c_str(), filename.size());
+        return;
+    }
+    auto file = iter->second;
+
+    // Drop the file from the directory if nobody holds a handle.
+    // Otherwise the file stays registered (e.g. pinned buffers) but loses its contents.
+    if (file->handle_count_ == 0) {
+        file_paths_.Erase(file->file_name_);
+        files_by_name_.erase(iter);
+        files_by_id_.erase(file->file_id_);
+    }
+    fs_guard.unlock();
+
+    std::unique_lock<SharedMutex> file_guard{file->file_mutex_};
+    switch (file->data_protocol_) {
+        case DataProtocol::BUFFER:
+            if (file->data_buffer_) file->data_buffer_->Resize(0);
+            file->file_size_ = 0;
+            break;
+        case DataProtocol::NATIVE: {
+            auto &path = file->data_url_ ? *file->data_url_ : file->file_name_;
+            duckdb_web_fs_file_remove(path.c_str(), path.size());
+            file->file_size_ = 0;
+            break;
+        }
+        case DataProtocol::HTTP:
+            throw std::runtime_error("cannot remove HTTP files");
+    }
+    ++file->write_epoch_;
+    InvalidateReadAheads(file->file_id_, file_guard);
 }
 
 /// Sync a file handle to disk
 void WebFileSystem::FileSync(duckdb::FileHandle &handle) {
-    // Noop, runtime writes directly
+    DEBUG_TRACE();
+    auto &file_hdl = static_cast<WebFileHandle &>(handle);
+    assert(file_hdl.file_);
+    auto &file = *file_hdl.file_;
+
+    // Buffers live in wasm memory, there's nothing to sync
+    {
+        std::shared_lock<SharedMutex> file_guard{file.file_mutex_};
+        if (file.data_protocol_ == DataProtocol::BUFFER) return;
+    }
+
+    // All writes that finished before this call must be durable when we return
+    std::unique_lock<std::mutex> sync_guard{file.sync_mutex_};
+    auto required_epoch = file.write_epoch_.load();
+    while (true) {
+        // Covered by a sync of someone else?
+        if (file.synced_epoch_ >= required_epoch) return;
+        // Become the leader if no sync is in flight.
+        // A sync that is already in flight might have sampled the epoch before our writes finished.
+        if (!file.sync_in_flight_) break;
+        file.sync_cv_.wait(sync_guard);
+    }
+    file.sync_in_flight_ = true;
+    sync_guard.unlock();
+
+    // Give concurrent writers the chance to join this sync
+    if (auto window = config_->filesystem.sync_window_micros; window > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds{window});
+    }
+
+    // Sample the epoch before syncing, everything written up to here is covered
+    auto synced_epoch = file.write_epoch_.load();
+    try {
+        duckdb_web_fs_file_sync(file.file_id_);
+    } catch (...) {
+        sync_guard.lock();
+        file.sync_in_flight_ = false;
+        file.sync_cv_.notify_all();
+        throw;
+    }
+
+    // Publish the synced epoch and wake up all followers
+    sync_guard.lock();
+    file.synced_epoch_ = std::max(file.synced_epoch_, synced_epoch);
+    file.sync_in_flight_ = false;
+    file.sync_cv_.notify_all();
 }
 
 /// Runs a glob on the file system, returning a list of matching files
 std::vector<std::string> WebFileSystem::Glob(const std::string &path) {
     std::unique_lock<LightMutex> fs_guard{fs_mutex_};
     std::vector<std::string> results;
-    auto glob = glob_to_regex(path);
-    for (auto [name, file] : files_by_name_) {
-        if (std::regex_match(file->file_name_, glob)) {
-            results.push_back(std::string{name});
-        }
+    GlobMatcher glob{path};
+    if (glob.IsLiteral()) {
+        // Plain paths are resolved with a single lookup of the unescaped literal
+        std::string literal{glob.GetLiteralPrefix()};
+        if (files_by_name_.count(literal)) results.push_back(std::move(literal));
+    } else {
+        // Only visit the registered files that share the literal prefix
+        file_paths_.VisitPrefix(glob.GetLiteralPrefix(), [&](std::string_view name) {
+            if (glob.Matches(name)) results.emplace_back(name);
+        });
     }
     auto &state = GetLocalState();
     state.glob_results.clear();
@@ -253,7 +253,7 @@ template <typename Derived, typename BuilderType> class BaseArrayParser : public
     /// Builder factory
     arrow::Status MakeConcreteBuilder(std::shared_ptr<BuilderType>* out) {
         std::unique_ptr<arrow::ArrayBuilder> builder;
-        RETURN_NOT_OK(MakeBuilder(arrow::default_memory_pool(), this->type_, &builder));
+        RETURN_NOT_OK(MakeBuilder(this->pool_, this->type_, &builder));
         *out = arrow::internal::checked_pointer_cast<BuilderType>(std::move(builder));
         return arrow::Status::OK();
     }
@@ -275,9 +275,11 @@ template <typename Derived, typename BuilderType> class BaseArrayParser : public
 class NullArrayParser final : public BaseArrayParser<NullArrayParser, arrow::NullBuilder> {
    public:
     /// Constructor
-    explicit NullArrayParser(const std::shared_ptr<arrow::DataType>& type) {
-        type_ = type;
-        builder_ = std::make_shared<arrow::NullBuilder>();
+    explicit NullArrayParser(const std::shared_ptr<arrow::DataType>& type) { type_ = type; }
+    /// Initialize the array builder
+    arrow::Status Init() override {
+        builder_ = std::make_shared<arrow::NullBuilder>(pool_);
+        return arrow::Status::OK();
     }
     /// Append a value
     arrow::Status AppendValue(const rapidjson::Value& json_obj) override {
@@ -290,9 +292,11 @@ class NullArrayParser final : public BaseArrayParser<NullArrayParser, arrow::Nul
 class BooleanArrayParser final : public BaseArrayParser<BooleanArrayParser, arrow::BooleanBuilder> {
    public:
     /// Constructor
-    explicit BooleanArrayParser(const std::shared_ptr<arrow::DataType>& type) {
-        type_ = type;
-        builder_ = std::make_shared<arrow::BooleanBuilder>();
+    explicit BooleanArrayParser(const std::shared_ptr<arrow::DataType>& type) { type_ = type; }
+    /// Initialize the array builder
+    arrow::Status Init() override {
+        builder_ = std::make_shared<arrow::BooleanBuilder>(pool_);
+        return arrow::Status::OK();
     }
     /// Append a value
     arrow::Status AppendValue(const rapidjson::Value& json_obj) override {
@@ -379,7 +383,11 @@ class TimestampArrayParser final : public BaseArrayParser<TimestampArrayParser,
     explicit TimestampArrayParser(const std::shared_ptr<arrow::DataType>& type)
         : timestamp_type_{&static_cast<const arrow::TimestampType&>(*type.get())} {
         this->type_ = type;
-        builder_ = std::make_shared<arrow::TimestampBuilder>(type, arrow::default_memory_pool());
+    }
+    /// Initialize the array builder
+    arrow::Status Init() override {
+        builder_ = std::make_shared<arrow::TimestampBuilder>(type_, pool_);
+        return arrow::Status::OK();
     }
     /// Append a value
     arrow::Status AppendValue(const rapidjson::Value& json_obj) override {
@@ -393,9 +401,11 @@ class DayTimeIntervalArrayParser final
     : public BaseArrayParser<DayTimeIntervalArrayParser, arrow::DayTimeIntervalBuilder> {
    public:
     /// Constructor
-    explicit DayTimeIntervalArrayParser(const std::shared_ptr<arrow::DataType>& type) {
-        type_ = type;
-        builder_ = std::make_shared<arrow::DayTimeIntervalBuilder>(arrow::default_memory_pool());
+    explicit DayTimeIntervalArrayParser(const std::shared_ptr<arrow::DataType>& type) { type_ = type; }
+    /// Initialize the array builder
+    arrow::Status Init() override {
+        builder_ = std::make_shared<arrow::DayTimeIntervalBuilder>(pool_);
+        return arrow::Status::OK();
     }
     /// Append a value
     arrow::Status AppendValue(const rapidjson::Value& json_obj) override {
@@ -458,9 +468,9 @@ class ListArrayParser final
     /// Initialize the array builder
     arrow::Status Init() override {
         const auto& list_type = static_cast<const TYPE&>(*this->type_);
-        ARROW_ASSIGN_OR_RAISE(child_converter_, ArrayParser::Resolve(list_type.value_type()));
+        ARROW_ASSIGN_OR_RAISE(child_converter_, ArrayParser::Resolve(list_type.value_type(), this->pool_));
         auto child_builder = child_converter_->builder();
-        this->builder_ = std::make_shared<BuilderType>(arrow::default_memory_pool(), child_builder, this->type_);
+        this->builder_ = std::make_shared<BuilderType>(this->pool_, child_builder, this->type_);
         return arrow::Status::OK();
     }
     /// Append a value
@@ -483,11 +493,11 @@ class MapArrayParser final : public BaseArrayParser<MapArrayParser, arrow::MapBu
     /// Initialize the parser
     arrow::Status Init() override {
         const auto& map_type = static_cast<const arrow::MapType&>(*type_);
-        ARROW_ASSIGN_OR_RAISE(key_parser_, ArrayParser::Resolve(map_type.key_type()));
-        ARROW_ASSIGN_OR_RAISE(item_parser_, ArrayParser::Resolve(map_type.item_type()));
+        ARROW_ASSIGN_OR_RAISE(key_parser_, ArrayParser::Resolve(map_type.key_type(), pool_));
+        ARROW_ASSIGN_OR_RAISE(item_parser_, ArrayParser::Resolve(map_type.item_type(), pool_));
         auto key_builder = key_parser_->builder();
         auto item_builder = item_parser_->builder();
-        builder_ = std::make_shared<arrow::MapBuilder>(arrow::default_memory_pool(), key_builder, item_builder, type_);
+        builder_ = std::make_shared<arrow::MapBuilder>(pool_, key_builder, item_builder, type_);
         return arrow::Status::OK();
     }
     /// Append a value
@@ -524,9 +534,9 @@ class FixedSizeListArrayParser final : public BaseArrayParser<FixedSizeListArray
     arrow::Status Init() override {
         const auto& list_type = static_cast<const arrow::FixedSizeListType&>(*type_);
         list_size_ = list_type.list_size();
-        ARROW_ASSIGN_OR_RAISE(child_converter_, ArrayParser::Resolve(list_type.value_type()));
+        ARROW_ASSIGN_OR_RAISE(child_converter_, ArrayParser::Resolve(list_type.value_type(), this->pool_));
         auto child_builder = child_converter_->builder();
-        builder_ = std::make_shared<arrow::FixedSizeListBuilder>(arrow::default_memory_pool(), child_builder, type_);
+        builder_ = std::make_shared<arrow::FixedSizeListBuilder>(pool_, child_builder, type_);
         return arrow::Status::OK();
     }
     /// Append a JSON value
@@ -555,12 +565,11 @@ class StructArrayParser final : public BaseArrayParser<StructArrayParser, arrow:
         std::vector<std::shared_ptr<arrow::ArrayBuilder>> child_builders;
         for (const auto& field : type_->fields()) {
             std::shared_ptr<ArrayParser> child_converter;
-            ARROW_ASSIGN_OR_RAISE(child_converter, ArrayParser::Resolve(field->type()));
+            ARROW_ASSIGN_OR_RAISE(child_converter, ArrayParser::Resolve(field->type(), pool_));
             child_parsers_.push_back(child_converter);
             child_builders.push_back(child_converter->builder());
         }
-        builder_ =
-            std::make_shared<arrow::StructBuilder>(type_, arrow::default_memory_pool(), std::move(child_builders));
+        builder_ = std::make_shared<arrow::StructBuilder>(type_, pool_, std::move(child_builders));
         return arrow::Status::OK();
     }
 
@@ -624,16 +633,14 @@ class UnionArrayParser final : public BaseArrayParser<UnionArrayParser, arrow::A
         std::vector<std::shared_ptr<arrow::ArrayBuilder>> child_builders;
         for (const auto& field : type_->fields()) {
             std::shared_ptr<ArrayParser> child_converter;
-            ARROW_ASSIGN_OR_RAISE(child_converter, ArrayParser::Resolve(field->type()));
+            ARROW_ASSIGN_OR_RAISE(child_converter, ArrayParser::Resolve(field->type(), pool_));
             child_parsers_.push_back(child_converter);
             child_builders.push_back(child_converter->builder());
         }
         if (mode_ == arrow::UnionMode::DENSE) {
-            builder_ = std::make_shared<arrow::DenseUnionBuilder>(arrow::default_memory_pool(),
-                                                                  std::move(child_builders), type_);
+            builder_ = std::make_shared<arrow::DenseUnionBuilder>(pool_, std::move(child_builders), type_);
         } else {
-            builder_ = std::make_shared<arrow::SparseUnionBuilder>(arrow::default_memory_pool(),
-                                                                   std::move(child_builders), type_);
+            builder_ = std::make_shared<arrow::SparseUnionBuilder>(pool_, std::move(child_builders), type_);
         }
         return arrow::Status::OK();
     }
@@ -713,7 +720,6 @@ arrow::Result<std::shared_ptr<ArrayParser>> GetDictArrayParser(const std::shared
 #undef SIMPLE_PARSER_CASE
 #undef PARAM_PARSER_CASE
 
-    RETURN_NOT_OK(res->Init());
     return res;
 }
 
@@ -838,9 +844,14 @@ std::unique_ptr<TypeAnalyzer> TypeAnalyzer::ResolveScalar(std::shared_ptr<arrow:
 // Resolvers
 
 arrow::Result<std::shared_ptr<ArrayParser>> ArrayParser::ArrayParser::Resolve(
-    const std::shared_ptr<arrow::DataType>& type) {
-    if (type->id() == arrow::Type::DICTIONARY) return GetDictArrayParser(type);
+    const std::shared_ptr<arrow::DataType>& type, arrow::MemoryPool* pool) {
     std::shared_ptr<ArrayParser> res;
+    if (type->id() == arrow::Type::DICTIONARY) {
+        ARROW_ASSIGN_OR_RAISE(res, GetDictArrayParser(type));
+        res->pool_ = pool;
+        RETURN_NOT_OK(res->Init());
+        return res;
+    }
 
 #define PARSER_CASE(ID, CLASS)               \
     case ID:                                 \
@@ -888,20 +899,21 @@ arrow::Result<std::shared_ptr<ArrayParser>> ArrayParser::ArrayParser::Resolve(
     }
 #undef PARSER_CASE
 
+    res->pool_ = pool;
     RETURN_NOT_OK(res->Init());
     return res;
 }
 
 /// Parse an array from json
 arrow::Result<std::shared_ptr<arrow::Array>> ArrayFromJSON(const std::shared_ptr<arrow::DataType>& type,
-                                                           std::string_view json) {
+                                                           std::string_view json, arrow::MemoryPool* pool) {
     rapidjson::Document json_doc;
     try {
         json_doc.Parse(json.begin(), json.size());
     } catch (...) {
         return arrow::Status::Invalid("invalid json document: ", json);
     }
-    ARROW_ASSIGN_OR_RAISE(auto parser, ArrayParser::Resolve(type));
+    ARROW_ASSIGN_OR_RAISE(auto parser, ArrayParser::Resolve(type, pool));
     ARROW_RETURN_NOT_OK(parser->AppendValues(json_doc));
     return parser->Finish();
 }
@@ -148,8 +148,9 @@ struct RowArrayTableReader : public TableReader {
     std::optional<ArrayReader> struct_reader_ = std::nullopt;
 
     /// Constructor
-    RowArrayTableReader(std::unique_ptr<io::InputFileStream> table, TableType type, size_t batch_size)
-        : TableReader(std::move(table), std::move(type), batch_size) {}
+    RowArrayTableReader(std::unique_ptr<io::InputFileStream> table, TableType type, size_t batch_size,
+                        arrow::MemoryPool* pool)
+        : TableReader(std::move(table), std::move(type), batch_size, pool) {}
     /// Prepare the table reader
     arrow::Status Prepare() override;
     /// Rewind the table reader
@@ -171,7 +172,7 @@ arrow::Status RowArrayTableReader::Prepare() {
         this->schema_ = std::make_shared<arrow::Schema>(std::move(schema_fields), arrow::Endianness::Native);
     }
     /// Resolve the struct parser
-    ARROW_ASSIGN_OR_RAISE(auto struct_parser, ArrayParser::Resolve(table_type_.type));
+    ARROW_ASSIGN_OR_RAISE(auto struct_parser, ArrayParser::Resolve(table_type_.type, pool_));
     /// Create the struct reader
     struct_reader_.emplace(*table_file_, std::move(struct_parser));
     return arrow::Status::OK();
@@ -215,8 +216,9 @@ struct ColumnObjectTableReader : public TableReader {
     std::unordered_map<std::string, std::unique_ptr<ColumnReader>> column_readers_ = {};
 
     /// Constructor
-    ColumnObjectTableReader(std::unique_ptr<io::InputFileStream> table, TableType type, size_t batch_size)
-        : TableReader(std::move(table), std::move(type), batch_size) {}
+    ColumnObjectTableReader(std::unique_ptr<io::InputFileStream> table, TableType type, size_t batch_size,
+                            arrow::MemoryPool* pool)
+        : TableReader(std::move(table), std::move(type), batch_size, pool) {}
     /// Prepare the table reader
     arrow::Status Prepare() override;
     /// Rewind the table reader
@@ -264,7 +266,7 @@ arrow::Status ColumnObjectTableReader::Prepare() {
             continue;
         }
         table_file_->Slice(bound_iter->second.offset, bound_iter->second.size);
-        ARROW_ASSIGN_OR_RAISE(auto parser, ArrayParser::Resolve(type));
+        ARROW_ASSIGN_OR_RAISE(auto parser, ArrayParser::Resolve(type, pool_));
         column_readers_.insert({name, std::make_unique<ColumnReader>(*table_file_, std::move(parser))});
     }
     return arrow::Status::OK();
@@ -311,19 +313,21 @@ arrow::Status ColumnObjectTableReader::ReadNext(std::shared_ptr<arrow::RecordBat
 }  // namespace
 
 /// Constructor
-TableReader::TableReader(std::unique_ptr<io::InputFileStream> table, TableType type, size_t batch_size)
-    : table_file_(std::move(table)), table_type_(std::move(type)), batch_size_(batch_size) {}
+TableReader::TableReader(std::unique_ptr<io::InputFileStream> table, TableType type, size_t batch_size,
+                         arrow::MemoryPool* pool)
+    : batch_size_(batch_size), pool_(pool), table_file_(std::move(table)), table_type_(std::move(type)) {}
 
 /// Access the schema
 std::shared_ptr<arrow::Schema> TableReader::schema() const { return schema_; }
 /// Resolve a table reader
 arrow::Result<std::shared_ptr<TableReader>> TableReader::Resolve(std::unique_ptr<io::InputFileStream> table,
-                                                                 TableType type, size_t batch_size) {
+                                                                 TableType type, size_t batch_size,
+                                                                 arrow::MemoryPool* pool) {
     switch (type.shape) {
         case JSONTableShape::COLUMN_OBJECT:
-            return std::make_shared<ColumnObjectTableReader>(std::move(table), std::move(type), batch_size);
+            return std::make_shared<ColumnObjectTableReader>(std::move(table), std::move(type), batch_size, pool);
         case JSONTableShape::ROW_ARRAY:
-            return std::make_shared<RowArrayTableReader>(std::move(table), std::move(type), batch_size);
+            return std::make_shared<RowArrayTableReader>(std::move(table), std::move(type), batch_size, pool);
         default:
             return arrow::Status::Invalid("Table type not specified");
     }
@@ -0,0 +1,136 @@
+#include "duckdb/web/memory_governor.h"
+
+#include <algorithm>
+
+namespace duckdb {
+namespace web {
+
+/// Constructor
+MemoryGovernor::MemoryGovernor(size_t budget) : budget_(budget) {}
+
+/// Get the limit of a share
+size_t MemoryGovernor::GetLimit(double share) const {
+    if (budget_ == 0 || share <= 0.0) return 0;
+    return std::max<size_t>(1, static_cast<size_t>(static_cast<double>(budget_) * share));
+}
+
+/// Get the budget
+size_t MemoryGovernor::GetBudget() {
+    std::unique_lock<std::mutex> guard{mutex_};
+    return budget_;
+}
+
+/// Set the budget
+void MemoryGovernor::SetBudget(size_t budget) {
+    std::unique_lock<std::mutex> guard{mutex_};
+    budget_ = budget;
+    for (auto& reg : consumers_) {
+        reg.limit = GetLimit(reg.share);
+        reg.consumer->SetMemoryLimit(reg.limit);
+    }
+}
+
+/// Register a consumer
+void MemoryGovernor::Register(std::string_view name, MemoryConsumer& consumer, double share) {
+    std::unique_lock<std::mutex> guard{mutex_};
+    auto limit = GetLimit(share);
+    consumers_.push_back({std::string{name}, &consumer, share, limit});
+    consumer.SetMemoryLimit(limit);
+}
+
+/// Unregister a consumer
+void MemoryGovernor::Unregister(MemoryConsumer& consumer) {
+    std::unique_lock<std::mutex> guard{mutex_};
+    consumers_.erase(std::remove_if(consumers_.begin(), consumers_.end(),
+                                    [&](auto& reg) { return reg.consumer == &consumer; }),
+                     consumers_.end());
+}
+
+/// Get the bytes that are held by all consumers
+size_t MemoryGovernor::GetUsage(std::unique_lock<std::mutex>& guard) {
+    size_t usage = 0;
+    for (auto& reg : consumers_) {
+        usage += reg.consumer->GetMemoryUsage();
+    }
+    return usage;
+}
+
+/// Get the bytes that are held by all consumers
+size_t MemoryGovernor::GetUsage() {
+    std::unique_lock<std::mutex> guard{mutex_};
+    return GetUsage(guard);
+}
+
+/// Get the memory that is left for the database
+size_t MemoryGovernor::GetDatabaseMemory() {
+    std::unique_lock<std::mutex> guard{mutex_};
+    if (budget_ == 0) return 0;
+    size_t reserved = 0;
+    for (auto& reg : consumers_) {
+        reserved += reg.limit > 0 ? reg.limit : reg.consumer->GetMemoryUsage();
+    }
+    auto remaining = reserved < budget_ ? budget_ - reserved : 0;
+    return std::max(remaining, MINIMUM_DATABASE_MEMORY);
+}
+
+/// Reclaim memory from the consumers in registration order
+size_t MemoryGovernor::Reclaim(size_t bytes, std::unique_lock<std::mutex>& guard) {
+    size_t released = 0;
+    for (auto& reg : consumers_) {
+        if (released >= bytes) break;
+        released += reg.consumer->ReclaimMemory(bytes - released);
+    }
+    return released;
+}
+
+/// Reclaim memory from the consumers
+size_t MemoryGovernor::Reclaim(size_t bytes) {
+    std::unique_lock<std::mutex> guard{mutex_};
+    return Reclaim(bytes, guard);
+}
+
+/// Reclaim memory until every consumer is within its limit and the usage fits the budget
+size_t MemoryGovernor::Enforce() {
+    std::unique_lock<std::mutex> guard{mutex_};
+    if (budget_ == 0) return 0;
+    size_t released = 0;
+    size_t usage = 0;
+    for (auto& reg : consumers_) {
+        auto consumer_usage = reg.consumer->GetMemoryUsage();
+        if (reg.limit > 0 && consumer_usage > reg.limit) {
+            auto n = reg.consumer->ReclaimMemory(consumer_usage - reg.limit);
+            consumer_usage -= std::min(n, consumer_usage);
+            released += n;
+        }
+        usage += consumer_usage;
+    }
+    if (usage > budget_) {
+        released += Reclaim(usage - budget_, guard);
+    }
+    return released;
+}
+
+/// Write the budget and the usage of all consumers as JSON
+rapidjson::Value MemoryGovernor::WriteInfo(rapidjson::Document& doc) {
+    std::unique_lock<std::mutex> guard{mutex_};
+    auto& allocator = doc.GetAllocator();
+    rapidjson::Value info{rapidjson::kObjectType};
+    rapidjson::Value consumers{rapidjson::kArrayType};
+    size_t usage = 0;
+    for (auto& reg : consumers_) {
+        auto consumer_usage = reg.consumer->GetMemoryUsage();
+        usage += consumer_usage;
+        rapidjson::Value consumer{rapidjson::kObjectType};
+        consumer.AddMember("name", rapidjson::Value{reg.name.c_str(), allocator}, allocator);
+        consumer.AddMember("usage", static_cast<double>(consumer_usage), allocator);
+        consumer.AddMember("limit", static_cast<double>(reg.limit), allocator);
+        consumers.PushBack(consumer, allocator);
+    }
+    info.AddMember("budget", static_cast<double>(budget_), allocator);
+    info.AddMember("usage", static_cast<double>(usage), allocator);
+    info.AddMember("consumers", consumers, allocator);
+    return info;
+}
+
+}  // namespace web
+}  // namespace duckdb
@@ -0,0 +1,122 @@
+#include "duckdb/web/result_cursor.h"
+
+#include <algorithm>
+#include <exception>
+
+#include "arrow/io/memory.h"
+#include "arrow/ipc/options.h"
+#include "arrow/ipc/reader.h"
+#include "arrow/ipc/writer.h"
+
+namespace duckdb {
+namespace web {
+
+/// Constructor
+ResultCursor::ResultCursor(duckdb::FileSystem& filesystem, std::string path, std::shared_ptr<arrow::Schema> schema,
+                           arrow::MemoryPool* memory_pool)
+    : filesystem_(filesystem), path_(std::move(path)), schema_(std::move(schema)), memory_pool_(memory_pool) {}
+
+/// Destructor
+ResultCursor::~ResultCursor() {
+    if (!file_) return;
+    try {
+        file_.reset();
+        filesystem_.RemoveFile(path_);
+    } catch (...) {
+    }
+}
+
+/// Create the file of a cursor
+arrow::Status ResultCursor::Open() {
+    try {
+        file_ = filesystem_.OpenFile(path_,
+                                     duckdb::FileFlags::FILE_FLAGS_READ | duckdb::FileFlags::FILE_FLAGS_WRITE |
+                                         duckdb::FileFlags::FILE_FLAGS_FILE_CREATE_NEW,
+                                     duckdb::FileLockType::NO_LOCK, duckdb::FileCompressionType::UNCOMPRESSED);
+    } catch (std::exception& e) {
+        return arrow::Status::IOError(e.what());
+    }
+    return arrow::Status::OK();
+}
+
+/// Append a record batch
+arrow::Status ResultCursor::Append(const arrow::RecordBatch& batch) {
+    if (!file_) return arrow::Status::Invalid("cursor is not opened");
+    if (batch.num_rows() == 0) return arrow::Status::OK();
+
+    // Serialize the batch as stream
+    auto options = arrow::ipc::IpcWriteOptions::Defaults();
+    options.use_threads = false;
+    options.memory_pool = memory_pool_;
+    ARROW_ASSIGN_OR_RAISE(auto out, arrow::io::BufferOutputStream::Create(0, memory_pool_));
+    ARROW_ASSIGN_OR_RAISE(auto writer, arrow::ipc::MakeStreamWriter(out, schema_, options));
+    ARROW_RETURN_NOT_OK(writer->WriteRecordBatch(batch));
+    ARROW_RETURN_NOT_OK(writer->Close());
+    ARROW_ASSIGN_OR_RAISE(auto buffer, out->Finish());
+
+    // Append it to the file
+    try {
+        filesystem_.Write(*file_, const_cast<uint8_t*>(buffer->data()), buffer->size(), file_size_);
+    } catch (std::exception& e) {
+        return arrow::Status::IOError(e.what());
+    }
+    batches_.push_back(BatchEntry{row_count_, static_cast<uint64_t>(batch.num_rows()), file_size_,
+                                  static_cast<uint64_t>(buffer->size())});
+    row_count_ += batch.num_rows();
+    file_size_ += buffer->size();
+    return arrow::Status::OK();
+}
+
+/// Read a batch from the file
+arrow::Result<std::shared_ptr<arrow::RecordBatch>> ResultCursor::ReadBatch(size_t batch_id) {
+    if (cached_batch_ && cached_batch_id_ == batch_id) return cached_batch_;
+    auto& entry = batches_[batch_id];
+    ARROW_ASSIGN_OR_RAISE(std::shared_ptr<arrow::Buffer> buffer, arrow::AllocateBuffer(entry.byte_size, memory_pool_));
+    try {
+        filesystem_.Read(*file_, buffer->mutable_data(), entry.byte_size, entry.file_offset);
+    } catch (std::exception& e) {
+        return arrow::Status::IOError(e.what());
+    }
+    auto options = arrow::ipc::IpcReadOptions::Defaults();
+    options.use_threads = false;
+    options.memory_pool = memory_pool_;
+    auto input = std::make_shared<arrow::io::BufferReader>(std::move(buffer));
+    ARROW_ASSIGN_OR_RAISE(auto reader, arrow::ipc::RecordBatchStreamReader::Open(input, options));
+    std::shared_ptr<arrow::RecordBatch> batch;
+    ARROW_RETURN_NOT_OK(reader->ReadNext(&batch));
+    if (!batch || static_cast<uint64_t>(batch->num_rows()) != entry.row_count) {
+        return arrow::Status::IOError("cursor batch ", batch_id, " is corrupt");
+    }
+    cached_batch_id_ = batch_id;
+    cached_batch_ = batch;
+    return batch;
+}
+
+/// Fetch up to `count` rows starting at row `offset` as Arrow IPC stream
+arrow::Result<std::shared_ptr<arrow::Buffer>> ResultCursor::FetchRows(uint64_t offset, uint64_t count,
+                                                                      io::OutputBufferPool& buffers) {
+    if (!file_) return arrow::Status::Invalid("cursor is not opened");
+    if (offset > row_count_) return arrow::Status::IndexError("row offset ", offset, " exceeds ", row_count_, " rows");
+    auto end = offset + std::min(count, row_count_ - offset);
+
+    // Write the schema, the slices of all overlapping batches and the end-of-stream marker
+    auto options = arrow::ipc::IpcWriteOptions::Defaults();
+    options.use_threads = false;
+    options.memory_pool = memory_pool_;
+    auto out = std::make_shared<io::PooledOutputStream>(buffers);
+    ARROW_ASSIGN_OR_RAISE(auto writer, arrow::ipc::MakeStreamWriter(out, schema_, options));
+    auto iter = std::upper_bound(batches_.begin(), batches_.end(), offset,
+                                 [](uint64_t row, const BatchEntry& entry) { return row < entry.first_row; });
+    if (iter != batches_.begin()) --iter;
+    for (; iter != batches_.end() && iter->first_row < end; ++iter) {
+        ARROW_ASSIGN_OR_RAISE(auto batch, ReadBatch(iter - batches_.begin()));
+        auto slice_begin = std::max(offset, iter->first_row) - iter->first_row;
+        auto slice_end = std::min(end, iter->first_row + iter->row_count) - iter->first_row;
+        ARROW_RETURN_NOT_OK(writer->WriteRecordBatch(*batch->Slice(slice_begin, slice_end - slice_begin)));
+    }
+    ARROW_RETURN_NOT_OK(writer->Close());
+    return out->Finish();
+}
+
+}  // namespace web
+}  // namespace duckdb
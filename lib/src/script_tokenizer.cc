@@ -0,0 +1,132 @@
+#include "duckdb/web/script_tokenizer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "duckdb/parser/parser.hpp"
+
+namespace duckdb {
+namespace web {
+
+/// Tokenize a range of the script
+void ScriptTokenizer::TokenizeRange(size_t begin, size_t end, Tokens& out) const {
+    duckdb::Parser parser;
+    auto tokens = parser.Tokenize(text_.substr(begin, end - begin));
+    out.offsets.reserve(out.offsets.size() + tokens.size());
+    out.types.reserve(out.types.size() + tokens.size());
+    for (auto& token : tokens) {
+        out.offsets.push_back(static_cast<uint32_t>(begin + token.start));
+        out.types.push_back(static_cast<uint8_t>(token.type));
+    }
+}
+
+/// Encode an update
+std::shared_ptr<arrow::Buffer> ScriptTokenizer::EncodeUpdate(size_t index, size_t removed, const Tokens& inserted,
+                                                             size_t begin, size_t end, int64_t shift) {
+    auto count = end - begin;
+    uint32_t header[4] = {static_cast<uint32_t>(index), static_cast<uint32_t>(removed), static_cast<uint32_t>(count),
+                          static_cast<uint32_t>(static_cast<int32_t>(shift))};
+    update_.resize(sizeof(header) + count * (sizeof(uint32_t) + sizeof(uint8_t)));
+    auto* writer = update_.data();
+    std::memcpy(writer, header, sizeof(header));
+    writer += sizeof(header);
+    if (count > 0) {
+        std::memcpy(writer, inserted.offsets.data() + begin, count * sizeof(uint32_t));
+        writer += count * sizeof(uint32_t);
+        std::memcpy(writer, inserted.types.data() + begin, count * sizeof(uint8_t));
+    }
+    return std::make_shared<arrow::Buffer>(update_.data(), update_.size());
+}
+
+/// Tokenize a script
+std::shared_ptr<arrow::Buffer> ScriptTokenizer::Tokenize(std::string_view text) {
+    auto removed = tokens_.size();
+    text_ = text;
+    tokens_.clear();
+    TokenizeRange(0, text_.size(), tokens_);
+    return EncodeUpdate(0, removed, tokens_, 0, tokens_.size(), 0);
+}
+
+/// Replace bytes of the script and tokenize the edit
+arrow::Result<std::shared_ptr<arrow::Buffer>> ScriptTokenizer::Retokenize(size_t offset, size_t removed,
+                                                                          std::string_view inserted) {
+    if (offset > text_.size() || removed > text_.size() - offset) {
+        return arrow::Status::Invalid("edit range exceeds the script");
+    }
+    text_.replace(offset, removed, inserted);
+    auto shift = static_cast<int64_t>(inserted.size()) - static_cast<int64_t>(removed);
+    auto old_edit_end = offset + removed;
+    auto new_edit_end = offset + inserted.size();
+    auto& offsets = tokens_.offsets;
+    auto& types = tokens_.types;
+
+    // Restart a few tokens before the edit since the edit can extend or merge the preceding tokens
+    size_t edited = std::lower_bound(offsets.begin(), offsets.end(), offset) - offsets.begin();
+    size_t restart_index = edited > RESTART_TOKENS ? edited - RESTART_TOKENS : 0;
+    size_t restart = restart_index > 0 ? offsets[restart_index] : 0;
+
+    // The old tokens that start after the edit can synchronize with the new ones
+    size_t sync_begin = std::lower_bound(offsets.begin(), offsets.end(), old_edit_end) - offsets.begin();
+
+    // Tokenize a window after the edit and grow it until a new token starts an old one again.
+    // Tokens that start in the window start at the right offset, only the last one might be cut off.
+    // A synchronizing token therefore has to be confirmed by the remaining tokens of the window.
+    Tokens window;
+    size_t window_tokens = WINDOW_TOKENS;
+    size_t sync_new = 0, sync_old = 0;
+    while (true) {
+        auto window_end_index = sync_begin + window_tokens;
+        auto window_end =
+            window_end_index < offsets.size() ? static_cast<size_t>(offsets[window_end_index] + shift) : text_.size();
+        window.clear();
+        TokenizeRange(restart, window_end, window);
+
+        // Reached the end of the script?
+        if (window_end == text_.size()) {
+            sync_new = window.size();
+            sync_old = offsets.size();
+            break;
+        }
+        // Find a token after the edit that starts an old token and is followed by the old tokens
+        bool synced = false;
+        for (size_t i = 0; i + 1 < window.size() && !synced; ++i) {
+            if (window.offsets[i] < new_edit_end) continue;
+            auto j = std::lower_bound(offsets.begin() + sync_begin, offsets.end(), window.offsets[i] - shift) -
+                     offsets.begin();
+            synced = true;
+            for (size_t k = 0; (i + k) < window.size() && synced; ++k) {
+                auto is_last = (i + k + 1) == window.size();
+                synced = (j + k) < offsets.size() && offsets[j + k] + shift == window.offsets[i + k] &&
+                         (is_last || types[j + k] == window.types[i + k]);
+            }
+            if (synced) {
+                sync_new = i;
+                sync_old = j;
+            }
+        }
+        if (synced) break;
+        window_tokens *= 2;
+    }
+
+    // Skip the tokens before the edit that did not change
+    size_t unchanged = 0;
+    while (unchanged < sync_new && (restart_index + unchanged) < sync_old &&
+           window.offsets[unchanged] == offsets[restart_index + unchanged] &&
+           window.types[unchanged] == types[restart_index + unchanged]) {
+        ++unchanged;
+    }
+    auto index = restart_index + unchanged;
+
+    // Replace the changed tokens and shift the following ones
+    offsets.erase(offsets.begin() + index, offsets.begin() + sync_old);
+    types.erase(types.begin() + index, types.begin() + sync_old);
+    offsets.insert(offsets.begin() + index, window.offsets.begin() + unchanged, window.offsets.begin() + sync_new);
+    types.insert(types.begin() + index, window.types.begin() + unchanged, window.types.begin() + sync_new);
+    for (auto i = index + (sync_new - unchanged); i < offsets.size(); ++i) {
+        offsets[i] += shift;
+    }
+    return EncodeUpdate(index, sync_old - index, window, unchanged, sync_new, shift);
+}
+
+}  // namespace web
+}  // namespace duckdb
@@ -0,0 +1,264 @@
+#include "duckdb/web/snapshot.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "arrow/buffer.h"
+#include "arrow/result.h"
+#include "arrow/status.h"
+#include "duckdb/common/file_system.hpp"
+#include "rapidjson/document.h"
+#include "zstd.h"
+
+namespace duckdb {
+namespace web {
+namespace snapshot {
+
+namespace {
+
+/// The snapshot magic bytes
+constexpr char SNAPSHOT_MAGIC[8] = {'D', 'U', 'C', 'K', 'S', 'N', 'A', 'P'};
+/// The snapshot format version
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+/// The header of a compressed snapshot.
+/// The header is followed by one uint64 frame size per chunk and the compressed frames.
+struct SnapshotHeader {
+    /// The magic bytes
+    char magic[8];
+    /// The format version
+    uint32_t version;
+    /// The compression
+    uint32_t compression;
+    /// The size of the database image
+    uint64_t raw_size;
+    /// The chunk size
+    uint64_t chunk_size;
+    /// The chunk count
+    uint64_t chunk_count;
+};
+static_assert(sizeof(SnapshotHeader) == 40);
+
+/// Run a task for every chunk on up to `threads` threads.
+/// The task receives the worker id and the chunk id.
+template <typename Fn> arrow::Status ParallelFor(size_t chunks, size_t threads, Fn fn) {
+    std::vector<arrow::Status> status(chunks);
+    std::atomic<size_t> next_chunk = 0;
+    auto work = [&](size_t worker_id) {
+        for (auto chunk_id = next_chunk++; chunk_id < chunks; chunk_id = next_chunk++) {
+            try {
+                status[chunk_id] = fn(worker_id, chunk_id);
+            } catch (std::exception& e) {
+                status[chunk_id] = arrow::Status::IOError(e.what());
+            }
+        }
+    };
+    threads = std::max<size_t>(1, std::min(threads, chunks));
+#ifndef DUCKDB_NO_THREADS
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(work, i);
+    }
+    work(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+#else
+    work(0);
+#endif
+    for (auto& s : status) {
+        ARROW_RETURN_NOT_OK(s);
+    }
+    return arrow::Status::OK();
+}
+
+/// Get the number of chunks
+size_t GetChunkCount(size_t size, size_t chunk_size) { return (size + chunk_size - 1) / chunk_size; }
+
+}  // namespace
+
+/// Read from a document
+arrow::Status SnapshotOptions::ReadFrom(const rapidjson::Document& doc) {
+    if (!doc.IsObject()) return arrow::Status::OK();
+    if (auto iter = doc.FindMember("compression"); iter != doc.MemberEnd()) {
+        if (iter->value.IsString()) {
+            std::string_view codec{iter->value.GetString(), iter->value.GetStringLength()};
+            if (codec == "zstd") {
+                compression = SnapshotCompression::ZSTD;
+            } else if (codec == "none") {
+                compression = SnapshotCompression::NONE;
+            } else {
+                return arrow::Status::Invalid("unknown snapshot compression: ", codec);
+            }
+        } else if (iter->value.IsBool()) {
+            compression = iter->value.GetBool() ? SnapshotCompression::ZSTD : SnapshotCompression::NONE;
+        } else {
+            return arrow::Status::Invalid("snapshot compression must be a string or boolean");
+        }
+    }
+    if (auto iter = doc.FindMember("compressionLevel"); iter != doc.MemberEnd()) {
+        if (!iter->value.IsInt()) return arrow::Status::Invalid("snapshot compression level must be an integer");
+        compression_level = iter->value.GetInt();
+    }
+    if (auto iter = doc.FindMember("chunkSize"); iter != doc.MemberEnd()) {
+        if (!iter->value.IsUint() || iter->value.GetUint() == 0)
+            return arrow::Status::Invalid("snapshot chunk size must be a positive integer");
+        chunk_size = iter->value.GetUint();
+    }
+    return arrow::Status::OK();
+}
+
+/// Copy a whole file into a buffer
+arrow::Result<std::shared_ptr<arrow::Buffer>> ReadFile(duckdb::FileSystem& fs, std::string_view path, size_t threads,
+                                                       size_t chunk_size) {
+    std::string file_path{path};
+    std::vector<std::unique_ptr<duckdb::FileHandle>> handles;
+    handles.push_back(fs.OpenFile(file_path, duckdb::FileFlags::FILE_FLAGS_READ));
+    auto size = static_cast<size_t>(fs.GetFileSize(*handles[0]));
+    ARROW_ASSIGN_OR_RAISE(auto buffer, arrow::AllocateBuffer(size));
+
+    // Every worker reads through its own handle to not share readahead state
+    auto chunks = GetChunkCount(size, chunk_size);
+    auto workers = std::max<size_t>(1, std::min(threads, chunks));
+    for (size_t i = 1; i < workers; ++i) {
+        handles.push_back(fs.OpenFile(file_path, duckdb::FileFlags::FILE_FLAGS_READ));
+    }
+    auto* out = buffer->mutable_data();
+    ARROW_RETURN_NOT_OK(ParallelFor(chunks, workers, [&](size_t worker_id, size_t chunk_id) {
+        auto offset = chunk_id * chunk_size;
+        auto n = std::min(chunk_size, size - offset);
+        fs.Read(*handles[worker_id], out + offset, n, offset);
+        return arrow::Status::OK();
+    }));
+    return std::shared_ptr<arrow::Buffer>{std::move(buffer)};
+}
+
+/// Write a whole buffer to a file
+arrow::Status WriteFile(duckdb::FileSystem& fs, std::string_view path, nonstd::span<const char> data,
+                        size_t chunk_size) {
+    try {
+        auto file = fs.OpenFile(std::string{path}, duckdb::FileFlags::FILE_FLAGS_WRITE |
+                                                       duckdb::FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+        for (size_t offset = 0; offset < data.size(); offset += chunk_size) {
+            auto n = std::min(chunk_size, data.size() - offset);
+            fs.Write(*file, const_cast<char*>(data.data()) + offset, n, offset);
+        }
+        fs.FileSync(*file);
+    } catch (std::exception& e) {
+        return arrow::Status::IOError(e.what());
+    }
+    return arrow::Status::OK();
+}
+
+/// Is a compressed snapshot?
+bool IsCompressed(nonstd::span<const char> data) {
+    return data.size() >= sizeof(SnapshotHeader) && std::memcmp(data.data(), SNAPSHOT_MAGIC, 8) == 0;
+}
+
+/// Compress a database image
+arrow::Result<std::shared_ptr<arrow::Buffer>> Compress(nonstd::span<const char> data, const SnapshotOptions& options,
+                                                       size_t threads) {
+    if (options.compression != SnapshotCompression::ZSTD) {
+        return arrow::Status::Invalid("unsupported snapshot compression");
+    }
+    auto chunk_size = options.chunk_size;
+    auto chunks = GetChunkCount(data.size(), chunk_size);
+
+    // Compress all chunks into independent frames
+    std::vector<std::unique_ptr<char[]>> frames(chunks);
+    std::vector<uint64_t> frame_sizes(chunks);
+    ARROW_RETURN_NOT_OK(ParallelFor(chunks, threads, [&](size_t, size_t chunk_id) {
+        auto offset = chunk_id * chunk_size;
+        auto n = std::min(chunk_size, data.size() - offset);
+        auto bound = duckdb_zstd::ZSTD_compressBound(n);
+        frames[chunk_id] = std::unique_ptr<char[]>(new char[bound]);
+        auto written = duckdb_zstd::ZSTD_compress(frames[chunk_id].get(), bound, data.data() + offset, n,
+                                                  options.compression_level);
+        if (duckdb_zstd::ZSTD_isError(written)) {
+            return arrow::Status::IOError("snapshot compression failed: ", duckdb_zstd::ZSTD_getErrorName(written));
+        }
+        frame_sizes[chunk_id] = written;
+        return arrow::Status::OK();
+    }));
+
+    // Assemble the snapshot
+    auto total = sizeof(SnapshotHeader) + chunks * sizeof(uint64_t);
+    for (auto frame_size : frame_sizes) total += frame_size;
+    ARROW_ASSIGN_OR_RAISE(auto buffer, arrow::AllocateBuffer(total));
+    auto* writer = buffer->mutable_data();
+    SnapshotHeader header;
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, 8);
+    header.version = SNAPSHOT_VERSION;
+    header.compression = static_cast<uint32_t>(options.compression);
+    header.raw_size = data.size();
+    header.chunk_size = chunk_size;
+    header.chunk_count = chunks;
+    std::memcpy(writer, &header, sizeof(header));
+    writer += sizeof(header);
+    std::memcpy(writer, frame_sizes.data(), chunks * sizeof(uint64_t));
+    writer += chunks * sizeof(uint64_t);
+    for (size_t i = 0; i < chunks; ++i) {
+        std::memcpy(writer, frames[i].get(), frame_sizes[i]);
+        writer += frame_sizes[i];
+    }
+    return std::shared_ptr<arrow::Buffer>{std::move(buffer)};
+}
+
+/// Decompress a compressed snapshot
+arrow::Result<SnapshotImage> Decompress(nonstd::span<const char> data, size_t threads) {
+    if (!IsCompressed(data)) return arrow::Status::Invalid("not a compressed snapshot");
+    SnapshotHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.version != SNAPSHOT_VERSION) {
+        return arrow::Status::Invalid("unsupported snapshot version: ", header.version);
+    }
+    if (header.compression != static_cast<uint32_t>(SnapshotCompression::ZSTD)) {
+        return arrow::Status::Invalid("unsupported snapshot compression: ", header.compression);
+    }
+    if (header.chunk_size == 0 || header.chunk_count != GetChunkCount(header.raw_size, header.chunk_size)) {
+        return arrow::Status::Invalid("corrupt snapshot header");
+    }
+
+    // Resolve the frame offsets
+    auto table_end = sizeof(SnapshotHeader) + header.chunk_count * sizeof(uint64_t);
+    if (header.chunk_count > data.size() || table_end > data.size()) {
+        return arrow::Status::Invalid("truncated snapshot");
+    }
+    std::vector<uint64_t> frame_sizes(header.chunk_count);
+    std::memcpy(frame_sizes.data(), data.data() + sizeof(SnapshotHeader), header.chunk_count * sizeof(uint64_t));
+    std::vector<uint64_t> frame_offsets(header.chunk_count);
+    uint64_t offset = table_end;
+    for (size_t i = 0; i < header.chunk_count; ++i) {
+        frame_offsets[i] = offset;
+        if (frame_sizes[i] > data.size() - offset) return arrow::Status::Invalid("truncated snapshot");
+        offset += frame_sizes[i];
+    }
+
+    // Decompress all frames into place
+    SnapshotImage image;
+    image.data = std::unique_ptr<char[]>(new char[header.raw_size]);
+    image.size = header.raw_size;
+    ARROW_RETURN_NOT_OK(ParallelFor(header.chunk_count, threads, [&](size_t, size_t chunk_id) {
+        auto out_offset = chunk_id * header.chunk_size;
+        auto n = std::min<uint64_t>(header.chunk_size, header.raw_size - out_offset);
+        auto written = duckdb_zstd::ZSTD_decompress(image.data.get() + out_offset, n,
+                                                    data.data() + frame_offsets[chunk_id], frame_sizes[chunk_id]);
+        if (duckdb_zstd::ZSTD_isError(written)) {
+            return arrow::Status::IOError("snapshot decompression failed: ",
+                                          duckdb_zstd::ZSTD_getErrorName(written));
+        }
+        if (written != n) return arrow::Status::Invalid("corrupt snapshot frame");
+        return arrow::Status::OK();
+    }));
+    return image;
+}
+
+}  // namespace snapshot
+}  // namespace web
+}  // namespace duckdb
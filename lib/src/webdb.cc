@@ -2,14 +2,20 @@
 
 #include <arrow/ipc/type_fwd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
 #include <cstddef>
 #include <cstdio>
+#include <filesystem>
 #include <functional>
 #include <limits>
 #include <memory>
 #include <optional>
 #include <stdexcept>
 #include <string_view>
+#include <typeinfo>
 #include <unordered_map>
 
 #include "arrow/array/array_dict.h"
@@ -28,6 +34,8 @@
 #include "duckdb/common/arrow.hpp"
 #include "duckdb/common/file_system.hpp"
 #include "duckdb/common/types/data_chunk.hpp"
+#include "duckdb/main/appender.hpp"
+#include "duckdb/main/materialized_query_result.hpp"
 #include "duckdb/main/query_result.hpp"
 #include "duckdb/parser/expression/constant_expression.hpp"
 #include "duckdb/parser/parser.hpp"
@@ -39,6 +47,7 @@
 #include "duckdb/web/csv_insert_options.h"
 #include "duckdb/web/environment.h"
 #include "duckdb/web/ext/table_function_relation.h"
+#include "duckdb/web/incremental_view.h"
 #include "duckdb/web/io/arrow_ifstream.h"
 #include "duckdb/web/io/buffered_filesystem.h"
 #include "duckdb/web/io/file_page_buffer.h"
@@ -47,6 +56,8 @@
 #include "duckdb/web/json_analyzer.h"
 #include "duckdb/web/json_insert_options.h"
 #include "duckdb/web/json_table.h"
+#include "duckdb/web/snapshot.h"
+#include "duckdb/web/utils/scope_guard.h"
 #include "parquet-extension.hpp"
 #include "rapidjson/document.h"
 #include "rapidjson/error/en.h"
@@ -57,6 +68,188 @@
 namespace duckdb {
 namespace web {
 
+namespace {
+
+/// The share of the memory budget that is reserved for the page buffer
+constexpr double PAGE_BUFFER_MEMORY_SHARE = 0.25;
+/// The share of the memory budget that is reserved for the readahead buffers of all threads
+constexpr double READAHEAD_MEMORY_SHARE = 0.125;
+/// The bytes that are reserved for the schema and footer of a materialized result
+constexpr int64_t RESULT_FOOTER_RESERVE = 16 << 10;
+/// The end-of-stream marker of the Arrow IPC stream format
+constexpr uint32_t IPC_STREAM_EOS[2] = {0xFFFFFFFF, 0};
+
+/// Does a type contain dictionaries?
+bool HasDictionary(const arrow::DataType& type) {
+    if (type.id() == arrow::Type::DICTIONARY) return true;
+    return std::any_of(type.fields().begin(), type.fields().end(),
+                       [](auto& field) { return HasDictionary(*field->type()); });
+}
+
+/// Is a text a single query that does not change the catalog?
+bool IsQueryText(std::string_view text) {
+    auto is_space = [](char c) { return std::isspace(static_cast<unsigned char>(c)); };
+    auto begin = std::find_if_not(text.begin(), text.end(), is_space);
+    auto rest = text.substr(begin - text.begin());
+    auto starts_with_keyword = [&](std::string_view keyword) {
+        if (rest.size() < keyword.size()) return false;
+        for (size_t i = 0; i < keyword.size(); ++i) {
+            if (std::toupper(static_cast<unsigned char>(rest[i])) != keyword[i]) return false;
+        }
+        return rest.size() == keyword.size() || !(std::isalnum(static_cast<unsigned char>(rest[keyword.size()])) ||
+                                                  rest[keyword.size()] == '_');
+    };
+    if (!starts_with_keyword("SELECT") && !starts_with_keyword("WITH")) return false;
+
+    // Scripts with multiple statements are not cached
+    auto semicolon = rest.find(';');
+    return semicolon == std::string_view::npos || std::all_of(rest.begin() + semicolon + 1, rest.end(), is_space);
+}
+
+/// Is a text a single statement?
+/// Statements of a script that ran before a failing one are already committed and must not be sent again.
+bool IsSingleStatement(std::string_view text) {
+    duckdb::Parser parser;
+    try {
+        parser.ParseQuery(std::string{text});
+    } catch (...) {
+        return false;
+    }
+    return parser.statements.size() == 1;
+}
+
+/// Quote an identifier
+std::string QuoteIdentifier(std::string_view name) {
+    std::string quoted = "\"";
+    for (auto c : name) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+    quoted += '"';
+    return quoted;
+}
+
+/// Does a text mention parquet?
+bool MentionsParquet(std::string_view text) {
+    constexpr std::string_view needle = "parquet";
+    auto iter = std::search(text.begin(), text.end(), needle.begin(), needle.end(),
+                            [](char l, char r) { return std::tolower(static_cast<unsigned char>(l)) == r; });
+    return iter != text.end();
+}
+
+/// Copy all tables, views and indexes of a database into another one.
+/// Tables are created and filled first, dependent entries are replayed afterwards.
+/// Entries that fail are replayed again once the others exist since views may refer to views of any name.
+arrow::Status CopyCatalog(duckdb::Connection& src, duckdb::Connection& dst) {
+    auto catalog = src.Query(R"RAW(
+        SELECT type, name, sql FROM sqlite_master
+        WHERE sql IS NOT NULL
+        ORDER BY CASE type WHEN 'table' THEN 0 WHEN 'view' THEN 1 ELSE 2 END
+    )RAW");
+    if (!catalog->success) return arrow::Status{arrow::StatusCode::ExecutionError, move(catalog->error)};
+    std::vector<std::string> pending;
+    for (size_t i = 0; i < catalog->collection.Count(); ++i) {
+        auto type = catalog->GetValue(0, i).ToString();
+        auto name = catalog->GetValue(1, i).ToString();
+        auto sql = catalog->GetValue(2, i).ToString();
+
+        // Create the entry
+        auto created = dst.Query(sql);
+        if (!created->success) {
+            if (type == "table") return arrow::Status{arrow::StatusCode::ExecutionError, move(created->error)};
+            pending.push_back(move(sql));
+            continue;
+        }
+        if (type != "table") continue;
+
+        // Copy the table chunk by chunk
+        auto rows = src.SendQuery("SELECT * FROM " + QuoteIdentifier(name));
+        if (!rows->success) return arrow::Status{arrow::StatusCode::ExecutionError, move(rows->error)};
+        duckdb::Appender appender{dst, name};
+        for (auto chunk = rows->Fetch(); !!chunk && chunk->size() > 0; chunk = rows->Fetch()) {
+            appender.AppendDataChunk(*chunk);
+        }
+        if (!rows->success) return arrow::Status{arrow::StatusCode::ExecutionError, move(rows->error)};
+        appender.Close();
+    }
+
+    // Replay the failed entries until no more progress is made
+    while (!pending.empty()) {
+        std::vector<std::string> failed;
+        std::string error;
+        for (auto& sql : pending) {
+            auto created = dst.Query(sql);
+            if (created->success) continue;
+            if (failed.empty()) error = move(created->error);
+            failed.push_back(move(sql));
+        }
+        if (failed.size() == pending.size()) return arrow::Status{arrow::StatusCode::ExecutionError, move(error)};
+        pending = move(failed);
+    }
+    return arrow::Status::OK();
+}
+
+/// Read the arrow insert options
+arrow::Result<ArrowInsertOptions> ReadArrowInsertOptions(std::string_view options_json) {
+    rapidjson::Document options_doc;
+    options_doc.Parse(options_json.begin(), options_json.size());
+    ArrowInsertOptions options;
+    ARROW_RETURN_NOT_OK(options.ReadFrom(options_doc));
+    return options;
+}
+
+/// Run statements one after another, stops at the first failure
+arrow::Status RunStatements(duckdb::Connection& connection, const std::vector<std::string>& statements) {
+    for (auto& statement : statements) {
+        auto result = connection.Query(statement);
+        if (!result->success) return arrow::Status{arrow::StatusCode::ExecutionError, move(result->error)};
+    }
+    return arrow::Status::OK();
+}
+
+/// The name of the temporary view over the appended rows that are folded into incremental views
+constexpr std::string_view INCREMENTAL_ROWS_VIEW = "__incremental_rows";
+
+/// Resolve the access mode of a database config and validate its files
+arrow::Result<AccessMode> ResolveAccessMode(const WebDBConfig& config) {
+    bool in_memory = config.path == ":memory:" || config.path == "";
+
+    // Database files are opened read-only unless the user explicitly asks for write access.
+    auto access_mode = in_memory ? AccessMode::UNDEFINED : AccessMode::READ_ONLY;
+    switch (config.access_mode) {
+        case WebDBAccessMode::AUTOMATIC:
+            break;
+        case WebDBAccessMode::READ_ONLY:
+            access_mode = AccessMode::READ_ONLY;
+            break;
+        case WebDBAccessMode::READ_WRITE:
+            access_mode = AccessMode::READ_WRITE;
+            break;
+    }
+
+    // HTTP files cannot be written
+    auto web_fs = io::WebFileSystem::Get();
+    if (!in_memory && access_mode == AccessMode::READ_WRITE && web_fs &&
+        web_fs->ResolveDataProtocol(config.path) == io::WebFileSystem::DataProtocol::HTTP) {
+        return arrow::Status::Invalid("Cannot open HTTP database file in read-write mode: ", config.path);
+    }
+    // Temporary files overflow into a native file
+    auto& temp_overflow_file = config.filesystem.temp_overflow_file;
+    if (web_fs && !temp_overflow_file.empty() &&
+        web_fs->ResolveDataProtocol(temp_overflow_file) != io::WebFileSystem::DataProtocol::NATIVE) {
+        return arrow::Status::Invalid("Temporary overflow file must be a native file: ", temp_overflow_file);
+    }
+    return access_mode;
+}
+
+/// Is a filesystem the local filesystem?
+bool IsLocalFileSystem(duckdb::FileSystem& fs) {
+    auto local = duckdb::FileSystem::CreateLocal();
+    return typeid(fs) == typeid(*local);
+}
+
+}  // namespace
+
 /// Create the default webdb database
 std::unique_ptr<WebDB> WebDB::Create() {
     if constexpr (ENVIRONMENT == Environment::WEB) {
@@ -77,75 +270,264 @@ arrow::Result<std::reference_wrapper<WebDB>> WebDB::Get() {
 
 /// Constructor
 WebDB::Connection::Connection(WebDB& webdb)
-    : webdb_(webdb), connection_(*webdb.database_), arrow_ipc_stream_(nullptr) {}
-/// Constructor
-WebDB::Connection::~Connection() = default;
+    : webdb_(webdb),
+      connection_(*webdb.database_),
+      arrow_ipc_stream_(nullptr),
+      output_buffers_(&webdb.arrow_memory_pool_) {
+    webdb_.memory_governor_.Register("results", *this);
+}
+/// Destructor
+WebDB::Connection::~Connection() { webdb_.memory_governor_.Unregister(*this); }
+
+/// Get the bytes of the arrow batches that are held by views and pending inserts.
+/// The governor calls this from other connections, only the counters and the buffer pool are read.
+size_t WebDB::Connection::GetMemoryUsage() {
+    return arrow_view_bytes_ + arrow_ipc_bytes_ + output_buffers_.GetRetainedBytes();
+}
+
+/// Free the recycled result buffers.
+/// The governor calls this from other connections, only the thread-safe buffer pool is touched.
+size_t WebDB::Connection::ReclaimMemory(size_t bytes) { return output_buffers_.Clear(); }
+
+/// Drop the cached plans of this connection
+void WebDB::Connection::ClearPlanCache() {
+    plan_cache_stats_.invalidations += plan_cache_.size();
+    plan_cache_index_.clear();
+    plan_cache_.clear();
+}
+
+/// Drop the cached plans of all connections before the catalog might change.
+/// Other connections notice the new epoch on their next lookup.
+void WebDB::Connection::InvalidatePlans() {
+    ++webdb_.catalog_epoch_;
+    ClearPlanCache();
+}
+
+/// Execute a query text with a cached plan
+arrow::Result<std::unique_ptr<duckdb::QueryResult>> WebDB::Connection::ExecuteCachedPlan(
+    std::string_view text, std::shared_ptr<ResultSchema>& schema) {
+    auto capacity = webdb_.config_->plan_cache_size;
+    if (capacity == 0 || !IsQueryText(text)) return nullptr;
+    std::vector<duckdb::Value> no_values;
+
+    // Reuse a cached plan of the current catalog epoch
+    if (auto iter = plan_cache_index_.find(text); iter != plan_cache_index_.end()) {
+        auto plan = iter->second;
+        if (plan->catalog_epoch == webdb_.catalog_epoch_) {
+            plan_cache_.splice(plan_cache_.begin(), plan_cache_, plan);
+            auto result = plan->statement->Execute(no_values);
+            if (result->success) {
+                ++plan_cache_stats_.hits;
+                plan_cache_stats_.planning_micros_saved += plan->planning_micros;
+                schema = plan->schema;
+                return result;
+            }
+            // DuckDB rebinds plans whose catalog entries changed, the failure is not caused by the cache.
+            // Drop the plan and report the error without running the query a second time.
+            ++plan_cache_stats_.invalidations;
+            plan_cache_index_.erase(iter);
+            plan_cache_.erase(plan);
+            return result;
+        }
+        // Plan again, the catalog might have changed
+        ++plan_cache_stats_.invalidations;
+        plan_cache_index_.erase(iter);
+        plan_cache_.erase(plan);
+    }
+
+    // Prepare the query, statements that cannot be prepared take the regular path
+    webdb_.LoadExtensionsFor(text);
+    auto planning_start = std::chrono::steady_clock::now();
+    auto statement = connection_.Prepare(std::string{text});
+    if (!statement->success && IsSingleStatement(text) && webdb_.LoadExtensionsAfterError(statement->error)) {
+        statement = connection_.Prepare(std::string{text});
+    }
+    if (!statement->success || statement->type != duckdb::StatementType::SELECT_STATEMENT || statement->n_param > 0) {
+        return nullptr;
+    }
+    auto planning_micros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                                 planning_start)
+                               .count();
+    ++plan_cache_stats_.misses;
+
+    // Execute the statement and cache the plan only if it succeeds
+    auto result = statement->Execute(no_values);
+    if (!result->success) return result;
+    ARROW_ASSIGN_OR_RAISE(schema, ImportResultSchema(*result));
+    while (plan_cache_.size() >= capacity) {
+        plan_cache_index_.erase(plan_cache_.back().text);
+        plan_cache_.pop_back();
+        ++plan_cache_stats_.evictions;
+    }
+    plan_cache_.push_front(CachedPlan{std::string{text}, std::move(statement), schema, webdb_.catalog_epoch_,
+                                      static_cast<uint64_t>(planning_micros)});
+    plan_cache_index_.insert({plan_cache_.front().text, plan_cache_.begin()});
+    return result;
+}
+
+/// Execute a query text with a cached plan (if possible)
+arrow::Result<std::unique_ptr<duckdb::QueryResult>> WebDB::Connection::ExecuteQuery(
+    std::string_view text, std::shared_ptr<ResultSchema>& schema) {
+    ARROW_ASSIGN_OR_RAISE(auto result, ExecuteCachedPlan(text, schema));
+    if (result) return result;
+
+    // Send the query
+    if (!IsQueryText(text)) InvalidatePlans();
+    webdb_.LoadExtensionsFor(text);
+    result = connection_.SendQuery(std::string{text});
+    if (!result->success && IsSingleStatement(text) && webdb_.LoadExtensionsAfterError(result->error)) {
+        result = connection_.SendQuery(std::string{text});
+    }
+    return result;
+}
+
+/// Import the arrow schema of a result set
+arrow::Result<std::shared_ptr<WebDB::Connection::ResultSchema>> WebDB::Connection::ImportResultSchema(
+    duckdb::QueryResult& result) {
+    auto out = std::make_shared<ResultSchema>();
+    out->types = result.types;
+    out->names = result.names;
+
+    // Import the schema
+    ArrowSchema raw_schema;
+    result.ToArrowSchema(&raw_schema);
+    ARROW_ASSIGN_OR_RAISE(out->schema, arrow::ImportSchema(&raw_schema));
+
+    // Patch the schema (if necessary)
+    out->patched_schema = out->schema;
+    if (!webdb_.config_->emit_bigint) {
+        out->patched_schema = patchSchema(out->schema, *webdb_.config_);
+    }
+    // Serialize the schema
+    ARROW_ASSIGN_OR_RAISE(out->schema_message,
+                          arrow::ipc::SerializeSchema(*out->patched_schema, &webdb_.arrow_memory_pool_));
+
+    // Dictionaries require dictionary batches that only the file writer emits
+    out->compact = std::none_of(out->patched_schema->fields().begin(), out->patched_schema->fields().end(),
+                                [](auto& field) { return HasDictionary(*field->type()); });
+    return out;
+}
+
+/// Resolve the cached arrow schema of a prepared statement result
+arrow::Result<std::shared_ptr<WebDB::Connection::ResultSchema>> WebDB::Connection::ResolvePreparedSchema(
+    size_t statement_id, duckdb::QueryResult& result) {
+    auto iter = prepared_schemas_.find(statement_id);
+    if (iter != prepared_schemas_.end() && iter->second->types == result.types &&
+        iter->second->names == result.names) {
+        return iter->second;
+    }
+    ARROW_ASSIGN_OR_RAISE(auto schema, ImportResultSchema(result));
+    prepared_schemas_.insert_or_assign(statement_id, schema);
+    return schema;
+}
+
+/// Import a data chunk as patched record batch
+arrow::Result<std::shared_ptr<arrow::RecordBatch>> WebDB::Connection::ImportChunk(duckdb::DataChunk& chunk,
+                                                                                   const ResultSchema& schema) {
+    ArrowArray array;
+    chunk.ToArrowArray(&array);
+    ARROW_ASSIGN_OR_RAISE(auto batch, arrow::ImportRecordBatch(&array, schema.schema));
+    return patchRecordBatch(batch, schema.patched_schema, *webdb_.config_, &webdb_.arrow_memory_pool_);
+}
 
 arrow::Result<std::shared_ptr<arrow::Buffer>> WebDB::Connection::MaterializeQueryResult(
-    std::unique_ptr<duckdb::QueryResult> result) {
+    std::unique_ptr<duckdb::QueryResult> result, std::shared_ptr<ResultSchema> schema) {
     current_query_result_.reset();
     current_schema_.reset();
     current_schema_patched_.reset();
 
-    // Configure the output writer
-    ArrowSchema raw_schema;
-    result->ToArrowSchema(&raw_schema);
-    ARROW_ASSIGN_OR_RAISE(auto schema, arrow::ImportSchema(&raw_schema));
+    // Import the schema (if necessary)
+    if (!schema) {
+        ARROW_ASSIGN_OR_RAISE(schema, ImportResultSchema(*result));
+    }
+    auto* pool = &webdb_.arrow_memory_pool_;
+    auto options = arrow::ipc::IpcWriteOptions::Defaults();
+    options.memory_pool = pool;
+
+    // Fetch the next non-empty chunk
+    auto fetch_chunk = [&]() {
+        auto chunk = result->Fetch();
+        return (!!chunk && chunk->size() > 0) ? std::move(chunk) : nullptr;
+    };
 
-    // Patch the schema (if necessary)
-    std::shared_ptr<arrow::Schema> patched_schema = schema;
-    if (!webdb_.config_->emit_bigint) {
-        patched_schema = patchSchema(schema, *webdb_.config_);
+    // Fetch the first two chunks to detect results of a single chunk
+    auto first_chunk = fetch_chunk();
+    auto next_chunk = first_chunk ? fetch_chunk() : nullptr;
+    std::shared_ptr<arrow::RecordBatch> first_batch = nullptr;
+    int64_t first_batch_size = 0;
+    if (first_chunk) {
+        ARROW_ASSIGN_OR_RAISE(first_batch, ImportChunk(*first_chunk, *schema));
+        ARROW_RETURN_NOT_OK(arrow::ipc::GetRecordBatchSize(*first_batch, options, &first_batch_size));
+    }
+
+    // Return a small result of a single chunk as IPC stream.
+    // The stream consists of the cached schema message, the record batch and the end-of-stream marker.
+    auto compact_size = schema->schema_message->size() + first_batch_size + sizeof(IPC_STREAM_EOS);
+    auto compact_limit = webdb_.config_->compact_result_size;
+    if (!next_chunk && schema->compact && compact_limit > 0 && compact_size <= compact_limit) {
+        io::PooledOutputStream out{output_buffers_};
+        ARROW_RETURN_NOT_OK(out.Reserve(compact_size));
+        ARROW_RETURN_NOT_OK(out.Write(schema->schema_message->data(), schema->schema_message->size()));
+        if (first_batch) {
+            ARROW_RETURN_NOT_OK(arrow::ipc::SerializeRecordBatch(*first_batch, options, &out));
+        }
+        ARROW_RETURN_NOT_OK(out.Write(IPC_STREAM_EOS, sizeof(IPC_STREAM_EOS)));
+        return out.Finish();
+    }
+
+    // Estimate the result size from the first batch if the chunk count is known.
+    // Otherwise, results of the same size as the previous one stay within a single recycled buffer.
+    auto out = std::make_shared<io::PooledOutputStream>(output_buffers_);
+    if (result->type == duckdb::QueryResultType::MATERIALIZED_RESULT) {
+        auto chunk_count = static_cast<duckdb::MaterializedQueryResult&>(*result).collection.ChunkCount();
+        ARROW_RETURN_NOT_OK(out->Reserve(first_batch_size * chunk_count + RESULT_FOOTER_RESERVE));
+    } else {
+        ARROW_RETURN_NOT_OK(out->Reserve(last_result_size_));
     }
 
     // Create the file writer
-    ARROW_ASSIGN_OR_RAISE(auto out, arrow::io::BufferOutputStream::Create());
-    ARROW_ASSIGN_OR_RAISE(auto writer, arrow::ipc::MakeFileWriter(out, patched_schema));
+    ARROW_ASSIGN_OR_RAISE(auto writer, arrow::ipc::MakeFileWriter(out, schema->patched_schema, options));
 
     // Write chunk stream
-    for (auto chunk = result->Fetch(); !!chunk && chunk->size() > 0; chunk = result->Fetch()) {
-        // Import the data chunk as record batch
-        ArrowArray array;
-        chunk->ToArrowArray(&array);
-        // Import the record batch
-        ARROW_ASSIGN_OR_RAISE(auto batch, arrow::ImportRecordBatch(&array, schema));
-        // Patch the record batch
-        ARROW_ASSIGN_OR_RAISE(batch, patchRecordBatch(batch, patched_schema, *webdb_.config_));
-        // Write the record batch
+    if (first_batch) {
+        ARROW_RETURN_NOT_OK(writer->WriteRecordBatch(*first_batch));
+        first_batch.reset();
+    }
+    for (auto chunk = std::move(next_chunk); !!chunk; chunk = fetch_chunk()) {
+        ARROW_ASSIGN_OR_RAISE(auto batch, ImportChunk(*chunk, *schema));
         ARROW_RETURN_NOT_OK(writer->WriteRecordBatch(*batch));
     }
     ARROW_RETURN_NOT_OK(writer->Close());
-    return out->Finish();
+    ARROW_ASSIGN_OR_RAISE(auto buffer, out->Finish());
+    last_result_size_ = buffer->size();
+    return buffer;
 }
 
 arrow::Result<std::shared_ptr<arrow::Buffer>> WebDB::Connection::StreamQueryResult(
-    std::unique_ptr<duckdb::QueryResult> result) {
+    std::unique_ptr<duckdb::QueryResult> result, std::shared_ptr<ResultSchema> schema) {
     current_query_result_ = move(result);
     current_schema_.reset();
     current_schema_patched_.reset();
 
-    // Import the schema
-    ArrowSchema raw_schema;
-    current_query_result_->ToArrowSchema(&raw_schema);
-    ARROW_ASSIGN_OR_RAISE(current_schema_, arrow::ImportSchema(&raw_schema));
-
-    // Patch the schema (if necessary)
-    current_schema_patched_ = current_schema_;
-    if (!webdb_.config_->emit_bigint) {
-        current_schema_patched_ = patchSchema(current_schema_, *webdb_.config_);
+    // Import the schema (if necessary)
+    if (!schema) {
+        ARROW_ASSIGN_OR_RAISE(schema, ImportResultSchema(*current_query_result_));
     }
-    // Serialize the schema
-    return arrow::ipc::SerializeSchema(*current_schema_patched_);
+    current_schema_ = schema->schema;
+    current_schema_patched_ = schema->patched_schema;
+    return schema->schema_message;
 }
 
 arrow::Result<std::shared_ptr<arrow::Buffer>> WebDB::Connection::RunQuery(std::string_view text) {
+    ArrowMemoryPool::Arena arena{webdb_.arrow_memory_pool_};
     try {
-        // Send the query
-        auto result = connection_.SendQuery(std::string{text});
+        webdb_.memory_governor_.Enforce();
+        std::shared_ptr<ResultSchema> schema;
+        ARROW_ASSIGN_OR_RAISE(auto result, ExecuteQuery(text, schema));
         if (!result->success) {
             return arrow::Status{arrow::StatusCode::ExecutionError, move(result->error)};
         }
-        return MaterializeQueryResult(std::move(result));
+        return MaterializeQueryResult(std::move(result), std::move(schema));
     } catch (std::exception& e) {
         return arrow::Status{arrow::StatusCode::ExecutionError, e.what()};
     } catch (...) {
@@ -154,11 +536,13 @@ arrow::Result<std::shared_ptr<arrow::Buffer>> WebDB::Connection::RunQuery(std::s
 }
 
 arrow::Result<std::shared_ptr<arrow::Buffer>> WebDB::Connection::SendQuery(std::string_view text) {
+    ArrowMemoryPool::Arena arena{webdb_.arrow_memory_pool_};
     try {
-        // Send the query
-        auto result = connection_.SendQuery(std::string{text});
+        webdb_.memory_governor_.Enforce();
+        std::shared_ptr<ResultSchema> schema;
+        ARROW_ASSIGN_OR_RAISE(auto result, ExecuteQuery(text, schema));
         if (!result->success) return arrow::Status{arrow::StatusCode::ExecutionError, move(result->error)};
-        return StreamQueryResult(std::move(result));
+        return StreamQueryResult(std::move(result), std::move(schema));
     } catch (std::exception& e) {
         return arrow::Status{arrow::StatusCode::ExecutionError, e.what()};
     } catch (...) {
@@ -167,6 +551,7 @@ arrow::Result<std::shared_ptr<arrow::Buffer>> WebDB::Connection::SendQuery(std::
 }
 
 arrow::Result<std::shared_ptr<arrow::Buffer>> WebDB::Connection::FetchQueryResults() {
+    ArrowMemoryPool::Arena arena{webdb_.arrow_memory_pool_};
     try {
         // Fetch data if a query is active
         std::unique_ptr<duckdb::DataChunk> chunk;
@@ -191,19 +576,137 @@ arrow::Result<std::shared_ptr<arrow::Buffer>> WebDB::Connection::FetchQueryResul
         chunk->ToArrowArray(&array);
         ARROW_ASSIGN_OR_RAISE(auto batch, arrow::ImportRecordBatch(&array, current_schema_));
         // Patch the record batch
-        ARROW_ASSIGN_OR_RAISE(batch, patchRecordBatch(batch, current_schema_patched_, *webdb_.config_));
-        // Serialize the record batch
+        auto* pool = &webdb_.arrow_memory_pool_;
+        ARROW_ASSIGN_OR_RAISE(batch, patchRecordBatch(batch, current_schema_patched_, *webdb_.config_, pool));
+        // Serialize the record batch into a recycled buffer of the exact size
         auto options = arrow::ipc::IpcWriteOptions::Defaults();
         options.use_threads = false;
-        return arrow::ipc::SerializeRecordBatch(*batch, options);
+        options.memory_pool = pool;
+        int64_t batch_size = 0;
+        ARROW_RETURN_NOT_OK(arrow::ipc::GetRecordBatchSize(*batch, options, &batch_size));
+        io::PooledOutputStream out{output_buffers_};
+        ARROW_RETURN_NOT_OK(out.Reserve(batch_size));
+        ARROW_RETURN_NOT_OK(arrow::ipc::SerializeRecordBatch(*batch, options, &out));
+        return out.Finish();
+    } catch (std::exception& e) {
+        return arrow::Status{arrow::StatusCode::ExecutionError, e.what()};
+    }
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>> WebDB::Connection::RunBatch(std::string_view script,
+                                                                          bool stop_on_error) {
+    ArrowMemoryPool::Arena arena{webdb_.arrow_memory_pool_};
+    try {
+        webdb_.memory_governor_.Enforce();
+        // Parse all statements at once
+        webdb_.LoadExtensionsFor(script);
+        duckdb::Parser parser;
+        parser.ParseQuery(std::string{script});
+
+        // Write the header, the result count is set at the end
+        io::PooledOutputStream out{output_buffers_};
+        uint32_t header[2] = {0, 0};
+        ARROW_RETURN_NOT_OK(out.Write(header, sizeof(header)));
+        uint32_t result_count = 0;
+
+        // Append a result record
+        auto append_result = [&](arrow::StatusCode code, const void* data, size_t length) {
+            static constexpr uint8_t PADDING[8] = {};
+            uint32_t record_header[2] = {static_cast<uint32_t>(code), static_cast<uint32_t>(length)};
+            ARROW_RETURN_NOT_OK(out.Reserve(sizeof(record_header) + length + sizeof(PADDING)));
+            ARROW_RETURN_NOT_OK(out.Write(record_header, sizeof(record_header)));
+            ARROW_RETURN_NOT_OK(out.Write(data, length));
+            ARROW_RETURN_NOT_OK(out.Write(PADDING, (8 - length % 8) % 8));
+            ++result_count;
+            return arrow::Status::OK();
+        };
+
+        // Execute the statements sequentially
+        for (auto& statement : parser.statements) {
+            if (statement->type != duckdb::StatementType::SELECT_STATEMENT) InvalidatePlans();
+            auto text = script.substr(statement->stmt_location, statement->stmt_length);
+            std::unique_ptr<duckdb::QueryResult> result = connection_.Query(std::move(statement));
+            if (!result->success && webdb_.LoadExtensionsAfterError(result->error)) {
+                result = connection_.Query(std::string{text});
+            }
+            auto buffer = result->success
+                              ? MaterializeQueryResult(std::move(result))
+                              : arrow::Status{arrow::StatusCode::ExecutionError, std::move(result->error)};
+            if (buffer.ok()) {
+                ARROW_RETURN_NOT_OK(append_result(arrow::StatusCode::OK, (*buffer)->data(), (*buffer)->size()));
+                continue;
+            }
+            auto& message = buffer.status().message();
+            ARROW_RETURN_NOT_OK(append_result(buffer.status().code(), message.data(), message.size()));
+            if (stop_on_error) break;
+        }
+        ARROW_ASSIGN_OR_RAISE(auto batch, out.Finish());
+        std::memcpy(batch->mutable_data(), &result_count, sizeof(result_count));
+        return batch;
     } catch (std::exception& e) {
         return arrow::Status{arrow::StatusCode::ExecutionError, e.what()};
     }
 }
 
+arrow::Result<size_t> WebDB::Connection::OpenCursor(std::string_view text) {
+    ArrowMemoryPool::Arena arena{webdb_.arrow_memory_pool_};
+    try {
+        webdb_.memory_governor_.Enforce();
+        std::shared_ptr<ResultSchema> schema;
+        ARROW_ASSIGN_OR_RAISE(auto result, ExecuteQuery(text, schema));
+        if (!result->success) return arrow::Status{arrow::StatusCode::ExecutionError, move(result->error)};
+        current_query_result_.reset();
+        current_schema_.reset();
+        current_schema_patched_.reset();
+        if (!schema) {
+            ARROW_ASSIGN_OR_RAISE(schema, ImportResultSchema(*result));
+        }
+
+        // Write the chunks into a temporary file that is compressed and spilled within the memory budget
+        auto id = next_cursor_id_++;
+        auto path = std::string{io::TEMP_DIRECTORY} + "/cursor_" + std::to_string(reinterpret_cast<uintptr_t>(this)) +
+                    "_" + std::to_string(id);
+        auto cursor = std::make_unique<ResultCursor>(webdb_.temp_filesystem(), std::move(path), schema->patched_schema,
+                                                     &webdb_.arrow_memory_pool_);
+        ARROW_RETURN_NOT_OK(cursor->Open());
+        for (auto chunk = result->Fetch(); !!chunk && chunk->size() > 0; chunk = result->Fetch()) {
+            ARROW_ASSIGN_OR_RAISE(auto batch, ImportChunk(*chunk, *schema));
+            ARROW_RETURN_NOT_OK(cursor->Append(*batch));
+        }
+        if (!result->success) return arrow::Status{arrow::StatusCode::ExecutionError, move(result->error)};
+        cursors_.insert({id, std::move(cursor)});
+        return id;
+    } catch (std::exception& e) {
+        return arrow::Status{arrow::StatusCode::ExecutionError, e.what()};
+    }
+}
+
+arrow::Result<uint64_t> WebDB::Connection::GetCursorRowCount(size_t cursor_id) {
+    auto iter = cursors_.find(cursor_id);
+    if (iter == cursors_.end()) return arrow::Status{arrow::StatusCode::KeyError, "No cursor found with ID"};
+    return iter->second->row_count();
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>> WebDB::Connection::FetchRows(size_t cursor_id, uint64_t offset,
+                                                                           uint64_t count) {
+    ArrowMemoryPool::Arena arena{webdb_.arrow_memory_pool_};
+    auto iter = cursors_.find(cursor_id);
+    if (iter == cursors_.end()) return arrow::Status{arrow::StatusCode::KeyError, "No cursor found with ID"};
+    return iter->second->FetchRows(offset, count, output_buffers_);
+}
+
+arrow::Status WebDB::Connection::CloseCursor(size_t cursor_id) {
+    if (cursors_.erase(cursor_id) == 0) return arrow::Status{arrow::StatusCode::KeyError, "No cursor found with ID"};
+    return arrow::Status::OK();
+}
+
 arrow::Result<size_t> WebDB::Connection::CreatePreparedStatement(std::string_view text) {
     try {
+        webdb_.LoadExtensionsFor(text);
         auto prep = connection_.Prepare(std::string{text});
+        if (!prep->success && webdb_.LoadExtensionsAfterError(prep->error)) {
+            prep = connection_.Prepare(std::string{text});
+        }
         if (!prep->success) return arrow::Status{arrow::StatusCode::ExecutionError, prep->error};
         auto id = next_prepared_statement_id_++;
 
@@ -220,6 +723,7 @@ arrow::Result<size_t> WebDB::Connection::CreatePreparedStatement(std::string_vie
 arrow::Result<std::unique_ptr<duckdb::QueryResult>> WebDB::Connection::ExecutePreparedStatement(
     size_t statement_id, std::string_view args_json) {
     try {
+        webdb_.memory_governor_.Enforce();
         auto stmt = prepared_statements_.find(statement_id);
         if (stmt == prepared_statements_.end())
             return arrow::Status{arrow::StatusCode::KeyError, "No prepared statement found with ID"};
@@ -229,6 +733,9 @@ arrow::Result<std::unique_ptr<duckdb::QueryResult>> WebDB::Connection::ExecutePr
         if (!ok) return arrow::Status{arrow::StatusCode::Invalid, rapidjson::GetParseError_En(ok.Code())};
         if (!args_doc.IsArray()) return arrow::Status{arrow::StatusCode::Invalid, "Arguments must be given as array"};
 
+        // Statements other than queries might change the catalog
+        if (stmt->second->type != duckdb::StatementType::SELECT_STATEMENT) InvalidatePlans();
+
         std::vector<duckdb::Value> values;
         size_t index = 0;
         for (const auto& v : args_doc.GetArray()) {
@@ -256,16 +763,20 @@ arrow::Result<std::unique_ptr<duckdb::QueryResult>> WebDB::Connection::ExecutePr
 
 arrow::Result<std::shared_ptr<arrow::Buffer>> WebDB::Connection::RunPreparedStatement(size_t statement_id,
                                                                                       std::string_view args_json) {
+    ArrowMemoryPool::Arena arena{webdb_.arrow_memory_pool_};
     auto result = ExecutePreparedStatement(statement_id, args_json);
     if (!result.ok()) return result.status();
-    return MaterializeQueryResult(std::move(*result));
+    ARROW_ASSIGN_OR_RAISE(auto schema, ResolvePreparedSchema(statement_id, **result));
+    return MaterializeQueryResult(std::move(*result), std::move(schema));
 }
 
 arrow::Result<std::shared_ptr<arrow::Buffer>> WebDB::Connection::SendPreparedStatement(size_t statement_id,
                                                                                        std::string_view args_json) {
+    ArrowMemoryPool::Arena arena{webdb_.arrow_memory_pool_};
     auto result = ExecutePreparedStatement(statement_id, args_json);
     if (!result.ok()) return result.status();
-    return StreamQueryResult(std::move(*result));
+    ARROW_ASSIGN_OR_RAISE(auto schema, ResolvePreparedSchema(statement_id, **result));
+    return StreamQueryResult(std::move(*result), std::move(schema));
 }
 
 arrow::Status WebDB::Connection::ClosePreparedStatement(size_t statement_id) {
@@ -273,12 +784,23 @@ arrow::Status WebDB::Connection::ClosePreparedStatement(size_t statement_id) {
     if (it == prepared_statements_.end())
         return arrow::Status{arrow::StatusCode::KeyError, "No prepared statement found with ID"};
     prepared_statements_.erase(it);
+    prepared_schemas_.erase(statement_id);
     return arrow::Status::OK();
 }
 
 /// Insert a record batch
 arrow::Status WebDB::Connection::InsertArrowFromIPCStream(nonstd::span<const uint8_t> stream,
                                                           std::string_view options_json) {
+    // The caller keeps the bytes, copy them once into a buffer that the decoded batches can reference
+    ArrowMemoryPool::Arena arena{webdb_.arrow_memory_pool_};
+    ARROW_ASSIGN_OR_RAISE(auto buffer, arrow::AllocateBuffer(stream.size(), &webdb_.arrow_memory_pool_));
+    std::memcpy(buffer->mutable_data(), stream.data(), stream.size());
+    return InsertArrowFromIPCStream(std::shared_ptr<arrow::Buffer>{std::move(buffer)}, options_json);
+}
+/// Insert a record batch
+arrow::Status WebDB::Connection::InsertArrowFromIPCStream(std::shared_ptr<arrow::Buffer> stream,
+                                                          std::string_view options_json) {
+    ArrowMemoryPool::Arena arena{webdb_.arrow_memory_pool_};
     try {
         // First call?
         if (!arrow_ipc_stream_) {
@@ -287,52 +809,204 @@ arrow::Status WebDB::Connection::InsertArrowFromIPCStream(nonstd::span<const uin
             /// Read table options.
             /// We deliberately do this BEFORE creating the ipc stream.
             /// This ensures that we always have valid options.
-            rapidjson::Document options_doc;
-            options_doc.Parse(options_json.begin(), options_json.size());
-            ArrowInsertOptions options;
-            ARROW_RETURN_NOT_OK(options.ReadFrom(options_doc));
-            arrow_insert_options_ = options;
+            ARROW_ASSIGN_OR_RAISE(arrow_insert_options_, ReadArrowInsertOptions(options_json));
 
             // Create the IPC stream
-            arrow_ipc_stream_ = std::make_unique<BufferingArrowIPCStreamDecoder>();
+            auto read_options = arrow::ipc::IpcReadOptions::Defaults();
+            read_options.memory_pool = &webdb_.arrow_memory_pool_;
+            arrow_ipc_stream_ = std::make_unique<BufferingArrowIPCStreamDecoder>(
+                std::make_shared<ArrowIPCStreamBuffer>(), std::move(read_options));
         }
 
         /// Consume stream bytes
-        ARROW_RETURN_NOT_OK(arrow_ipc_stream_->Consume(stream.data(), stream.size()));
+        ARROW_RETURN_NOT_OK(arrow_ipc_stream_->Consume(std::move(stream)));
+        arrow_ipc_bytes_ = arrow_ipc_stream_->buffer()->GetByteSize();
         if (!arrow_ipc_stream_->buffer()->is_eos()) {
             return arrow::Status::OK();
         }
         assert(arrow_insert_options_);
 
-        // Prepare stream reader
+        // Reset the ipc stream and insert the buffered batches
+        auto options = *arrow_insert_options_;
         auto stream_reader = std::make_shared<ArrowIPCStreamBufferReader>(arrow_ipc_stream_->buffer());
-        auto stream_wrapper = duckdb::make_unique<duckdb::ArrowArrayStreamWrapper>();
-        stream_wrapper->arrow_array_stream.release = nullptr;
-        ARROW_RETURN_NOT_OK(arrow::ExportRecordBatchReader(stream_reader, &stream_wrapper->arrow_array_stream));
-
+        arrow_insert_options_.reset();
+        arrow_ipc_stream_.reset();
+        arrow_ipc_bytes_ = 0;
+        return InsertArrowRecordBatches(std::move(stream_reader), options);
+    } catch (const std::exception& e) {
+        arrow_insert_options_.reset();
+        arrow_ipc_stream_.reset();
+        arrow_ipc_bytes_ = 0;
+        return arrow::Status::UnknownError(e.what());
+    }
+    return arrow::Status::OK();
+}
+/// Insert the record batches of a reader into a table
+arrow::Status WebDB::Connection::InsertArrowRecordBatches(std::shared_ptr<arrow::RecordBatchReader> reader,
+                                                          const ArrowInsertOptions& options) {
+    if (options.create_new) InvalidatePlans();
+
+    // Appends are folded into the incremental views over the table
+    std::vector<IncrementalView*> views;
+    if (!options.create_new) {
+        auto schema_name = options.schema_name.empty() ? std::string{"main"} : options.schema_name;
+        for (auto& [name, view] : incremental_views_) {
+            if (view.table_name() == options.table_name && view.schema_name() == schema_name) views.push_back(&view);
+        }
+    }
+    if (!views.empty()) return InsertAndFoldArrowRecordBatches(std::move(reader), options, views);
+    try {
         /// Execute the arrow scan
         vector<Value> params;
-        params.push_back(duckdb::Value::POINTER((uintptr_t)&stream_reader));
+        params.push_back(duckdb::Value::POINTER((uintptr_t)&reader));
         params.push_back(
             duckdb::Value::POINTER((uintptr_t)ArrowIPCStreamBufferReader::CreateArrayStreamFromSharedPtrPtr));
         params.push_back(duckdb::Value::UBIGINT(1000000));
         auto func = connection_.TableFunction("arrow_scan", params);
 
         /// Create or insert
-        if (arrow_insert_options_->create_new) {
-            func->Create(arrow_insert_options_->schema_name, arrow_insert_options_->table_name);
+        if (options.create_new) {
+            func->Create(options.schema_name, options.table_name);
         } else {
-            func->Insert(arrow_insert_options_->schema_name, arrow_insert_options_->table_name);
+            func->Insert(options.schema_name, options.table_name);
         }
+    } catch (const std::exception& e) {
+        return arrow::Status::UnknownError(e.what());
+    }
+    return arrow::Status::OK();
+}
+/// Insert the record batches of a reader into a table and fold them into incremental views.
+/// The batches are buffered since they are scanned by the insert and by every fold.
+arrow::Status WebDB::Connection::InsertAndFoldArrowRecordBatches(std::shared_ptr<arrow::RecordBatchReader> reader,
+                                                                 const ArrowInsertOptions& options,
+                                                                 const std::vector<IncrementalView*>& views) {
+    ARROW_ASSIGN_OR_RAISE(auto buffer, ArrowIPCStreamBuffer::ReadFrom(*reader));
+    reader.reset();
+
+    // Insert and fold in a single transaction unless the caller already started one
+    auto own_transaction = connection_.IsAutoCommit();
+    auto status = arrow::Status::OK();
+    try {
+        if (own_transaction) connection_.BeginTransaction();
+        vector<Value> params;
+        params.push_back(duckdb::Value::POINTER((uintptr_t)buffer.get()));
+        params.push_back(duckdb::Value::POINTER((uintptr_t)ArrowIPCStreamBufferReader::CreateArrayStreamFromBufferPtr));
+        params.push_back(duckdb::Value::UBIGINT(1000000));
+        auto func = connection_.TableFunction("arrow_scan", params);
+        func->Insert(options.schema_name, options.table_name);
+
+        // Fold the appended rows through a transient view over the same batches
+        std::string rows_view{INCREMENTAL_ROWS_VIEW};
+        func->CreateView(rows_view, true, true);
+        for (auto* view : views) {
+            status = RunStatements(connection_, view->EncodeFold(QuoteIdentifier(rows_view)));
+            if (!status.ok()) break;
+        }
+        auto dropped = connection_.Query("DROP VIEW IF EXISTS " + QuoteIdentifier(rows_view));
+        if (status.ok() && !dropped->success) {
+            status = arrow::Status{arrow::StatusCode::ExecutionError, move(dropped->error)};
+        }
+        if (status.ok() && own_transaction) connection_.Commit();
+    } catch (const std::exception& e) {
+        status = arrow::Status::UnknownError(e.what());
+    }
 
-        // Reset the ipc stream
-        arrow_insert_options_.reset();
-        arrow_ipc_stream_.reset();
+    // A failed insert or fold would leave the views out of sync with the table.
+    // The transaction is rolled back as a whole, even if the caller started it.
+    if (!status.ok()) {
+        try {
+            if (!connection_.IsAutoCommit()) connection_.Rollback();
+        } catch (...) {
+        }
+        if (own_transaction) return status;
+        return arrow::Status(status.code(), "the transaction was rolled back: " + status.message());
+    }
+    for (auto* view : views) view->CommitFold();
+    return status;
+}
+/// Insert the record batches of a reader
+arrow::Status WebDB::Connection::InsertArrowFromRecordBatchReader(std::shared_ptr<arrow::RecordBatchReader> reader,
+                                                                  std::string_view options_json) {
+    if (!reader) return arrow::Status::Invalid("record batch reader is null");
+    ARROW_ASSIGN_OR_RAISE(auto options, ReadArrowInsertOptions(options_json));
+    return InsertArrowRecordBatches(std::move(reader), options);
+}
+/// Insert the record batches of an arrow C stream
+arrow::Status WebDB::Connection::InsertArrowFromArrayStream(ArrowArrayStream* stream, std::string_view options_json) {
+    if (!stream) return arrow::Status::Invalid("arrow array stream is null");
+    ARROW_ASSIGN_OR_RAISE(auto reader, arrow::ImportRecordBatchReader(stream));
+    return InsertArrowFromRecordBatchReader(std::move(reader), options_json);
+}
+/// Create a temporary view over the record batches of a reader
+arrow::Status WebDB::Connection::CreateArrowView(std::string_view name,
+                                                 std::shared_ptr<arrow::RecordBatchReader> reader) {
+    if (!reader) return arrow::Status::Invalid("record batch reader is null");
+    ARROW_ASSIGN_OR_RAISE(auto buffer, ArrowIPCStreamBuffer::ReadFrom(*reader));
+    InvalidatePlans();
+    try {
+        // Every scan of the view reads the buffered batches with a new reader
+        vector<Value> params;
+        params.push_back(duckdb::Value::POINTER((uintptr_t)buffer.get()));
+        params.push_back(duckdb::Value::POINTER((uintptr_t)ArrowIPCStreamBufferReader::CreateArrayStreamFromBufferPtr));
+        params.push_back(duckdb::Value::UBIGINT(1000000));
+        connection_.TableFunction("arrow_scan", params)->CreateView(std::string{name}, true, true);
+    } catch (const std::exception& e) {
+        return arrow::Status::UnknownError(e.what());
+    }
+    // Replace the batches of a previous view only after the view was replaced
+    if (auto iter = arrow_views_.find(std::string{name}); iter != arrow_views_.end()) {
+        arrow_view_bytes_ -= iter->second->GetByteSize();
+    }
+    arrow_view_bytes_ += buffer->GetByteSize();
+    arrow_views_.insert_or_assign(std::string{name}, std::move(buffer));
+    return arrow::Status::OK();
+}
+/// Create a temporary view over the record batches of an arrow C stream
+arrow::Status WebDB::Connection::CreateArrowView(std::string_view name, ArrowArrayStream* stream) {
+    if (!stream) return arrow::Status::Invalid("arrow array stream is null");
+    ARROW_ASSIGN_OR_RAISE(auto reader, arrow::ImportRecordBatchReader(stream));
+    return CreateArrowView(name, std::move(reader));
+}
+/// Drop an arrow view
+arrow::Status WebDB::Connection::DropArrowView(std::string_view name) {
+    auto iter = arrow_views_.find(std::string{name});
+    if (iter == arrow_views_.end()) return arrow::Status::KeyError("unknown arrow view: ", name);
+    InvalidatePlans();
+    auto result = connection_.Query("DROP VIEW IF EXISTS " + QuoteIdentifier(name));
+    if (!result->success) return arrow::Status{arrow::StatusCode::ExecutionError, move(result->error)};
+    arrow_view_bytes_ -= iter->second->GetByteSize();
+    arrow_views_.erase(iter);
+    return arrow::Status::OK();
+}
+/// Create an incremental aggregate view
+arrow::Status WebDB::Connection::CreateIncrementalView(std::string_view definition) {
+    rapidjson::Document doc;
+    rapidjson::ParseResult ok = doc.Parse(definition.begin(), definition.size());
+    if (!ok) return arrow::Status{arrow::StatusCode::Invalid, rapidjson::GetParseError_En(ok.Code())};
+    IncrementalView view;
+    ARROW_RETURN_NOT_OK(view.ReadFrom(doc));
+    if (arrow_views_.count(view.name())) return arrow::Status::Invalid("name is used by an arrow view: ", view.name());
+    InvalidatePlans();
+    try {
+        ARROW_RETURN_NOT_OK(RunStatements(connection_, view.EncodeCreate()));
+    } catch (const std::exception& e) {
+        return arrow::Status::UnknownError(e.what());
+    }
+    auto name = view.name();
+    incremental_views_.insert_or_assign(std::move(name), std::move(view));
+    return arrow::Status::OK();
+}
+/// Drop an incremental view
+arrow::Status WebDB::Connection::DropIncrementalView(std::string_view name) {
+    auto iter = incremental_views_.find(std::string{name});
+    if (iter == incremental_views_.end()) return arrow::Status::KeyError("unknown incremental view: ", name);
+    InvalidatePlans();
+    try {
+        ARROW_RETURN_NOT_OK(RunStatements(connection_, iter->second.EncodeDrop()));
     } catch (const std::exception& e) {
-        arrow_insert_options_.reset();
-        arrow_ipc_stream_.reset();
         return arrow::Status::UnknownError(e.what());
     }
+    incremental_views_.erase(iter);
     return arrow::Status::OK();
 }
 /// Import a csv file
@@ -387,6 +1061,7 @@ arrow::Status WebDB::Connection::InsertCSVFromPath(std::string_view path, std::s
         named_params.insert({"auto_detect", Value::BOOLEAN(options.auto_detect.value_or(true))});
 
         /// Execute the csv scan
+        if (options.create_new) InvalidatePlans();
         auto func =
             std::make_shared<TableFunctionRelation>(*connection_.context, "read_csv", unnamed_params, named_params);
 
@@ -405,6 +1080,7 @@ arrow::Status WebDB::Connection::InsertCSVFromPath(std::string_view path, std::s
 
 /// Import a json file
 arrow::Status WebDB::Connection::InsertJSONFromPath(std::string_view path, std::string_view options_json) {
+    ArrowMemoryPool::Arena arena{webdb_.arrow_memory_pool_};
     try {
         /// Read table options
         rapidjson::Document options_doc;
@@ -417,7 +1093,8 @@ arrow::Status WebDB::Connection::InsertJSONFromPath(std::string_view path, std::
         if (options.table_name.empty()) return arrow::Status::Invalid("missing 'name' option");
 
         // Create the input file stream
-        auto ifs = std::make_unique<io::InputFileStream>(webdb_.file_page_buffer_, path);
+        auto codec = io::ResolveCompressionCodec(path, duckdb::FileCompressionType::AUTO_DETECT);
+        auto ifs = std::make_unique<io::InputFileStream>(webdb_.file_page_buffer_, path, codec);
         // Do we need to run the analyzer?
         json::TableType table_type;
         if (!options.table_shape || options.table_shape == json::JSONTableShape::UNRECOGNIZED ||
@@ -430,9 +1107,11 @@ arrow::Status WebDB::Connection::InsertJSONFromPath(std::string_view path, std::
             table_type.type = arrow::struct_(options.columns.value_or(std::vector<std::shared_ptr<arrow::Field>>{}));
         }
         // Resolve the table reader
-        ARROW_ASSIGN_OR_RAISE(auto table_reader, json::TableReader::Resolve(std::move(ifs), table_type));
+        ARROW_ASSIGN_OR_RAISE(auto table_reader, json::TableReader::Resolve(std::move(ifs), table_type, 1024,
+                                                                             &webdb_.arrow_memory_pool_));
 
         /// Execute the arrow scan
+        if (options.create_new) InvalidatePlans();
         vector<Value> params;
         params.push_back(duckdb::Value::POINTER((uintptr_t)&table_reader));
         params.push_back(duckdb::Value::POINTER((uintptr_t)json::TableReader::CreateArrayStreamFromSharedPtrPtr));
@@ -463,8 +1142,12 @@ WebDB::WebDB(WebTag)
       pinned_web_files_() {
     auto webfs = std::make_shared<io::WebFileSystem>(config_);
     webfs->ConfigureFileStatistics(file_stats_);
+    memory_governor_.Register("readahead", *webfs, READAHEAD_MEMORY_SHARE);
     file_page_buffer_ = std::make_shared<io::FilePageBuffer>(std::move(webfs));
     file_page_buffer_->ConfigureFileStatistics(file_stats_);
+    memory_governor_.Register("pageBuffer", *file_page_buffer_, PAGE_BUFFER_MEMORY_SHARE);
+    memory_governor_.Register("arrow", arrow_memory_pool_);
+    file_warmer_ = std::make_unique<io::FileWarmer>(file_page_buffer_);
     if (auto open_status = Open(); !open_status.ok()) {
         throw std::runtime_error(open_status.message());
     }
@@ -480,12 +1163,24 @@ WebDB::WebDB(NativeTag, std::unique_ptr<duckdb::FileSystem> fs)
       file_stats_(std::make_shared<io::FileStatisticsRegistry>()),
       pinned_web_files_() {
     file_page_buffer_->ConfigureFileStatistics(file_stats_);
+    memory_governor_.Register("pageBuffer", *file_page_buffer_, PAGE_BUFFER_MEMORY_SHARE);
+    memory_governor_.Register("arrow", arrow_memory_pool_);
+    // Read-only local files are mapped instead of being copied into page frames.
+    // Other local files load page runs with batched async reads.
+    if (IsLocalFileSystem(*file_page_buffer_->GetFileSystem())) {
+        file_page_buffer_->ConfigureMemoryMapping(true);
+        file_page_buffer_->ConfigureAsyncReads(io::AsyncReader::Create(io::DEFAULT_ASYNC_QUEUE_DEPTH));
+    }
+    file_warmer_ = std::make_unique<io::FileWarmer>(file_page_buffer_);
     if (auto open_status = Open(); !open_status.ok()) {
         throw std::runtime_error(open_status.message());
     }
 }
 
-WebDB::~WebDB() { pinned_web_files_.clear(); }
+WebDB::~WebDB() {
+    file_warmer_.reset();
+    pinned_web_files_.clear();
+}
 
 /// Tokenize a script and return tokens as json
 std::string WebDB::Tokenize(std::string_view text) {
@@ -511,6 +1206,15 @@ std::string WebDB::Tokenize(std::string_view text) {
     return strbuf.GetString();
 }
 
+/// Tokenize a script and return the packed tokens
+std::shared_ptr<arrow::Buffer> WebDB::TokenizeBinary(std::string_view text) { return script_tokenizer_.Tokenize(text); }
+
+/// Apply an edit to the last tokenized script and return the packed token update
+arrow::Result<std::shared_ptr<arrow::Buffer>> WebDB::RetokenizeBinary(size_t offset, size_t removed,
+                                                                      std::string_view inserted) {
+    return script_tokenizer_.Retokenize(offset, removed, inserted);
+}
+
 /// Get the version
 std::string_view WebDB::GetVersion() { return database_->LibraryVersion(); }
 /// Get feature flags
@@ -538,35 +1242,124 @@ void WebDB::FlushFiles() { file_page_buffer_->FlushFiles(); }
 /// Flush file by path
 void WebDB::FlushFile(std::string_view path) { file_page_buffer_->FlushFile(path); }
 
-/// Reset the database
+/// Reset the database.
+/// The file page buffer and the registered files are kept, only the database instance is replaced.
 arrow::Status WebDB::Reset() { return Open(); }
 
+/// Load the parquet extension
+void WebDB::LoadParquetExtension() {
+    if (parquet_extension_loaded_.load()) return;
+    std::lock_guard<std::mutex> extension_guard{extension_mutex_};
+    if (parquet_extension_loaded_.load()) return;
+    database_->LoadExtension<duckdb::ParquetExtension>();
+    parquet_extension_loaded_.store(true);
+}
+
+/// Load the extensions that a query text refers to
+void WebDB::LoadExtensionsFor(std::string_view text) {
+    if (!parquet_extension_loaded_ && MentionsParquet(text)) {
+        LoadParquetExtension();
+    }
+}
+
+/// Load the extensions that a failed query might have missed.
+/// Views of persistent databases may refer to extension functions without mentioning them in the query text.
+bool WebDB::LoadExtensionsAfterError(std::string_view error) {
+    if (!parquet_extension_loaded_ && MentionsParquet(error)) {
+        LoadParquetExtension();
+        return true;
+    }
+    return false;
+}
+
 /// Open a database
 arrow::Status WebDB::Open(std::string_view args_json) {
     assert(config_ != nullptr);
-    *config_ = WebDBConfig::ReadFrom(args_json);
-    bool in_memory = config_->path == ":memory:" || config_->path == "";
+    return OpenDatabase(WebDBConfig::ReadFrom(args_json));
+}
+
+/// Close the current database and all its connections
+void WebDB::CloseDatabase() {
+    connections_.clear();
+    database_.reset();
+    buffered_filesystem_ = nullptr;
+}
+
+/// Open the database of a config, the config is adopted once the database is opened
+arrow::Status WebDB::OpenDatabase(const WebDBConfig& config) {
+    // Validate the config before the current database is touched
+    ARROW_ASSIGN_OR_RAISE(auto access_mode, ResolveAccessMode(config));
+    bool in_memory = config.path == ":memory:" || config.path == "";
+
+    // Other databases are opened next to the current one and replace it only once they are opened.
+    // The current database has to release its file first if it is opened again, it is recovered on failure.
+    if (!database_ || in_memory || config_->path != config.path) return CreateDatabase(config, access_mode);
+    auto previous = *config_;
+    CloseDatabase();
+    auto status = CreateDatabase(config, access_mode);
+    if (!status.ok()) RecoverDatabase(previous);
+    return status;
+}
+
+/// Create a database and replace the current one if it was opened
+arrow::Status WebDB::CreateDatabase(const WebDBConfig& config, duckdb::AccessMode access_mode) {
+    // The filesystems read the new config while the database is opened, the current one is restored on failure
+    auto previous = *config_;
+    *config_ = config;
+    auto restore = sg::make_scope_guard([&]() noexcept {
+        *config_ = previous;
+        memory_governor_.SetBudget(previous.memory_budget);
+        file_page_buffer_->ConfigureDecompression(previous.maximum_threads);
+    });
     try {
         // Setup new database
         auto buffered_fs = std::make_unique<io::BufferedFileSystem>(file_page_buffer_);
         auto buffered_fs_ptr = buffered_fs.get();
 
+        // Temporary files of out-of-core operators are kept in memory and overflow into a native file
+        auto& temp_overflow_file = config.filesystem.temp_overflow_file;
+        auto temp_fs = std::make_shared<io::TempFileSystem>(
+            config.filesystem.temp_budget,
+            temp_overflow_file.empty() ? nullptr : file_page_buffer_->GetFileSystem().get(), temp_overflow_file);
+        buffered_fs_ptr->SetTempFileSystem(temp_fs);
+
+        // Split the memory budget and hand the remainder to the DuckDB buffer manager
+        memory_governor_.SetBudget(config.memory_budget);
+        memory_governor_.Enforce();
+
         duckdb::DBConfig db_config;
         db_config.file_system = std::move(buffered_fs);
-        db_config.maximum_threads = config_->maximum_threads;
-        db_config.access_mode = in_memory ? AccessMode::UNDEFINED : AccessMode::READ_ONLY;
+        db_config.maximum_threads = config.maximum_threads;
+        db_config.access_mode = access_mode;
+        db_config.temporary_directory = std::string{io::TEMP_DIRECTORY};
+        if (auto database_memory = memory_governor_.GetDatabaseMemory(); database_memory > 0) {
+            db_config.maximum_memory = database_memory;
+        }
+        file_page_buffer_->ConfigureDecompression(config.maximum_threads);
+
+        // Buffers that are pinned as web files bypass the page buffer
+        if (auto web_fs = io::WebFileSystem::Get()) {
+            for (auto& [file_name, file_hdl] : pinned_web_files_) {
+                if (web_fs->ResolveDataProtocol(file_name) == io::WebFileSystem::DataProtocol::BUFFER) {
+                    buffered_fs_ptr->RegisterFile(file_name, {.force_direct_io = true});
+                }
+            }
+        }
 
-        auto db = std::make_shared<duckdb::DuckDB>(config_->path, &db_config);
-        db->LoadExtension<duckdb::ParquetExtension>();
+        // Extensions are loaded lazily
+        auto db = std::make_shared<duckdb::DuckDB>(config.path, &db_config);
 
         // Reset state that is specific to the old database
-        connections_.clear();
-        database_.reset();
-        buffered_filesystem_ = nullptr;
+        CloseDatabase();
 
         // Store  new database
+        if (temp_filesystem_) memory_governor_.Unregister(*temp_filesystem_);
+        temp_filesystem_ = std::move(temp_fs);
+        memory_governor_.Register("tempStorage", *temp_filesystem_);
         buffered_filesystem_ = buffered_fs_ptr;
         database_ = std::move(db);
+        parquet_extension_loaded_.store(false);
+        restore.dismiss();
 
     } catch (std::exception& ex) {
         return arrow::Status::Invalid("Opening the database failed with error: ", ex.what());
@@ -575,14 +1368,30 @@ arrow::Status WebDB::Open(std::string_view args_json) {
     }
     return arrow::Status::OK();
 }
+
+/// Reopen the previous database after a failed open, falls back to an in-memory database
+void WebDB::RecoverDatabase(const WebDBConfig& previous) {
+    if (OpenDatabase(previous).ok()) return;
+    auto fallback = previous;
+    fallback.path = ":memory:";
+    fallback.access_mode = WebDBAccessMode::AUTOMATIC;
+    fallback.filesystem.temp_overflow_file = "";
+    auto status = OpenDatabase(fallback);
+    assert(status.ok());
+    (void)status;
+}
+
 /// Register a file URL
 arrow::Status WebDB::RegisterFileURL(std::string_view file_name, std::string_view file_url,
                                      std::optional<uint64_t> file_size) {
     // No web filesystem configured?
     auto web_fs = io::WebFileSystem::Get();
     if (!web_fs) return arrow::Status::Invalid("WebFileSystem is not configured");
+    // Cached plans might have bound the previous file
+    ++catalog_epoch_;
     // Try to drop the file in the buffered file system.
     // If that fails we have to give up since someone still holds an open file ref.
+    file_warmer_->CancelFile(file_name);
     if (!buffered_filesystem_->TryDropFile(file_name)) {
         return arrow::Status::Invalid("File is already registered and is still buffered");
     }
@@ -591,20 +1400,63 @@ arrow::Status WebDB::RegisterFileURL(std::string_view file_name, std::string_vie
     if (auto iter = pinned_web_files_.find(file_name); iter != pinned_web_files_.end()) {
         pinned_web_files_.erase(iter);
     }
+    web_fs->UnpinFile(file_name);
     // Register new file url in web filesystem.
     // Pin the file handle to keep the file alive.
     ARROW_ASSIGN_OR_RAISE(auto file_hdl, web_fs->RegisterFileURL(file_name, file_url, file_size));
     pinned_web_files_.insert({file_hdl->GetName(), std::move(file_hdl)});
     return arrow::Status::OK();
 }
+/// Register a batch of file URLs
+arrow::Status WebDB::RegisterFileURLs(nonstd::span<const char> batch, bool defer_handles) {
+    // No web filesystem configured?
+    auto web_fs = io::WebFileSystem::Get();
+    if (!web_fs) return arrow::Status::Invalid("WebFileSystem is not configured");
+    // Cached plans might have bound the previous file
+    ++catalog_epoch_;
+    ARROW_ASSIGN_OR_RAISE(auto files, io::WebFileSystem::DecodeFileURLs(batch));
+    nonstd::span<const io::WebFileSystem::FileURL> file_urls{files.data(), files.size()};
+
+    // Check the whole batch before unpinning any file
+    ARROW_RETURN_NOT_OK(web_fs->CheckFileURLs(
+        file_urls, [&](std::string_view file_name) { return pinned_web_files_.count(file_name) > 0; }));
+
+    // Try to drop the files in the buffered file system
+    std::vector<std::string_view> file_names;
+    file_names.reserve(files.size());
+    for (auto& file : files) {
+        file_names.push_back(file.file_name);
+        file_warmer_->CancelFile(file.file_name);
+    }
+    if (auto buffered = buffered_filesystem_->TryDropFiles({file_names.data(), file_names.size()})) {
+        return arrow::Status::Invalid("File is already registered and is still buffered: ", *buffered);
+    }
+    // Unpin files that we pinned before
+    for (auto file_name : file_names) {
+        if (auto iter = pinned_web_files_.find(file_name); iter != pinned_web_files_.end()) {
+            pinned_web_files_.erase(iter);
+        }
+        web_fs->UnpinFile(file_name);
+    }
+    // Register all files at once and pin the handles (if any)
+    ARROW_ASSIGN_OR_RAISE(auto file_hdls, web_fs->RegisterFileURLs(file_urls, defer_handles));
+    pinned_web_files_.reserve(pinned_web_files_.size() + file_hdls.size());
+    for (auto& file_hdl : file_hdls) {
+        pinned_web_files_.insert({file_hdl->GetName(), std::move(file_hdl)});
+    }
+    return arrow::Status::OK();
+}
 /// Register a file URL
 arrow::Status WebDB::RegisterFileBuffer(std::string_view file_name, std::unique_ptr<char[]> buffer,
                                         size_t buffer_length) {
     // No web filesystem configured?
     auto web_fs = io::WebFileSystem::Get();
     if (!web_fs) return arrow::Status::Invalid("WebFileSystem is not configured");
+    // Cached plans might have bound the previous file
+    ++catalog_epoch_;
     // Try to drop the file in the buffered file system.
     // If that fails we have to give up since someone still holds an open file ref.
+    file_warmer_->CancelFile(file_name);
     if (!buffered_filesystem_->TryDropFile(file_name)) {
         return arrow::Status::Invalid("File is already registered and is still buffered");
     }
@@ -613,6 +1465,7 @@ arrow::Status WebDB::RegisterFileBuffer(std::string_view file_name, std::unique_
     if (auto iter = pinned_web_files_.find(file_name); iter != pinned_web_files_.end()) {
         pinned_web_files_.erase(iter);
     }
+    web_fs->UnpinFile(file_name);
     // Register new file in web filesystem
     io::WebFileSystem::DataBuffer data{std::move(buffer), buffer_length};
     ARROW_ASSIGN_OR_RAISE(auto file_hdl, web_fs->RegisterFileBuffer(file_name, std::move(data)));
@@ -627,6 +1480,9 @@ arrow::Status WebDB::RegisterFileBuffer(std::string_view file_name, std::unique_
 }
 /// Drop all files
 arrow::Status WebDB::DropFiles() {
+    // Cached plans might have bound the dropped files
+    ++catalog_epoch_;
+    file_warmer_->CancelAll();
     file_page_buffer_->DropDanglingFiles();
     pinned_web_files_.clear();
     if (auto fs = io::WebFileSystem::Get()) {
@@ -636,6 +1492,9 @@ arrow::Status WebDB::DropFiles() {
 }
 /// Drop a file
 arrow::Status WebDB::DropFile(std::string_view file_name) {
+    // Cached plans might have bound the dropped files
+    ++catalog_epoch_;
+    file_warmer_->CancelFile(file_name);
     file_page_buffer_->TryDropFile(file_name);
     pinned_web_files_.erase(file_name);
     if (auto fs = io::WebFileSystem::Get()) {
@@ -713,45 +1572,199 @@ arrow::Result<std::shared_ptr<arrow::Buffer>> WebDB::ExportFileStatistics(std::s
     return file_stats_->ExportStatistics(path);
 }
 
-/// Copy a file to a buffer
-arrow::Result<std::shared_ptr<arrow::Buffer>> WebDB::CopyFileToBuffer(std::string_view path) {
-    auto& fs = filesystem();
-    auto src = fs.OpenFile(std::string{path}, duckdb::FileFlags::FILE_FLAGS_READ);
-    auto n = fs.GetFileSize(*src);
-    ARROW_ASSIGN_OR_RAISE(auto buffer, arrow::AllocateResizableBuffer(n));
+/// Warm up a file
+arrow::Result<size_t> WebDB::WarmFile(std::string_view path, std::string_view target_json, int32_t priority) {
+    ARROW_ASSIGN_OR_RAISE(auto target, io::FileWarmer::ParseTarget(target_json));
+    return file_warmer_->Enqueue(path, target.first, std::move(target.second), priority);
+}
 
-    auto writer = buffer->mutable_data();
-    while (n > 0) {
-        auto m = fs.Read(*src, writer, n);
-        assert(m <= n);
-        writer += m;
-        if (m == 0) break;
+/// Get the progress of a warm-up
+arrow::Result<std::string> WebDB::GetWarmUpProgress(size_t warm_up_id) {
+    // Without a background thread, polling the progress drives the warm-up
+    if (!file_warmer_->HasBackgroundThread()) {
+        file_warmer_->Step();
     }
+    auto progress = file_warmer_->GetProgress(warm_up_id);
+    if (!progress) return arrow::Status::KeyError("unknown warm-up: ", warm_up_id);
 
-    ARROW_RETURN_NOT_OK(buffer->Resize(writer - buffer->data()));
-    return buffer;
+    rapidjson::Document doc;
+    auto value = progress->WriteInfo(doc);
+    rapidjson::StringBuffer strbuf;
+    rapidjson::Writer<rapidjson::StringBuffer> writer{strbuf};
+    value.Accept(writer);
+    return strbuf.GetString();
+}
+
+/// Cancel a warm-up
+arrow::Status WebDB::CancelWarmUp(size_t warm_up_id) {
+    if (!file_warmer_->Cancel(warm_up_id)) return arrow::Status::KeyError("unknown warm-up: ", warm_up_id);
+    return arrow::Status::OK();
+}
+
+/// Get the memory budget and the usage of all subsystems as JSON
+arrow::Result<std::string> WebDB::GetMemoryInfo() {
+    rapidjson::Document doc;
+    auto value = memory_governor_.WriteInfo(doc);
+    value.AddMember("databaseMemory", static_cast<double>(memory_governor_.GetDatabaseMemory()), doc.GetAllocator());
+    value.AddMember("arrow", arrow_memory_pool_.WriteStatistics(doc), doc.GetAllocator());
+    rapidjson::StringBuffer strbuf;
+    rapidjson::Writer<rapidjson::StringBuffer> writer{strbuf};
+    value.Accept(writer);
+    return strbuf.GetString();
+}
+
+/// Release memory of the page buffer and the readaheads
+arrow::Result<size_t> WebDB::ReclaimMemory(size_t bytes) { return memory_governor_.Reclaim(bytes); }
+
+/// Copy a file to a buffer
+arrow::Result<std::shared_ptr<arrow::Buffer>> WebDB::CopyFileToBuffer(std::string_view path) {
+    try {
+        // Write back buffered pages and read the file with parallel positional reads
+        file_page_buffer_->FlushFile(path);
+        return snapshot::ReadFile(*file_page_buffer_->GetFileSystem(), path, config_->maximum_threads);
+    } catch (std::exception& e) {
+        return arrow::Status::IOError(e.what());
+    }
 }
 
 /// Copy a file to a path
 arrow::Status WebDB::CopyFileToPath(std::string_view path, std::string_view out) {
-    auto& fs = filesystem();
-    auto src = fs.OpenFile(std::string{path}, duckdb::FileFlags::FILE_FLAGS_READ);
-    auto dst = fs.OpenFile(std::string{path},
-                           duckdb::FileFlags::FILE_FLAGS_WRITE | duckdb::FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+    try {
+        auto& fs = filesystem();
+        auto src = fs.OpenFile(std::string{path}, duckdb::FileFlags::FILE_FLAGS_READ);
+        auto dst = fs.OpenFile(std::string{out},
+                               duckdb::FileFlags::FILE_FLAGS_WRITE | duckdb::FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+
+        auto size = static_cast<uint64_t>(fs.GetFileSize(*src));
+        auto buffer_size = snapshot::DEFAULT_SNAPSHOT_CHUNK_SIZE;
+        std::unique_ptr<char[]> buffer{new char[buffer_size]};
+        for (uint64_t offset = 0; offset < size; offset += buffer_size) {
+            auto n = std::min<uint64_t>(buffer_size, size - offset);
+            fs.Read(*src, buffer.get(), n, offset);
+            fs.Write(*dst, buffer.get(), n, offset);
+        }
+        fs.FileSync(*dst);
+    } catch (std::exception& e) {
+        return arrow::Status::IOError(e.what());
+    }
+    return arrow::Status::OK();
+}
+
+/// Copy an in-memory database into a checkpointed database image
+arrow::Result<std::shared_ptr<arrow::Buffer>> WebDB::ExportInMemoryDatabase() {
+    static std::atomic<uint64_t> NEXT_SNAPSHOT_ID = 0;
+    auto snapshot_name = "duckdb_snapshot_" + std::to_string(reinterpret_cast<uintptr_t>(this)) + "_" +
+                         std::to_string(NEXT_SNAPSHOT_ID++) + ".db";
 
-    auto buffer_size = 16 * 1024;
-    std::unique_ptr<char[]> buffer{new char[buffer_size]};
-    while (true) {
-        auto buffered = fs.Read(*src, buffer.get(), buffer_size);
-        if (buffered == 0) break;
-        while (buffered > 0) {
-            auto written = fs.Write(*dst, buffer.get(), buffered);
-            assert(written <= buffered);
-            buffered -= written;
+    // Stage the database in a scratch buffer or, without web filesystem, in a temporary file
+    std::string staging_path;
+    if (io::WebFileSystem::Get()) {
+        staging_path = std::string{io::WebFileSystem::SCRATCH_PREFIX} + snapshot_name;
+    } else {
+        staging_path = (std::filesystem::temp_directory_path() / snapshot_name).string();
+    }
+    auto wal_path = staging_path + ".wal";
+    auto& fs = *file_page_buffer_->GetFileSystem();
+    auto cleanup = sg::make_scope_guard([&]() noexcept {
+        try {
+            for (auto& path : {staging_path, wal_path}) {
+                file_page_buffer_->TryDropFile(path);
+                if (fs.FileExists(path)) fs.RemoveFile(path);
+            }
+        } catch (...) {
         }
+    });
+
+    // Copy the catalog and checkpoint the staging database
+    {
+        duckdb::DBConfig db_config;
+        db_config.file_system = std::make_unique<io::BufferedFileSystem>(file_page_buffer_);
+        db_config.maximum_threads = config_->maximum_threads;
+        db_config.access_mode = AccessMode::READ_WRITE;
+        duckdb::DuckDB staging{staging_path, &db_config};
+        if (parquet_extension_loaded_.load()) staging.LoadExtension<duckdb::ParquetExtension>();
+        duckdb::Connection src{*database_};
+        duckdb::Connection dst{staging};
+        ARROW_RETURN_NOT_OK(CopyCatalog(src, dst));
+        auto checkpoint = dst.Query("CHECKPOINT");
+        if (!checkpoint->success) return arrow::Status{arrow::StatusCode::ExecutionError, move(checkpoint->error)};
     }
-    fs.FileSync(*dst);
+    file_page_buffer_->FlushFile(staging_path);
+    return snapshot::ReadFile(fs, staging_path, config_->maximum_threads);
+}
 
+/// Export a snapshot of the database
+arrow::Result<std::shared_ptr<arrow::Buffer>> WebDB::ExportSnapshot(std::string_view options_json) {
+    rapidjson::Document options_doc;
+    options_doc.Parse(options_json.begin(), options_json.size());
+    snapshot::SnapshotOptions options;
+    ARROW_RETURN_NOT_OK(options.ReadFrom(options_doc));
+
+    std::shared_ptr<arrow::Buffer> image;
+    try {
+        bool in_memory = config_->path == ":memory:" || config_->path == "";
+        if (in_memory) {
+            ARROW_ASSIGN_OR_RAISE(image, ExportInMemoryDatabase());
+        } else {
+            // Checkpoint writable databases so that the database file is self-contained
+            if (config_->access_mode == WebDBAccessMode::READ_WRITE) {
+                duckdb::Connection conn{*database_};
+                auto checkpoint = conn.Query("CHECKPOINT");
+                if (!checkpoint->success)
+                    return arrow::Status{arrow::StatusCode::ExecutionError, move(checkpoint->error)};
+            }
+            ARROW_ASSIGN_OR_RAISE(image, CopyFileToBuffer(config_->path));
+        }
+    } catch (std::exception& e) {
+        return arrow::Status{arrow::StatusCode::ExecutionError, e.what()};
+    }
+
+    if (options.compression == snapshot::SnapshotCompression::NONE) return image;
+    return snapshot::Compress({reinterpret_cast<const char*>(image->data()), static_cast<size_t>(image->size())},
+                              options, config_->maximum_threads);
+}
+
+/// Open a database snapshot as buffered file
+arrow::Status WebDB::OpenSnapshot(std::string_view file_name, std::unique_ptr<char[]> buffer, size_t buffer_length,
+                                  std::string_view args_json) {
+    auto config = WebDBConfig::ReadFrom(args_json);
+    config.path = file_name;
+
+    // Decompress the snapshot (if necessary)
+    if (snapshot::IsCompressed({buffer.get(), buffer_length})) {
+        ARROW_ASSIGN_OR_RAISE(auto image,
+                              snapshot::Decompress({buffer.get(), buffer_length}, config.maximum_threads));
+        buffer = std::move(image.data);
+        buffer_length = image.size;
+    }
+
+    // Validate the config before the current database is touched.
+    // Only a database of the same file has to be closed to release it, it is recovered if the snapshot fails.
+    ARROW_RETURN_NOT_OK(ResolveAccessMode(config).status());
+    auto previous = *config_;
+    bool replaces_database = database_ && previous.path == config.path;
+    if (replaces_database) CloseDatabase();
+    auto recover = sg::make_scope_guard([&]() noexcept {
+        if (replaces_database) RecoverDatabase(previous);
+    });
+    file_warmer_->CancelFile(file_name);
+    if (!file_page_buffer_->TryDropFile(file_name)) {
+        return arrow::Status::Invalid("File is already registered and is still buffered");
+    }
+    pinned_web_files_.erase(file_name);
+
+    if (auto web_fs = io::WebFileSystem::Get()) {
+        // Serve the database straight from the buffer
+        io::WebFileSystem::DataBuffer data{std::move(buffer), buffer_length};
+        ARROW_ASSIGN_OR_RAISE(auto file_hdl, web_fs->RegisterFileBuffer(file_name, std::move(data)));
+        pinned_web_files_.insert({file_hdl->GetName(), std::move(file_hdl)});
+    } else {
+        // Without web filesystem, write the database file
+        ARROW_RETURN_NOT_OK(
+            snapshot::WriteFile(*file_page_buffer_->GetFileSystem(), file_name, {buffer.get(), buffer_length}));
+    }
+    ARROW_RETURN_NOT_OK(OpenDatabase(config));
+    recover.dismiss();
     return arrow::Status::OK();
 }
 
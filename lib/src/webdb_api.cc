@@ -1,8 +1,10 @@
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 
 #include "arrow/buffer.h"
 #include "arrow/status.h"
+#include "duckdb/web/arrow_stream_buffer.h"
 #include "duckdb/web/utils/wasm_response.h"
 #include "duckdb/web/webdb.h"
 
@@ -81,6 +83,36 @@ void duckdb_web_export_file_stats(WASMResponse* packed, const char* file_name) {
     GET_WEBDB(*packed);
     WASMResponseBuffer::Get().Store(*packed, webdb.ExportFileStatistics(file_name));
 }
+/// Warm up a file
+void duckdb_web_warm_file(WASMResponse* packed, const char* path, const char* target, int32_t priority) {
+    GET_WEBDB(*packed);
+    WASMResponseBuffer::Get().Store(*packed, webdb.WarmFile(path, target, priority));
+}
+/// Get the progress of a warm-up
+void duckdb_web_get_warm_up_progress(WASMResponse* packed, size_t warm_up_id) {
+    GET_WEBDB(*packed);
+    WASMResponseBuffer::Get().Store(*packed, webdb.GetWarmUpProgress(warm_up_id));
+}
+/// Cancel a warm-up
+void duckdb_web_cancel_warm_up(WASMResponse* packed, size_t warm_up_id) {
+    GET_WEBDB(*packed);
+    WASMResponseBuffer::Get().Store(*packed, webdb.CancelWarmUp(warm_up_id));
+}
+/// Get the memory budget and usage
+void duckdb_web_get_memory_info(WASMResponse* packed) {
+    GET_WEBDB(*packed);
+    WASMResponseBuffer::Get().Store(*packed, webdb.GetMemoryInfo());
+}
+/// Release memory
+void duckdb_web_reclaim_memory(WASMResponse* packed, double bytes) {
+    GET_WEBDB(*packed);
+    auto released = webdb.ReclaimMemory(static_cast<size_t>(std::max(0.0, bytes)));
+    if (!released.ok()) {
+        WASMResponseBuffer::Get().Store(*packed, released.status());
+        return;
+    }
+    WASMResponseBuffer::Get().Store(*packed, arrow::Result<double>(static_cast<double>(*released)));
+}
 /// Drop a file
 void duckdb_web_fs_drop_file(WASMResponse* packed, const char* file_name) {
     GET_WEBDB(*packed);
@@ -120,6 +152,13 @@ void duckdb_web_fs_register_file_url(WASMResponse* packed, const char* file_name
                      file_name, file_url,
                      ((file_size == -1) ? std::nullopt : std::optional<uint64_t>(static_cast<uint64_t>(file_size)))));
 }
+/// Register a batch of file urls
+void duckdb_web_fs_register_file_urls(WASMResponse* packed, const char* batch, uint32_t batch_length,
+                                      bool defer_handles) {
+    GET_WEBDB(*packed);
+    WASMResponseBuffer::Get().Store(*packed,
+                                    webdb.RegisterFileURLs(nonstd::span{batch, batch_length}, defer_handles));
+}
 /// Register a file buffer
 void duckdb_web_fs_register_file_buffer(WASMResponse* packed, const char* file_name, char* data, uint32_t data_length) {
     GET_WEBDB(*packed);
@@ -137,6 +176,18 @@ void duckdb_web_copy_file_to_path(WASMResponse* packed, const char* path, const
     GET_WEBDB(*packed);
     WASMResponseBuffer::Get().Store(*packed, webdb.CopyFileToPath(path, out));
 }
+/// Export a database snapshot
+void duckdb_web_export_snapshot(WASMResponse* packed, const char* options) {
+    GET_WEBDB(*packed);
+    WASMResponseBuffer::Get().Store(*packed, webdb.ExportSnapshot(options));
+}
+/// Open a database snapshot
+void duckdb_web_open_snapshot(WASMResponse* packed, const char* file_name, char* data, uint32_t data_length,
+                              const char* args) {
+    GET_WEBDB(*packed);
+    auto data_ptr = std::unique_ptr<char[]>(data);
+    WASMResponseBuffer::Get().Store(*packed, webdb.OpenSnapshot(file_name, std::move(data_ptr), data_length, args));
+}
 /// Get the duckdb version
 void duckdb_web_get_version(WASMResponse* packed) {
     GET_WEBDB(*packed);
@@ -153,6 +204,18 @@ void duckdb_web_tokenize(WASMResponse* packed, const char* query) {
     auto tokens = webdb.Tokenize(query);
     WASMResponseBuffer::Get().Store(*packed, arrow::Result(std::move(tokens)));
 }
+/// Tokenize a query and return the packed tokens
+void duckdb_web_tokenize_binary(WASMResponse* packed, const char* query) {
+    GET_WEBDB(*packed);
+    WASMResponseBuffer::Get().Store(*packed, arrow::Result(webdb.TokenizeBinary(query)));
+}
+/// Apply an edit to the last tokenized query and return the packed token update
+void duckdb_web_tokenize_edit(WASMResponse* packed, double offset, double removed, const char* inserted) {
+    GET_WEBDB(*packed);
+    auto update = webdb.RetokenizeBinary(static_cast<size_t>(std::max(0.0, offset)),
+                                         static_cast<size_t>(std::max(0.0, removed)), inserted);
+    WASMResponseBuffer::Get().Store(*packed, std::move(update));
+}
 /// Prepare a query statement
 void duckdb_web_prepared_create(WASMResponse* packed, ConnectionHdl connHdl, const char* script) {
     auto c = reinterpret_cast<WebDB::Connection*>(connHdl);
@@ -183,6 +246,42 @@ void duckdb_web_query_run(WASMResponse* packed, ConnectionHdl connHdl, const cha
     auto r = c->RunQuery(script);
     WASMResponseBuffer::Get().Store(*packed, std::move(r));
 }
+/// Run all statements of a script
+void duckdb_web_query_run_batch(WASMResponse* packed, ConnectionHdl connHdl, const char* script, bool stop_on_error) {
+    auto c = reinterpret_cast<WebDB::Connection*>(connHdl);
+    auto r = c->RunBatch(script, stop_on_error);
+    WASMResponseBuffer::Get().Store(*packed, std::move(r));
+}
+/// Run a query and materialize its result into a cursor
+void duckdb_web_cursor_open(WASMResponse* packed, ConnectionHdl connHdl, const char* script) {
+    auto c = reinterpret_cast<WebDB::Connection*>(connHdl);
+    auto r = c->OpenCursor(script);
+    WASMResponseBuffer::Get().Store(*packed, std::move(r));
+}
+/// Get the number of rows of a cursor
+void duckdb_web_cursor_row_count(WASMResponse* packed, ConnectionHdl connHdl, size_t cursor_id) {
+    auto c = reinterpret_cast<WebDB::Connection*>(connHdl);
+    auto r = c->GetCursorRowCount(cursor_id);
+    if (!r.ok()) {
+        WASMResponseBuffer::Get().Store(*packed, r.status());
+        return;
+    }
+    WASMResponseBuffer::Get().Store(*packed, arrow::Result<double>(static_cast<double>(*r)));
+}
+/// Fetch rows of a cursor
+void duckdb_web_cursor_fetch_rows(WASMResponse* packed, ConnectionHdl connHdl, size_t cursor_id, double offset,
+                                  double count) {
+    auto c = reinterpret_cast<WebDB::Connection*>(connHdl);
+    auto r = c->FetchRows(cursor_id, static_cast<uint64_t>(std::max(0.0, offset)),
+                          static_cast<uint64_t>(std::max(0.0, count)));
+    WASMResponseBuffer::Get().Store(*packed, std::move(r));
+}
+/// Close a cursor
+void duckdb_web_cursor_close(WASMResponse* packed, ConnectionHdl connHdl, size_t cursor_id) {
+    auto c = reinterpret_cast<WebDB::Connection*>(connHdl);
+    auto r = c->CloseCursor(cursor_id);
+    WASMResponseBuffer::Get().Store(*packed, std::move(r));
+}
 /// Send a query
 void duckdb_web_query_send(WASMResponse* packed, ConnectionHdl connHdl, const char* script) {
     auto c = reinterpret_cast<WebDB::Connection*>(connHdl);
@@ -195,11 +294,12 @@ void duckdb_web_query_fetch_results(WASMResponse* packed, ConnectionHdl connHdl)
     auto r = c->FetchQueryResults();
     WASMResponseBuffer::Get().Store(*packed, std::move(r));
 }
-/// Insert arrow from an ipc stream
-void duckdb_web_insert_arrow_from_ipc_stream(WASMResponse* packed, ConnectionHdl connHdl, const uint8_t* buffer,
+/// Insert arrow from an ipc stream, takes ownership of the buffer
+void duckdb_web_insert_arrow_from_ipc_stream(WASMResponse* packed, ConnectionHdl connHdl, char* buffer,
                                              size_t buffer_length, const char* options) {
     auto c = reinterpret_cast<WebDB::Connection*>(connHdl);
-    auto r = c->InsertArrowFromIPCStream(nonstd::span{buffer, buffer_length}, std::string_view{options});
+    auto chunk = std::make_shared<ArrowOwnedBuffer>(std::unique_ptr<char[]>(buffer), buffer_length);
+    auto r = c->InsertArrowFromIPCStream(std::move(chunk), std::string_view{options});
     WASMResponseBuffer::Get().Store(*packed, std::move(r));
 }
 /// Insert csv from a file
@@ -216,6 +316,18 @@ void duckdb_web_insert_json_from_path(WASMResponse* packed, ConnectionHdl connHd
     auto r = c->InsertJSONFromPath(std::string_view{path}, std::string_view{options});
     WASMResponseBuffer::Get().Store(*packed, std::move(r));
 }
+/// Create an incremental aggregate view
+void duckdb_web_incremental_view_create(WASMResponse* packed, ConnectionHdl connHdl, const char* definition) {
+    auto c = reinterpret_cast<WebDB::Connection*>(connHdl);
+    auto r = c->CreateIncrementalView(std::string_view{definition});
+    WASMResponseBuffer::Get().Store(*packed, std::move(r));
+}
+/// Drop an incremental aggregate view
+void duckdb_web_incremental_view_drop(WASMResponse* packed, ConnectionHdl connHdl, const char* name) {
+    auto c = reinterpret_cast<WebDB::Connection*>(connHdl);
+    auto r = c->DropIncrementalView(std::string_view{name});
+    WASMResponseBuffer::Get().Store(*packed, std::move(r));
+}
 
 static void RaiseExtensionNotLoaded(WASMResponse* packed, std::string_view ext) {
     WASMResponseBuffer::Get().Store(
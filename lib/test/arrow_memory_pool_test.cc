@@ -0,0 +1,110 @@
+#include "duckdb/web/arrow_memory_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace duckdb::web;
+
+namespace {
+
+TEST(ArrowMemoryPool, ReuseBlocks) {
+    ArrowMemoryPool pool;
+    uint8_t* a = nullptr;
+    uint8_t* b = nullptr;
+    ASSERT_TRUE(pool.Allocate(100, &a).ok());
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(a) % 64, 0);
+    ASSERT_EQ(pool.bytes_allocated(), 100);
+    pool.Free(a, 100);
+    ASSERT_EQ(pool.bytes_allocated(), 0);
+
+    // Blocks of the same size class are reused
+    ASSERT_TRUE(pool.Allocate(120, &b).ok());
+    ASSERT_EQ(a, b);
+    pool.Free(b, 120);
+
+    auto stats = pool.GetStatistics();
+    ASSERT_EQ(stats.allocations, 2);
+    ASSERT_EQ(stats.cache_hits, 1);
+    ASSERT_EQ(stats.bytes_peak, 120);
+    ASSERT_EQ(stats.bytes_reserved, ArrowMemoryPool::SLAB_SIZE);
+    pool.ReleaseUnused();
+    ASSERT_EQ(pool.GetMemoryUsage(), 0);
+}
+
+TEST(ArrowMemoryPool, Reallocate) {
+    ArrowMemoryPool pool;
+    uint8_t* data = nullptr;
+    ASSERT_TRUE(pool.Allocate(0, &data).ok());
+    int64_t size = 0;
+    for (int64_t next = 1; next <= (1 << 20); next *= 2) {
+        ASSERT_TRUE(pool.Reallocate(size, next, &data).ok());
+        std::memset(data + size, static_cast<int>(next & 0xFF), next - size);
+        size = next;
+    }
+    ASSERT_EQ(data[0], 1);
+    ASSERT_EQ(data[3], 4);
+    ASSERT_EQ(data[size - 1], 0);
+    ASSERT_EQ(pool.bytes_allocated(), size);
+    ASSERT_TRUE(pool.Reallocate(size, 10, &data).ok());
+    ASSERT_EQ(data[0], 1);
+    pool.Free(data, 10);
+    ASSERT_EQ(pool.bytes_allocated(), 0);
+    ASSERT_GE(pool.max_memory(), 1 << 20);
+}
+
+TEST(ArrowMemoryPool, ArenaRelease) {
+    ArrowMemoryPool pool;
+    std::vector<uint8_t*> blocks;
+    {
+        ArrowMemoryPool::Arena outer{pool};
+        {
+            ArrowMemoryPool::Arena inner{pool};
+            for (size_t i = 0; i < 32; ++i) {
+                uint8_t* block = nullptr;
+                ASSERT_TRUE(pool.Allocate(ArrowMemoryPool::MAX_BLOCK_SIZE, &block).ok());
+                blocks.push_back(block);
+            }
+            for (auto* block : blocks) {
+                pool.Free(block, ArrowMemoryPool::MAX_BLOCK_SIZE);
+            }
+        }
+        // Nested arenas keep their slabs
+        ASSERT_EQ(pool.GetMemoryUsage(), 8 * ArrowMemoryPool::SLAB_SIZE);
+    }
+    // The outermost arena releases all but the retained slabs
+    ASSERT_EQ(pool.GetMemoryUsage(), ArrowMemoryPool::RETAINED_SLAB_BYTES);
+    ASSERT_EQ(pool.ReclaimMemory(1), ArrowMemoryPool::RETAINED_SLAB_BYTES);
+}
+
+TEST(ArrowMemoryPool, LiveBlocksSurviveArena) {
+    ArrowMemoryPool pool;
+    uint8_t* block = nullptr;
+    {
+        ArrowMemoryPool::Arena arena{pool};
+        ASSERT_TRUE(pool.Allocate(1000, &block).ok());
+        std::memset(block, 42, 1000);
+    }
+    pool.ReleaseUnused();
+    ASSERT_EQ(pool.GetMemoryUsage(), ArrowMemoryPool::SLAB_SIZE);
+    ASSERT_EQ(block[999], 42);
+    pool.Free(block, 1000);
+    pool.ReleaseUnused();
+    ASSERT_EQ(pool.GetMemoryUsage(), 0);
+}
+
+TEST(ArrowMemoryPool, LargeAllocations) {
+    ArrowMemoryPool pool;
+    uint8_t* data = nullptr;
+    auto size = 2 * ArrowMemoryPool::SLAB_SIZE;
+    ASSERT_TRUE(pool.Allocate(size, &data).ok());
+    ASSERT_EQ(pool.GetMemoryUsage(), size);
+    ASSERT_TRUE(pool.Reallocate(size, 2 * size, &data).ok());
+    ASSERT_EQ(pool.GetMemoryUsage(), 2 * size);
+    pool.Free(data, 2 * size);
+    ASSERT_EQ(pool.GetMemoryUsage(), 0);
+}
+
+}  // namespace
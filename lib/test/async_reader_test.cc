@@ -0,0 +1,89 @@
+#include "duckdb/web/io/async_reader.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace duckdb::web;
+namespace fs = std::filesystem;
+
+namespace {
+
+std::filesystem::path CreateTestFile(const std::vector<char>& data) {
+    static uint64_t NEXT_TEST_FILE = 0;
+
+    auto cwd = fs::current_path();
+    auto tmp = cwd / ".tmp";
+    auto file = tmp / (std::string("test_async_") + std::to_string(NEXT_TEST_FILE++));
+    if (!fs::is_directory(tmp) || !fs::exists(tmp)) fs::create_directory(tmp);
+    if (fs::exists(file)) fs::remove(file);
+    std::ofstream output(file, std::ios::binary);
+    output.write(data.data(), data.size());
+    return file;
+}
+
+/// Read random pages with a reader and compare them with the file
+void CheckRandomReads(io::AsyncReader& reader) {
+    std::vector<char> data(1 << 20);
+    std::mt19937 rng{42};
+    for (auto& c : data) c = static_cast<char>(rng());
+    auto path = CreateTestFile(data);
+    auto file = io::AsyncFile::Open(path.c_str());
+    ASSERT_NE(file, nullptr);
+
+    // More requests than the queue depth, the last one crosses the end of the file
+    constexpr size_t REQUEST_COUNT = 300;
+    constexpr size_t REQUEST_SIZE = 4096;
+    std::vector<io::AsyncReader::Request> requests;
+    std::vector<std::vector<char>> buffers(REQUEST_COUNT, std::vector<char>(REQUEST_SIZE));
+    for (size_t i = 0; i < REQUEST_COUNT; ++i) {
+        auto offset = (i + 1 == REQUEST_COUNT) ? data.size() - 100 : rng() % (data.size() - REQUEST_SIZE);
+        requests.push_back({file->GetFD(), buffers[i].data(), REQUEST_SIZE, offset});
+    }
+    std::vector<int64_t> results(REQUEST_COUNT, -1);
+    reader.Read(nonstd::span<const io::AsyncReader::Request>{requests.data(), requests.size()},
+                [&](size_t request_id, int64_t result) { results[request_id] = result; });
+
+    for (size_t i = 0; i < REQUEST_COUNT; ++i) {
+        auto expected = std::min<uint64_t>(REQUEST_SIZE, data.size() - requests[i].offset);
+        ASSERT_EQ(results[i], static_cast<int64_t>(expected)) << "request=" << i;
+        ASSERT_EQ(std::memcmp(buffers[i].data(), data.data() + requests[i].offset, expected), 0) << "request=" << i;
+    }
+}
+
+// NOLINTNEXTLINE
+TEST(AsyncReaderTest, PRead) {
+    auto reader = io::AsyncReader::CreatePRead();
+    ASSERT_NE(reader, nullptr);
+    CheckRandomReads(*reader);
+}
+
+// NOLINTNEXTLINE
+TEST(AsyncReaderTest, IOUring) {
+    auto reader = io::AsyncReader::CreateIOUring(32);
+    // Kernels without io_uring use the pread fallback
+    if (!reader) return;
+    ASSERT_LE(32, reader->GetQueueDepth());
+    CheckRandomReads(*reader);
+}
+
+// NOLINTNEXTLINE
+TEST(AsyncReaderTest, ReadError) {
+    auto reader = io::AsyncReader::Create(8);
+    ASSERT_NE(reader, nullptr);
+    char buffer[16];
+    std::vector<io::AsyncReader::Request> requests{{-1, buffer, sizeof(buffer), 0}};
+    int64_t result = 0;
+    reader->Read(nonstd::span<const io::AsyncReader::Request>{requests.data(), requests.size()},
+                 [&](size_t, int64_t r) { result = r; });
+    ASSERT_LT(result, 0);
+}
+
+}  // namespace
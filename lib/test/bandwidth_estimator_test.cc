@@ -0,0 +1,103 @@
+#include "duckdb/web/io/bandwidth_estimator.h"
+
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace duckdb::web::io;
+
+namespace {
+
+TEST(BandwidthEstimatorTest, ResolveOrigin) {
+    ASSERT_EQ(BandwidthEstimator::ResolveOrigin("https://example.com/data/a.parquet"), "https://example.com");
+    ASSERT_EQ(BandwidthEstimator::ResolveOrigin("https://example.com:8080?x=1"), "https://example.com:8080");
+    ASSERT_EQ(BandwidthEstimator::ResolveOrigin("http://example.com"), "http://example.com");
+    ASSERT_EQ(BandwidthEstimator::ResolveOrigin("/tmp/a.parquet"), "file");
+
+    BandwidthEstimator estimator;
+    ASSERT_EQ(estimator.Find("file"), nullptr);
+    auto& a = estimator.Resolve("file");
+    auto& b = estimator.Resolve("file");
+    ASSERT_EQ(&a, &b);
+    ASSERT_EQ(estimator.Find("file"), &a);
+}
+
+TEST(BandwidthEstimatorTest, Estimate) {
+    OriginEstimator estimator{"https://example.com"};
+    ASSERT_FALSE(estimator.Get().IsReliable());
+
+    // 50ms latency and 10 MB/s
+    constexpr double LATENCY = 0.05;
+    constexpr double BANDWIDTH = 10 << 20;
+    for (size_t i = 0; i < 10; ++i) {
+        estimator.Record(4 << 10, LATENCY);
+        estimator.Record(4 << 20, LATENCY + (4 << 20) / BANDWIDTH);
+    }
+    auto estimate = estimator.Get();
+    ASSERT_TRUE(estimate.IsReliable());
+    ASSERT_NEAR(estimate.latency, LATENCY, 0.001);
+    ASSERT_NEAR(estimate.bandwidth, BANDWIDTH, BANDWIDTH * 0.01);
+    ASSERT_NEAR(estimate.GetBandwidthDelayProduct(), 512 << 10, 8 << 10);
+
+    // The read heads amortize the latency
+    auto policy = estimate.GetReadAheadPolicy();
+    ASSERT_EQ(policy.maximum, estimate.GetBandwidthDelayProduct() * 4);
+    ASSERT_EQ(policy.base, estimate.GetBandwidthDelayProduct() / 4);
+}
+
+TEST(BandwidthEstimatorTest, PolicyBounds) {
+    ReadAheadPolicy defaults;
+    ASSERT_EQ(OriginEstimator::Estimate{}.GetReadAheadPolicy().maximum, defaults.maximum);
+
+    // A fast local origin gets small read heads
+    OriginEstimator local{"file"};
+    for (size_t i = 0; i < 4; ++i) {
+        local.Record(4 << 10, 0.000001);
+        local.Record(1 << 20, 0.0005);
+    }
+    auto local_policy = local.Get().GetReadAheadPolicy();
+    ASSERT_EQ(local_policy.maximum, READAHEAD_BASE);
+    ASSERT_LE(local_policy.base, local_policy.maximum);
+
+    // A slow distant origin is capped
+    OriginEstimator remote{"https://example.com"};
+    for (size_t i = 0; i < 4; ++i) {
+        remote.Record(4 << 10, 1.0);
+        remote.Record(64 << 20, 2.0);
+    }
+    auto remote_policy = remote.Get().GetReadAheadPolicy();
+    ASSERT_EQ(remote_policy.maximum, READAHEAD_MAXIMUM);
+    ASSERT_EQ(remote_policy.base, 1 << 20);
+}
+
+TEST(BandwidthEstimatorTest, ReadAheadPolicy) {
+    constexpr size_t FILE_ID = 0;
+    std::vector<uint8_t> in(4 << 20);
+    std::iota(in.begin(), in.end(), 0);
+    std::vector<size_t> reads;
+    auto read = [&](auto* buffer, size_t bytes, duckdb::idx_t offset) -> size_t {
+        std::memcpy(buffer, in.data() + offset, bytes);
+        reads.push_back(bytes);
+        return bytes;
+    };
+
+    // Sequential reads accelerate up to the policy maximum
+    ReadAheadPolicy policy{64 << 10, 256 << 10};
+    ReadAheadBuffer buffer;
+    std::vector<uint8_t> out(in.size());
+    size_t offset = 0;
+    while (offset < in.size()) {
+        auto n = buffer.Read(FILE_ID, in.size(), out.data() + offset, 1024, offset, read, nullptr, policy);
+        ASSERT_GT(n, 0);
+        offset += n;
+    }
+    ASSERT_EQ(in, out);
+    ASSERT_GE(reads.size(), 3);
+    ASSERT_EQ(reads[1], 64 << 10);
+    for (auto n : reads) ASSERT_LE(n, 256 << 10);
+    ASSERT_EQ(reads[reads.size() - 2], 256 << 10);
+}
+
+}  // namespace
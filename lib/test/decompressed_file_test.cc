@@ -0,0 +1,188 @@
+#include "duckdb/web/io/decompressed_file.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "duckdb/web/io/file_page_buffer.h"
+#include "duckdb/web/io/ifstream.h"
+#include "duckdb/web/io/memory_filesystem.h"
+#include "duckdb/web/webdb.h"
+#include "miniz.hpp"
+#include "zstd.h"
+
+using namespace duckdb::web;
+namespace fs = std::filesystem;
+
+namespace {
+
+std::filesystem::path CreateTestFile(std::string_view suffix, const std::vector<char>& data) {
+    static uint64_t NEXT_TEST_FILE = 0;
+
+    auto cwd = fs::current_path();
+    auto tmp = cwd / ".tmp";
+    auto file = tmp / (std::string("test_decompressed_") + std::to_string(NEXT_TEST_FILE++) + std::string{suffix});
+    if (!fs::is_directory(tmp) || !fs::exists(tmp)) fs::create_directory(tmp);
+    if (fs::exists(file)) fs::remove(file);
+    std::ofstream output(file, std::ios::binary);
+    output.write(data.data(), data.size());
+    return file;
+}
+
+/// Generate compressible text
+std::vector<char> GenerateText(size_t n) {
+    static const char* WORDS[] = {"duckdb", "wasm", "page", "buffer", "gzip", "zstd", "frame", "window", "\n"};
+    std::mt19937 rng{42};
+    std::vector<char> data;
+    data.reserve(n);
+    while (data.size() < n) {
+        auto word = WORDS[rng() % (sizeof(WORDS) / sizeof(WORDS[0]))];
+        data.insert(data.end(), word, word + std::strlen(word));
+        data.push_back(' ');
+    }
+    data.resize(n);
+    return data;
+}
+
+/// Append a gzip member
+void AppendGzipMember(std::vector<char>& out, const char* data, size_t n) {
+    const uint8_t header[] = {0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF};
+    out.insert(out.end(), header, header + sizeof(header));
+    size_t deflated_size = 0;
+    auto* deflated = duckdb_miniz::tdefl_compress_mem_to_heap(data, n, &deflated_size, 128);
+    ASSERT_NE(deflated, nullptr);
+    out.insert(out.end(), static_cast<char*>(deflated), static_cast<char*>(deflated) + deflated_size);
+    duckdb_miniz::mz_free(deflated);
+    auto crc = static_cast<uint32_t>(duckdb_miniz::mz_crc32(0, reinterpret_cast<const uint8_t*>(data), n));
+    auto size = static_cast<uint32_t>(n);
+    for (size_t i = 0; i < 4; ++i) out.push_back(static_cast<char>((crc >> (8 * i)) & 0xFF));
+    for (size_t i = 0; i < 4; ++i) out.push_back(static_cast<char>((size >> (8 * i)) & 0xFF));
+}
+
+/// Compress data into gzip members of a given size
+std::vector<char> CompressGzip(const std::vector<char>& data, size_t member_size) {
+    std::vector<char> out;
+    for (size_t offset = 0; offset < data.size(); offset += member_size) {
+        AppendGzipMember(out, data.data() + offset, std::min(member_size, data.size() - offset));
+    }
+    return out;
+}
+
+/// Compress data into zstd frames of a given size
+std::vector<char> CompressZstd(const std::vector<char>& data, size_t frame_size) {
+    std::vector<char> out;
+    for (size_t offset = 0; offset < data.size(); offset += frame_size) {
+        auto n = std::min(frame_size, data.size() - offset);
+        auto prev = out.size();
+        out.resize(prev + duckdb_zstd::ZSTD_compressBound(n));
+        auto written = duckdb_zstd::ZSTD_compress(out.data() + prev, out.size() - prev, data.data() + offset, n, 1);
+        EXPECT_FALSE(duckdb_zstd::ZSTD_isError(written));
+        out.resize(prev + written);
+    }
+    return out;
+}
+
+/// Read a file through the page buffer at random offsets and sequentially
+void CheckPageBuffer(const fs::path& path, io::CompressionCodec codec, const std::vector<char>& expected) {
+    auto buffer = std::make_shared<io::FilePageBuffer>(duckdb::FileSystem::CreateLocal(), 16);
+    buffer->ConfigureDecompression(4);
+    auto file = buffer->OpenFile(path.c_str(), duckdb::FileFlags::FILE_FLAGS_READ, duckdb::FileLockType::NO_LOCK,
+                                 codec);
+    ASSERT_EQ(file->GetSize(), expected.size());
+
+    std::mt19937 rng{7};
+    std::vector<char> out;
+    for (size_t i = 0; i < 64; ++i) {
+        auto offset = rng() % expected.size();
+        auto n = std::min<size_t>(rng() % (64 << 10) + 1, expected.size() - offset);
+        out.resize(n);
+        ASSERT_EQ(file->Read(out.data(), n, offset), n);
+        ASSERT_EQ(std::memcmp(out.data(), expected.data() + offset, n), 0) << "offset=" << offset;
+    }
+
+    io::InputFileStream ifs{buffer, path.c_str(), codec};
+    std::string text{std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>()};
+    ASSERT_EQ(text.size(), expected.size());
+    ASSERT_EQ(std::memcmp(text.data(), expected.data(), text.size()), 0);
+}
+
+// NOLINTNEXTLINE
+TEST(DecompressedFileTest, ResolveCodec) {
+    using duckdb::FileCompressionType;
+    EXPECT_EQ(io::ResolveCompressionCodec("a.csv", FileCompressionType::AUTO_DETECT), io::CompressionCodec::NONE);
+    EXPECT_EQ(io::ResolveCompressionCodec("a.csv.gz", FileCompressionType::AUTO_DETECT), io::CompressionCodec::GZIP);
+    EXPECT_EQ(io::ResolveCompressionCodec("a.json.zst", FileCompressionType::AUTO_DETECT),
+              io::CompressionCodec::ZSTD);
+    EXPECT_EQ(io::ResolveCompressionCodec("a.csv.gz", FileCompressionType::UNCOMPRESSED),
+              io::CompressionCodec::NONE);
+    EXPECT_EQ(io::ResolveCompressionCodec("a.csv", FileCompressionType::GZIP), io::CompressionCodec::GZIP);
+}
+
+// NOLINTNEXTLINE
+TEST(DecompressedFileTest, GzipRandomAccess) {
+    // Multiple members and enough data for several checkpoints
+    auto data = GenerateText(11 << 20);
+    auto path = CreateTestFile(".gz", CompressGzip(data, 5 << 20));
+    CheckPageBuffer(path, io::CompressionCodec::GZIP, data);
+}
+
+// NOLINTNEXTLINE
+TEST(DecompressedFileTest, ZstdRandomAccess) {
+    auto data = GenerateText(5 << 20);
+    auto path = CreateTestFile(".zst", CompressZstd(data, 256 << 10));
+    CheckPageBuffer(path, io::CompressionCodec::ZSTD, data);
+}
+
+// NOLINTNEXTLINE
+TEST(DecompressedFileTest, ZstdLargeFrame) {
+    // A single frame beyond the frame cache is streamed
+    auto data = GenerateText(12 << 20);
+    auto path = CreateTestFile(".zst", CompressZstd(data, data.size()));
+    CheckPageBuffer(path, io::CompressionCodec::ZSTD, data);
+}
+
+// NOLINTNEXTLINE
+TEST(DecompressedFileTest, CorruptGzip) {
+    std::vector<char> garbage(1000, 'x');
+    auto path = CreateTestFile(".gz", garbage);
+    auto buffer = std::make_shared<io::FilePageBuffer>(duckdb::FileSystem::CreateLocal());
+    EXPECT_THROW(buffer->OpenFile(path.c_str(), duckdb::FileFlags::FILE_FLAGS_READ, duckdb::FileLockType::NO_LOCK,
+                                  io::CompressionCodec::GZIP),
+                 duckdb::IOException);
+    EXPECT_THROW(buffer->OpenFile(path.c_str(), duckdb::FileFlags::FILE_FLAGS_WRITE, duckdb::FileLockType::NO_LOCK,
+                                  io::CompressionCodec::GZIP),
+                 duckdb::IOException);
+}
+
+// NOLINTNEXTLINE
+TEST(DecompressedFileTest, InsertJSONFromGzip) {
+    constexpr const char* path = "TEST.json.gz";
+    std::string json = "[";
+    for (size_t i = 0; i < 1000; ++i) {
+        json += (i == 0 ? "" : ",") + std::string{"{\"a\":"} + std::to_string(i) + "}";
+    }
+    json += "]";
+    std::vector<char> input{json.begin(), json.end()};
+    auto memory_filesystem = std::make_unique<io::MemoryFileSystem>();
+    ASSERT_TRUE(memory_filesystem->RegisterFileBuffer(path, CompressGzip(input, 1 << 20)).ok());
+
+    auto db = std::make_shared<WebDB>(NATIVE, std::move(memory_filesystem));
+    WebDB::Connection conn{*db};
+    auto maybe_ok = conn.InsertJSONFromPath(path, R"JSON({"name": "foo"})JSON");
+    ASSERT_TRUE(maybe_ok.ok()) << maybe_ok.message();
+
+    auto result = conn.connection().Query("SELECT count(*)::INTEGER, sum(a)::INTEGER FROM foo");
+    ASSERT_TRUE(result->success) << result->error;
+    ASSERT_EQ(result->GetValue(0, 0).GetValue<int32_t>(), 1000);
+    ASSERT_EQ(result->GetValue(1, 0).GetValue<int32_t>(), 999 * 1000 / 2);
+}
+
+}  // namespace
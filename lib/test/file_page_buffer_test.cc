@@ -16,6 +16,7 @@
 #include <thread>
 #include <vector>
 
+#include "duckdb/web/io/async_reader.h"
 #include "duckdb/web/io/web_filesystem.h"
 #include "duckdb/web/test/config.h"
 
@@ -633,4 +634,83 @@ TEST(FilePageBufferTest, BlockStatistics) {
     }
 }
 
+// NOLINTNEXTLINE
+TEST(FilePageBufferTest, MemoryMapped) {
+    auto buffer = std::make_shared<TestableFilePageBuffer>();
+    buffer->ConfigureMemoryMapping(true);
+    auto page_size = buffer->GetPageSize();
+    auto file_path = CreateTestFile();
+    std::vector<char> expected(3 * page_size + 100);
+    for (size_t i = 0; i < expected.size(); ++i) expected[i] = static_cast<char>(i * 7);
+    {
+        std::ofstream output(file_path, std::ios::binary);
+        output.write(expected.data(), expected.size());
+    }
+
+    // Read-only files are served from the mapping without frames
+    auto file = buffer->OpenFile(file_path.c_str(), duckdb::FileFlags::FILE_FLAGS_READ);
+    ASSERT_EQ(file->GetSize(), expected.size());
+    {
+        auto page = file->FixPage(3, false);
+        ASSERT_TRUE(page.IsMapped());
+        ASSERT_EQ(page.GetData().size(), 100);
+        ASSERT_EQ(std::memcmp(page.GetData().data(), expected.data() + 3 * page_size, 100), 0);
+    }
+    {
+        auto range = file->FixRange(10, 2 * page_size);
+        ASSERT_TRUE(range.IsMapped());
+        ASSERT_EQ(range.GetData().size(), 2 * page_size);
+        ASSERT_EQ(std::memcmp(range.GetData().data(), expected.data() + 10, 2 * page_size), 0);
+    }
+    std::vector<char> values(expected.size());
+    ASSERT_EQ(file->Read(values.data(), values.size(), 0), expected.size());
+    ASSERT_EQ(values, expected);
+    ASSERT_TRUE(buffer->GetFrames().empty());
+
+    // Reopening the file as writeable drops the mapping
+    auto writer = buffer->OpenFile(file_path.c_str(),
+                                   duckdb::FileFlags::FILE_FLAGS_READ | duckdb::FileFlags::FILE_FLAGS_WRITE);
+    ASSERT_FALSE(file->FixRange(0, page_size));
+    auto page = file->FixPage(0, false);
+    ASSERT_FALSE(page.IsMapped());
+    ASSERT_EQ(std::memcmp(page.GetData().data(), expected.data(), page_size), 0);
+}
+
+// NOLINTNEXTLINE
+TEST(FilePageBufferTest, AsyncLoadPages) {
+    auto buffer = std::make_shared<TestableFilePageBuffer>(duckdb::FileSystem::CreateLocal(), 16);
+    buffer->ConfigureAsyncReads(io::AsyncReader::Create(8));
+    auto page_size = buffer->GetPageSize();
+    auto file_path = CreateTestFile();
+    std::vector<char> expected(20 * page_size + 100);
+    for (size_t i = 0; i < expected.size(); ++i) expected[i] = static_cast<char>(i * 13);
+    {
+        std::ofstream output(file_path, std::ios::binary);
+        output.write(expected.data(), expected.size());
+    }
+    auto file = buffer->OpenFile(file_path.c_str(), duckdb::FileFlags::FILE_FLAGS_READ);
+
+    // The run stops at the first buffered page
+    file->FixPage(5, false);
+    file->LoadPages(2, 10);
+    ASSERT_EQ(buffer->GetFrames().size(), 4);
+
+    // A run is capped at half of the buffer
+    file->LoadPages(6, 100);
+    ASSERT_EQ(buffer->GetFrames().size(), 12);
+
+    // And at the end of the file
+    file->LoadPages(18, 100);
+    ASSERT_EQ(buffer->GetFrames().size(), 15);
+
+    // A read that spans many pages loads them in one batch
+    std::vector<char> values(expected.size());
+    size_t offset = 0;
+    while (offset < values.size()) {
+        offset += file->Read(values.data() + offset, values.size() - offset, offset);
+    }
+    ASSERT_EQ(values, expected);
+    ASSERT_LE(buffer->GetFrames().size(), 16);
+}
+
 }  // namespace
@@ -0,0 +1,152 @@
+#include "duckdb/web/io/file_warmer.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace duckdb::web;
+namespace fs = std::filesystem;
+
+namespace {
+
+struct TestableFilePageBuffer : public io::FilePageBuffer {
+    TestableFilePageBuffer(size_t page_capacity = 32, size_t page_size_bits = 14)
+        : io::FilePageBuffer(duckdb::FileSystem::CreateLocal(), page_capacity, page_size_bits) {}
+
+    auto& GetFrames() { return frames; }
+};
+
+fs::path CreateTestFile(size_t size, std::string_view trailer = {}) {
+    static uint64_t NEXT_TEST_FILE = 0;
+
+    auto tmp = fs::current_path() / ".tmp";
+    auto file = tmp / (std::string("test_warmer_") + std::to_string(NEXT_TEST_FILE++));
+    if (!fs::is_directory(tmp) || !fs::exists(tmp)) fs::create_directory(tmp);
+    if (fs::exists(file)) fs::remove(file);
+    std::vector<char> data(size, 'x');
+    std::memcpy(data.data() + size - trailer.size(), trailer.data(), trailer.size());
+    std::ofstream output(file, std::ios::binary);
+    output.write(data.data(), data.size());
+    return file;
+}
+
+std::vector<uint64_t> SortedPages(TestableFilePageBuffer& buffer) {
+    auto pages = buffer.GetFIFOList();
+    std::sort(pages.begin(), pages.end());
+    return pages;
+}
+
+TEST(FileWarmerTest, ParseTarget) {
+    auto metadata = io::FileWarmer::ParseTarget("\"metadata\"");
+    ASSERT_TRUE(metadata.ok());
+    ASSERT_EQ(metadata->first, io::WarmUpMode::METADATA);
+    auto all = io::FileWarmer::ParseTarget("all");
+    ASSERT_TRUE(all.ok());
+    ASSERT_EQ(all->first, io::WarmUpMode::ALL);
+    auto ranges = io::FileWarmer::ParseTarget("[[0, 100], [4096, 10]]");
+    ASSERT_TRUE(ranges.ok());
+    ASSERT_EQ(ranges->first, io::WarmUpMode::RANGES);
+    ASSERT_EQ(ranges->second.size(), 2);
+    ASSERT_EQ(ranges->second[1].offset, 4096);
+    ASSERT_EQ(ranges->second[1].length, 10);
+
+    ASSERT_FALSE(io::FileWarmer::ParseTarget("\"footer\"").ok());
+    ASSERT_FALSE(io::FileWarmer::ParseTarget("[[0]]").ok());
+    ASSERT_FALSE(io::FileWarmer::ParseTarget("{").ok());
+}
+
+TEST(FileWarmerTest, Ranges) {
+    auto buffer = std::make_shared<TestableFilePageBuffer>();
+    auto page_size = buffer->GetPageSize();
+    auto path = CreateTestFile(20 * page_size);
+    io::FileWarmer warmer{buffer, false};
+
+    auto id = warmer.Enqueue(path.c_str(), io::WarmUpMode::RANGES, {{0, 3 * page_size}, {10 * page_size + 1, 10}});
+    auto progress = warmer.GetProgress(id);
+    ASSERT_TRUE(progress.has_value());
+    ASSERT_EQ(progress->state, io::WarmUpState::QUEUED);
+
+    progress = warmer.Wait(id);
+    ASSERT_TRUE(progress.has_value());
+    ASSERT_EQ(progress->state, io::WarmUpState::DONE);
+    ASSERT_EQ(progress->bytes_total, 4 * page_size);
+    ASSERT_EQ(progress->bytes_loaded, 4 * page_size);
+    ASSERT_EQ(SortedPages(*buffer), (std::vector<uint64_t>{0, 1, 2, 10}));
+}
+
+TEST(FileWarmerTest, ParquetMetadata) {
+    auto buffer = std::make_shared<TestableFilePageBuffer>();
+    auto page_size = buffer->GetPageSize();
+
+    // The footer spans the last two pages and the trailer
+    uint32_t footer_length = 2 * page_size;
+    std::string trailer(8, '\0');
+    std::memcpy(trailer.data(), &footer_length, sizeof(footer_length));
+    std::memcpy(trailer.data() + 4, "PAR1", 4);
+    auto path = CreateTestFile(20 * page_size, trailer);
+
+    io::FileWarmer warmer{buffer, false};
+    auto id = warmer.Enqueue(path.c_str(), io::WarmUpMode::METADATA);
+    auto progress = warmer.Wait(id);
+    ASSERT_EQ(progress->state, io::WarmUpState::DONE);
+    ASSERT_EQ(SortedPages(*buffer), (std::vector<uint64_t>{0, 17, 18, 19}));
+}
+
+TEST(FileWarmerTest, HalfCapacity) {
+    auto buffer = std::make_shared<TestableFilePageBuffer>(32);
+    auto page_size = buffer->GetPageSize();
+    auto path = CreateTestFile(40 * page_size);
+
+    io::FileWarmer warmer{buffer, false};
+    auto id = warmer.Enqueue(path.c_str(), io::WarmUpMode::ALL);
+    auto progress = warmer.Wait(id);
+    ASSERT_EQ(progress->state, io::WarmUpState::DONE);
+    ASSERT_EQ(progress->bytes_total, 16 * page_size);
+    ASSERT_EQ(buffer->GetFrames().size(), 16);
+}
+
+TEST(FileWarmerTest, PriorityAndCancel) {
+    auto buffer = std::make_shared<TestableFilePageBuffer>();
+    auto page_size = buffer->GetPageSize();
+    auto path = CreateTestFile(4 * page_size);
+
+    io::FileWarmer warmer{buffer, false};
+    auto low = warmer.Enqueue(path.c_str(), io::WarmUpMode::RANGES, {{0, page_size}});
+    auto high = warmer.Enqueue(path.c_str(), io::WarmUpMode::RANGES, {{page_size, page_size}}, 1);
+    auto cancelled = warmer.Enqueue(path.c_str(), io::WarmUpMode::RANGES, {{2 * page_size, page_size}}, 2);
+    ASSERT_TRUE(warmer.Cancel(cancelled));
+    ASSERT_FALSE(warmer.Cancel(42));
+    ASSERT_FALSE(warmer.GetProgress(42).has_value());
+
+    // The higher priority runs first
+    ASSERT_TRUE(warmer.Step());
+    ASSERT_EQ(warmer.GetProgress(high)->state, io::WarmUpState::DONE);
+    ASSERT_EQ(warmer.GetProgress(low)->state, io::WarmUpState::QUEUED);
+    ASSERT_EQ(warmer.GetProgress(cancelled)->state, io::WarmUpState::CANCELLED);
+    ASSERT_EQ(buffer->GetFIFOList(), (std::vector<uint64_t>{1}));
+
+    ASSERT_FALSE(warmer.Step());
+    ASSERT_EQ(warmer.GetProgress(low)->state, io::WarmUpState::DONE);
+    ASSERT_EQ(SortedPages(*buffer), (std::vector<uint64_t>{0, 1}));
+}
+
+TEST(FileWarmerTest, MissingFile) {
+    auto buffer = std::make_shared<TestableFilePageBuffer>();
+    auto path = fs::current_path() / ".tmp" / "test_warmer_missing";
+    if (fs::exists(path)) fs::remove(path);
+
+    io::FileWarmer warmer{buffer, false};
+    auto id = warmer.Enqueue(path.c_str(), io::WarmUpMode::ALL);
+    auto progress = warmer.Wait(id);
+    ASSERT_EQ(progress->state, io::WarmUpState::FAILED);
+    ASSERT_FALSE(progress->error.empty());
+}
+
+}  // namespace
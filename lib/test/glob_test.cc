@@ -1,6 +1,10 @@
 #include "duckdb/web/io/glob.h"
 
 #include <regex>
+#include <string>
+#include <vector>
+
+#include "duckdb/web/io/path_trie.h"
 
 #include "gtest/gtest.h"
 
@@ -186,4 +190,93 @@ TEST(GlobTest, globstar) {
     test(true);
 }
 
+TEST(GlobTest, MatcherEquivalence) {
+    std::vector<std::string> globs{
+        "",
+        "*",
+        "**",
+        "f*",
+        "*o",
+        "f*uck",
+        "f*o*o",
+        "a*a",
+        "*.parquet",
+        "/data/*",
+        "/data/*.csv",
+        "/data/*/x.csv",
+        "/data/**/*.csv",
+        "data/y=*/m=*/p.parquet",
+        "/data/y*",
+        "/data/x.csv",
+        "\\\\/$^+?.()=!|{},[].*",
+    };
+    std::vector<std::string> inputs{
+        "",
+        "a",
+        "aa",
+        "foo",
+        "o",
+        "firetruck",
+        "fuck",
+        "x.parquet",
+        "/data/x.csv",
+        "/data/x.csv.gz",
+        "/data/sub/x.csv",
+        "/data/y=2021/m=1/p.parquet",
+        "data/y=2021/m=12/p.parquet",
+        "data/y=2021/m=12/q.parquet",
+        "\\/$^+?.()=!|{},[].*",
+    };
+    for (auto& glob : globs) {
+        auto regex = glob_to_regex(glob);
+        GlobMatcher matcher{glob};
+        for (auto& input : inputs) {
+            ASSERT_EQ(matcher.Matches(input), std::regex_match(input, regex)) << "glob=" << glob << " input=" << input;
+            if (matcher.Matches(input)) {
+                ASSERT_EQ(input.rfind(matcher.GetLiteralPrefix(), 0), 0) << "glob=" << glob << " input=" << input;
+            }
+        }
+    }
+    ASSERT_TRUE(GlobMatcher{"/data/x.csv"}.IsLiteral());
+    ASSERT_FALSE(GlobMatcher{"/data/*.csv"}.IsLiteral());
+    ASSERT_TRUE(GlobMatcher{"/data/a\\*b.csv"}.IsLiteral());
+    ASSERT_EQ(GlobMatcher{"/data/a\\*b.csv"}.GetLiteralPrefix(), "/data/a*b.csv");
+    ASSERT_EQ(GlobMatcher{"/data/y=*/p.parquet"}.GetLiteralPrefix(), "/data/y=");
+    ASSERT_EQ(GlobMatcher{"*.csv"}.GetLiteralPrefix(), "");
+}
+
+TEST(GlobTest, PathTrie) {
+    PathTrie trie;
+    ASSERT_TRUE(trie.Insert("/data/y=2020/p.parquet"));
+    ASSERT_TRUE(trie.Insert("/data/y=2021/p.parquet"));
+    ASSERT_TRUE(trie.Insert("/data/y=2021/q.parquet"));
+    ASSERT_TRUE(trie.Insert("/other/p.parquet"));
+    ASSERT_TRUE(trie.Insert("relative.csv"));
+    ASSERT_FALSE(trie.Insert("/data/y=2021/p.parquet"));
+    ASSERT_EQ(trie.size(), 5);
+
+    auto visit = [&](std::string_view prefix) {
+        std::vector<std::string> out;
+        trie.VisitPrefix(prefix, [&](std::string_view path) { out.emplace_back(path); });
+        return out;
+    };
+    ASSERT_EQ(visit("/data/y=2021"), (std::vector<std::string>{"/data/y=2021/p.parquet", "/data/y=2021/q.parquet"}));
+    ASSERT_EQ(visit("/data/y="), (std::vector<std::string>{"/data/y=2020/p.parquet", "/data/y=2021/p.parquet",
+                                                           "/data/y=2021/q.parquet"}));
+    ASSERT_EQ(visit("/o"), (std::vector<std::string>{"/other/p.parquet"}));
+    ASSERT_EQ(visit("rel"), (std::vector<std::string>{"relative.csv"}));
+    ASSERT_EQ(visit("/missing/"), (std::vector<std::string>{}));
+    ASSERT_EQ(visit("").size(), 5);
+
+    ASSERT_TRUE(trie.Erase("/data/y=2021/p.parquet"));
+    ASSERT_FALSE(trie.Erase("/data/y=2021/p.parquet"));
+    ASSERT_FALSE(trie.Erase("/data/y=2021"));
+    ASSERT_TRUE(trie.Erase("/data/y=2021/q.parquet"));
+    ASSERT_EQ(visit("/data/"), (std::vector<std::string>{"/data/y=2020/p.parquet"}));
+    ASSERT_EQ(trie.size(), 3);
+    trie.Clear();
+    ASSERT_EQ(trie.size(), 0);
+    ASSERT_EQ(visit("").size(), 0);
+}
+
 }  // namespace
@@ -0,0 +1,156 @@
+#include "duckdb/web/incremental_view.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "arrow/record_batch.h"
+#include "arrow/type.h"
+#include "duckdb/web/json_parser.h"
+#include "duckdb/web/test/config.h"
+#include "duckdb/web/webdb.h"
+#include "gtest/gtest.h"
+#include "rapidjson/document.h"
+
+using namespace duckdb::web;
+
+namespace {
+
+/// Read a view definition
+arrow::Status ReadView(std::string_view definition, IncrementalView& view) {
+    rapidjson::Document doc;
+    doc.Parse(definition.data(), definition.size());
+    return view.ReadFrom(doc);
+}
+
+TEST(IncrementalView, ReadDefinition) {
+    IncrementalView view;
+    auto status = ReadView(R"JSON({
+        "name": "totals",
+        "table": "sales",
+        "groupBy": ["region"],
+        "aggregates": [
+            {"function": "SUM", "column": "amount", "name": "total"},
+            {"function": "count"},
+            {"function": "avg", "column": "amount"}
+        ]
+    })JSON",
+                           view);
+    ASSERT_TRUE(status.ok()) << status.message();
+    ASSERT_EQ(view.name(), "totals");
+    ASSERT_EQ(view.schema_name(), "main");
+    ASSERT_EQ(view.table_name(), "sales");
+    ASSERT_EQ(view.aggregates().size(), 3);
+    ASSERT_EQ(view.aggregates()[0].name, "total");
+    ASSERT_EQ(view.aggregates()[1].function, IncrementalView::AggregateFunction::COUNT);
+    ASSERT_EQ(view.aggregates()[1].name, "count(*)");
+    ASSERT_EQ(view.aggregates()[2].name, "avg(amount)");
+    ASSERT_EQ(view.GetStateTable(), "\"__incremental_totals\"");
+}
+
+TEST(IncrementalView, InvalidDefinition) {
+    IncrementalView a, b, c, d;
+    ASSERT_FALSE(
+        ReadView(R"JSON({"name": "v", "table": "t", "aggregates": [{"function": "median", "column": "x"}]})JSON", a)
+            .ok());
+    ASSERT_FALSE(ReadView(R"JSON({"name": "v", "table": "t", "aggregates": [{"function": "sum"}]})JSON", b).ok());
+    ASSERT_FALSE(ReadView(R"JSON({"name": "v", "table": "t", "aggregates": []})JSON", c).ok());
+    ASSERT_FALSE(ReadView(R"JSON({"table": "t", "aggregates": [{"function": "count"}]})JSON", d).ok());
+}
+
+TEST(IncrementalView, Compaction) {
+    IncrementalView view;
+    ASSERT_TRUE(ReadView(R"JSON({"name": "v", "table": "t", "aggregates": [{"function": "count"}]})JSON", view).ok());
+    for (size_t i = 1; i < IncrementalView::COMPACTION_FOLDS; ++i) {
+        ASSERT_EQ(view.EncodeFold("rows").size(), 1);
+        ASSERT_EQ(view.folds(), i - 1);
+        view.CommitFold();
+    }
+    ASSERT_GT(view.EncodeFold("rows").size(), 1);
+    // Encoding alone does not count a fold
+    ASSERT_GT(view.EncodeFold("rows").size(), 1);
+    view.CommitFold();
+    ASSERT_EQ(view.folds(), 0);
+}
+
+TEST(IncrementalView, FoldArrowInserts) {
+    auto schema = arrow::schema({arrow::field("g", arrow::utf8()), arrow::field("v", arrow::int64())});
+    auto db = std::make_shared<WebDB>(NATIVE);
+    WebDB::Connection conn{*db};
+    auto created = conn.connection().Query("CREATE TABLE facts (g VARCHAR, v BIGINT)");
+    ASSERT_TRUE(created->success) << created->error;
+    created = conn.connection().Query("INSERT INTO facts VALUES ('a', 100), ('c', NULL)");
+    ASSERT_TRUE(created->success) << created->error;
+
+    auto status = conn.CreateIncrementalView(R"JSON({
+        "name": "facts_by_g",
+        "table": "facts",
+        "groupBy": ["g"],
+        "aggregates": [
+            {"function": "sum", "column": "v", "name": "s"},
+            {"function": "count", "name": "n"},
+            {"function": "count", "column": "v", "name": "nv"},
+            {"function": "min", "column": "v", "name": "lo"},
+            {"function": "max", "column": "v", "name": "hi"},
+            {"function": "avg", "column": "v", "name": "mean"}
+        ]
+    })JSON");
+    ASSERT_TRUE(status.ok()) << status.message();
+
+    // Append more batches than fold until compaction
+    for (size_t i = 0; i < 2 * IncrementalView::COMPACTION_FOLDS + 3; ++i) {
+        auto groups = json::ArrayFromJSON(arrow::utf8(), R"(["a", "b", "a"])").ValueOrDie();
+        auto values =
+            json::ArrayFromJSON(arrow::int64(), "[" + std::to_string(i) + ", " + std::to_string(2 * i) + ", 1]")
+                .ValueOrDie();
+        auto batch = arrow::RecordBatch::Make(schema, 3, {groups, values});
+        auto reader = arrow::RecordBatchReader::Make({batch}, schema).ValueOrDie();
+        status = conn.InsertArrowFromRecordBatchReader(reader, R"JSON({"name": "facts", "create": false})JSON");
+        ASSERT_TRUE(status.ok()) << status.message();
+    }
+
+    // The view matches a full aggregation
+    auto diff = conn.connection().Query(R"SQL(
+        (SELECT g, s, n, nv, lo, hi, mean FROM facts_by_g
+         EXCEPT
+         SELECT g, SUM(v), COUNT(*), COUNT(v), MIN(v), MAX(v), AVG(v) FROM facts GROUP BY g)
+        UNION ALL
+        (SELECT g, SUM(v), COUNT(*), COUNT(v), MIN(v), MAX(v), AVG(v) FROM facts GROUP BY g
+         EXCEPT
+         SELECT g, s, n, nv, lo, hi, mean FROM facts_by_g)
+    )SQL");
+    ASSERT_TRUE(diff->success) << diff->error;
+    ASSERT_EQ(diff->collection.Count(), 0);
+    auto groups = conn.connection().Query("SELECT count(*)::INTEGER FROM facts_by_g");
+    ASSERT_TRUE(groups->success) << groups->error;
+    ASSERT_EQ(groups->GetValue(0, 0).ToString(), "3");
+
+    // A failed fold rolls back the insert, even in a transaction of the caller
+    auto count_facts = [&]() {
+        auto count = conn.connection().Query("SELECT count(*)::INTEGER FROM facts");
+        EXPECT_TRUE(count->success) << count->error;
+        return count->GetValue(0, 0).GetValue<int32_t>();
+    };
+    auto facts = count_facts();
+    auto dropped = conn.connection().Query("DROP TABLE __incremental_facts_by_g");
+    ASSERT_TRUE(dropped->success) << dropped->error;
+    for (auto caller_transaction : {false, true}) {
+        if (caller_transaction) ASSERT_TRUE(conn.RunQuery("BEGIN TRANSACTION").ok());
+        auto group = json::ArrayFromJSON(arrow::utf8(), R"(["a"])").ValueOrDie();
+        auto value = json::ArrayFromJSON(arrow::int64(), "[1]").ValueOrDie();
+        auto batch = arrow::RecordBatch::Make(schema, 1, {group, value});
+        auto reader = arrow::RecordBatchReader::Make({batch}, schema).ValueOrDie();
+        status = conn.InsertArrowFromRecordBatchReader(reader, R"JSON({"name": "facts", "create": false})JSON");
+        ASSERT_FALSE(status.ok());
+        ASSERT_TRUE(conn.connection().IsAutoCommit());
+        ASSERT_EQ(count_facts(), facts);
+    }
+
+    // Dropping the view removes its state
+    ASSERT_TRUE(conn.DropIncrementalView("facts_by_g").ok());
+    ASSERT_FALSE(conn.DropIncrementalView("facts_by_g").ok());
+    ASSERT_FALSE(conn.connection().Query("SELECT * FROM facts_by_g")->success);
+    ASSERT_FALSE(conn.connection().Query("SELECT * FROM __incremental_facts_by_g")->success);
+}
+
+}  // namespace
@@ -1,10 +1,12 @@
 #include <arrow/memory_pool.h>
 
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <memory>
 #include <sstream>
 
+#include "arrow/c/bridge.h"
 #include "arrow/io/memory.h"
 #include "arrow/ipc/options.h"
 #include "arrow/ipc/writer.h"
@@ -14,6 +16,7 @@
 #include "duckdb/common/types/date.hpp"
 #include "duckdb/common/types/timestamp.hpp"
 #include "duckdb/execution/operator/persistent/buffered_csv_reader.hpp"
+#include "duckdb/web/arrow_stream_buffer.h"
 #include "duckdb/web/io/ifstream.h"
 #include "duckdb/web/io/memory_filesystem.h"
 #include "duckdb/web/json_parser.h"
@@ -56,16 +59,18 @@ struct ArrowInsertTest {
 
 struct ArrowInsertTestSuite : public testing::TestWithParam<ArrowInsertTest> {};
 
-TEST_P(ArrowInsertTestSuite, TestInsert) {
-    auto& test = GetParam();
-
+/// Write the record batches of a test as IPC stream
+std::shared_ptr<arrow::Buffer> WriteIPCStream(const ArrowInsertTest& test) {
     /// Create the record batches
     std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
     for (auto& batch : test.batches) {
         std::vector<std::shared_ptr<arrow::Array>> arrays;
         for (auto& c : batch.columns) {
             auto maybe_array = json::ArrayFromJSON(c.type, c.values);
-            ASSERT_TRUE(maybe_array.ok()) << maybe_array.status().message();
+            if (!maybe_array.ok()) {
+                ADD_FAILURE() << maybe_array.status().message();
+                return nullptr;
+            }
             arrays.push_back(maybe_array.ValueUnsafe());
         }
         batches.push_back(arrow::RecordBatch::Make(test.schema, batch.num_rows, arrays));
@@ -73,17 +78,29 @@ TEST_P(ArrowInsertTestSuite, TestInsert) {
 
     // Prepare the writing of the record batch stream
     auto maybe_out_stream = arrow::io::BufferOutputStream::Create();
-    ASSERT_TRUE(maybe_out_stream.ok());
+    if (!maybe_out_stream.ok()) return nullptr;
     auto& out_stream = maybe_out_stream.ValueUnsafe();
     auto ipc_options = arrow::ipc::IpcWriteOptions::Defaults();
     ipc_options.use_threads = false;
 
     // Write the record batch stream
     auto maybe_ok = arrow::ipc::WriteRecordBatchStream(batches, ipc_options, out_stream.get());
-    ASSERT_TRUE(maybe_ok.ok()) << maybe_ok.message();
+    if (!maybe_ok.ok()) {
+        ADD_FAILURE() << maybe_ok.message();
+        return nullptr;
+    }
     auto maybe_buffer = out_stream->Finish();
-    ASSERT_TRUE(maybe_buffer.ok()) << maybe_buffer.status().message();
-    auto& buffer = maybe_buffer.ValueUnsafe();
+    if (!maybe_buffer.ok()) {
+        ADD_FAILURE() << maybe_buffer.status().message();
+        return nullptr;
+    }
+    return maybe_buffer.ValueUnsafe();
+}
+
+TEST_P(ArrowInsertTestSuite, TestInsert) {
+    auto& test = GetParam();
+    auto buffer = WriteIPCStream(test);
+    ASSERT_NE(buffer, nullptr);
 
     // Stream the buffer to the WebDB
     auto db = std::make_shared<WebDB>(NATIVE);
@@ -96,7 +113,29 @@ TEST_P(ArrowInsertTestSuite, TestInsert) {
         ASSERT_TRUE(maybe_ok.ok()) << maybe_ok.message();
         ofs += chunk_size;
     }
-    ASSERT_TRUE(maybe_ok.ok()) << maybe_ok.message();
+
+    // Query the resulting table
+    auto result = conn.connection().Query(std::string{test.query});
+    ASSERT_STREQ(result->ToString().c_str(), std::string{test.expected_output}.c_str());
+}
+
+TEST_P(ArrowInsertTestSuite, TestInsertOwnedChunks) {
+    auto& test = GetParam();
+    auto buffer = WriteIPCStream(test);
+    ASSERT_NE(buffer, nullptr);
+
+    // Hand the chunks over to the WebDB
+    auto db = std::make_shared<WebDB>(NATIVE);
+    WebDB::Connection conn{*db};
+    for (size_t ofs = 0; ofs < buffer->size();) {
+        auto chunk_size = std::min<size_t>(buffer->size() - ofs, test.chunk_size);
+        std::unique_ptr<char[]> chunk_data{new char[chunk_size]};
+        std::memcpy(chunk_data.get(), buffer->data() + ofs, chunk_size);
+        auto chunk = std::make_shared<ArrowOwnedBuffer>(std::move(chunk_data), chunk_size);
+        auto maybe_ok = conn.InsertArrowFromIPCStream(std::move(chunk), ofs == 0 ? test.options : "");
+        ASSERT_TRUE(maybe_ok.ok()) << maybe_ok.message();
+        ofs += chunk_size;
+    }
 
     // Query the resulting table
     auto result = conn.connection().Query(std::string{test.query});
@@ -243,4 +282,63 @@ INTEGER	SMALLINT	VARCHAR
 INSTANTIATE_TEST_SUITE_P(ArrowInsertTest, ArrowInsertTestSuite, testing::ValuesIn(ARROW_IMPORT_TEST),
                          ArrowInsertTest::TestPrinter());
 
+TEST(ArrowInsertTest, RecordBatchReader) {
+    auto schema = arrow::schema({arrow::field("a", arrow::int32())});
+    auto values = json::ArrayFromJSON(arrow::int32(), "[1, 2, 3]").ValueOrDie();
+    auto batch = arrow::RecordBatch::Make(schema, 3, {values});
+    auto db = std::make_shared<WebDB>(NATIVE);
+    WebDB::Connection conn{*db};
+
+    // Insert from a reader
+    auto reader = arrow::RecordBatchReader::Make({batch, batch}, schema).ValueOrDie();
+    auto maybe_ok = conn.InsertArrowFromRecordBatchReader(reader, R"JSON({"schema": "main", "name": "foo"})JSON");
+    ASSERT_TRUE(maybe_ok.ok()) << maybe_ok.message();
+
+    // Append from an arrow C stream
+    ArrowArrayStream stream;
+    reader = arrow::RecordBatchReader::Make({batch}, schema).ValueOrDie();
+    ASSERT_TRUE(arrow::ExportRecordBatchReader(reader, &stream).ok());
+    maybe_ok =
+        conn.InsertArrowFromArrayStream(&stream, R"JSON({"schema": "main", "name": "foo", "create": false})JSON");
+    ASSERT_TRUE(maybe_ok.ok()) << maybe_ok.message();
+
+    auto result = conn.connection().Query("SELECT count(*)::INTEGER, sum(a)::INTEGER FROM main.foo");
+    ASSERT_TRUE(result->success) << result->error;
+    ASSERT_EQ(result->GetValue(0, 0).ToString(), "9");
+    ASSERT_EQ(result->GetValue(1, 0).ToString(), "18");
+}
+
+TEST(ArrowInsertTest, ArrowView) {
+    auto schema = arrow::schema({arrow::field("a", arrow::int32())});
+    auto values = json::ArrayFromJSON(arrow::int32(), "[1, 2, 3]").ValueOrDie();
+    auto batch = arrow::RecordBatch::Make(schema, 3, {values});
+    auto db = std::make_shared<WebDB>(NATIVE);
+    WebDB::Connection conn{*db};
+
+    // The view can be scanned more than once
+    auto reader = arrow::RecordBatchReader::Make({batch, batch}, schema).ValueOrDie();
+    auto maybe_ok = conn.CreateArrowView("bar", reader);
+    ASSERT_TRUE(maybe_ok.ok()) << maybe_ok.message();
+    for (size_t i = 0; i < 2; ++i) {
+        auto result = conn.connection().Query("SELECT sum(a)::INTEGER FROM bar");
+        ASSERT_TRUE(result->success) << result->error;
+        ASSERT_EQ(result->GetValue(0, 0).ToString(), "12");
+    }
+
+    // Replace the view with a C stream
+    ArrowArrayStream stream;
+    reader = arrow::RecordBatchReader::Make({batch}, schema).ValueOrDie();
+    ASSERT_TRUE(arrow::ExportRecordBatchReader(reader, &stream).ok());
+    maybe_ok = conn.CreateArrowView("bar", &stream);
+    ASSERT_TRUE(maybe_ok.ok()) << maybe_ok.message();
+    auto result = conn.connection().Query("SELECT sum(a)::INTEGER FROM bar");
+    ASSERT_TRUE(result->success) << result->error;
+    ASSERT_EQ(result->GetValue(0, 0).ToString(), "6");
+
+    // Drop the view
+    ASSERT_TRUE(conn.DropArrowView("bar").ok());
+    ASSERT_FALSE(conn.DropArrowView("bar").ok());
+    ASSERT_FALSE(conn.connection().Query("SELECT * FROM bar")->success);
+}
+
 }  // namespace
@@ -1,10 +1,14 @@
 #include "duckdb/web/io/memory_filesystem.h"
 
+#include <atomic>
+#include <cstring>
 #include <fstream>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
+#include "duckdb/common/exception.hpp"
 #include "duckdb/web/io/ifstream.h"
 #include "duckdb/web/test/config.h"
 #include "gtest/gtest.h"
@@ -52,4 +56,126 @@ TEST(MemoryFilesystem, integers) {
     }
 }
 
+TEST(MemoryFilesystem, Append) {
+    io::MemoryFileSystem fs;
+    auto file = fs.OpenFile("out", duckdb::FileFlags::FILE_FLAGS_WRITE | duckdb::FileFlags::FILE_FLAGS_FILE_CREATE,
+                            duckdb::FileLockType::NO_LOCK, duckdb::FileCompressionType::UNCOMPRESSED);
+    constexpr size_t N = 100000;
+    for (uint64_t i = 0; i < N; ++i) {
+        ASSERT_EQ(file->Write(&i, sizeof(i)), sizeof(i));
+    }
+    ASSERT_EQ(file->GetFileSize(), N * sizeof(uint64_t));
+    auto segments =
+        (N * sizeof(uint64_t) + io::MemoryFileSystem::SEGMENT_SIZE - 1) / io::MemoryFileSystem::SEGMENT_SIZE;
+    ASSERT_EQ(fs.GetAllocatedBytes(), segments * io::MemoryFileSystem::SEGMENT_SIZE);
+
+    // Scan the file in place
+    uint64_t next = 0;
+    size_t spans = 0;
+    auto n = fs.ScanSpans(*file, 0, N * sizeof(uint64_t), [&](nonstd::span<const char> span) {
+        ASSERT_LE(span.size(), io::MemoryFileSystem::SEGMENT_SIZE);
+        ++spans;
+        for (size_t i = 0; i + sizeof(uint64_t) <= span.size(); i += sizeof(uint64_t)) {
+            uint64_t v;
+            std::memcpy(&v, span.data() + i, sizeof(v));
+            ASSERT_EQ(v, next++);
+        }
+    });
+    ASSERT_EQ(n, N * sizeof(uint64_t));
+    ASSERT_EQ(next, N);
+    ASSERT_EQ(spans, segments);
+
+    // Shrinking releases segments, regrown bytes are zero
+    fs.Truncate(*file, 12);
+    ASSERT_EQ(fs.GetAllocatedBytes(), io::MemoryFileSystem::SEGMENT_SIZE);
+    fs.Truncate(*file, 16);
+    uint64_t have[2];
+    file->Read(have, sizeof(have), 0);
+    ASSERT_EQ(have[0], 0);
+    ASSERT_EQ(have[1], 1);
+    ASSERT_THROW(file->Read(have, sizeof(have), 8), duckdb::IOException);
+}
+
+TEST(MemoryFilesystem, Errors) {
+    io::MemoryFileSystem fs;
+    ASSERT_THROW(fs.OpenFile("missing", duckdb::FileFlags::FILE_FLAGS_READ, duckdb::FileLockType::NO_LOCK,
+                             duckdb::FileCompressionType::UNCOMPRESSED),
+                 duckdb::IOException);
+    ASSERT_THROW(fs.RemoveFile("missing"), duckdb::IOException);
+    ASSERT_THROW(fs.MoveFile("missing", "other"), duckdb::IOException);
+    ASSERT_TRUE(fs.RegisterFileBuffer("foo", {'a', 'b'}).ok());
+    ASSERT_FALSE(fs.RegisterFileBuffer("foo", {'c'}).ok());
+    auto file = fs.OpenFile("foo", duckdb::FileFlags::FILE_FLAGS_READ, duckdb::FileLockType::NO_LOCK,
+                            duckdb::FileCompressionType::UNCOMPRESSED);
+    ASSERT_THROW(fs.OpenFile("foo", duckdb::FileFlags::FILE_FLAGS_WRITE, duckdb::FileLockType::WRITE_LOCK,
+                             duckdb::FileCompressionType::UNCOMPRESSED),
+                 duckdb::IOException);
+
+    // Removed files stay readable through open handles
+    fs.RemoveFile("foo");
+    ASSERT_FALSE(fs.FileExists("foo"));
+    char have[2];
+    file->Read(have, 2, 0);
+    ASSERT_EQ(std::string_view(have, 2), "ab");
+    ASSERT_EQ(fs.GetAllocatedBytes(), io::MemoryFileSystem::SEGMENT_SIZE);
+    file.reset();
+    ASSERT_EQ(fs.GetAllocatedBytes(), 0);
+}
+
+TEST(MemoryFilesystem, MoveFileReplacesTarget) {
+    io::MemoryFileSystem fs;
+    ASSERT_TRUE(fs.RegisterFileBuffer("wal", {'a', 'b'}).ok());
+    ASSERT_TRUE(fs.RegisterFileBuffer("wal.tmp", {'c', 'd'}).ok());
+    auto file = fs.OpenFile("wal", duckdb::FileFlags::FILE_FLAGS_READ, duckdb::FileLockType::NO_LOCK,
+                            duckdb::FileCompressionType::UNCOMPRESSED);
+
+    // The replaced target stays readable through open handles until they are closed
+    fs.MoveFile("wal.tmp", "wal");
+    ASSERT_FALSE(fs.FileExists("wal.tmp"));
+    char have[2];
+    file->Read(have, 2, 0);
+    ASSERT_EQ(std::string_view(have, 2), "ab");
+    auto moved = fs.OpenFile("wal", duckdb::FileFlags::FILE_FLAGS_READ, duckdb::FileLockType::NO_LOCK,
+                             duckdb::FileCompressionType::UNCOMPRESSED);
+    moved->Read(have, 2, 0);
+    ASSERT_EQ(std::string_view(have, 2), "cd");
+    ASSERT_EQ(fs.GetAllocatedBytes(), 2 * io::MemoryFileSystem::SEGMENT_SIZE);
+    file.reset();
+    ASSERT_EQ(fs.GetAllocatedBytes(), io::MemoryFileSystem::SEGMENT_SIZE);
+}
+
+TEST(MemoryFilesystem, ConcurrentReaders) {
+    constexpr size_t N = 1 << 16;
+    io::MemoryFileSystem fs;
+    auto writer = fs.OpenFile("data", duckdb::FileFlags::FILE_FLAGS_WRITE | duckdb::FileFlags::FILE_FLAGS_FILE_CREATE,
+                              duckdb::FileLockType::NO_LOCK, duckdb::FileCompressionType::UNCOMPRESSED);
+    uint64_t first = 0;
+    writer->Write(&first, sizeof(first));
+
+    std::atomic<bool> done = false;
+    std::atomic<size_t> failures = 0;
+    std::vector<std::thread> readers;
+    for (size_t t = 0; t < 4; ++t) {
+        readers.emplace_back([&]() {
+            auto reader = fs.OpenFile("data", duckdb::FileFlags::FILE_FLAGS_READ, duckdb::FileLockType::NO_LOCK,
+                                      duckdb::FileCompressionType::UNCOMPRESSED);
+            while (!done) {
+                // Every complete value that is visible must be correct
+                auto size = reader->GetFileSize() / sizeof(uint64_t) * sizeof(uint64_t);
+                auto offset = size - sizeof(uint64_t);
+                uint64_t v;
+                reader->Read(&v, sizeof(v), offset);
+                if (v != offset / sizeof(uint64_t)) ++failures;
+            }
+        });
+    }
+    for (uint64_t i = 1; i < N; ++i) {
+        writer->Write(&i, sizeof(i));
+    }
+    done = true;
+    for (auto& reader : readers) reader.join();
+    ASSERT_EQ(failures, 0);
+    ASSERT_EQ(writer->GetFileSize(), N * sizeof(uint64_t));
+}
+
 }  // namespace
@@ -0,0 +1,169 @@
+#include "duckdb/web/memory_governor.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "duckdb/web/io/file_page_buffer.h"
+#include "duckdb/web/webdb.h"
+#include "rapidjson/document.h"
+
+using namespace duckdb::web;
+namespace fs = std::filesystem;
+
+namespace {
+
+struct TestConsumer : public MemoryConsumer {
+    size_t usage = 0;
+    size_t limit = 0;
+    size_t reclaimable = 0;
+
+    size_t GetMemoryUsage() override { return usage; }
+    void SetMemoryLimit(size_t bytes) override { limit = bytes; }
+    size_t ReclaimMemory(size_t bytes) override {
+        auto n = std::min(bytes, reclaimable);
+        reclaimable -= n;
+        usage -= n;
+        return n;
+    }
+};
+
+struct TestableFilePageBuffer : public io::FilePageBuffer {
+    TestableFilePageBuffer(size_t page_capacity = 256, size_t page_size_bits = 12)
+        : io::FilePageBuffer(duckdb::FileSystem::CreateLocal(), page_capacity, page_size_bits) {}
+
+    auto& GetFrames() { return frames; }
+};
+
+fs::path CreateTestFile(size_t size) {
+    auto tmp = fs::current_path() / ".tmp";
+    auto file = tmp / "test_memory_governor";
+    if (!fs::is_directory(tmp) || !fs::exists(tmp)) fs::create_directory(tmp);
+    if (fs::exists(file)) fs::remove(file);
+    std::vector<char> data(size, 'x');
+    std::ofstream output(file, std::ios::binary);
+    output.write(data.data(), data.size());
+    return file;
+}
+
+TEST(MemoryGovernorTest, Limits) {
+    MemoryGovernor governor;
+    TestConsumer pages, results;
+    governor.Register("pages", pages, 0.25);
+    governor.Register("results", results);
+    ASSERT_EQ(pages.limit, 0);
+    ASSERT_EQ(governor.GetDatabaseMemory(), 0);
+
+    governor.SetBudget(1 << 30);
+    ASSERT_EQ(pages.limit, 256 << 20);
+    ASSERT_EQ(results.limit, 0);
+
+    // Unlimited consumers count with their usage
+    results.usage = 100 << 20;
+    ASSERT_EQ(governor.GetDatabaseMemory(), (1 << 30) - (256 << 20) - (100 << 20));
+    results.usage = 1 << 30;
+    ASSERT_EQ(governor.GetDatabaseMemory(), MemoryGovernor::MINIMUM_DATABASE_MEMORY);
+
+    // A budget of 0 removes the limits
+    governor.SetBudget(0);
+    ASSERT_EQ(pages.limit, 0);
+    governor.Unregister(results);
+    ASSERT_EQ(governor.GetUsage(), 0);
+}
+
+TEST(MemoryGovernorTest, Enforce) {
+    MemoryGovernor governor{1000};
+    TestConsumer first, second;
+    governor.Register("first", first, 0.5);
+    governor.Register("second", second);
+    ASSERT_EQ(first.limit, 500);
+
+    // Within the budget
+    first.usage = 400;
+    first.reclaimable = 400;
+    second.usage = 500;
+    second.reclaimable = 500;
+    ASSERT_EQ(governor.Enforce(), 0);
+
+    // The first consumer exceeds its limit
+    first.usage = 600;
+    first.reclaimable = 600;
+    ASSERT_EQ(governor.Enforce(), 100);
+    ASSERT_EQ(first.usage, 500);
+
+    // The usage exceeds the budget, consumers are asked in registration order
+    second.usage = 800;
+    second.reclaimable = 800;
+    ASSERT_EQ(governor.Enforce(), 300);
+    ASSERT_EQ(first.usage, 200);
+    ASSERT_EQ(second.usage, 800);
+}
+
+TEST(MemoryGovernorTest, FilePageBuffer) {
+    auto buffer = std::make_shared<TestableFilePageBuffer>();
+    auto page_size = buffer->GetPageSize();
+    auto path = CreateTestFile(200 * page_size);
+    {
+        auto file = buffer->OpenFile(path.c_str(), duckdb::FileFlags::FILE_FLAGS_READ);
+        for (uint64_t page_id = 0; page_id < 200; ++page_id) {
+            file->FixPage(page_id, false);
+        }
+    }
+    ASSERT_EQ(buffer->GetFrames().size(), 200);
+    ASSERT_EQ(buffer->GetMemoryUsage(), 200 * page_size);
+
+    // Lowering the limit evicts the pages that no longer fit
+    MemoryGovernor governor{400 * page_size};
+    governor.Register("pageBuffer", *buffer, 0.25);
+    ASSERT_EQ(buffer->GetPageCapacity(), 100);
+    ASSERT_EQ(buffer->GetFrames().size(), 100);
+
+    // Reclaiming evicts unused pages
+    ASSERT_EQ(governor.Reclaim(10 * page_size), 10 * page_size);
+    ASSERT_EQ(buffer->GetFrames().size(), 90);
+
+    // The capacity never drops below the minimum and is restored without budget
+    governor.SetBudget(page_size);
+    ASSERT_EQ(buffer->GetPageCapacity(), io::MINIMUM_FILE_PAGE_CAPACITY);
+    governor.SetBudget(0);
+    ASSERT_EQ(buffer->GetPageCapacity(), 256);
+}
+
+TEST(MemoryGovernorTest, WebDBBudget) {
+    auto db = std::make_shared<WebDB>(NATIVE);
+    ASSERT_TRUE(db->Open(R"JSON({"memoryBudget": 1073741824})JSON").ok());
+    ASSERT_EQ(db->memory_governor().GetBudget(), 1 << 30);
+    ASSERT_EQ(db->file_page_buffer().GetPageCapacity(), io::DEFAULT_FILE_PAGE_CAPACITY);
+
+    WebDB::Connection conn{*db};
+    auto result = conn.RunQuery("SELECT 42");
+    ASSERT_TRUE(result.ok()) << result.status().message();
+
+    auto info = db->GetMemoryInfo();
+    ASSERT_TRUE(info.ok());
+    rapidjson::Document doc;
+    doc.Parse(info->c_str());
+    ASSERT_TRUE(doc.IsObject());
+    ASSERT_EQ(doc["budget"].GetDouble(), 1 << 30);
+    ASSERT_EQ(doc["databaseMemory"].GetDouble(), (1 << 30) - (256 << 20));
+    auto consumers = doc["consumers"].GetArray();
+    ASSERT_EQ(consumers.Size(), 4);
+    ASSERT_EQ(std::string{consumers[0]["name"].GetString()}, "pageBuffer");
+    ASSERT_EQ(consumers[0]["limit"].GetDouble(), 256 << 20);
+    ASSERT_EQ(std::string{consumers[1]["name"].GetString()}, "arrow");
+    ASSERT_EQ(std::string{consumers[2]["name"].GetString()}, "tempStorage");
+    ASSERT_EQ(std::string{consumers[3]["name"].GetString()}, "results");
+    ASSERT_GT(doc["arrow"]["allocations"].GetDouble(), 0);
+    ASSERT_GE(doc["arrow"]["bytesAllocated"].GetDouble(), result.ValueUnsafe()->size());
+
+    // Without budget, DuckDB keeps its own limit
+    ASSERT_TRUE(db->Open("{}").ok());
+    ASSERT_EQ(db->memory_governor().GetDatabaseMemory(), 0);
+}
+
+}  // namespace
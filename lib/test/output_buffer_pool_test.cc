@@ -0,0 +1,108 @@
+#include "duckdb/web/io/output_buffer_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+using namespace duckdb::web;
+
+namespace {
+
+TEST(OutputBufferPool, Recycle) {
+    io::OutputBufferPool pool;
+    auto first = pool.Acquire(100 << 10);
+    ASSERT_TRUE(first.ok());
+    auto* data = (*first)->data();
+    ASSERT_GE((*first)->capacity(), 100 << 10);
+    ASSERT_EQ((*first)->size(), 0);
+    ASSERT_EQ(pool.GetRetainedBytes(), 0);
+
+    // Released buffers return to the pool
+    auto capacity = (*first)->capacity();
+    first->reset();
+    ASSERT_EQ(pool.GetRetainedBytes(), capacity);
+    auto second = pool.Acquire(90 << 10);
+    ASSERT_TRUE(second.ok());
+    ASSERT_EQ((*second)->data(), data);
+    ASSERT_EQ(pool.GetReuseCount(), 1);
+    ASSERT_EQ(pool.GetRetainedBytes(), 0);
+
+    second->reset();
+    ASSERT_EQ(pool.Clear(), capacity);
+
+    // Much smaller requests do not take large buffers
+    auto large = pool.Acquire(1 << 20);
+    ASSERT_TRUE(large.ok());
+    data = (*large)->data();
+    large->reset();
+    auto small = pool.Acquire(1);
+    ASSERT_TRUE(small.ok());
+    ASSERT_NE((*small)->data(), data);
+    ASSERT_EQ(pool.GetRetainedBytes(), 1 << 20);
+}
+
+TEST(OutputBufferPool, RetainedLimit) {
+    io::OutputBufferPool pool{arrow::default_memory_pool(), 1 << 20};
+    {
+        auto a = pool.Acquire(1 << 20);
+        auto b = pool.Acquire(1 << 20);
+        ASSERT_TRUE(a.ok() && b.ok());
+    }
+    ASSERT_EQ(pool.GetRetainedBytes(), 1 << 20);
+}
+
+TEST(OutputBufferPool, OutlivePool) {
+    std::shared_ptr<arrow::ResizableBuffer> buffer;
+    {
+        io::OutputBufferPool pool;
+        auto acquired = pool.Acquire(1);
+        ASSERT_TRUE(acquired.ok());
+        buffer = *acquired;
+    }
+    ASSERT_GE(buffer->capacity(), 1);
+    buffer.reset();
+}
+
+TEST(PooledOutputStream, SingleBuffer) {
+    io::OutputBufferPool pool;
+    io::PooledOutputStream out{pool};
+    std::vector<uint8_t> data(200 << 10);
+    std::iota(data.begin(), data.end(), 0);
+    ASSERT_TRUE(out.Write(data.data(), 8).ok());
+    ASSERT_TRUE(out.Reserve(data.size()).ok());
+    ASSERT_TRUE(out.Write(data.data(), data.size()).ok());
+    ASSERT_EQ(*out.Tell(), data.size() + 8);
+    auto buffer = out.Finish();
+    ASSERT_TRUE(buffer.ok());
+    ASSERT_EQ((*buffer)->size(), data.size() + 8);
+    ASSERT_EQ((*buffer)->data()[7], 7);
+    ASSERT_EQ((*buffer)->data()[8 + 1000], data[1000]);
+    ASSERT_EQ(pool.GetReuseCount(), 0);
+    ASSERT_FALSE(out.Write(data.data(), 1).ok());
+}
+
+TEST(PooledOutputStream, Growth) {
+    io::OutputBufferPool pool;
+    std::vector<uint8_t> data(1000);
+    std::iota(data.begin(), data.end(), 0);
+    size_t n = 0;
+    for (size_t round = 0; round < 2; ++round) {
+        io::PooledOutputStream out{pool};
+        for (n = 0; n < 1000; ++n) {
+            ASSERT_TRUE(out.Write(data.data(), data.size()).ok());
+        }
+        auto buffer = out.Finish();
+        ASSERT_TRUE(buffer.ok());
+        ASSERT_EQ((*buffer)->size(), n * data.size());
+        for (size_t i = 0; i < n; ++i) {
+            ASSERT_EQ((*buffer)->data()[i * data.size() + 999], data[999]);
+        }
+    }
+    // The second round reuses the buffers of the first one
+    ASSERT_GT(pool.GetReuseCount(), 0);
+}
+
+}  // namespace
@@ -108,4 +108,40 @@ TEST(ReadAheadBufferTest, ConsecutiveReads) {
     ASSERT_EQ(buffer.GetReadHeads().back().buffer_size, FILE_SIZE - ofs);
 }
 
+TEST(ReadAheadBufferTest, Release) {
+    constexpr size_t FILE_ID = 0;
+    constexpr auto FILE_SIZE = 4 * READAHEAD_BASE;
+    constexpr auto CHUNK_SIZE = 1024;
+    TestableReadAheadBuffer buffer;
+    std::vector<char> in;
+    std::vector<char> out;
+    in.resize(FILE_SIZE);
+    out.resize(FILE_SIZE);
+    std::iota(in.begin(), in.end(), 0);
+
+    auto read = [&](auto* buffer, size_t bytes, duckdb::idx_t offset) -> size_t {
+        std::memcpy(buffer, reinterpret_cast<char*>(in.data()) + offset, bytes);
+        return bytes;
+    };
+
+    // The second consecutive read allocates a buffer
+    buffer.Read(FILE_ID, FILE_SIZE, out.data(), CHUNK_SIZE, 0, read);
+    ASSERT_EQ(buffer.GetMemoryUsage(), 0);
+    buffer.Read(FILE_ID, FILE_SIZE, out.data(), CHUNK_SIZE, CHUNK_SIZE, read);
+    ASSERT_EQ(buffer.GetMemoryUsage(), READAHEAD_BASE);
+
+    // Buffers within the capacity are kept
+    ASSERT_EQ(buffer.Release(READAHEAD_BASE), 0);
+    ASSERT_EQ(buffer.GetMemoryUsage(), READAHEAD_BASE);
+
+    // Released read heads start over
+    ASSERT_EQ(buffer.Release(), READAHEAD_BASE);
+    ASSERT_EQ(buffer.GetMemoryUsage(), 0);
+    ASSERT_EQ(buffer.GetReadHeads().back().buffer, nullptr);
+    ASSERT_NE(buffer.GetReadHeads().back().file_id, FILE_ID);
+    auto bytes_read = buffer.Read(FILE_ID, FILE_SIZE, out.data(), CHUNK_SIZE, 2 * CHUNK_SIZE, read);
+    ASSERT_EQ(bytes_read, CHUNK_SIZE);
+    ASSERT_EQ(std::memcmp(out.data(), in.data() + 2 * CHUNK_SIZE, CHUNK_SIZE), 0);
+}
+
 }  // namespace
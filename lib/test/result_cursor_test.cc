@@ -0,0 +1,117 @@
+#include "duckdb/web/result_cursor.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "arrow/array/array_dict.h"
+#include "arrow/array/array_primitive.h"
+#include "arrow/array/builder_primitive.h"
+#include "arrow/io/memory.h"
+#include "arrow/ipc/reader.h"
+#include "arrow/table.h"
+#include "duckdb/web/io/temp_filesystem.h"
+
+using namespace duckdb::web;
+
+namespace {
+
+constexpr auto CURSOR_FILE = "tmp://duckdb/cursor_test";
+
+std::shared_ptr<arrow::RecordBatch> CreateBatch(std::shared_ptr<arrow::Schema> schema, int64_t first, int64_t n) {
+    arrow::Int64Builder builder;
+    for (int64_t i = 0; i < n; ++i) {
+        EXPECT_TRUE(builder.Append(first + i).ok());
+    }
+    auto array = builder.Finish().ValueOrDie();
+    return arrow::RecordBatch::Make(schema, n, {array});
+}
+
+std::shared_ptr<arrow::Table> ReadStream(std::shared_ptr<arrow::Buffer> buffer) {
+    arrow::io::BufferReader input{buffer};
+    auto reader = arrow::ipc::RecordBatchStreamReader::Open(&input).ValueOrDie();
+    return reader->ToTable().ValueOrDie();
+}
+
+std::vector<int64_t> ReadValues(const arrow::Table& table) {
+    std::vector<int64_t> values;
+    for (auto& chunk : table.column(0)->chunks()) {
+        auto& array = static_cast<const arrow::Int64Array&>(*chunk);
+        for (int64_t i = 0; i < array.length(); ++i) values.push_back(array.Value(i));
+    }
+    return values;
+}
+
+TEST(ResultCursor, FetchRows) {
+    io::TempFileSystem fs;
+    io::OutputBufferPool buffers;
+    auto schema = arrow::schema({arrow::field("v", arrow::int64())});
+    ResultCursor cursor{fs, CURSOR_FILE, schema};
+    ASSERT_TRUE(cursor.Open().ok());
+    for (int64_t first = 0; first < 10000; first += 1000) {
+        ASSERT_TRUE(cursor.Append(*CreateBatch(schema, first, 1000)).ok());
+    }
+    ASSERT_EQ(cursor.row_count(), 10000);
+    ASSERT_EQ(cursor.batch_count(), 10);
+
+    // Rows within a batch
+    auto table = ReadStream(cursor.FetchRows(5000, 10, buffers).ValueOrDie());
+    ASSERT_EQ(ReadValues(*table), (std::vector<int64_t>{5000, 5001, 5002, 5003, 5004, 5005, 5006, 5007, 5008, 5009}));
+
+    // Rows across batches
+    table = ReadStream(cursor.FetchRows(1990, 2020, buffers).ValueOrDie());
+    auto values = ReadValues(*table);
+    ASSERT_EQ(values.size(), 2020);
+    for (size_t i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(values[i], static_cast<int64_t>(1990 + i));
+    }
+
+    // Fetches are clipped to the end
+    table = ReadStream(cursor.FetchRows(9995, 100, buffers).ValueOrDie());
+    ASSERT_EQ(table->num_rows(), 5);
+    table = ReadStream(cursor.FetchRows(10000, 100, buffers).ValueOrDie());
+    ASSERT_EQ(table->num_rows(), 0);
+    ASSERT_TRUE(table->schema()->Equals(*schema));
+    ASSERT_FALSE(cursor.FetchRows(10001, 1, buffers).ok());
+}
+
+TEST(ResultCursor, Dictionaries) {
+    io::TempFileSystem fs;
+    io::OutputBufferPool buffers;
+    auto type = arrow::dictionary(arrow::int32(), arrow::int64());
+    auto schema = arrow::schema({arrow::field("v", type)});
+    ResultCursor cursor{fs, CURSOR_FILE, schema};
+    ASSERT_TRUE(cursor.Open().ok());
+
+    // Every batch brings its own dictionary
+    for (int64_t batch = 0; batch < 3; ++batch) {
+        auto dictionary = CreateBatch(arrow::schema({arrow::field("d", arrow::int64())}), batch * 10, 2)->column(0);
+        arrow::Int32Builder indices;
+        ASSERT_TRUE(indices.AppendValues({0, 1, 1, 0}).ok());
+        auto array = arrow::DictionaryArray::FromArrays(type, indices.Finish().ValueOrDie(), dictionary);
+        ASSERT_TRUE(cursor.Append(*arrow::RecordBatch::Make(schema, 4, {array.ValueOrDie()})).ok());
+    }
+    auto table = ReadStream(cursor.FetchRows(3, 6, buffers).ValueOrDie());
+    ASSERT_EQ(table->num_rows(), 6);
+    auto first = std::static_pointer_cast<arrow::DictionaryArray>(table->column(0)->chunk(0));
+    auto second = std::static_pointer_cast<arrow::DictionaryArray>(table->column(0)->chunk(1));
+    ASSERT_EQ(std::static_pointer_cast<arrow::Int64Array>(first->dictionary())->Value(first->GetValueIndex(0)), 0);
+    ASSERT_EQ(std::static_pointer_cast<arrow::Int64Array>(second->dictionary())->Value(second->GetValueIndex(0)), 10);
+}
+
+TEST(ResultCursor, RemoveFile) {
+    io::TempFileSystem fs;
+    auto schema = arrow::schema({arrow::field("v", arrow::int64())});
+    {
+        ResultCursor cursor{fs, CURSOR_FILE, schema};
+        ASSERT_TRUE(cursor.Open().ok());
+        ASSERT_TRUE(cursor.Append(*CreateBatch(schema, 0, 100000)).ok());
+        ASSERT_TRUE(fs.FileExists(CURSOR_FILE));
+        ASSERT_GT(cursor.file_size(), 0);
+    }
+    ASSERT_FALSE(fs.FileExists(CURSOR_FILE));
+}
+
+}  // namespace
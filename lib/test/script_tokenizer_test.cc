@@ -0,0 +1,100 @@
+#include "duckdb/web/script_tokenizer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace duckdb::web;
+
+namespace {
+
+struct TokenUpdate {
+    uint32_t index;
+    uint32_t removed;
+    std::vector<uint32_t> offsets;
+    std::vector<uint8_t> types;
+    int32_t shift;
+};
+
+TokenUpdate DecodeUpdate(const arrow::Buffer& buffer) {
+    uint32_t header[4];
+    std::memcpy(header, buffer.data(), sizeof(header));
+    TokenUpdate update{header[0], header[1], std::vector<uint32_t>(header[2]), std::vector<uint8_t>(header[2]),
+                       static_cast<int32_t>(header[3])};
+    std::memcpy(update.offsets.data(), buffer.data() + sizeof(header), header[2] * sizeof(uint32_t));
+    std::memcpy(update.types.data(), buffer.data() + sizeof(header) + header[2] * sizeof(uint32_t), header[2]);
+    return update;
+}
+
+void ExpectFullTokenization(ScriptTokenizer& tokenizer) {
+    ScriptTokenizer full;
+    full.Tokenize(tokenizer.text());
+    ASSERT_EQ(tokenizer.tokens().offsets, full.tokens().offsets) << tokenizer.text();
+    ASSERT_EQ(tokenizer.tokens().types, full.tokens().types) << tokenizer.text();
+}
+
+TEST(ScriptTokenizer, Tokenize) {
+    ScriptTokenizer tokenizer;
+    auto update = DecodeUpdate(*tokenizer.Tokenize("SELECT * FROM region"));
+    ASSERT_EQ(update.index, 0);
+    ASSERT_EQ(update.removed, 0);
+    ASSERT_EQ(update.offsets, (std::vector<uint32_t>{0, 7, 9, 14}));
+    ASSERT_EQ(update.types, (std::vector<uint8_t>{4, 3, 4, 0}));
+    ASSERT_EQ(update.shift, 0);
+
+    // A new script replaces all tokens
+    update = DecodeUpdate(*tokenizer.Tokenize("SELECT 1"));
+    ASSERT_EQ(update.removed, 4);
+    ASSERT_EQ(update.offsets, (std::vector<uint32_t>{0, 7}));
+}
+
+TEST(ScriptTokenizer, Edits) {
+    ScriptTokenizer tokenizer;
+    tokenizer.Tokenize("SELECT a, b FROM foo WHERE c = 'x' -- comment\nAND d = 1;");
+    struct Edit {
+        size_t offset;
+        size_t removed;
+        std::string_view inserted;
+    };
+    std::vector<Edit> edits{
+        {7, 1, "aa"},           // Extend an identifier
+        {0, 0, "\n"},           // Insert before the first token
+        {28, 0, "'"},           // Open a string
+        {28, 1, ""},            // Close it again
+        {37, 0, "-"},           // Merge an operator with a comment
+        {0, 6, "WITH x AS"},    // Replace a keyword
+        {20, 0, "/* abc */"},   // Insert a block comment
+        {5, 3, ""},             // Delete across tokens
+    };
+    for (auto& edit : edits) {
+        auto offset = std::min(edit.offset, tokenizer.text().size());
+        auto removed = std::min(edit.removed, tokenizer.text().size() - offset);
+        ASSERT_TRUE(tokenizer.Retokenize(offset, removed, edit.inserted).ok());
+        ExpectFullTokenization(tokenizer);
+    }
+    ASSERT_FALSE(tokenizer.Retokenize(tokenizer.text().size() + 1, 0, "x").ok());
+}
+
+TEST(ScriptTokenizer, LocalEdits) {
+    std::string script;
+    for (size_t i = 0; i < 1000; ++i) {
+        script += "SELECT a" + std::to_string(i) + ", 'text' FROM table" + std::to_string(i) + ";\n";
+    }
+    ScriptTokenizer tokenizer;
+    auto full = DecodeUpdate(*tokenizer.Tokenize(script));
+    ASSERT_EQ(full.offsets.size(), 7000);
+
+    // Typing in the middle only tokenizes the surrounding tokens
+    auto offset = script.size() / 2;
+    for (auto c : std::string_view{"bc, 42"}) {
+        auto update = DecodeUpdate(*tokenizer.Retokenize(offset++, 0, std::string_view{&c, 1}).ValueOrDie());
+        ASSERT_LT(update.offsets.size(), 10);
+        ASSERT_LT(update.removed, 10);
+        ASSERT_EQ(update.shift, 1);
+    }
+    ExpectFullTokenization(tokenizer);
+}
+
+}  // namespace
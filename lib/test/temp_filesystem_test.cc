@@ -0,0 +1,204 @@
+#include "duckdb/web/io/temp_filesystem.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/web/webdb.h"
+
+using namespace duckdb::web;
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr auto TEMP_FILE = "tmp://duckdb/test.block";
+constexpr auto FLAGS_CREATE = duckdb::FileFlags::FILE_FLAGS_READ | duckdb::FileFlags::FILE_FLAGS_WRITE |
+                              duckdb::FileFlags::FILE_FLAGS_FILE_CREATE;
+
+std::vector<uint64_t> CreateIntegers(size_t n) {
+    std::vector<uint64_t> values(n);
+    for (size_t i = 0; i < n; ++i) values[i] = i;
+    return values;
+}
+
+std::vector<uint64_t> CreateRandom(size_t n) {
+    std::mt19937_64 rng{42};
+    std::vector<uint64_t> values(n);
+    for (auto& v : values) v = rng();
+    return values;
+}
+
+fs::path GetOverflowPath() {
+    auto tmp = fs::current_path() / ".tmp";
+    if (!fs::is_directory(tmp) || !fs::exists(tmp)) fs::create_directory(tmp);
+    return tmp / "test_temp_overflow";
+}
+
+TEST(TempFileSystemTest, RoundTrip) {
+    io::TempFileSystem temp_fs;
+    auto values = CreateIntegers(3 * io::TempFileSystem::SEGMENT_SIZE / sizeof(uint64_t) + 17);
+    auto bytes = values.size() * sizeof(uint64_t);
+    {
+        auto file = temp_fs.OpenFile(TEMP_FILE, FLAGS_CREATE, duckdb::FileLockType::NO_LOCK,
+                                     duckdb::FileCompressionType::UNCOMPRESSED);
+        file->Write(values.data(), bytes, 0);
+        ASSERT_EQ(file->GetFileSize(), bytes);
+    }
+
+    // Closed files are compressed
+    ASSERT_LT(temp_fs.GetMemoryUsage(), bytes / 2);
+
+    // Read the file with an unaligned offset
+    std::vector<uint64_t> have(values.size() - 1);
+    auto file = temp_fs.OpenFile(TEMP_FILE, duckdb::FileFlags::FILE_FLAGS_READ, duckdb::FileLockType::NO_LOCK,
+                                 duckdb::FileCompressionType::UNCOMPRESSED);
+    file->Read(have.data(), have.size() * sizeof(uint64_t), sizeof(uint64_t));
+    ASSERT_TRUE(std::equal(have.begin(), have.end(), values.begin() + 1));
+    ASSERT_THROW(file->Read(have.data(), 16, bytes - 8), duckdb::IOException);
+
+    // Truncated bytes read as zeros after growing the file again
+    temp_fs.Truncate(*file, 12);
+    uint64_t tail = 0xFF;
+    file->Write(&tail, sizeof(tail), 24);
+    std::vector<uint64_t> prefix(4);
+    file->Read(prefix.data(), 32, 0);
+    ASSERT_EQ(prefix[1], 1);
+    ASSERT_EQ(prefix[2], 0);
+    ASSERT_EQ(prefix[3], 0xFF);
+
+    // Removed files are released with their last handle
+    temp_fs.RemoveFile(TEMP_FILE);
+    ASSERT_FALSE(temp_fs.FileExists(TEMP_FILE));
+    ASSERT_GT(temp_fs.GetMemoryUsage(), 0);
+    file.reset();
+    ASSERT_EQ(temp_fs.GetMemoryUsage(), 0);
+}
+
+TEST(TempFileSystemTest, Directory) {
+    io::TempFileSystem temp_fs;
+    ASSERT_TRUE(temp_fs.DirectoryExists("tmp://duckdb"));
+    ASSERT_FALSE(temp_fs.DirectoryExists("tmp://duckdbx"));
+    for (auto name : {"tmp://duckdb/1.block", "tmp://duckdb/2.block"}) {
+        auto file = temp_fs.OpenFile(name, FLAGS_CREATE, duckdb::FileLockType::NO_LOCK,
+                                     duckdb::FileCompressionType::UNCOMPRESSED);
+        uint64_t value = 42;
+        file->Write(&value, sizeof(value), 0);
+    }
+    ASSERT_THROW(temp_fs.OpenFile("tmp://duckdb/3.block", duckdb::FileFlags::FILE_FLAGS_READ,
+                                  duckdb::FileLockType::NO_LOCK, duckdb::FileCompressionType::UNCOMPRESSED),
+                 duckdb::IOException);
+
+    std::vector<std::string> names;
+    temp_fs.ListFiles("tmp://duckdb", [&](std::string name, bool is_dir) { names.push_back(name); });
+    std::sort(names.begin(), names.end());
+    ASSERT_EQ(names, (std::vector<std::string>{"1.block", "2.block"}));
+
+    temp_fs.MoveFile("tmp://duckdb/1.block", "tmp://duckdb/3.block");
+    ASSERT_FALSE(temp_fs.FileExists("tmp://duckdb/1.block"));
+    ASSERT_TRUE(temp_fs.FileExists("tmp://duckdb/3.block"));
+
+    temp_fs.RemoveDirectory("tmp://duckdb");
+    ASSERT_FALSE(temp_fs.FileExists("tmp://duckdb/2.block"));
+    ASSERT_FALSE(temp_fs.FileExists("tmp://duckdb/3.block"));
+    ASSERT_EQ(temp_fs.GetMemoryUsage(), 0);
+}
+
+TEST(TempFileSystemTest, BudgetExhausted) {
+    io::TempFileSystem temp_fs{io::TempFileSystem::SEGMENT_SIZE};
+    auto values = CreateRandom(4 * io::TempFileSystem::SEGMENT_SIZE / sizeof(uint64_t));
+    auto file = temp_fs.OpenFile(TEMP_FILE, FLAGS_CREATE, duckdb::FileLockType::NO_LOCK,
+                                 duckdb::FileCompressionType::UNCOMPRESSED);
+    ASSERT_THROW(file->Write(values.data(), values.size() * sizeof(uint64_t), 0), duckdb::IOException);
+}
+
+TEST(TempFileSystemTest, Overflow) {
+    auto local_fs = duckdb::FileSystem::CreateLocal();
+    auto overflow_path = GetOverflowPath();
+    auto budget = io::TempFileSystem::SEGMENT_SIZE;
+    auto values = CreateRandom(4 * io::TempFileSystem::SEGMENT_SIZE / sizeof(uint64_t));
+    auto bytes = values.size() * sizeof(uint64_t);
+    {
+        io::TempFileSystem temp_fs{budget, local_fs.get(), overflow_path.string()};
+        {
+            auto file = temp_fs.OpenFile(TEMP_FILE, FLAGS_CREATE, duckdb::FileLockType::NO_LOCK,
+                                         duckdb::FileCompressionType::UNCOMPRESSED);
+            file->Write(values.data(), bytes, 0);
+        }
+        ASSERT_LE(temp_fs.GetMemoryUsage(), budget);
+        ASSERT_GT(temp_fs.GetOverflowSize(), 0);
+
+        // Spilled segments are read back from the overflow file
+        std::vector<uint64_t> have(values.size());
+        auto file = temp_fs.OpenFile(TEMP_FILE, duckdb::FileFlags::FILE_FLAGS_READ, duckdb::FileLockType::NO_LOCK,
+                                     duckdb::FileCompressionType::UNCOMPRESSED);
+        file->Read(have.data(), bytes, 0);
+        ASSERT_EQ(have, values);
+        file.reset();
+
+        // Reclaiming moves the resident segments to the overflow file
+        ASSERT_GT(temp_fs.ReclaimMemory(bytes), 0);
+        ASSERT_EQ(temp_fs.GetMemoryUsage(), 0);
+
+        // The overflow file is reused once it is empty
+        temp_fs.RemoveFile(TEMP_FILE);
+        ASSERT_EQ(temp_fs.GetOverflowSize(), 0);
+    }
+    ASSERT_FALSE(fs::exists(overflow_path));
+}
+
+TEST(TempFileSystemTest, OverflowReuse) {
+    auto local_fs = duckdb::FileSystem::CreateLocal();
+    auto overflow_path = GetOverflowPath();
+    auto budget = io::TempFileSystem::SEGMENT_SIZE;
+    auto values = CreateRandom(4 * io::TempFileSystem::SEGMENT_SIZE / sizeof(uint64_t));
+    auto bytes = values.size() * sizeof(uint64_t);
+    io::TempFileSystem temp_fs{budget, local_fs.get(), overflow_path.string()};
+
+    // Keep a spilled file alive while another one is rewritten
+    auto pinned = temp_fs.OpenFile("tmp://duckdb/pinned.block", FLAGS_CREATE, duckdb::FileLockType::NO_LOCK,
+                                   duckdb::FileCompressionType::UNCOMPRESSED);
+    pinned->Write(values.data(), bytes, 0);
+    for (size_t round = 0; round < 10; ++round) {
+        auto file = temp_fs.OpenFile(TEMP_FILE, FLAGS_CREATE, duckdb::FileLockType::NO_LOCK,
+                                     duckdb::FileCompressionType::UNCOMPRESSED);
+        std::rotate(values.begin(), values.begin() + 1, values.end());
+        file->Write(values.data(), bytes, 0);
+        file.reset();
+        std::vector<uint64_t> have(values.size());
+        file = temp_fs.OpenFile(TEMP_FILE, duckdb::FileFlags::FILE_FLAGS_READ, duckdb::FileLockType::NO_LOCK,
+                                duckdb::FileCompressionType::UNCOMPRESSED);
+        file->Read(have.data(), bytes, 0);
+        ASSERT_EQ(have, values);
+    }
+
+    // Rewritten segments reuse the space of their predecessors
+    ASSERT_LE(temp_fs.GetOverflowSize(), 3 * bytes);
+    temp_fs.RemoveFile(TEMP_FILE);
+    ASSERT_LE(temp_fs.GetOverflowSize(), bytes);
+    pinned.reset();
+    temp_fs.RemoveFile("tmp://duckdb/pinned.block");
+    ASSERT_EQ(temp_fs.GetOverflowSize(), 0);
+    ASSERT_EQ(temp_fs.GetOverflowFreeBytes(), 0);
+}
+
+TEST(TempFileSystemTest, ExternalSort) {
+    auto db = std::make_shared<WebDB>(NATIVE);
+    WebDB::Connection conn{*db};
+    ASSERT_TRUE(conn.RunQuery("PRAGMA memory_limit='32MB'").ok());
+    auto sorted = conn.RunQuery(
+        "CREATE TABLE sorted AS SELECT range::VARCHAR || 'x' AS v FROM range(0, 4000000) ORDER BY v DESC");
+    ASSERT_TRUE(sorted.ok()) << sorted.status().message();
+    auto result = conn.RunQuery("SELECT count(*) FROM sorted");
+    ASSERT_TRUE(result.ok()) << result.status().message();
+    ASSERT_EQ(db->temp_filesystem().GetMemoryUsage(), 0);
+}
+
+}  // namespace
@@ -1,5 +1,13 @@
+#include <condition_variable>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
+#include <limits>
+#include <mutex>
 #include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "duckdb/common/types/date.hpp"
 #include "duckdb/common/types/timestamp.hpp"
@@ -66,4 +74,353 @@ TEST(WebFileSystemTest, TestExport) {
     ASSERT_TRUE(result.ok()) << result.status().message();
 }
 
+std::filesystem::path CreateTestFile(std::string_view name) {
+    auto cwd = fs::current_path();
+    auto tmp = cwd / ".tmp";
+    auto file = tmp / name;
+    if (!fs::is_directory(tmp) || !fs::exists(tmp)) fs::create_directory(tmp);
+    if (fs::exists(file)) fs::remove(file);
+    std::ofstream output(file);
+    return file;
+}
+
+TEST(WebFileSystemTest, SyncWithoutWrites) {
+    auto config = std::make_shared<WebDBConfig>();
+    io::WebFileSystem webfs{config};
+    auto path = CreateTestFile("webfs_sync_clean");
+    auto flags = duckdb::FileFlags::FILE_FLAGS_READ | duckdb::FileFlags::FILE_FLAGS_WRITE;
+    auto handle = webfs.OpenFile(path.string(), flags, duckdb::FileLockType::NO_LOCK,
+                                 duckdb::FileCompressionType::UNCOMPRESSED);
+
+    // Nothing was written, the runtime must not be called
+    auto before = io::WebFileSystem::GetNativeRuntimeSyncCount();
+    webfs.FileSync(*handle);
+    webfs.FileSync(*handle);
+    ASSERT_EQ(io::WebFileSystem::GetNativeRuntimeSyncCount(), before);
+
+    // A write makes the file dirty again, a second sync is absorbed
+    std::vector<char> data(64, 'a');
+    handle->Write(data.data(), data.size());
+    webfs.FileSync(*handle);
+    ASSERT_EQ(io::WebFileSystem::GetNativeRuntimeSyncCount(), before + 1);
+    webfs.FileSync(*handle);
+    ASSERT_EQ(io::WebFileSystem::GetNativeRuntimeSyncCount(), before + 1);
+}
+
+TEST(WebFileSystemTest, GroupCommitSyncs) {
+    auto config = std::make_shared<WebDBConfig>();
+    config->filesystem.sync_window_micros = 50000;
+    io::WebFileSystem webfs{config};
+    auto path = CreateTestFile("webfs_group_commit");
+    auto flags = duckdb::FileFlags::FILE_FLAGS_READ | duckdb::FileFlags::FILE_FLAGS_WRITE;
+
+    constexpr size_t THREAD_COUNT = 8;
+    constexpr size_t CHUNK_SIZE = 1024;
+    std::vector<std::unique_ptr<duckdb::FileHandle>> handles;
+    for (size_t i = 0; i < THREAD_COUNT; ++i) {
+        handles.push_back(webfs.OpenFile(path.string(), flags, duckdb::FileLockType::NO_LOCK,
+                                         duckdb::FileCompressionType::UNCOMPRESSED));
+    }
+
+    // Every thread writes its own chunk and syncs it once all threads have written.
+    // The first sync covers all writes, no matter how the syncs interleave.
+    auto before = io::WebFileSystem::GetNativeRuntimeSyncCount();
+    std::mutex barrier_mutex;
+    std::condition_variable barrier_cv;
+    size_t written = 0;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < THREAD_COUNT; ++i) {
+        threads.emplace_back([&, i]() {
+            std::vector<char> data(CHUNK_SIZE, static_cast<char>('a' + i));
+            handles[i]->Seek(i * CHUNK_SIZE);
+            handles[i]->Write(data.data(), data.size());
+            {
+                std::unique_lock<std::mutex> barrier_guard{barrier_mutex};
+                if (++written == THREAD_COUNT) barrier_cv.notify_all();
+                barrier_cv.wait(barrier_guard, [&]() { return written == THREAD_COUNT; });
+            }
+            webfs.FileSync(*handles[i]);
+        });
+    }
+    for (auto& t : threads) t.join();
+    ASSERT_EQ(io::WebFileSystem::GetNativeRuntimeSyncCount() - before, 1);
+
+    // All chunks must have reached the file
+    handles.clear();
+    std::ifstream in{path, std::ios::binary};
+    std::vector<char> contents{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    ASSERT_EQ(contents.size(), THREAD_COUNT * CHUNK_SIZE);
+    for (size_t i = 0; i < THREAD_COUNT; ++i) {
+        ASSERT_EQ(contents[i * CHUNK_SIZE], static_cast<char>('a' + i));
+        ASSERT_EQ(contents[(i + 1) * CHUNK_SIZE - 1], static_cast<char>('a' + i));
+    }
+}
+
+TEST(WebFileSystemTest, SpeculativeTail) {
+    auto config = std::make_shared<WebDBConfig>();
+    config->filesystem.speculative_tail_size = 4096;
+    io::WebFileSystem webfs{config};
+    auto path = CreateTestFile("webfs_speculative_tail");
+    std::vector<char> data(64 << 10);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<char>(i * 7);
+    {
+        std::ofstream output(path, std::ios::binary);
+        output.write(data.data(), data.size());
+    }
+    auto handle = webfs.OpenFile(path.string(), duckdb::FileFlags::FILE_FLAGS_READ, duckdb::FileLockType::NO_LOCK,
+                                 duckdb::FileCompressionType::UNCOMPRESSED);
+
+    // Reads in the tail do not reach the runtime
+    auto before = io::WebFileSystem::GetNativeRuntimeReadCount();
+    std::vector<char> buffer(1024);
+    handle->Read(buffer.data(), 8, data.size() - 8);
+    ASSERT_EQ(std::memcmp(buffer.data(), data.data() + data.size() - 8, 8), 0);
+    handle->Read(buffer.data(), 1024, data.size() - 4096);
+    ASSERT_EQ(std::memcmp(buffer.data(), data.data() + data.size() - 4096, 1024), 0);
+    ASSERT_EQ(io::WebFileSystem::GetNativeRuntimeReadCount(), before);
+
+    // Reads before the tail do
+    handle->Read(buffer.data(), 1024, 0);
+    ASSERT_EQ(std::memcmp(buffer.data(), data.data(), 1024), 0);
+    ASSERT_EQ(io::WebFileSystem::GetNativeRuntimeReadCount(), before + 1);
+
+    // Opening the file for writing drops the tail
+    auto flags = duckdb::FileFlags::FILE_FLAGS_READ | duckdb::FileFlags::FILE_FLAGS_WRITE;
+    auto writer = webfs.OpenFile(path.string(), flags, duckdb::FileLockType::NO_LOCK,
+                                 duckdb::FileCompressionType::UNCOMPRESSED);
+    handle->Read(buffer.data(), 8, data.size() - 8);
+    ASSERT_EQ(std::memcmp(buffer.data(), data.data() + data.size() - 8, 8), 0);
+    ASSERT_EQ(io::WebFileSystem::GetNativeRuntimeReadCount(), before + 2);
+
+    // Writes and truncation are visible to all handles
+    std::vector<char> update(8, 'x');
+    writer->Write(update.data(), update.size(), data.size() - 8);
+    handle->Read(buffer.data(), 8, data.size() - 8);
+    ASSERT_EQ(std::memcmp(buffer.data(), update.data(), 8), 0);
+    webfs.Truncate(*writer, data.size() - 4096);
+    ASSERT_EQ(handle->GetFileSize(), data.size() - 4096);
+    handle->Read(buffer.data(), 8, data.size() - 4096 - 8);
+    ASSERT_EQ(std::memcmp(buffer.data(), data.data() + data.size() - 4096 - 8, 8), 0);
+    ASSERT_EQ(io::WebFileSystem::GetNativeRuntimeReadCount(), before + 4);
+
+    // Reopening the file read-only does not fetch the tail again
+    handle.reset();
+    handle = webfs.OpenFile(path.string(), duckdb::FileFlags::FILE_FLAGS_READ, duckdb::FileLockType::NO_LOCK,
+                            duckdb::FileCompressionType::UNCOMPRESSED);
+    handle->Read(buffer.data(), 8, data.size() - 4096 - 8);
+    ASSERT_EQ(io::WebFileSystem::GetNativeRuntimeReadCount(), before + 5);
+}
+
+TEST(WebFileSystemTest, SpeculativeTailReclaim) {
+    auto config = std::make_shared<WebDBConfig>();
+    config->filesystem.speculative_tail_size = 4096;
+    io::WebFileSystem webfs{config};
+    auto path = CreateTestFile("webfs_speculative_tail_reclaim");
+    std::vector<char> data(64 << 10, 'a');
+    {
+        std::ofstream output(path, std::ios::binary);
+        output.write(data.data(), data.size());
+    }
+    auto usage = webfs.GetMemoryUsage();
+    auto handle = webfs.OpenFile(path.string(), duckdb::FileFlags::FILE_FLAGS_READ, duckdb::FileLockType::NO_LOCK,
+                                 duckdb::FileCompressionType::UNCOMPRESSED);
+
+    // The tail is accounted as filesystem memory
+    ASSERT_EQ(webfs.GetMemoryUsage(), usage + 4096);
+
+    // Reopening the file keeps the tail
+    auto second = webfs.OpenFile(path.string(), duckdb::FileFlags::FILE_FLAGS_READ, duckdb::FileLockType::NO_LOCK,
+                                 duckdb::FileCompressionType::UNCOMPRESSED);
+    ASSERT_EQ(webfs.GetMemoryUsage(), usage + 4096);
+
+    // Reclaiming memory drops it, reads in the tail reach the runtime again
+    ASSERT_GE(webfs.ReclaimMemory(std::numeric_limits<size_t>::max()), 4096);
+    ASSERT_EQ(webfs.GetMemoryUsage(), 0);
+    auto before = io::WebFileSystem::GetNativeRuntimeReadCount();
+    std::vector<char> buffer(8);
+    handle->Read(buffer.data(), 8, data.size() - 8);
+    ASSERT_EQ(std::memcmp(buffer.data(), data.data() + data.size() - 8, 8), 0);
+    ASSERT_EQ(io::WebFileSystem::GetNativeRuntimeReadCount(), before + 1);
+}
+
+std::string ReadWriteArgs(const std::filesystem::path& path) {
+    return std::string{"{\"path\":\""} + path.string() + "\",\"accessMode\":3}";
+}
+
+TEST(WebFileSystemTest, ReadWritePersistence) {
+    auto db = std::make_shared<WebDB>(WEB);
+    auto path = fs::current_path() / ".tmp" / "webfs_rw.db";
+    fs::create_directories(path.parent_path());
+    fs::remove(path);
+    fs::remove(path.string() + ".wal");
+
+    // Create the database and write some data
+    ASSERT_TRUE(db->Open(ReadWriteArgs(path)).ok());
+    {
+        WebDB::Connection conn{*db};
+        ASSERT_TRUE(conn.RunQuery("CREATE TABLE foo AS (SELECT * FROM generate_series(1, 10000) t(v))").ok());
+        ASSERT_TRUE(conn.RunQuery("INSERT INTO foo VALUES (42)").ok());
+        ASSERT_TRUE(conn.RunQuery("CHECKPOINT").ok());
+        ASSERT_TRUE(conn.RunQuery("DELETE FROM foo WHERE v <= 100").ok());
+    }
+
+    // Reopen the database and check the contents
+    ASSERT_TRUE(db->Open().ok());
+    ASSERT_TRUE(db->Open(ReadWriteArgs(path)).ok());
+    WebDB::Connection conn{*db};
+    auto result = conn.connection().Query("SELECT count(*)::INTEGER, sum(v)::BIGINT FROM foo");
+    ASSERT_TRUE(result->success) << result->error;
+    ASSERT_EQ(result->GetValue(0, 0).GetValue<int32_t>(), 9901);
+    ASSERT_EQ(result->GetValue(1, 0).GetValue<int64_t>(), 50005000 - 5050 + 42);
+}
+
+TEST(WebFileSystemTest, ReadWriteWALRecovery) {
+    auto db = std::make_shared<WebDB>(WEB);
+    auto tmp = fs::current_path() / ".tmp";
+    auto path = tmp / "webfs_wal.db";
+    auto crashed = tmp / "webfs_wal_crashed.db";
+    fs::create_directories(tmp);
+    for (auto& p : {path, crashed}) {
+        fs::remove(p);
+        fs::remove(p.string() + ".wal");
+    }
+
+    // Commit some transactions that only reach the WAL
+    ASSERT_TRUE(db->Open(ReadWriteArgs(path)).ok());
+    {
+        WebDB::Connection conn{*db};
+        ASSERT_TRUE(conn.RunQuery("CREATE TABLE foo (v INTEGER)").ok());
+        for (int i = 0; i < 10; ++i) {
+            ASSERT_TRUE(conn.RunQuery("INSERT INTO foo VALUES (" + std::to_string(i) + ")").ok());
+        }
+    }
+
+    // Simulate a crash by copying the files of the open database.
+    // Every commit was synced, so the copy must recover all rows.
+    fs::copy_file(path, crashed);
+    ASSERT_TRUE(fs::exists(path.string() + ".wal"));
+    fs::copy_file(path.string() + ".wal", crashed.string() + ".wal");
+
+    ASSERT_TRUE(db->Open(ReadWriteArgs(crashed)).ok());
+    WebDB::Connection conn{*db};
+    auto result = conn.connection().Query("SELECT count(*)::INTEGER, sum(v)::INTEGER FROM foo");
+    ASSERT_TRUE(result->success) << result->error;
+    ASSERT_EQ(result->GetValue(0, 0).GetValue<int32_t>(), 10);
+    ASSERT_EQ(result->GetValue(1, 0).GetValue<int32_t>(), 45);
+}
+
+TEST(WebFileSystemTest, ReadWriteRejectsHTTP) {
+    auto db = std::make_shared<WebDB>(WEB);
+    auto status = db->Open(R"JSON({"path":"https://example.com/remote.db","accessMode":3})JSON");
+    ASSERT_FALSE(status.ok());
+}
+
+TEST(WebFileSystemTest, ReadWriteOpenFailureKeepsDatabase) {
+    auto db = std::make_shared<WebDB>(WEB);
+    auto tmp = fs::current_path() / ".tmp";
+    auto path = tmp / "webfs_rw_keep.db";
+    auto corrupt = tmp / "webfs_rw_corrupt.db";
+    fs::create_directories(tmp);
+    for (auto& p : {path, corrupt}) {
+        fs::remove(p);
+        fs::remove(p.string() + ".wal");
+    }
+    std::ofstream{corrupt} << std::string(10000, 'x');
+
+    ASSERT_TRUE(db->Open(ReadWriteArgs(path)).ok());
+    auto* conn = db->Connect();
+    ASSERT_TRUE(conn->RunQuery("CREATE TABLE foo AS (SELECT * FROM generate_series(1, 100) t(v))").ok());
+
+    // Failed opens keep the current database and its connections
+    ASSERT_FALSE(db->Open(ReadWriteArgs(corrupt)).ok());
+    ASSERT_FALSE(db->Open(R"JSON({"path":"https://example.com/remote.db","accessMode":3})JSON").ok());
+    ASSERT_FALSE(db->GetVersion().empty());
+    auto result = conn->connection().Query("SELECT sum(v)::INTEGER FROM foo");
+    ASSERT_TRUE(result->success) << result->error;
+    ASSERT_EQ(result->GetValue(0, 0).GetValue<int32_t>(), 5050);
+    auto* other = db->Connect();
+    ASSERT_TRUE(other->RunQuery("INSERT INTO foo VALUES (1)").ok());
+    db->Disconnect(other);
+    db->Disconnect(conn);
+}
+
+/// Encode a batch of file URLs
+std::string EncodeFileURLs(const std::vector<std::pair<std::string, std::string>>& files) {
+    std::string batch;
+    auto append = [&](auto value) { batch.append(reinterpret_cast<const char*>(&value), sizeof(value)); };
+    append(static_cast<uint32_t>(files.size()));
+    for (auto& [name, url] : files) {
+        append(static_cast<uint32_t>(name.size()));
+        append(static_cast<uint32_t>(url.size()));
+        append(std::numeric_limits<uint64_t>::max());
+        batch += name;
+        batch += url;
+    }
+    return batch;
+}
+
+TEST(WebFileSystemTest, DecodeFileURLs) {
+    auto batch = EncodeFileURLs({{"a.parquet", "http://localhost/a.parquet"}, {"b.parquet", "b.parquet"}});
+    auto files = io::WebFileSystem::DecodeFileURLs({batch.data(), batch.size()});
+    ASSERT_TRUE(files.ok()) << files.status().message();
+    ASSERT_EQ(files->size(), 2);
+    ASSERT_EQ((*files)[0].file_name, "a.parquet");
+    ASSERT_EQ((*files)[0].file_url, "http://localhost/a.parquet");
+    ASSERT_FALSE((*files)[0].file_size.has_value());
+    ASSERT_EQ((*files)[1].file_name, "b.parquet");
+    ASSERT_FALSE(io::WebFileSystem::DecodeFileURLs({batch.data(), batch.size() - 1}).ok());
+}
+
+void TestRegisterFileURLs(bool defer_handles) {
+    auto db = std::make_shared<WebDB>(WEB);
+    WebDB::Connection conn{*db};
+    auto data = (test::SOURCE_DIR / ".." / "data" / "uni" / "studenten.parquet").string();
+    std::vector<std::pair<std::string, std::string>> files;
+    for (auto i = 0; i < 3; ++i) {
+        files.push_back({"batch/part" + std::to_string(i) + ".parquet", data});
+    }
+    auto batch = EncodeFileURLs(files);
+    ASSERT_TRUE(db->RegisterFileURLs({batch.data(), batch.size()}, defer_handles).ok());
+
+    // Registering the same batch again replaces the files
+    ASSERT_TRUE(db->RegisterFileURLs({batch.data(), batch.size()}, defer_handles).ok());
+
+    // The files must survive closing the handles of the first scan
+    std::string query = "SELECT count(*)::INTEGER FROM parquet_scan('batch/*.parquet')";
+    for (auto i = 0; i < 2; ++i) {
+        auto result = conn.connection().Query(query);
+        ASSERT_TRUE(result->success) << result->error;
+        ASSERT_EQ(result->GetValue(0, 0).GetValue<int32_t>(), 24);
+    }
+    auto duplicate = EncodeFileURLs({files[2], files[2]});
+    ASSERT_FALSE(db->RegisterFileURLs({duplicate.data(), duplicate.size()}, defer_handles).ok());
+
+    // A rejected batch leaves the registered files untouched
+    auto single = conn.connection().Query("SELECT count(*)::INTEGER FROM parquet_scan('" + files[2].first + "')");
+    ASSERT_TRUE(single->success) << single->error;
+    ASSERT_EQ(single->GetValue(0, 0).GetValue<int32_t>(), 8);
+    ASSERT_TRUE(db->DropFile(files[0].first).ok());
+    auto infos = db->GlobFileInfos("batch/*");
+    ASSERT_TRUE(infos.ok());
+    ASSERT_EQ(infos->find(files[0].first), std::string::npos);
+    ASSERT_NE(infos->find(files[1].first), std::string::npos);
+    ASSERT_NE(infos->find(files[2].first), std::string::npos);
+}
+
+TEST(WebFileSystemTest, GlobEscapedLiteral) {
+    auto db = std::make_shared<WebDB>(WEB);
+    auto data = (test::SOURCE_DIR / ".." / "data" / "uni" / "studenten.parquet").string();
+    ASSERT_TRUE(db->RegisterFileURL("escaped/a*b.parquet", data, std::nullopt).ok());
+    ASSERT_TRUE(db->RegisterFileURL("escaped/axb.parquet", data, std::nullopt).ok());
+
+    // An escaped wildcard only matches the literal name
+    auto files = io::WebFileSystem::Get()->Glob("escaped/a\\*b.parquet");
+    ASSERT_EQ(files, std::vector<std::string>{"escaped/a*b.parquet"});
+    files = io::WebFileSystem::Get()->Glob("escaped/a*b.parquet");
+    ASSERT_EQ(files, (std::vector<std::string>{"escaped/a*b.parquet", "escaped/axb.parquet"}));
+}
+
+TEST(WebFileSystemTest, RegisterFileURLs) { TestRegisterFileURLs(false); }
+TEST(WebFileSystemTest, RegisterFileURLsDeferred) { TestRegisterFileURLs(true); }
+
 }  // namespace
@@ -1,8 +1,12 @@
 #include "duckdb/web/webdb.h"
 
+#include <cstring>
 #include <filesystem>
 #include <sstream>
 
+#include "arrow/array/array_primitive.h"
+#include "arrow/io/memory.h"
+#include "arrow/ipc/reader.h"
 #include "duckdb/common/types/date.hpp"
 #include "duckdb/common/types/timestamp.hpp"
 #include "duckdb/execution/operator/persistent/buffered_csv_reader.hpp"
@@ -72,6 +76,217 @@ TEST(WebDB, PrepareQuery) {
     ASSERT_TRUE(success.ok()) << success.message();
 }
 
+std::shared_ptr<arrow::Table> ReadResultStream(std::shared_ptr<arrow::Buffer> buffer) {
+    arrow::io::BufferReader input{buffer};
+    auto reader = arrow::ipc::RecordBatchStreamReader::Open(&input).ValueOrDie();
+    return reader->ToTable().ValueOrDie();
+}
+
+TEST(WebDB, CompactResults) {
+    auto db = make_shared<WebDB>(NATIVE);
+    WebDB::Connection conn{*db};
+
+    // Small results are returned as IPC stream without file footer
+    auto buffer = conn.RunQuery("SELECT 42::INTEGER AS v");
+    ASSERT_TRUE(buffer.ok()) << buffer.status().message();
+    ASSERT_NE(std::string_view(reinterpret_cast<const char*>((*buffer)->data()), 6), "ARROW1");
+    auto table = ReadResultStream(*buffer);
+    ASSERT_EQ(table->num_rows(), 1);
+    ASSERT_EQ(table->schema()->field(0)->name(), "v");
+
+    // Empty results only consist of the schema
+    buffer = conn.RunQuery("SELECT 42::INTEGER AS v WHERE false");
+    ASSERT_TRUE(buffer.ok()) << buffer.status().message();
+    ASSERT_EQ(ReadResultStream(*buffer)->num_rows(), 0);
+
+    // Prepared statements reuse the schema across executions
+    auto stmt = conn.CreatePreparedStatement("SELECT ?::INTEGER + 5 AS v");
+    ASSERT_TRUE(stmt.ok()) << stmt.status().message();
+    for (auto arg : {"[1]", "[2]"}) {
+        buffer = conn.RunPreparedStatement(*stmt, arg);
+        ASSERT_TRUE(buffer.ok()) << buffer.status().message();
+        ASSERT_EQ(ReadResultStream(*buffer)->num_rows(), 1);
+    }
+    ASSERT_TRUE(conn.ClosePreparedStatement(*stmt).ok());
+
+    // Larger results and disabled compact results are written as IPC file
+    buffer = conn.RunQuery("SELECT v FROM generate_series(0, 9999) t(v)");
+    ASSERT_TRUE(buffer.ok()) << buffer.status().message();
+    ASSERT_EQ(std::string_view(reinterpret_cast<const char*>((*buffer)->data()), 6), "ARROW1");
+    ASSERT_TRUE(db->Open(R"JSON({"compactResultSize": 0})JSON").ok());
+    WebDB::Connection conn2{*db};
+    buffer = conn2.RunQuery("SELECT 42::INTEGER AS v");
+    ASSERT_TRUE(buffer.ok()) << buffer.status().message();
+    ASSERT_EQ(std::string_view(reinterpret_cast<const char*>((*buffer)->data()), 6), "ARROW1");
+}
+
+TEST(WebDB, PlanCache) {
+    auto db = make_shared<WebDB>(NATIVE);
+    WebDB::Connection conn{*db};
+    auto& stats = conn.plan_cache_statistics();
+    ASSERT_TRUE(conn.RunQuery("CREATE TABLE foo AS SELECT v FROM generate_series(0, 99) t(v)").ok());
+
+    // Repeated query texts reuse the plan
+    auto query = "SELECT v FROM foo ORDER BY v LIMIT 1";
+    for (size_t i = 0; i < 3; ++i) {
+        auto buffer = conn.RunQuery(query);
+        ASSERT_TRUE(buffer.ok()) << buffer.status().message();
+        auto table = ReadResultStream(*buffer);
+        ASSERT_EQ(table->num_rows(), 1);
+        ASSERT_EQ(table->schema()->field(0)->type()->id(), arrow::Type::INT64);
+    }
+    ASSERT_EQ(stats.misses, 1);
+    ASSERT_EQ(stats.hits, 2);
+    ASSERT_TRUE(conn.SendQuery(query).ok());
+    ASSERT_EQ(stats.hits, 3);
+
+    // Catalog changes of other connections invalidate the plan
+    WebDB::Connection other{*db};
+    ASSERT_TRUE(other.RunQuery("DROP TABLE foo").ok());
+    ASSERT_TRUE(other.RunQuery("CREATE TABLE foo AS SELECT v::VARCHAR AS v FROM generate_series(0, 9) t(v)").ok());
+    auto buffer = conn.RunQuery(query);
+    ASSERT_TRUE(buffer.ok()) << buffer.status().message();
+    auto table = ReadResultStream(*buffer);
+    ASSERT_EQ(table->num_rows(), 1);
+    ASSERT_EQ(table->schema()->field(0)->type()->id(), arrow::Type::STRING);
+    ASSERT_EQ(stats.misses, 2);
+    ASSERT_EQ(stats.hits, 3);
+    ASSERT_EQ(stats.invalidations, 1);
+
+    // Least recently used plans are evicted
+    ASSERT_TRUE(db->Open(R"JSON({"planCacheSize": 2})JSON").ok());
+    WebDB::Connection small{*db};
+    for (auto text : {"SELECT 1", "SELECT 2", "SELECT 1", "SELECT 3", "SELECT 1", "SELECT 2"}) {
+        ASSERT_TRUE(small.RunQuery(text).ok());
+    }
+    ASSERT_EQ(small.plan_cache_statistics().hits, 2);
+    ASSERT_EQ(small.plan_cache_statistics().evictions, 2);
+
+    // Scripts are not cached
+    ASSERT_TRUE(small.RunQuery("SELECT 1; SELECT 2").ok());
+    ASSERT_TRUE(small.RunQuery("SELECT 1; SELECT 2").ok());
+    ASSERT_EQ(small.plan_cache_statistics().misses, 4);
+}
+
+TEST(WebDB, PlanCacheRegisteredFiles) {
+    auto db = make_shared<WebDB>(WEB);
+    WebDB::Connection conn{*db};
+    auto& stats = conn.plan_cache_statistics();
+    auto dir = fs::current_path() / ".tmp";
+    fs::create_directories(dir);
+    auto first = (dir / "plan_cache_first.parquet").string();
+    auto second = (dir / "plan_cache_second.parquet").string();
+    auto copy = conn.connection().Query("COPY (SELECT 42::BIGINT AS v) TO '" + first + "' (FORMAT PARQUET)");
+    ASSERT_TRUE(copy->success) << copy->error;
+    copy = conn.connection().Query("COPY (SELECT 'a' AS s, 'b' AS t) TO '" + second + "' (FORMAT PARQUET)");
+    ASSERT_TRUE(copy->success) << copy->error;
+
+    // Plans over a registered file are reused
+    auto query = "SELECT * FROM parquet_scan('registered.parquet')";
+    ASSERT_TRUE(db->RegisterFileURL("registered.parquet", first, std::nullopt).ok());
+    for (size_t i = 0; i < 2; ++i) {
+        auto buffer = conn.RunQuery(query);
+        ASSERT_TRUE(buffer.ok()) << buffer.status().message();
+        ASSERT_EQ(ReadResultStream(*buffer)->num_columns(), 1);
+    }
+    ASSERT_EQ(stats.hits, 1);
+
+    // Registering another file under the same name binds the new schema
+    ASSERT_TRUE(db->RegisterFileURL("registered.parquet", second, std::nullopt).ok());
+    auto buffer = conn.RunQuery(query);
+    ASSERT_TRUE(buffer.ok()) << buffer.status().message();
+    auto table = ReadResultStream(*buffer);
+    ASSERT_EQ(table->num_columns(), 2);
+    ASSERT_EQ(table->schema()->field(0)->type()->id(), arrow::Type::STRING);
+    ASSERT_EQ(stats.hits, 1);
+    ASSERT_EQ(stats.invalidations, 1);
+
+    // Dropping the file invalidates the plan as well
+    ASSERT_TRUE(db->DropFile("registered.parquet").ok());
+    ASSERT_FALSE(conn.RunQuery(query).ok());
+    ASSERT_EQ(stats.invalidations, 2);
+}
+
+std::vector<std::pair<uint32_t, std::shared_ptr<arrow::Buffer>>> DecodeBatch(std::shared_ptr<arrow::Buffer> batch) {
+    std::vector<std::pair<uint32_t, std::shared_ptr<arrow::Buffer>>> results;
+    uint32_t count = 0;
+    std::memcpy(&count, batch->data(), sizeof(count));
+    size_t offset = 8;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t header[2];
+        std::memcpy(header, batch->data() + offset, sizeof(header));
+        EXPECT_EQ((offset + 8) % 8, 0);
+        results.push_back({header[0], arrow::SliceBuffer(batch, offset + 8, header[1])});
+        offset += 8 + header[1] + (8 - header[1] % 8) % 8;
+    }
+    EXPECT_EQ(offset, batch->size());
+    return results;
+}
+
+TEST(WebDB, RunBatch) {
+    auto db = make_shared<WebDB>(NATIVE);
+    WebDB::Connection conn{*db};
+    auto batch = conn.RunBatch(R"SQL(
+        CREATE TABLE foo AS SELECT v FROM generate_series(0, 9) t(v);
+        INSERT INTO foo SELECT v FROM generate_series(10, 19) t(v);
+        SELECT count(*)::INTEGER AS c FROM foo;
+        SELECT v FROM foo WHERE v < 3 ORDER BY v;
+    )SQL");
+    ASSERT_TRUE(batch.ok()) << batch.status().message();
+    auto results = DecodeBatch(*batch);
+    ASSERT_EQ(results.size(), 4);
+    for (auto& [code, buffer] : results) {
+        ASSERT_EQ(code, 0);
+    }
+    auto count = ReadResultStream(results[2].second);
+    ASSERT_EQ(std::static_pointer_cast<arrow::Int32Array>(count->column(0)->chunk(0))->Value(0), 20);
+    ASSERT_EQ(ReadResultStream(results[3].second)->num_rows(), 3);
+
+    // Stop at the first failed statement
+    auto script = "SELECT 1; SELECT * FROM missing; SELECT 2";
+    batch = conn.RunBatch(script);
+    ASSERT_TRUE(batch.ok()) << batch.status().message();
+    results = DecodeBatch(*batch);
+    ASSERT_EQ(results.size(), 2);
+    ASSERT_EQ(results[0].first, 0);
+    ASSERT_EQ(results[1].first, static_cast<uint32_t>(arrow::StatusCode::ExecutionError));
+    ASSERT_NE(results[1].second->ToString().find("missing"), std::string::npos);
+
+    // Or continue after errors
+    batch = conn.RunBatch(script, false);
+    ASSERT_TRUE(batch.ok()) << batch.status().message();
+    results = DecodeBatch(*batch);
+    ASSERT_EQ(results.size(), 3);
+    ASSERT_EQ(results[2].first, 0);
+
+    // Parser errors fail the whole batch
+    ASSERT_FALSE(conn.RunBatch("SELECT 1; SELEC 2").ok());
+}
+
+TEST(WebDB, ResultCursor) {
+    auto db = make_shared<WebDB>(NATIVE);
+    WebDB::Connection conn{*db};
+    auto cursor = conn.OpenCursor("SELECT v::INTEGER AS v FROM generate_series(0, 99999) t(v) ORDER BY v");
+    ASSERT_TRUE(cursor.ok()) << cursor.status().message();
+    ASSERT_EQ(*conn.GetCursorRowCount(*cursor), 100000);
+
+    // Fetch rows in arbitrary order
+    for (auto offset : {50000, 0, 99990, 4000}) {
+        auto rows = conn.FetchRows(*cursor, offset, 20);
+        ASSERT_TRUE(rows.ok()) << rows.status().message();
+        auto table = ReadResultStream(*rows);
+        ASSERT_EQ(table->num_rows(), std::min(20, 100000 - offset));
+        ASSERT_EQ(std::static_pointer_cast<arrow::Int32Array>(table->column(0)->chunk(0))->Value(0), offset);
+    }
+
+    // The cursor outlives other queries
+    ASSERT_TRUE(conn.RunQuery("SELECT 1").ok());
+    ASSERT_TRUE(conn.FetchRows(*cursor, 10, 10).ok());
+    ASSERT_TRUE(conn.CloseCursor(*cursor).ok());
+    ASSERT_FALSE(conn.FetchRows(*cursor, 0, 10).ok());
+    ASSERT_FALSE(conn.OpenCursor("SELECT * FROM missing").ok());
+}
+
 TEST(WebDB, Tokenize) {
     auto db = make_shared<WebDB>(NATIVE);
     ASSERT_EQ(db->Tokenize("SELECT 1"), "{\"offsets\":[0,7],\"types\":[4,1]}");
@@ -79,4 +294,91 @@ TEST(WebDB, Tokenize) {
     ASSERT_EQ(db->Tokenize("SELECT * FROM region, nation"), "{\"offsets\":[0,7,9,14,20,22],\"types\":[4,3,4,0,3,0]}");
 }
 
+TEST(WebDB, LazyParquetExtension) {
+    auto db = make_shared<WebDB>(NATIVE);
+    WebDB::Connection conn{*db};
+    auto data = test::SOURCE_DIR / ".." / "data" / "uni" / "studenten.parquet";
+    auto query = "SELECT count(*) FROM parquet_scan('" + data.string() + "')";
+
+    // The extension is loaded by the first query that needs it
+    auto buffer = conn.RunQuery(query);
+    ASSERT_TRUE(buffer.ok()) << buffer.status().message();
+
+    // Raw connections load it eagerly after a reset
+    ASSERT_TRUE(db->Reset().ok());
+    WebDB::Connection conn2{*db};
+    auto raw = conn2.connection().Query(query);
+    ASSERT_TRUE(raw->success) << raw->error;
+}
+
+void TestSnapshotRoundTrip(std::string_view options) {
+    auto db = make_shared<WebDB>(NATIVE);
+    WebDB::Connection conn{*db};
+    ASSERT_TRUE(
+        conn.RunQuery("CREATE TABLE foo AS SELECT v, v::VARCHAR AS s FROM generate_series(0, 99999) t(v)").ok());
+    ASSERT_TRUE(conn.RunQuery("CREATE VIEW bar AS SELECT count(*) AS c FROM foo").ok());
+    // Views on views are replayed after the views they refer to, no matter how the catalog orders them
+    ASSERT_TRUE(conn.RunQuery("CREATE VIEW a AS SELECT c * 2 AS d FROM bar").ok());
+    ASSERT_TRUE(conn.RunQuery("CREATE VIEW baz AS SELECT d + 1 AS e FROM a").ok());
+
+    // Export the in-memory database
+    auto snapshot = db->ExportSnapshot(options);
+    ASSERT_TRUE(snapshot.ok()) << snapshot.status().message();
+    auto size = (*snapshot)->size();
+    std::unique_ptr<char[]> data{new char[size]};
+    std::memcpy(data.get(), (*snapshot)->data(), size);
+
+    // Restore it
+    auto path = CreateTestDB();
+    auto restored = make_shared<WebDB>(NATIVE);
+    auto status = restored->OpenSnapshot(path.string(), std::move(data), size);
+    ASSERT_TRUE(status.ok()) << status.message();
+    WebDB::Connection restored_conn{*restored};
+    auto rows = restored_conn.connection().Query("SELECT sum(v), count(DISTINCT s) FROM foo");
+    ASSERT_TRUE(rows->success) << rows->error;
+    ASSERT_EQ(rows->GetValue(0, 0).ToString(), "4999950000");
+    ASSERT_EQ(rows->GetValue(1, 0).ToString(), "100000");
+    auto view = restored_conn.connection().Query("SELECT c FROM bar");
+    ASSERT_TRUE(view->success) << view->error;
+    ASSERT_EQ(view->GetValue(0, 0).ToString(), "100000");
+    view = restored_conn.connection().Query("SELECT e FROM baz");
+    ASSERT_TRUE(view->success) << view->error;
+    ASSERT_EQ(view->GetValue(0, 0).ToString(), "200001");
+}
+
+TEST(WebDB, SnapshotRoundTrip) { TestSnapshotRoundTrip(""); }
+TEST(WebDB, SnapshotRoundTripCompressed) {
+    TestSnapshotRoundTrip(R"JSON({"compression": "zstd", "chunkSize": 65536})JSON");
+}
+
+TEST(WebDB, SnapshotOpenFailure) {
+    auto db = make_shared<WebDB>(NATIVE);
+    auto* conn = db->Connect();
+    ASSERT_TRUE(conn->RunQuery("CREATE TABLE foo AS SELECT * FROM generate_series(1, 100) t(v)").ok());
+    auto garbage = [](size_t size) {
+        std::unique_ptr<char[]> data{new char[size]};
+        std::memset(data.get(), 'x', size);
+        return data;
+    };
+
+    // A snapshot that cannot be opened keeps the current database and its connections
+    auto path = CreateTestDB();
+    ASSERT_FALSE(db->OpenSnapshot(path.string(), garbage(10000), 10000).ok());
+    auto result = conn->connection().Query("SELECT sum(v)::INTEGER FROM foo");
+    ASSERT_TRUE(result->success) << result->error;
+    ASSERT_EQ(result->GetValue(0, 0).GetValue<int32_t>(), 5050);
+
+    // Replacing the file of the current database leaves a usable database
+    auto snapshot = db->ExportSnapshot("");
+    ASSERT_TRUE(snapshot.ok()) << snapshot.status().message();
+    auto size = (*snapshot)->size();
+    std::unique_ptr<char[]> data{new char[size]};
+    std::memcpy(data.get(), (*snapshot)->data(), size);
+    ASSERT_TRUE(db->OpenSnapshot(path.string(), std::move(data), size).ok());
+    ASSERT_FALSE(db->OpenSnapshot(path.string(), garbage(10000), 10000).ok());
+    ASSERT_FALSE(db->GetVersion().empty());
+    conn = db->Connect();
+    ASSERT_TRUE(conn->RunQuery("SELECT 42").ok());
+}
+
 }  // namespace
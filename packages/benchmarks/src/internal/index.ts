@@ -1,2 +1,3 @@
 export * from './format_benchmark';
 export * from './iterator_benchmark';
+export * from './startup_benchmark';
@@ -0,0 +1,26 @@
+import * as duckdb from '@duckdb/duckdb-wasm/dist/duckdb-esm';
+import Benchmark from 'buffalo-bench/lib';
+
+export function benchmarkStartup(
+    setup: () => Promise<duckdb.DuckDBBindings>,
+    db: () => duckdb.DuckDBBindings,
+): Benchmark[] {
+    return [
+        new Benchmark(`startup_instantiate_first_query`, {
+            fn: async () => {
+                const instance = await setup();
+                const conn = instance.connect();
+                conn.query('SELECT 1');
+                conn.close();
+            },
+        }),
+        new Benchmark(`startup_reset_first_query`, {
+            fn: async () => {
+                db().reset();
+                const conn = db().connect();
+                conn.query('SELECT 1');
+                conn.close();
+            },
+        }),
+    ];
+}
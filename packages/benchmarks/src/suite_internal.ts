@@ -1,4 +1,4 @@
-import { benchmarkFormat, benchmarkIterator, benchmarkIteratorAsync } from './internal';
+import { benchmarkFormat, benchmarkIterator, benchmarkIteratorAsync, benchmarkStartup } from './internal';
 import { runBenchmarks } from './suite';
 import Benchmark from 'buffalo-bench/lib';
 import { setupDuckDBAsync, setupDuckDBSync } from './setup';
@@ -11,6 +11,7 @@ async function main() {
     suite = suite.concat(benchmarkFormat(() => duckdbSync!));
     suite = suite.concat(benchmarkIterator(() => duckdbSync!));
     suite = suite.concat(benchmarkIteratorAsync(() => duckdbAsync!));
+    suite = suite.concat(benchmarkStartup(setupDuckDBSync, () => duckdbSync!));
     await runBenchmarks(suite);
 }
 
@@ -0,0 +1,34 @@
+import * as arrow from 'apache-arrow';
+import { StatusCode } from '../status';
+
+/** The result of a statement in a batch */
+export interface BatchResult<T extends { [key: string]: arrow.DataType } = any> {
+    /** The result table (if the statement succeeded) */
+    table?: arrow.Table<T>;
+    /** The error message (if the statement failed) */
+    error?: string;
+}
+
+/** Decode the results of a batch, see WebDB::Connection::RunBatch for the encoding */
+export function decodeBatchResults(buffer: Uint8Array): BatchResult[] {
+    const view = new DataView(buffer.buffer, buffer.byteOffset, buffer.byteLength);
+    const decoder = new TextDecoder();
+    const count = view.getUint32(0, true);
+    const results: BatchResult[] = [];
+    let ofs = 8;
+    for (let i = 0; i < count; ++i) {
+        const status = view.getUint32(ofs, true);
+        const length = view.getUint32(ofs + 4, true);
+        const data = buffer.subarray(ofs + 8, ofs + 8 + length);
+        if (status == StatusCode.SUCCESS) {
+            const reader = arrow.RecordBatchReader.from(data);
+            console.assert(reader.isSync());
+            results.push({ table: arrow.Table.from(reader) });
+        } else {
+            results.push({ error: decoder.decode(data) });
+        }
+        // Records are padded to 8 bytes
+        ofs += 8 + length + ((8 - (length % 8)) % 8);
+    }
+    return results;
+}
@@ -1,15 +1,19 @@
 import { DuckDBModule, PThread } from './duckdb_module';
-import { DuckDBConfig } from './config';
+import { DuckDBConfig, DuckDBSnapshotOptions } from './config';
 import { Logger } from '../log';
 import { DuckDBBindings } from './bindings_interface';
 import { DuckDBConnection } from './connection';
 import { StatusCode } from '../status';
 import { dropResponseBuffers, DuckDBRuntime, readString, callSRet, copyBuffer } from './runtime';
 import { CSVInsertOptions, JSONInsertOptions, ArrowInsertOptions } from './insert_options';
-import { ScriptTokens } from './tokens';
+import { ScriptTokens, ScriptTokenUpdate, decodeScriptTokenUpdate } from './tokens';
+import { CursorInfo } from './cursor_info';
+import { IncrementalViewDefinition } from './incremental_view';
 import { FileStatistics } from './file_stats';
 import { flattenArrowField } from '../flat_arrow';
-import { WebFile } from './web_file';
+import { WebFile, WebFileURL, encodeWebFileURLs } from './web_file';
+import { WarmUpProgress, WarmUpTarget } from './warm_up';
+import { MemoryInfo } from './memory_info';
 
 const TEXT_ENCODER = new TextEncoder();
 
@@ -132,6 +136,31 @@ export abstract class DuckDBBindingsBase implements DuckDBBindings {
         dropResponseBuffers(this.mod);
         return JSON.parse(res) as ScriptTokens;
     }
+    /** Tokenize a script into packed tokens, the script is kept for `retokenize` */
+    public tokenizeBinary(text: string): ScriptTokenUpdate {
+        const [s, d, n] = callSRet(this.mod, 'duckdb_web_tokenize_binary', ['string'], [text]);
+        if (s !== StatusCode.SUCCESS) {
+            throw new Error(readString(this.mod, d, n));
+        }
+        const res = copyBuffer(this.mod, d, n);
+        dropResponseBuffers(this.mod);
+        return decodeScriptTokenUpdate(res);
+    }
+    /** Replace `removed` UTF-8 bytes at `offset` of the last tokenized script and tokenize the edit */
+    public retokenize(offset: number, removed: number, inserted: string): ScriptTokenUpdate {
+        const [s, d, n] = callSRet(
+            this.mod,
+            'duckdb_web_tokenize_edit',
+            ['number', 'number', 'string'],
+            [offset, removed, inserted],
+        );
+        if (s !== StatusCode.SUCCESS) {
+            throw new Error(readString(this.mod, d, n));
+        }
+        const res = copyBuffer(this.mod, d, n);
+        dropResponseBuffers(this.mod);
+        return decodeScriptTokenUpdate(res);
+    }
 
     /** Connect to database */
     public connect(): DuckDBConnection {
@@ -153,6 +182,59 @@ export abstract class DuckDBBindingsBase implements DuckDBBindings {
         dropResponseBuffers(this.mod);
         return res;
     }
+    /** Run all statements of a script and return the encoded results */
+    public runBatch(conn: number, text: string, stopOnError: boolean = true): Uint8Array {
+        const [s, d, n] = callSRet(
+            this.mod,
+            'duckdb_web_query_run_batch',
+            ['number', 'string', 'boolean'],
+            [conn, text, stopOnError],
+        );
+        if (s !== StatusCode.SUCCESS) {
+            throw new Error(readString(this.mod, d, n));
+        }
+        const res = copyBuffer(this.mod, d, n);
+        dropResponseBuffers(this.mod);
+        return res;
+    }
+    /** Run a query and materialize its result into a cursor */
+    public openCursor(conn: number, text: string): CursorInfo {
+        const [s, d, n] = callSRet(this.mod, 'duckdb_web_cursor_open', ['number', 'string'], [conn, text]);
+        if (s !== StatusCode.SUCCESS) {
+            throw new Error(readString(this.mod, d, n));
+        }
+        dropResponseBuffers(this.mod);
+        const cursorId = d;
+        const [s2, d2, n2] = callSRet(this.mod, 'duckdb_web_cursor_row_count', ['number', 'number'], [conn, cursorId]);
+        if (s2 !== StatusCode.SUCCESS) {
+            throw new Error(readString(this.mod, d2, n2));
+        }
+        dropResponseBuffers(this.mod);
+        return { cursorId, rowCount: d2 };
+    }
+    /** Fetch up to `count` rows starting at row `offset` of a cursor */
+    public fetchRows(conn: number, cursor: number, offset: number, count: number): Uint8Array {
+        const [s, d, n] = callSRet(
+            this.mod,
+            'duckdb_web_cursor_fetch_rows',
+            ['number', 'number', 'number', 'number'],
+            [conn, cursor, offset, count],
+        );
+        if (s !== StatusCode.SUCCESS) {
+            throw new Error(readString(this.mod, d, n));
+        }
+        const res = copyBuffer(this.mod, d, n);
+        dropResponseBuffers(this.mod);
+        return res;
+    }
+    /** Close a cursor */
+    public closeCursor(conn: number, cursor: number): void {
+        const [s, d, n] = callSRet(this.mod, 'duckdb_web_cursor_close', ['number', 'number'], [conn, cursor]);
+        if (s !== StatusCode.SUCCESS) {
+            throw new Error(readString(this.mod, d, n));
+        }
+        dropResponseBuffers(this.mod);
+    }
     /** Send a query asynchronously. Results have to be fetched with `fetchQueryResults` */
     public sendQuery(conn: number, text: string): Uint8Array {
         const [s, d, n] = callSRet(this.mod, 'duckdb_web_query_send', ['number', 'string'], [conn, text]);
@@ -227,7 +309,8 @@ export abstract class DuckDBBindingsBase implements DuckDBBindings {
 
     /** Insert record batches from an arrow ipc stream */
     public insertArrowFromIPCStream(conn: number, buffer: Uint8Array, options?: ArrowInsertOptions): void {
-        // Store buffer
+        // Store buffer.
+        // The wasm side takes ownership of the chunk and references it from the decoded batches.
         const bufferPtr = this.mod._malloc(buffer.length);
         const bufferOfs = this.mod.HEAPU8.subarray(bufferPtr, bufferPtr + buffer.length);
         bufferOfs.set(buffer);
@@ -295,6 +378,27 @@ export abstract class DuckDBBindingsBase implements DuckDBBindings {
             throw new Error(readString(this.mod, d, n));
         }
     }
+    /** Create an aggregate view that is maintained on every arrow insert into its table */
+    public createIncrementalView(conn: number, definition: IncrementalViewDefinition): void {
+        const [s, d, n] = callSRet(
+            this.mod,
+            'duckdb_web_incremental_view_create',
+            ['number', 'string'],
+            [conn, JSON.stringify(definition)],
+        );
+        if (s !== StatusCode.SUCCESS) {
+            throw new Error(readString(this.mod, d, n));
+        }
+        dropResponseBuffers(this.mod);
+    }
+    /** Drop an incremental view */
+    public dropIncrementalView(conn: number, name: string): void {
+        const [s, d, n] = callSRet(this.mod, 'duckdb_web_incremental_view_drop', ['number', 'string'], [conn, name]);
+        if (s !== StatusCode.SUCCESS) {
+            throw new Error(readString(this.mod, d, n));
+        }
+        dropResponseBuffers(this.mod);
+    }
     /** Glob file infos */
     public globFiles(path: string): WebFile[] {
         const [s, d, n] = callSRet(this.mod, 'duckdb_web_fs_glob_file_infos', ['string'], [path]);
@@ -320,6 +424,26 @@ export abstract class DuckDBBindingsBase implements DuckDBBindings {
         }
         dropResponseBuffers(this.mod);
     }
+    /** Register many file URLs at once */
+    public registerFileURLs(files: WebFileURL[], deferHandles = false): void {
+        const batch = encodeWebFileURLs(files);
+        const ptr = this.mod._malloc(batch.length);
+        this.mod.HEAPU8.subarray(ptr, ptr + batch.length).set(batch);
+        try {
+            const [s, d, n] = callSRet(
+                this.mod,
+                'duckdb_web_fs_register_file_urls',
+                ['number', 'number', 'boolean'],
+                [ptr, batch.length, deferHandles],
+            );
+            if (s !== StatusCode.SUCCESS) {
+                throw new Error(readString(this.mod, d, n));
+            }
+            dropResponseBuffers(this.mod);
+        } finally {
+            this.mod._free(ptr);
+        }
+    }
     /** Register file text */
     public registerFileText(name: string, text: string): void {
         const buffer = TEXT_ENCODER.encode(text);
@@ -401,6 +525,34 @@ export abstract class DuckDBBindingsBase implements DuckDBBindings {
         dropResponseBuffers(this.mod);
         return copy;
     }
+    /** Export a snapshot of the database */
+    public exportSnapshot(options: DuckDBSnapshotOptions = {}): Uint8Array {
+        const [s, d, n] = callSRet(this.mod, 'duckdb_web_export_snapshot', ['string'], [JSON.stringify(options)]);
+        if (s !== StatusCode.SUCCESS) {
+            throw new Error(readString(this.mod, d, n));
+        }
+        const buffer = this.mod.HEAPU8.subarray(d, d + n);
+        const copy = new Uint8Array(buffer.length);
+        copy.set(buffer);
+        dropResponseBuffers(this.mod);
+        return copy;
+    }
+    /** Open a database snapshot that was exported with exportSnapshot */
+    public openSnapshot(name: string, buffer: Uint8Array, config: DuckDBConfig = {}): void {
+        const ptr = this.mod._malloc(buffer.length);
+        const dst = this.mod.HEAPU8.subarray(ptr, ptr + buffer.length);
+        dst.set(buffer);
+        const [s, d, n] = callSRet(
+            this.mod,
+            'duckdb_web_open_snapshot',
+            ['string', 'number', 'number', 'string'],
+            [name, ptr, buffer.length, JSON.stringify(config)],
+        );
+        if (s !== StatusCode.SUCCESS) {
+            throw new Error(readString(this.mod, d, n));
+        }
+        dropResponseBuffers(this.mod);
+    }
 
     /** Enable tracking of file statistics */
     public collectFileStatistics(file: string, enable: boolean): void {
@@ -417,4 +569,57 @@ export abstract class DuckDBBindingsBase implements DuckDBBindings {
         }
         return new FileStatistics(this.mod.HEAPU8.subarray(d, d + n));
     }
+
+    /** Load file ranges into the page buffer ahead of queries and return the warm-up id */
+    public warmFile(file: string, target: WarmUpTarget, priority = 0): number {
+        const [s, d, n] = callSRet(
+            this.mod,
+            'duckdb_web_warm_file',
+            ['string', 'string', 'number'],
+            [file, JSON.stringify(target), priority],
+        );
+        if (s !== StatusCode.SUCCESS) {
+            throw new Error(readString(this.mod, d, n));
+        }
+        dropResponseBuffers(this.mod);
+        return d;
+    }
+    /** Get the progress of a warm-up */
+    public getWarmUpProgress(id: number): WarmUpProgress {
+        const [s, d, n] = callSRet(this.mod, 'duckdb_web_get_warm_up_progress', ['number'], [id]);
+        if (s !== StatusCode.SUCCESS) {
+            throw new Error(readString(this.mod, d, n));
+        }
+        const res = readString(this.mod, d, n);
+        dropResponseBuffers(this.mod);
+        return JSON.parse(res) as WarmUpProgress;
+    }
+    /** Cancel a warm-up */
+    public cancelWarmUp(id: number): void {
+        const [s, d, n] = callSRet(this.mod, 'duckdb_web_cancel_warm_up', ['number'], [id]);
+        if (s !== StatusCode.SUCCESS) {
+            throw new Error(readString(this.mod, d, n));
+        }
+        dropResponseBuffers(this.mod);
+    }
+
+    /** Get the memory budget and the usage of all subsystems */
+    public getMemoryInfo(): MemoryInfo {
+        const [s, d, n] = callSRet(this.mod, 'duckdb_web_get_memory_info', [], []);
+        if (s !== StatusCode.SUCCESS) {
+            throw new Error(readString(this.mod, d, n));
+        }
+        const res = readString(this.mod, d, n);
+        dropResponseBuffers(this.mod);
+        return JSON.parse(res) as MemoryInfo;
+    }
+    /** Release memory of the page buffer and the readaheads, returns the released bytes */
+    public reclaimMemory(bytes: number): number {
+        const [s, d, n] = callSRet(this.mod, 'duckdb_web_reclaim_memory', ['number'], [bytes]);
+        if (s !== StatusCode.SUCCESS) {
+            throw new Error(readString(this.mod, d, n));
+        }
+        dropResponseBuffers(this.mod);
+        return d;
+    }
 }
@@ -1,7 +1,11 @@
-import { DuckDBConfig, DuckDBConnection, FileStatistics } from '.';
+import { DuckDBConfig, DuckDBConnection, DuckDBSnapshotOptions, FileStatistics } from '.';
 import { CSVInsertOptions, JSONInsertOptions, ArrowInsertOptions } from './insert_options';
-import { ScriptTokens } from './tokens';
-import { WebFile } from './web_file';
+import { ScriptTokens, ScriptTokenUpdate } from './tokens';
+import { WebFile, WebFileURL } from './web_file';
+import { WarmUpProgress, WarmUpTarget } from './warm_up';
+import { MemoryInfo } from './memory_info';
+import { CursorInfo } from './cursor_info';
+import { IncrementalViewDefinition } from './incremental_view';
 
 export interface DuckDBBindings {
     open(config: DuckDBConfig): void;
@@ -10,10 +14,16 @@ export interface DuckDBBindings {
     getVersion(): string;
     getFeatureFlags(): number;
     tokenize(text: string): ScriptTokens;
+    tokenizeBinary(text: string): ScriptTokenUpdate;
+    retokenize(offset: number, removed: number, inserted: string): ScriptTokenUpdate;
 
     connect(): DuckDBConnection;
     disconnect(conn: number): void;
     runQuery(conn: number, text: string): Uint8Array;
+    runBatch(conn: number, text: string, stopOnError?: boolean): Uint8Array;
+    openCursor(conn: number, text: string): CursorInfo;
+    fetchRows(conn: number, cursor: number, offset: number, count: number): Uint8Array;
+    closeCursor(conn: number, cursor: number): void;
     sendQuery(conn: number, text: string): Uint8Array;
     fetchQueryResults(conn: number): Uint8Array;
 
@@ -25,8 +35,11 @@ export interface DuckDBBindings {
     insertArrowFromIPCStream(conn: number, buffer: Uint8Array, options?: ArrowInsertOptions): void;
     insertCSVFromPath(conn: number, path: string, options: CSVInsertOptions): void;
     insertJSONFromPath(conn: number, path: string, options: JSONInsertOptions): void;
+    createIncrementalView(conn: number, definition: IncrementalViewDefinition): void;
+    dropIncrementalView(conn: number, name: string): void;
 
     registerFileURL(name: string, url?: string): void;
+    registerFileURLs(files: WebFileURL[], deferHandles?: boolean): void;
     registerFileText(name: string, text: string): void;
     registerFileBuffer(name: string, buffer: Uint8Array): void;
     registerFileHandle<HandleType>(name: string, handle: HandleType): void;
@@ -36,6 +49,13 @@ export interface DuckDBBindings {
     flushFiles(): void;
     copyFileToPath(name: string, path: string): void;
     copyFileToBuffer(name: string): Uint8Array;
+    exportSnapshot(options?: DuckDBSnapshotOptions): Uint8Array;
+    openSnapshot(name: string, buffer: Uint8Array, config?: DuckDBConfig): void;
     collectFileStatistics(file: string, enable: boolean): void;
     exportFileStatistics(file: string): FileStatistics;
+    warmFile(file: string, target: WarmUpTarget, priority?: number): number;
+    getWarmUpProgress(id: number): WarmUpProgress;
+    cancelWarmUp(id: number): void;
+    getMemoryInfo(): MemoryInfo;
+    reclaimMemory(bytes: number): number;
 }
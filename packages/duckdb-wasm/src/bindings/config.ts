@@ -1,9 +1,22 @@
+/** The access mode of a database */
+export enum DuckDBAccessMode {
+    AUTOMATIC = 1,
+    READ_ONLY = 2,
+    READ_WRITE = 3,
+}
+
 /** A DuckDB Config */
 export interface DuckDBConfig {
     /**
      * The database path
      */
     path?: string;
+    /**
+     * The access mode.
+     * Database files are opened read-only by default.
+     * READ_WRITE requires a file that is writable through the runtime (e.g. a native file).
+     */
+    accessMode?: DuckDBAccessMode;
     /**
      * Emit BigInts?
      */
@@ -13,8 +26,63 @@ export interface DuckDBConfig {
      * Note that this will only work with cross-origin isolated sites since it requires SharedArrayBuffers.
      */
     maximumThreads?: number;
+    /**
+     * The memory budget in bytes.
+     * The page buffer, the readahead buffers and the query results are kept within the budget.
+     * The remainder is left for the DuckDB buffer manager.
+     */
+    memoryBudget?: number;
+    /**
+     * The byte size up to which results of a single chunk are returned as Arrow IPC stream without file footer.
+     * 0 always returns Arrow IPC files.
+     */
+    compactResultSize?: number;
+    /**
+     * The number of query plans that every connection caches by query text.
+     * Repeated queries skip parsing, binding and optimization, 0 disables the cache.
+     */
+    planCacheSize?: number;
     /**
      * Allow falling back to full HTTP reads if the server does not support range requests.
      */
     allowFullHTTPReads?: boolean;
+    /**
+     * The time in microseconds a file sync waits for concurrent syncs.
+     * Syncs that arrive within this window are merged into a single flush.
+     */
+    syncWindowMicros?: number;
+    /**
+     * The number of bytes at the end of a remote file that are fetched when opening it.
+     * The tail is requested together with the file size and usually holds the file metadata.
+     * Set to 0 to probe the file size with a HEAD request instead.
+     */
+    speculativeTailSize?: number;
+    /**
+     * The bytes of temporary files that are kept in memory.
+     * DuckDB spills large sorts, joins and aggregations into compressed temporary files.
+     * 0 keeps all temporary files in memory.
+     */
+    tempBudget?: number;
+    /**
+     * A native file that receives the temporary files beyond the budget.
+     * Without it, queries fail once the budget is exhausted.
+     */
+    tempOverflowFile?: string;
+}
+
+/** The options of a database snapshot */
+export interface DuckDBSnapshotOptions {
+    /**
+     * The snapshot compression.
+     * Compressed snapshots are split into independent zstd frames that are decoded in parallel.
+     */
+    compression?: 'none' | 'zstd';
+    /**
+     * The zstd compression level
+     */
+    compressionLevel?: number;
+    /**
+     * The chunk size in bytes
+     */
+    chunkSize?: number;
 }
@@ -2,6 +2,9 @@ import * as arrow from 'apache-arrow';
 import * as utils from '../utils';
 import { DuckDBBindings } from './bindings_interface';
 import { CSVInsertOptions, JSONInsertOptions, ArrowInsertOptions } from './insert_options';
+import { BatchResult, decodeBatchResults } from './batch_result';
+import { CursorInfo } from './cursor_info';
+import { IncrementalViewDefinition } from './incremental_view';
 
 /** A thin helper to bind the connection id and talk record batches */
 export class DuckDBConnection {
@@ -31,10 +34,20 @@ export class DuckDBConnection {
         const buffer = this._bindings.runQuery(this._conn, text);
         const reader = arrow.RecordBatchReader.from<T>(buffer);
         console.assert(reader.isSync());
-        console.assert(reader.isFile());
         return arrow.Table.from(reader);
     }
 
+    /** Run all statements of a script in a single call */
+    public batch(text: string, stopOnError: boolean = true): BatchResult[] {
+        return decodeBatchResults(this._bindings.runBatch(this._conn, text, stopOnError));
+    }
+
+    /** Run a query and keep its result in a cursor for random access to its rows */
+    public openCursor<T extends { [key: string]: arrow.DataType } = any>(text: string): DuckDBCursor<T> {
+        const info = this._bindings.openCursor(this._conn, text);
+        return new DuckDBCursor<T>(this._bindings, this._conn, info);
+    }
+
     /** Send a query */
     public send<T extends { [key: string]: arrow.DataType } = any>(text: string): arrow.RecordBatchStreamReader<T> {
         const header = this._bindings.sendQuery(this._conn, text);
@@ -109,6 +122,15 @@ export class DuckDBConnection {
     public insertJSONFromPath(path: string, options: JSONInsertOptions): void {
         this._bindings.insertJSONFromPath(this._conn, path, options);
     }
+
+    /** Create an aggregate view that is maintained on every arrow insert into its table */
+    public createIncrementalView(definition: IncrementalViewDefinition): void {
+        this._bindings.createIncrementalView(this._conn, definition);
+    }
+    /** Drop an incremental view */
+    public dropIncrementalView(name: string): void {
+        this._bindings.dropIncrementalView(this._conn, name);
+    }
 }
 
 /** A result stream iterator */
@@ -170,8 +192,7 @@ export class PreparedStatement<T extends { [key: string]: arrow.DataType } = any
         const buffer = this.bindings.runPrepared(this.connectionId, this.statementId, params);
         const reader = arrow.RecordBatchReader.from<T>(buffer);
         console.assert(reader.isSync());
-        console.assert(reader.isFile());
-        return arrow.Table.from(reader as arrow.RecordBatchFileReader);
+        return arrow.Table.from(reader);
     }
 
     /** Send a prepared statement */
@@ -184,3 +205,38 @@ export class PreparedStatement<T extends { [key: string]: arrow.DataType } = any
         return reader as arrow.RecordBatchStreamReader;
     }
 }
+
+/** A thin helper to bind the cursor id */
+export class DuckDBCursor<T extends { [key: string]: arrow.DataType } = any> {
+    /** The bindings */
+    protected readonly bindings: DuckDBBindings;
+    /** The connection id */
+    protected readonly connectionId: number;
+    /** The cursor */
+    protected readonly info: CursorInfo;
+
+    /** Constructor */
+    constructor(bindings: DuckDBBindings, connectionId: number, info: CursorInfo) {
+        this.bindings = bindings;
+        this.connectionId = connectionId;
+        this.info = info;
+    }
+
+    /** Get the number of rows */
+    public get rowCount(): number {
+        return this.info.rowCount;
+    }
+
+    /** Close the cursor */
+    public close() {
+        this.bindings.closeCursor(this.connectionId, this.info.cursorId);
+    }
+
+    /** Fetch up to `count` rows starting at row `offset` */
+    public fetchRows(offset: number, count: number): arrow.Table<T> {
+        const buffer = this.bindings.fetchRows(this.connectionId, this.info.cursorId, offset, count);
+        const reader = arrow.RecordBatchReader.from<T>(buffer);
+        console.assert(reader.isSync());
+        return arrow.Table.from(reader);
+    }
+}
@@ -0,0 +1,7 @@
+/** A result cursor */
+export interface CursorInfo {
+    /** The cursor id */
+    cursorId: number;
+    /** The number of rows */
+    rowCount: number;
+}
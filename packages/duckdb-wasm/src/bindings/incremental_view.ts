@@ -0,0 +1,32 @@
+/** An aggregate function of an incremental view */
+export enum IncrementalAggregateFunction {
+    SUM = 'sum',
+    COUNT = 'count',
+    MIN = 'min',
+    MAX = 'max',
+    AVG = 'avg',
+}
+
+/** An aggregate of an incremental view */
+export interface IncrementalAggregate {
+    /** The function */
+    function: IncrementalAggregateFunction;
+    /** The aggregated column, omitted for count(*) */
+    column?: string;
+    /** The output name, defaults to `function(column)` */
+    name?: string;
+}
+
+/** An aggregate view that is maintained on every arrow insert into its table */
+export interface IncrementalViewDefinition {
+    /** The view name */
+    name: string;
+    /** The schema of the table */
+    schema?: string;
+    /** The table */
+    table: string;
+    /** The group columns */
+    groupBy?: string[];
+    /** The aggregates */
+    aggregates: IncrementalAggregate[];
+}
@@ -1,9 +1,16 @@
 export * from './bindings_interface';
 export * from './bindings_base';
+export * from './batch_result';
 export * from './config';
 export * from './connection';
+export * from './cursor_info';
 export * from './duckdb_module';
 export * from './file_stats';
+export * from './incremental_view';
 export * from './runtime';
 export * from './insert_options';
 export * from './insert';
+export * from './web_file';
+export * from './warm_up';
+export * from './memory_info';
+export * from './tokens';
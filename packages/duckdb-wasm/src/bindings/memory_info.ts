@@ -0,0 +1,37 @@
+/** The memory of a subsystem */
+export interface MemoryConsumerInfo {
+    /** The subsystem, e.g. 'pageBuffer', 'readahead', 'arrow' or 'results' */
+    name: string;
+    /** The bytes that are held */
+    usage: number;
+    /** The memory limit, 0 if unlimited */
+    limit: number;
+}
+
+/** The statistics of the arrow memory pool */
+export interface ArrowMemoryInfo {
+    /** The bytes that are currently allocated */
+    bytesAllocated: number;
+    /** The peak of the allocated bytes */
+    bytesPeak: number;
+    /** The bytes that are held by slabs and large allocations */
+    bytesReserved: number;
+    /** The number of allocations */
+    allocations: number;
+    /** The number of allocations that reused a cached block */
+    cacheHits: number;
+}
+
+/** The memory budget and its usage */
+export interface MemoryInfo {
+    /** The memory budget, 0 if unlimited */
+    budget: number;
+    /** The bytes that are held by all subsystems */
+    usage: number;
+    /** The memory that is left for the DuckDB buffer manager, 0 if unlimited */
+    databaseMemory: number;
+    /** The subsystems */
+    consumers: MemoryConsumerInfo[];
+    /** The arrow memory pool */
+    arrow: ArrowMemoryInfo;
+}
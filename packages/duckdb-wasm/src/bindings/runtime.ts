@@ -46,6 +46,26 @@ export interface DuckDBFileInfo {
     dataUrl: string | null;
     dataNativeFd: number | null;
     allowFullHttpReads?: boolean;
+    speculativeTailSize?: number;
+}
+
+/** Allocate the result of an opened file.
+ * The file buffer holds the full file, the tail buffer the last bytes of it (if fetched).
+ * Ownership of both buffers passes to the filesystem.
+ */
+export function allocOpenedFile(
+    mod: DuckDBModule,
+    fileSize: number,
+    fileBuffer = 0,
+    tailBuffer = 0,
+    tailSize = 0,
+): number {
+    const result = mod._malloc(4 * 8);
+    mod.HEAPF64[(result >> 3) + 0] = fileSize;
+    mod.HEAPF64[(result >> 3) + 1] = fileBuffer;
+    mod.HEAPF64[(result >> 3) + 2] = tailBuffer;
+    mod.HEAPF64[(result >> 3) + 3] = tailSize;
+    return result;
 }
 
 /** Call a function with packed response buffer */
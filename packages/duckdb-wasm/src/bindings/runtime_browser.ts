@@ -7,9 +7,36 @@ import {
     dropResponseBuffers,
     readString,
     DuckDBDataProtocol,
+    allocOpenedFile,
 } from './runtime';
 import { DuckDBModule } from '../targets/duckdb-browser-sync-next';
 
+/** Open a range-capable HTTP file and fetch its tail along with it.
+ * Parquet and Arrow files keep their metadata at the end, reading it is then free.
+ * The tail is only a hint, any unexpected response falls back to the plain file size.
+ */
+function allocOpenedFileWithTail(mod: DuckDBModule, url: string, fileSize: number, tailSize: number): number {
+    tailSize = Math.min(tailSize, fileSize);
+    if (tailSize == 0) {
+        return allocOpenedFile(mod, fileSize);
+    }
+    try {
+        const xhr = new XMLHttpRequest();
+        xhr.open('GET', url, false);
+        xhr.responseType = 'arraybuffer';
+        xhr.setRequestHeader('Range', `bytes=${fileSize - tailSize}-${fileSize - 1}`);
+        xhr.send(null);
+        if (xhr.status == 206 && xhr.response?.byteLength == tailSize) {
+            const data = mod._malloc(tailSize);
+            mod.HEAPU8.set(new Uint8Array(xhr.response, 0, tailSize), data);
+            return allocOpenedFile(mod, fileSize, 0, data, tailSize);
+        }
+    } catch (e: any) {
+        // Read the tail on demand
+    }
+    return allocOpenedFile(mod, fileSize);
+}
+
 export const BROWSER_RUNTIME: DuckDBRuntime & {
     fileInfoCache: Map<number, DuckDBFileInfo>;
 
@@ -68,10 +95,8 @@ export const BROWSER_RUNTIME: DuckDBRuntime & {
                         // Supports range requests
                         const contentLength = xhr.getResponseHeader('Content-Length');
                         if (xhr.status == 206 && contentLength !== null) {
-                            const result = mod._malloc(2 * 8);
-                            mod.HEAPF64[(result >> 3) + 0] = +contentLength;
-                            mod.HEAPF64[(result >> 3) + 1] = 0;
-                            return result;
+                            const fileSize = +contentLength;
+                            return allocOpenedFileWithTail(mod, file.dataUrl!, fileSize, file.speculativeTailSize ?? 0);
                         }
                     } catch (e: any) {
                         error = e;
@@ -93,10 +118,7 @@ export const BROWSER_RUNTIME: DuckDBRuntime & {
                             const data = mod._malloc(xhr.response.byteLength);
                             const src = new Uint8Array(xhr.response, 0, xhr.response.byteLength);
                             mod.HEAPU8.set(src, data);
-                            const result = mod._malloc(2 * 8);
-                            mod.HEAPF64[(result >> 3) + 0] = xhr.response.byteLength;
-                            mod.HEAPF64[(result >> 3) + 1] = data;
-                            return result;
+                            return allocOpenedFile(mod, xhr.response.byteLength, data);
                         }
                     }
 
@@ -110,19 +132,13 @@ export const BROWSER_RUNTIME: DuckDBRuntime & {
                 case DuckDBDataProtocol.NATIVE: {
                     const handle = BROWSER_RUNTIME._files?.get(file.fileName);
                     if (handle) {
-                        const result = mod._malloc(2 * 8);
-                        mod.HEAPF64[(result >> 3) + 0] = handle.size;
-                        mod.HEAPF64[(result >> 3) + 1] = 0;
-                        return result;
+                        return allocOpenedFile(mod, handle.size);
                     }
 
                     // Fall back to empty buffered file in the browser
                     console.warn(`Buffering missing file: ${file.fileName}`);
-                    const result = mod._malloc(2 * 8);
                     const buffer = mod._malloc(1); // malloc(0) is allowed to return a nullptr
-                    mod.HEAPF64[(result >> 3) + 0] = 1;
-                    mod.HEAPF64[(result >> 3) + 1] = buffer;
-                    return result;
+                    return allocOpenedFile(mod, 1, buffer);
                 }
             }
         } catch (e: any) {
@@ -8,6 +8,7 @@ import {
     readString,
     decodeText,
     DuckDBDataProtocol,
+    allocOpenedFile,
 } from './runtime';
 import { StatusCode } from '../status';
 import { DuckDBModule } from './duckdb_module';
@@ -73,10 +74,7 @@ export const NODE_RUNTIME: DuckDBRuntime & {
                         failWith(mod, readString(mod, d, n));
                     }
                     const fileSize = fs.fstatSync(file.dataNativeFd!).size;
-                    const result = mod._malloc(2 * 8);
-                    mod.HEAPF64[(result >> 3) + 0] = +fileSize;
-                    mod.HEAPF64[(result >> 3) + 1] = 0;
-                    return result;
+                    return allocOpenedFile(mod, +fileSize);
                 }
                 // HTTP file
                 case DuckDBDataProtocol.HTTP:
@@ -11,3 +11,45 @@ export interface ScriptTokens {
     offsets: number[];
     types: TokenType[];
 }
+
+/** An update of script tokens, see WebDB::TokenizeBinary and WebDB::RetokenizeBinary */
+export interface ScriptTokenUpdate {
+    /** The index of the first replaced token */
+    index: number;
+    /** The number of replaced tokens */
+    removed: number;
+    /** The UTF-8 byte offsets of the inserted tokens */
+    offsets: Uint32Array;
+    /** The types of the inserted tokens */
+    types: Uint8Array;
+    /** The offset shift of all tokens after the inserted ones */
+    shift: number;
+}
+
+/** Decode a packed token update */
+export function decodeScriptTokenUpdate(buffer: Uint8Array): ScriptTokenUpdate {
+    const view = new DataView(buffer.buffer, buffer.byteOffset, buffer.byteLength);
+    const count = view.getUint32(8, true);
+    // Typed arrays need aligned offsets
+    if (buffer.byteOffset % 4 != 0) {
+        buffer = buffer.slice();
+    }
+    return {
+        index: view.getUint32(0, true),
+        removed: view.getUint32(4, true),
+        offsets: new Uint32Array(buffer.buffer, buffer.byteOffset + 16, count),
+        types: buffer.subarray(16 + count * 4, 16 + count * 5),
+        shift: view.getInt32(12, true),
+    };
+}
+
+/** Apply a token update to script tokens */
+export function applyScriptTokenUpdate(tokens: ScriptTokens, update: ScriptTokenUpdate): ScriptTokens {
+    const tail = tokens.offsets.slice(update.index + update.removed).map(o => o + update.shift);
+    return {
+        offsets: tokens.offsets.slice(0, update.index).concat(Array.from(update.offsets), tail),
+        types: tokens.types
+            .slice(0, update.index)
+            .concat(Array.from(update.types), tokens.types.slice(update.index + update.removed)),
+    };
+}
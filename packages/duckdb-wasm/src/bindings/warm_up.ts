@@ -0,0 +1,14 @@
+/** What a warm-up loads: the file metadata, the whole file or [offset, length] byte ranges */
+export type WarmUpTarget = 'metadata' | 'all' | [number, number][];
+
+/** The progress of a warm-up */
+export interface WarmUpProgress {
+    /** The state */
+    state: 'queued' | 'running' | 'done' | 'cancelled' | 'failed';
+    /** The bytes that were loaded */
+    bytesLoaded: number;
+    /** The bytes that will be loaded, known once the warm-up is running */
+    bytesTotal: number;
+    /** The error (if failed) */
+    error?: string;
+}
@@ -12,4 +12,65 @@ export interface WebFile {
     dataUrl?: string;
     dataNativeFd?: number;
     allowFullHttpReads?: boolean;
+    speculativeTailSize?: number;
+    bandwidth?: WebFileBandwidth;
+}
+
+/** The bandwidth estimate of a data origin */
+export interface WebFileBandwidth {
+    /** The origin, scheme and host of a URL or "file" */
+    origin: string;
+    /** The request latency in milliseconds */
+    latencyMs: number;
+    /** The throughput in bytes per second */
+    bytesPerSecond: number;
+    /** The number of latency samples */
+    latencySamples: number;
+    /** The number of bandwidth samples */
+    bandwidthSamples: number;
+    /** The bandwidth-delay product in bytes */
+    bandwidthDelayProduct: number;
+    /** The size of the first readahead */
+    readAheadBase: number;
+    /** The maximum readahead */
+    readAheadMaximum: number;
+}
+
+/** A file URL of a batched registration */
+export interface WebFileURL {
+    /** The file name */
+    name: string;
+    /** The file URL, defaults to the name */
+    url?: string;
+    /** The file size (if known) */
+    size?: number;
+}
+
+/** Encode file URLs as compact binary batch */
+export function encodeWebFileURLs(files: WebFileURL[]): Uint8Array {
+    const encoder = new TextEncoder();
+    const names = files.map(f => encoder.encode(f.name));
+    const urls = files.map(f => encoder.encode(f.url ?? f.name));
+    let byteLength = 4;
+    for (let i = 0; i < files.length; ++i) {
+        byteLength += 16 + names[i].length + urls[i].length;
+    }
+    const buffer = new Uint8Array(byteLength);
+    const view = new DataView(buffer.buffer);
+    view.setUint32(0, files.length, true);
+    let ofs = 4;
+    for (let i = 0; i < files.length; ++i) {
+        const size = files[i].size;
+        view.setUint32(ofs, names[i].length, true);
+        view.setUint32(ofs + 4, urls[i].length, true);
+        // Unknown sizes are encoded as UINT64_MAX
+        view.setUint32(ofs + 8, size === undefined ? 0xffffffff : size % 0x100000000, true);
+        view.setUint32(ofs + 12, size === undefined ? 0xffffffff : Math.floor(size / 0x100000000), true);
+        ofs += 16;
+        buffer.set(names[i], ofs);
+        ofs += names[i].length;
+        buffer.set(urls[i], ofs);
+        ofs += urls[i].length;
+    }
+    return buffer;
 }
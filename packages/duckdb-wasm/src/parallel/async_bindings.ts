@@ -11,11 +11,15 @@ import { AsyncDuckDBBindings } from './async_bindings_interface';
 import { Logger } from '../log';
 import { AsyncDuckDBConnection } from './async_connection';
 import { CSVInsertOptions, JSONInsertOptions, ArrowInsertOptions } from '../bindings/insert_options';
-import { ScriptTokens } from '../bindings/tokens';
+import { ScriptTokens, ScriptTokenUpdate } from '../bindings/tokens';
 import { FileStatistics } from '../bindings/file_stats';
-import { DuckDBConfig } from '../bindings/config';
+import { DuckDBConfig, DuckDBSnapshotOptions } from '../bindings/config';
 import { flattenArrowField } from '../flat_arrow';
-import { WebFile } from '../bindings/web_file';
+import { WebFile, WebFileURL } from '../bindings/web_file';
+import { WarmUpProgress, WarmUpTarget } from '../bindings/warm_up';
+import { MemoryInfo } from '../bindings/memory_info';
+import { CursorInfo } from '../bindings/cursor_info';
+import { IncrementalViewDefinition } from '../bindings/incremental_view';
 
 const TEXT_ENCODER = new TextEncoder();
 
@@ -139,10 +143,14 @@ export class AsyncDuckDB implements AsyncDuckDBBindings {
 
         // Otherwise differentiate between the tasks first
         switch (task.type) {
+            case WorkerRequestType.CANCEL_WARM_UP:
+            case WorkerRequestType.CLOSE_CURSOR:
             case WorkerRequestType.CLOSE_PREPARED:
             case WorkerRequestType.COLLECT_FILE_STATISTICS:
             case WorkerRequestType.COPY_FILE_TO_PATH:
+            case WorkerRequestType.CREATE_INCREMENTAL_VIEW:
             case WorkerRequestType.DISCONNECT:
+            case WorkerRequestType.DROP_INCREMENTAL_VIEW:
             case WorkerRequestType.DROP_FILES:
             case WorkerRequestType.FLUSH_FILES:
             case WorkerRequestType.INSERT_ARROW_FROM_IPC_STREAM:
@@ -150,10 +158,12 @@ export class AsyncDuckDB implements AsyncDuckDBBindings {
             case WorkerRequestType.INSERT_JSON_FROM_PATH:
             case WorkerRequestType.INSTANTIATE:
             case WorkerRequestType.OPEN:
+            case WorkerRequestType.OPEN_SNAPSHOT:
             case WorkerRequestType.PING:
             case WorkerRequestType.REGISTER_FILE_BUFFER:
             case WorkerRequestType.REGISTER_FILE_HANDLE:
             case WorkerRequestType.REGISTER_FILE_URL:
+            case WorkerRequestType.REGISTER_FILE_URLS:
             case WorkerRequestType.RESET:
                 if (response.type == WorkerResponseType.OK) {
                     task.promiseResolver(response.data);
@@ -184,6 +194,13 @@ export class AsyncDuckDB implements AsyncDuckDBBindings {
                     return;
                 }
                 break;
+            case WorkerRequestType.TOKENIZE_BINARY:
+            case WorkerRequestType.TOKENIZE_EDIT:
+                if (response.type == WorkerResponseType.SCRIPT_TOKEN_UPDATE) {
+                    task.promiseResolver(response.data);
+                    return;
+                }
+                break;
             case WorkerRequestType.DROP_FILE:
                 if (response.type == WorkerResponseType.SUCCESS) {
                     task.promiseResolver(response.data);
@@ -191,6 +208,7 @@ export class AsyncDuckDB implements AsyncDuckDBBindings {
                 }
                 break;
             case WorkerRequestType.COPY_FILE_TO_BUFFER:
+            case WorkerRequestType.EXPORT_SNAPSHOT:
                 if (response.type == WorkerResponseType.FILE_BUFFER) {
                     task.promiseResolver(response.data);
                     return;
@@ -202,12 +220,38 @@ export class AsyncDuckDB implements AsyncDuckDBBindings {
                     return;
                 }
                 break;
+            case WorkerRequestType.WARM_FILE:
+                if (response.type == WorkerResponseType.WARM_UP_ID) {
+                    task.promiseResolver(response.data);
+                    return;
+                }
+                break;
+            case WorkerRequestType.GET_WARM_UP_PROGRESS:
+                if (response.type == WorkerResponseType.WARM_UP_PROGRESS) {
+                    task.promiseResolver(response.data);
+                    return;
+                }
+                break;
+            case WorkerRequestType.GET_MEMORY_INFO:
+                if (response.type == WorkerResponseType.MEMORY_INFO) {
+                    task.promiseResolver(response.data);
+                    return;
+                }
+                break;
+            case WorkerRequestType.RECLAIM_MEMORY:
+                if (response.type == WorkerResponseType.RECLAIMED_BYTES) {
+                    task.promiseResolver(response.data);
+                    return;
+                }
+                break;
             case WorkerRequestType.CONNECT:
                 if (response.type == WorkerResponseType.CONNECTION_INFO) {
                     task.promiseResolver(response.data);
                     return;
                 }
                 break;
+            case WorkerRequestType.FETCH_ROWS:
+            case WorkerRequestType.RUN_BATCH:
             case WorkerRequestType.RUN_PREPARED:
             case WorkerRequestType.RUN_QUERY:
                 if (response.type == WorkerResponseType.QUERY_RESULT) {
@@ -234,6 +278,12 @@ export class AsyncDuckDB implements AsyncDuckDBBindings {
                     return;
                 }
                 break;
+            case WorkerRequestType.OPEN_CURSOR:
+                if (response.type == WorkerResponseType.CURSOR_INFO) {
+                    task.promiseResolver(response.data);
+                    return;
+                }
+                break;
         }
         task.promiseRejecter(new Error(`unexpected response type: ${response.type.toString()}`));
     }
@@ -321,6 +371,24 @@ export class AsyncDuckDB implements AsyncDuckDBBindings {
         return tokens;
     }
 
+    /** Tokenize a script text into packed tokens, the script is kept for `retokenize` */
+    public async tokenizeBinary(text: string): Promise<ScriptTokenUpdate> {
+        const task = new WorkerTask<WorkerRequestType.TOKENIZE_BINARY, string, ScriptTokenUpdate>(
+            WorkerRequestType.TOKENIZE_BINARY,
+            text,
+        );
+        return await this.postTask(task);
+    }
+
+    /** Replace `removed` UTF-8 bytes at `offset` of the last tokenized script and tokenize the edit */
+    public async retokenize(offset: number, removed: number, inserted: string): Promise<ScriptTokenUpdate> {
+        const task = new WorkerTask<WorkerRequestType.TOKENIZE_EDIT, [number, number, string], ScriptTokenUpdate>(
+            WorkerRequestType.TOKENIZE_EDIT,
+            [offset, removed, inserted],
+        );
+        return await this.postTask(task);
+    }
+
     /** Connect to the database */
     public async connectInternal(): Promise<number> {
         const task = new WorkerTask<WorkerRequestType.CONNECT, null, ConnectionID>(WorkerRequestType.CONNECT, null);
@@ -351,6 +419,42 @@ export class AsyncDuckDB implements AsyncDuckDBBindings {
         return await this.postTask(task);
     }
 
+    /** Run all statements of a script */
+    public async runBatch(conn: ConnectionID, text: string, stopOnError: boolean = true): Promise<Uint8Array> {
+        const task = new WorkerTask<WorkerRequestType.RUN_BATCH, [ConnectionID, string, boolean], Uint8Array>(
+            WorkerRequestType.RUN_BATCH,
+            [conn, text, stopOnError],
+        );
+        return await this.postTask(task);
+    }
+
+    /** Run a query and materialize its result into a cursor */
+    public async openCursor(conn: ConnectionID, text: string): Promise<CursorInfo> {
+        const task = new WorkerTask<WorkerRequestType.OPEN_CURSOR, [ConnectionID, string], CursorInfo>(
+            WorkerRequestType.OPEN_CURSOR,
+            [conn, text],
+        );
+        return await this.postTask(task);
+    }
+
+    /** Fetch up to `count` rows starting at row `offset` of a cursor */
+    public async fetchRows(conn: ConnectionID, cursor: number, offset: number, count: number): Promise<Uint8Array> {
+        const task = new WorkerTask<WorkerRequestType.FETCH_ROWS, [ConnectionID, number, number, number], Uint8Array>(
+            WorkerRequestType.FETCH_ROWS,
+            [conn, cursor, offset, count],
+        );
+        return await this.postTask(task);
+    }
+
+    /** Close a cursor */
+    public async closeCursor(conn: ConnectionID, cursor: number): Promise<void> {
+        const task = new WorkerTask<WorkerRequestType.CLOSE_CURSOR, [ConnectionID, number], null>(
+            WorkerRequestType.CLOSE_CURSOR,
+            [conn, cursor],
+        );
+        await this.postTask(task);
+    }
+
     /** Send a query */
     public async sendQuery(conn: ConnectionID, text: string): Promise<Uint8Array> {
         const task = new WorkerTask<WorkerRequestType.SEND_QUERY, [ConnectionID, string], Uint8Array>(
@@ -425,6 +529,14 @@ export class AsyncDuckDB implements AsyncDuckDBBindings {
         );
         await this.postTask(task);
     }
+    /** Register many file URLs at once. */
+    public async registerFileURLs(files: WebFileURL[], deferHandles = false): Promise<void> {
+        const task = new WorkerTask<WorkerRequestType.REGISTER_FILE_URLS, [WebFileURL[], boolean], null>(
+            WorkerRequestType.REGISTER_FILE_URLS,
+            [files, deferHandles],
+        );
+        await this.postTask(task);
+    }
 
     /** Register an empty file buffer. */
     public async registerEmptyFileBuffer(name: string): Promise<void> {
@@ -471,6 +583,51 @@ export class AsyncDuckDB implements AsyncDuckDBBindings {
         return await this.postTask(task, []);
     }
 
+    /** Load file ranges into the page buffer ahead of queries and return the warm-up id */
+    public async warmFile(name: string, target: WarmUpTarget, priority = 0): Promise<number> {
+        const task = new WorkerTask<WorkerRequestType.WARM_FILE, [string, WarmUpTarget, number], number>(
+            WorkerRequestType.WARM_FILE,
+            [name, target, priority],
+        );
+        return await this.postTask(task, []);
+    }
+
+    /** Get the progress of a warm-up */
+    public async getWarmUpProgress(id: number): Promise<WarmUpProgress> {
+        const task = new WorkerTask<WorkerRequestType.GET_WARM_UP_PROGRESS, number, WarmUpProgress>(
+            WorkerRequestType.GET_WARM_UP_PROGRESS,
+            id,
+        );
+        return await this.postTask(task, []);
+    }
+
+    /** Cancel a warm-up */
+    public async cancelWarmUp(id: number): Promise<void> {
+        const task = new WorkerTask<WorkerRequestType.CANCEL_WARM_UP, number, null>(
+            WorkerRequestType.CANCEL_WARM_UP,
+            id,
+        );
+        await this.postTask(task, []);
+    }
+
+    /** Get the memory budget and the usage of all subsystems */
+    public async getMemoryInfo(): Promise<MemoryInfo> {
+        const task = new WorkerTask<WorkerRequestType.GET_MEMORY_INFO, null, MemoryInfo>(
+            WorkerRequestType.GET_MEMORY_INFO,
+            null,
+        );
+        return await this.postTask(task, []);
+    }
+
+    /** Release memory of the page buffer and the readaheads, returns the released bytes */
+    public async reclaimMemory(bytes: number): Promise<number> {
+        const task = new WorkerTask<WorkerRequestType.RECLAIM_MEMORY, number, number>(
+            WorkerRequestType.RECLAIM_MEMORY,
+            bytes,
+        );
+        return await this.postTask(task, []);
+    }
+
     /** Copy a file to a buffer. */
     public async copyFileToBuffer(name: string): Promise<Uint8Array> {
         const task = new WorkerTask<WorkerRequestType.COPY_FILE_TO_BUFFER, string, Uint8Array>(
@@ -480,6 +637,24 @@ export class AsyncDuckDB implements AsyncDuckDBBindings {
         return await this.postTask(task);
     }
 
+    /** Export a snapshot of the database. */
+    public async exportSnapshot(options: DuckDBSnapshotOptions = {}): Promise<Uint8Array> {
+        const task = new WorkerTask<WorkerRequestType.EXPORT_SNAPSHOT, DuckDBSnapshotOptions, Uint8Array>(
+            WorkerRequestType.EXPORT_SNAPSHOT,
+            options,
+        );
+        return await this.postTask(task);
+    }
+
+    /** Open a database snapshot. */
+    public async openSnapshot(name: string, buffer: Uint8Array, config: DuckDBConfig = {}): Promise<void> {
+        const task = new WorkerTask<WorkerRequestType.OPEN_SNAPSHOT, [string, Uint8Array, DuckDBConfig], null>(
+            WorkerRequestType.OPEN_SNAPSHOT,
+            [name, buffer, config],
+        );
+        await this.postTask(task, [buffer.buffer]);
+    }
+
     /** Copy a file to a path. */
     public async copyFileToPath(name: string, path: string): Promise<void> {
         const task = new WorkerTask<WorkerRequestType.COPY_FILE_TO_PATH, [string, string], null>(
@@ -543,4 +718,22 @@ export class AsyncDuckDB implements AsyncDuckDBBindings {
         );
         await this.postTask(task);
     }
+
+    /** Create an aggregate view that is maintained on every arrow insert into its table */
+    public async createIncrementalView(conn: ConnectionID, definition: IncrementalViewDefinition): Promise<void> {
+        const task = new WorkerTask<
+            WorkerRequestType.CREATE_INCREMENTAL_VIEW,
+            [ConnectionID, IncrementalViewDefinition],
+            null
+        >(WorkerRequestType.CREATE_INCREMENTAL_VIEW, [conn, definition]);
+        await this.postTask(task);
+    }
+    /** Drop an incremental view */
+    public async dropIncrementalView(conn: ConnectionID, name: string): Promise<void> {
+        const task = new WorkerTask<WorkerRequestType.DROP_INCREMENTAL_VIEW, [ConnectionID, string], null>(
+            WorkerRequestType.DROP_INCREMENTAL_VIEW,
+            [conn, name],
+        );
+        await this.postTask(task);
+    }
 }
@@ -1,18 +1,36 @@
 import { Logger } from '../log';
 import { CSVInsertOptions, JSONInsertOptions } from '../bindings/insert_options';
+import { DuckDBConfig, DuckDBSnapshotOptions } from '../bindings/config';
+import { WebFileURL } from '../bindings/web_file';
+import { WarmUpProgress, WarmUpTarget } from '../bindings/warm_up';
+import { MemoryInfo } from '../bindings/memory_info';
+import { CursorInfo } from '../bindings/cursor_info';
+import { IncrementalViewDefinition } from '../bindings/incremental_view';
 
 /** An interface for the async DuckDB bindings */
 export interface AsyncDuckDBBindings {
     logger: Logger;
 
     registerFileURL(name: string, url: string, size: number): Promise<void>;
+    registerFileURLs(files: WebFileURL[], deferHandles?: boolean): Promise<void>;
     registerFileBuffer(name: string, buffer: Uint8Array): Promise<void>;
     registerFileHandle<HandleType>(name: string, handle: HandleType): Promise<void>;
     copyFileToPath(name: string, out: string): Promise<void>;
     copyFileToBuffer(name: string): Promise<Uint8Array>;
+    exportSnapshot(options?: DuckDBSnapshotOptions): Promise<Uint8Array>;
+    openSnapshot(name: string, buffer: Uint8Array, config?: DuckDBConfig): Promise<void>;
+    warmFile(name: string, target: WarmUpTarget, priority?: number): Promise<number>;
+    getWarmUpProgress(id: number): Promise<WarmUpProgress>;
+    cancelWarmUp(id: number): Promise<void>;
+    getMemoryInfo(): Promise<MemoryInfo>;
+    reclaimMemory(bytes: number): Promise<number>;
 
     disconnect(conn: number): Promise<void>;
     runQuery(conn: number, text: string): Promise<Uint8Array>;
+    runBatch(conn: number, text: string, stopOnError?: boolean): Promise<Uint8Array>;
+    openCursor(conn: number, text: string): Promise<CursorInfo>;
+    fetchRows(conn: number, cursor: number, offset: number, count: number): Promise<Uint8Array>;
+    closeCursor(conn: number, cursor: number): Promise<void>;
     sendQuery(conn: number, text: string): Promise<Uint8Array>;
     fetchQueryResults(conn: number): Promise<Uint8Array>;
 
@@ -24,4 +42,6 @@ export interface AsyncDuckDBBindings {
     insertArrowFromIPCStream(conn: number, buffer: Uint8Array, options?: CSVInsertOptions): Promise<void>;
     insertCSVFromPath(conn: number, path: string, options: CSVInsertOptions): Promise<void>;
     insertJSONFromPath(conn: number, path: string, options: JSONInsertOptions): Promise<void>;
+    createIncrementalView(conn: number, definition: IncrementalViewDefinition): Promise<void>;
+    dropIncrementalView(conn: number, name: string): Promise<void>;
 }
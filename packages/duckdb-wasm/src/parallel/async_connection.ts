@@ -3,6 +3,9 @@ import * as utils from '../utils';
 import { AsyncDuckDB } from './async_bindings';
 import { LogLevel, LogTopic, LogOrigin, LogEvent } from '../log';
 import { ArrowInsertOptions, CSVInsertOptions, JSONInsertOptions } from '../bindings/insert_options';
+import { BatchResult, decodeBatchResults } from '../bindings/batch_result';
+import { CursorInfo } from '../bindings/cursor_info';
+import { IncrementalViewDefinition } from '../bindings/incremental_view';
 
 /** A thin helper to memoize the connection id */
 export class AsyncDuckDBConnection {
@@ -44,8 +47,37 @@ export class AsyncDuckDBConnection {
         const buffer = await this._bindings.runQuery(this._conn, text);
         const reader = arrow.RecordBatchReader.from<T>(buffer);
         console.assert(reader.isSync());
-        console.assert(reader.isFile());
-        return arrow.Table.from(reader as arrow.RecordBatchFileReader);
+        return arrow.Table.from(reader);
+    }
+
+    /** Run all statements of a script in a single call */
+    public async batch(text: string, stopOnError: boolean = true): Promise<BatchResult[]> {
+        this._bindings.logger.log({
+            timestamp: new Date(),
+            level: LogLevel.INFO,
+            origin: LogOrigin.ASYNC_DUCKDB,
+            topic: LogTopic.QUERY,
+            event: LogEvent.RUN,
+            value: text,
+        });
+        const buffer = await this._bindings.runBatch(this._conn, text, stopOnError);
+        return decodeBatchResults(buffer);
+    }
+
+    /** Run a query and keep its result in a cursor for random access to its rows */
+    public async openCursor<T extends { [key: string]: arrow.DataType } = any>(
+        text: string,
+    ): Promise<AsyncDuckDBCursor<T>> {
+        this._bindings.logger.log({
+            timestamp: new Date(),
+            level: LogLevel.INFO,
+            origin: LogOrigin.ASYNC_DUCKDB,
+            topic: LogTopic.QUERY,
+            event: LogEvent.RUN,
+            value: text,
+        });
+        const info = await this._bindings.openCursor(this._conn, text);
+        return new AsyncDuckDBCursor<T>(this._bindings, this._conn, info);
     }
 
     /** Send a query */
@@ -127,6 +159,15 @@ export class AsyncDuckDBConnection {
     public async insertJSONFromPath(text: string, options: JSONInsertOptions): Promise<void> {
         await this._bindings.insertJSONFromPath(this._conn, text, options);
     }
+
+    /** Create an aggregate view that is maintained on every arrow insert into its table */
+    public async createIncrementalView(definition: IncrementalViewDefinition): Promise<void> {
+        await this._bindings.createIncrementalView(this._conn, definition);
+    }
+    /** Drop an incremental view */
+    public async dropIncrementalView(name: string): Promise<void> {
+        await this._bindings.dropIncrementalView(this._conn, name);
+    }
 }
 
 /** An async result stream iterator */
@@ -204,8 +245,7 @@ export class AsyncPreparedStatement<T extends { [key: string]: arrow.DataType }
         const buffer = await this.bindings.runPrepared(this.connectionId, this.statementId, params);
         const reader = arrow.RecordBatchReader.from<T>(buffer);
         console.assert(reader.isSync());
-        console.assert(reader.isFile());
-        return arrow.Table.from(reader as arrow.RecordBatchFileReader);
+        return arrow.Table.from(reader);
     }
 
     /** Send a prepared statement */
@@ -218,3 +258,38 @@ export class AsyncPreparedStatement<T extends { [key: string]: arrow.DataType }
         return reader as unknown as arrow.AsyncRecordBatchStreamReader<T>; // XXX
     }
 }
+
+/** A thin helper to bind the cursor id */
+export class AsyncDuckDBCursor<T extends { [key: string]: arrow.DataType } = any> {
+    /** The bindings */
+    protected readonly bindings: AsyncDuckDB;
+    /** The connection id */
+    protected readonly connectionId: number;
+    /** The cursor */
+    protected readonly info: CursorInfo;
+
+    /** Constructor */
+    constructor(bindings: AsyncDuckDB, connectionId: number, info: CursorInfo) {
+        this.bindings = bindings;
+        this.connectionId = connectionId;
+        this.info = info;
+    }
+
+    /** Get the number of rows */
+    public get rowCount(): number {
+        return this.info.rowCount;
+    }
+
+    /** Close the cursor */
+    public async close() {
+        await this.bindings.closeCursor(this.connectionId, this.info.cursorId);
+    }
+
+    /** Fetch up to `count` rows starting at row `offset` */
+    public async fetchRows(offset: number, count: number): Promise<arrow.Table<T>> {
+        const buffer = await this.bindings.fetchRows(this.connectionId, this.info.cursorId, offset, count);
+        const reader = arrow.RecordBatchReader.from<T>(buffer);
+        console.assert(reader.isSync());
+        return arrow.Table.from(reader);
+    }
+}
@@ -171,6 +171,42 @@ export abstract class AsyncDuckDBDispatcher implements Logger {
                     );
                     break;
                 }
+                case WorkerRequestType.OPEN_CURSOR: {
+                    const result = this._bindings.openCursor(request.data[0], request.data[1]);
+                    this.postMessage(
+                        {
+                            messageId: this._nextMessageId++,
+                            requestId: request.messageId,
+                            type: WorkerResponseType.CURSOR_INFO,
+                            data: result,
+                        },
+                        [],
+                    );
+                    break;
+                }
+                case WorkerRequestType.FETCH_ROWS: {
+                    const result = this._bindings.fetchRows(
+                        request.data[0],
+                        request.data[1],
+                        request.data[2],
+                        request.data[3],
+                    );
+                    this.postMessage(
+                        {
+                            messageId: this._nextMessageId++,
+                            requestId: request.messageId,
+                            type: WorkerResponseType.QUERY_RESULT,
+                            data: result,
+                        },
+                        [result.buffer],
+                    );
+                    break;
+                }
+                case WorkerRequestType.CLOSE_CURSOR: {
+                    this._bindings.closeCursor(request.data[0], request.data[1]);
+                    this.sendOK(request);
+                    break;
+                }
                 case WorkerRequestType.CLOSE_PREPARED: {
                     this._bindings.closePrepared(request.data[0], request.data[1]);
                     this.sendOK(request);
@@ -189,6 +225,19 @@ export abstract class AsyncDuckDBDispatcher implements Logger {
                     );
                     break;
                 }
+                case WorkerRequestType.RUN_BATCH: {
+                    const result = this._bindings.runBatch(request.data[0], request.data[1], request.data[2]);
+                    this.postMessage(
+                        {
+                            messageId: this._nextMessageId++,
+                            requestId: request.messageId,
+                            type: WorkerResponseType.QUERY_RESULT,
+                            data: result,
+                        },
+                        [result.buffer],
+                    );
+                    break;
+                }
                 case WorkerRequestType.RUN_QUERY: {
                     const result = this._bindings.runQuery(request.data[0], request.data[1]);
                     this.postMessage(
@@ -260,6 +309,11 @@ export abstract class AsyncDuckDBDispatcher implements Logger {
                     this.sendOK(request);
                     break;
 
+                case WorkerRequestType.REGISTER_FILE_URLS:
+                    this._bindings.registerFileURLs(request.data[0], request.data[1]);
+                    this.sendOK(request);
+                    break;
+
                 case WorkerRequestType.REGISTER_FILE_BUFFER:
                     this._bindings.registerFileBuffer(request.data[0], request.data[1]);
                     this.sendOK(request);
@@ -288,6 +342,24 @@ export abstract class AsyncDuckDBDispatcher implements Logger {
                     );
                     break;
                 }
+                case WorkerRequestType.EXPORT_SNAPSHOT: {
+                    const buffer = this._bindings.exportSnapshot(request.data);
+                    this.postMessage(
+                        {
+                            messageId: this._nextMessageId++,
+                            requestId: request.messageId,
+                            type: WorkerResponseType.FILE_BUFFER,
+                            data: buffer,
+                        },
+                        [buffer.buffer],
+                    );
+                    break;
+                }
+                case WorkerRequestType.OPEN_SNAPSHOT:
+                    this._bindings.openSnapshot(request.data[0], request.data[1], request.data[2]);
+                    this.sendOK(request);
+                    break;
+
                 case WorkerRequestType.COLLECT_FILE_STATISTICS:
                     this._bindings.collectFileStatistics(request.data[0], request.data[1]);
                     this.sendOK(request);
@@ -305,6 +377,59 @@ export abstract class AsyncDuckDBDispatcher implements Logger {
                     );
                     break;
                 }
+                case WorkerRequestType.WARM_FILE:
+                    this.postMessage(
+                        {
+                            messageId: this._nextMessageId++,
+                            requestId: request.messageId,
+                            type: WorkerResponseType.WARM_UP_ID,
+                            data: this._bindings.warmFile(request.data[0], request.data[1], request.data[2]),
+                        },
+                        [],
+                    );
+                    break;
+
+                case WorkerRequestType.GET_WARM_UP_PROGRESS:
+                    this.postMessage(
+                        {
+                            messageId: this._nextMessageId++,
+                            requestId: request.messageId,
+                            type: WorkerResponseType.WARM_UP_PROGRESS,
+                            data: this._bindings.getWarmUpProgress(request.data),
+                        },
+                        [],
+                    );
+                    break;
+
+                case WorkerRequestType.CANCEL_WARM_UP:
+                    this._bindings.cancelWarmUp(request.data);
+                    this.sendOK(request);
+                    break;
+
+                case WorkerRequestType.GET_MEMORY_INFO:
+                    this.postMessage(
+                        {
+                            messageId: this._nextMessageId++,
+                            requestId: request.messageId,
+                            type: WorkerResponseType.MEMORY_INFO,
+                            data: this._bindings.getMemoryInfo(),
+                        },
+                        [],
+                    );
+                    break;
+
+                case WorkerRequestType.RECLAIM_MEMORY:
+                    this.postMessage(
+                        {
+                            messageId: this._nextMessageId++,
+                            requestId: request.messageId,
+                            type: WorkerResponseType.RECLAIMED_BYTES,
+                            data: this._bindings.reclaimMemory(request.data),
+                        },
+                        [],
+                    );
+                    break;
+
                 case WorkerRequestType.INSERT_ARROW_FROM_IPC_STREAM: {
                     this._bindings.insertArrowFromIPCStream(request.data[0], request.data[1], request.data[2]);
                     this.sendOK(request);
@@ -320,6 +445,16 @@ export abstract class AsyncDuckDBDispatcher implements Logger {
                     this.sendOK(request);
                     break;
                 }
+                case WorkerRequestType.CREATE_INCREMENTAL_VIEW: {
+                    this._bindings.createIncrementalView(request.data[0], request.data[1]);
+                    this.sendOK(request);
+                    break;
+                }
+                case WorkerRequestType.DROP_INCREMENTAL_VIEW: {
+                    this._bindings.dropIncrementalView(request.data[0], request.data[1]);
+                    this.sendOK(request);
+                    break;
+                }
                 case WorkerRequestType.TOKENIZE: {
                     const result = this._bindings.tokenize(request.data);
                     this.postMessage(
@@ -333,6 +468,23 @@ export abstract class AsyncDuckDBDispatcher implements Logger {
                     );
                     break;
                 }
+                case WorkerRequestType.TOKENIZE_BINARY:
+                case WorkerRequestType.TOKENIZE_EDIT: {
+                    const result =
+                        request.type == WorkerRequestType.TOKENIZE_BINARY
+                            ? this._bindings.tokenizeBinary(request.data)
+                            : this._bindings.retokenize(request.data[0], request.data[1], request.data[2]);
+                    this.postMessage(
+                        {
+                            messageId: this._nextMessageId++,
+                            requestId: request.messageId,
+                            type: WorkerResponseType.SCRIPT_TOKEN_UPDATE,
+                            data: result,
+                        },
+                        [result.offsets.buffer],
+                    );
+                    break;
+                }
             }
         } catch (e: any) {
             return this.failWith(request, e);
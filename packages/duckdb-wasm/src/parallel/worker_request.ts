@@ -1,48 +1,69 @@
 import { CSVInsertOptions, JSONInsertOptions, ArrowInsertOptions } from '../bindings/insert_options';
 import { LogEntryVariant } from '../log';
-import { ScriptTokens } from '../bindings/tokens';
+import { ScriptTokens, ScriptTokenUpdate } from '../bindings/tokens';
 import { FileStatistics } from '../bindings/file_stats';
-import { DuckDBConfig } from '../bindings/config';
-import { WebFile } from '../bindings/web_file';
+import { DuckDBConfig, DuckDBSnapshotOptions } from '../bindings/config';
+import { WebFile, WebFileURL } from '../bindings/web_file';
+import { WarmUpProgress, WarmUpTarget } from '../bindings/warm_up';
+import { MemoryInfo } from '../bindings/memory_info';
+import { CursorInfo } from '../bindings/cursor_info';
+import { IncrementalViewDefinition } from '../bindings/incremental_view';
 
 export type ConnectionID = number;
 export type StatementID = number;
 
 export enum WorkerRequestType {
+    CANCEL_WARM_UP = 'CANCEL_WARM_UP',
+    CLOSE_CURSOR = 'CLOSE_CURSOR',
     CLOSE_PREPARED = 'CLOSE_PREPARED',
     COLLECT_FILE_STATISTICS = 'COLLECT_FILE_STATISTICS',
     CONNECT = 'CONNECT',
     COPY_FILE_TO_BUFFER = 'COPY_FILE_TO_BUFFER',
     COPY_FILE_TO_PATH = 'COPY_FILE_TO_PATH',
+    CREATE_INCREMENTAL_VIEW = 'CREATE_INCREMENTAL_VIEW',
     CREATE_PREPARED = 'CREATE_PREPARED',
     DISCONNECT = 'DISCONNECT',
+    DROP_INCREMENTAL_VIEW = 'DROP_INCREMENTAL_VIEW',
     DROP_FILE = 'DROP_FILE',
     DROP_FILES = 'DROP_FILES',
     EXPORT_FILE_STATISTICS = 'EXPORT_FILE_STATISTICS',
+    EXPORT_SNAPSHOT = 'EXPORT_SNAPSHOT',
     FETCH_QUERY_RESULTS = 'FETCH_QUERY_RESULTS',
+    FETCH_ROWS = 'FETCH_ROWS',
     FLUSH_FILES = 'FLUSH_FILES',
     GET_FEATURE_FLAGS = 'GET_FEATURE_FLAGS',
+    GET_MEMORY_INFO = 'GET_MEMORY_INFO',
     GET_VERSION = 'GET_VERSION',
+    GET_WARM_UP_PROGRESS = 'GET_WARM_UP_PROGRESS',
     GLOB_FILE_INFOS = 'GLOB_FILE_INFOS',
     INSERT_ARROW_FROM_IPC_STREAM = 'INSERT_ARROW_FROM_IPC_STREAM',
     INSERT_CSV_FROM_PATH = 'IMPORT_CSV_FROM_PATH',
     INSERT_JSON_FROM_PATH = 'IMPORT_JSON_FROM_PATH',
     INSTANTIATE = 'INSTANTIATE',
     OPEN = 'OPEN',
+    OPEN_CURSOR = 'OPEN_CURSOR',
+    OPEN_SNAPSHOT = 'OPEN_SNAPSHOT',
     PING = 'PING',
+    RECLAIM_MEMORY = 'RECLAIM_MEMORY',
     REGISTER_FILE_BUFFER = 'REGISTER_FILE_BUFFER',
     REGISTER_FILE_HANDLE = 'REGISTER_FILE_HANDLE',
     REGISTER_FILE_URL = 'REGISTER_FILE_URL',
+    REGISTER_FILE_URLS = 'REGISTER_FILE_URLS',
     RESET = 'RESET',
+    RUN_BATCH = 'RUN_BATCH',
     RUN_PREPARED = 'RUN_PREPARED',
     RUN_QUERY = 'RUN_QUERY',
     SEND_PREPARED = 'SEND_PREPARED',
     SEND_QUERY = 'SEND_QUERY',
     TOKENIZE = 'TOKENIZE',
+    TOKENIZE_BINARY = 'TOKENIZE_BINARY',
+    TOKENIZE_EDIT = 'TOKENIZE_EDIT',
+    WARM_FILE = 'WARM_FILE',
 }
 
 export enum WorkerResponseType {
     CONNECTION_INFO = 'CONNECTION_INFO',
+    CURSOR_INFO = 'CURSOR_INFO',
     ERROR = 'ERROR',
     FEATURE_FLAGS = 'FEATURE_FLAGS',
     FILE_BUFFER = 'FILE_BUFFER',
@@ -50,16 +71,21 @@ export enum WorkerResponseType {
     FILE_SIZE = 'FILE_SIZE',
     FILE_STATISTICS = 'FILE_STATISTICS',
     LOG = 'LOG',
+    MEMORY_INFO = 'MEMORY_INFO',
     OK = 'OK',
     PREPARED_STATEMENT_ID = 'PREPARED_STATEMENT_ID',
     QUERY_PLAN = 'QUERY_PLAN',
     QUERY_RESULT = 'QUERY_RESULT',
     QUERY_RESULT_CHUNK = 'QUERY_RESULT_CHUNK',
     QUERY_START = 'QUERY_START',
+    RECLAIMED_BYTES = 'RECLAIMED_BYTES',
     REGISTERED_FILE = 'REGISTERED_FILE',
     SCRIPT_TOKENS = 'SCRIPT_TOKENS',
+    SCRIPT_TOKEN_UPDATE = 'SCRIPT_TOKEN_UPDATE',
     SUCCESS = 'SUCCESS',
     VERSION_STRING = 'VERSION_STRING',
+    WARM_UP_ID = 'WARM_UP_ID',
+    WARM_UP_PROGRESS = 'WARM_UP_PROGRESS',
 }
 
 export type WorkerRequest<T, P> = {
@@ -97,20 +123,28 @@ export class WorkerTask<T, D, P> {
 }
 
 export type WorkerRequestVariant =
+    | WorkerRequest<WorkerRequestType.CANCEL_WARM_UP, number>
+    | WorkerRequest<WorkerRequestType.CLOSE_CURSOR, [ConnectionID, number]>
     | WorkerRequest<WorkerRequestType.CLOSE_PREPARED, [ConnectionID, StatementID]>
     | WorkerRequest<WorkerRequestType.COLLECT_FILE_STATISTICS, [string, boolean]>
     | WorkerRequest<WorkerRequestType.CONNECT, null>
     | WorkerRequest<WorkerRequestType.COPY_FILE_TO_BUFFER, string>
     | WorkerRequest<WorkerRequestType.COPY_FILE_TO_PATH, [string, string]>
+    | WorkerRequest<WorkerRequestType.CREATE_INCREMENTAL_VIEW, [ConnectionID, IncrementalViewDefinition]>
     | WorkerRequest<WorkerRequestType.CREATE_PREPARED, [ConnectionID, string]>
     | WorkerRequest<WorkerRequestType.DISCONNECT, number>
+    | WorkerRequest<WorkerRequestType.DROP_INCREMENTAL_VIEW, [ConnectionID, string]>
     | WorkerRequest<WorkerRequestType.DROP_FILE, string>
     | WorkerRequest<WorkerRequestType.DROP_FILES, null>
     | WorkerRequest<WorkerRequestType.EXPORT_FILE_STATISTICS, string>
+    | WorkerRequest<WorkerRequestType.EXPORT_SNAPSHOT, DuckDBSnapshotOptions>
     | WorkerRequest<WorkerRequestType.FETCH_QUERY_RESULTS, number>
+    | WorkerRequest<WorkerRequestType.FETCH_ROWS, [ConnectionID, number, number, number]>
     | WorkerRequest<WorkerRequestType.FLUSH_FILES, null>
     | WorkerRequest<WorkerRequestType.GET_FEATURE_FLAGS, null>
+    | WorkerRequest<WorkerRequestType.GET_MEMORY_INFO, null>
     | WorkerRequest<WorkerRequestType.GET_VERSION, null>
+    | WorkerRequest<WorkerRequestType.GET_WARM_UP_PROGRESS, number>
     | WorkerRequest<
           WorkerRequestType.INSERT_ARROW_FROM_IPC_STREAM,
           [number, Uint8Array, ArrowInsertOptions | undefined]
@@ -119,20 +153,29 @@ export type WorkerRequestVariant =
     | WorkerRequest<WorkerRequestType.INSERT_JSON_FROM_PATH, [number, string, JSONInsertOptions]>
     | WorkerRequest<WorkerRequestType.INSTANTIATE, [string, string | null]>
     | WorkerRequest<WorkerRequestType.OPEN, DuckDBConfig>
+    | WorkerRequest<WorkerRequestType.OPEN_CURSOR, [ConnectionID, string]>
+    | WorkerRequest<WorkerRequestType.OPEN_SNAPSHOT, [string, Uint8Array, DuckDBConfig]>
     | WorkerRequest<WorkerRequestType.PING, null>
+    | WorkerRequest<WorkerRequestType.RECLAIM_MEMORY, number>
     | WorkerRequest<WorkerRequestType.REGISTER_FILE_BUFFER, [string, Uint8Array]>
     | WorkerRequest<WorkerRequestType.REGISTER_FILE_HANDLE, [string, any]>
     | WorkerRequest<WorkerRequestType.REGISTER_FILE_URL, [string, string]>
+    | WorkerRequest<WorkerRequestType.REGISTER_FILE_URLS, [WebFileURL[], boolean]>
     | WorkerRequest<WorkerRequestType.GLOB_FILE_INFOS, string>
     | WorkerRequest<WorkerRequestType.RESET, null>
+    | WorkerRequest<WorkerRequestType.RUN_BATCH, [number, string, boolean]>
     | WorkerRequest<WorkerRequestType.RUN_PREPARED, [number, number, any[]]>
     | WorkerRequest<WorkerRequestType.RUN_QUERY, [number, string]>
     | WorkerRequest<WorkerRequestType.SEND_PREPARED, [number, number, any[]]>
     | WorkerRequest<WorkerRequestType.SEND_QUERY, [number, string]>
-    | WorkerRequest<WorkerRequestType.TOKENIZE, string>;
+    | WorkerRequest<WorkerRequestType.TOKENIZE, string>
+    | WorkerRequest<WorkerRequestType.TOKENIZE_BINARY, string>
+    | WorkerRequest<WorkerRequestType.TOKENIZE_EDIT, [number, number, string]>
+    | WorkerRequest<WorkerRequestType.WARM_FILE, [string, WarmUpTarget, number]>;
 
 export type WorkerResponseVariant =
     | WorkerResponse<WorkerResponseType.CONNECTION_INFO, number>
+    | WorkerResponse<WorkerResponseType.CURSOR_INFO, CursorInfo>
     | WorkerResponse<WorkerResponseType.ERROR, any>
     | WorkerResponse<WorkerResponseType.FEATURE_FLAGS, number>
     | WorkerResponse<WorkerResponseType.FILE_BUFFER, Uint8Array>
@@ -140,31 +183,44 @@ export type WorkerResponseVariant =
     | WorkerResponse<WorkerResponseType.FILE_SIZE, number>
     | WorkerResponse<WorkerResponseType.FILE_STATISTICS, FileStatistics>
     | WorkerResponse<WorkerResponseType.LOG, LogEntryVariant>
+    | WorkerResponse<WorkerResponseType.MEMORY_INFO, MemoryInfo>
     | WorkerResponse<WorkerResponseType.OK, null>
     | WorkerResponse<WorkerResponseType.PREPARED_STATEMENT_ID, number>
     | WorkerResponse<WorkerResponseType.QUERY_PLAN, Uint8Array>
     | WorkerResponse<WorkerResponseType.QUERY_RESULT, Uint8Array>
     | WorkerResponse<WorkerResponseType.QUERY_RESULT_CHUNK, Uint8Array>
     | WorkerResponse<WorkerResponseType.QUERY_START, Uint8Array>
+    | WorkerResponse<WorkerResponseType.RECLAIMED_BYTES, number>
     | WorkerResponse<WorkerResponseType.SCRIPT_TOKENS, ScriptTokens>
+    | WorkerResponse<WorkerResponseType.SCRIPT_TOKEN_UPDATE, ScriptTokenUpdate>
     | WorkerResponse<WorkerResponseType.SUCCESS, boolean>
-    | WorkerResponse<WorkerResponseType.VERSION_STRING, string>;
+    | WorkerResponse<WorkerResponseType.VERSION_STRING, string>
+    | WorkerResponse<WorkerResponseType.WARM_UP_ID, number>
+    | WorkerResponse<WorkerResponseType.WARM_UP_PROGRESS, WarmUpProgress>;
 
 export type WorkerTaskVariant =
+    | WorkerTask<WorkerRequestType.CANCEL_WARM_UP, number, null>
     | WorkerTask<WorkerRequestType.COLLECT_FILE_STATISTICS, [string, boolean], null>
+    | WorkerTask<WorkerRequestType.CLOSE_CURSOR, [ConnectionID, number], null>
     | WorkerTask<WorkerRequestType.CLOSE_PREPARED, [number, number], null>
     | WorkerTask<WorkerRequestType.CONNECT, null, ConnectionID>
     | WorkerTask<WorkerRequestType.COPY_FILE_TO_BUFFER, string, Uint8Array>
     | WorkerTask<WorkerRequestType.COPY_FILE_TO_PATH, [string, string], null>
+    | WorkerTask<WorkerRequestType.CREATE_INCREMENTAL_VIEW, [ConnectionID, IncrementalViewDefinition], null>
     | WorkerTask<WorkerRequestType.CREATE_PREPARED, [number, string], number>
     | WorkerTask<WorkerRequestType.DISCONNECT, ConnectionID, null>
+    | WorkerTask<WorkerRequestType.DROP_INCREMENTAL_VIEW, [ConnectionID, string], null>
     | WorkerTask<WorkerRequestType.DROP_FILE, string, boolean>
     | WorkerTask<WorkerRequestType.DROP_FILES, null, null>
     | WorkerTask<WorkerRequestType.EXPORT_FILE_STATISTICS, string, FileStatistics>
+    | WorkerTask<WorkerRequestType.EXPORT_SNAPSHOT, DuckDBSnapshotOptions, Uint8Array>
     | WorkerTask<WorkerRequestType.FETCH_QUERY_RESULTS, ConnectionID, Uint8Array>
+    | WorkerTask<WorkerRequestType.FETCH_ROWS, [ConnectionID, number, number, number], Uint8Array>
     | WorkerTask<WorkerRequestType.FLUSH_FILES, null, null>
     | WorkerTask<WorkerRequestType.GET_FEATURE_FLAGS, null, number>
+    | WorkerTask<WorkerRequestType.GET_MEMORY_INFO, null, MemoryInfo>
     | WorkerTask<WorkerRequestType.GET_VERSION, null, string>
+    | WorkerTask<WorkerRequestType.GET_WARM_UP_PROGRESS, number, WarmUpProgress>
     | WorkerTask<
           WorkerRequestType.INSERT_ARROW_FROM_IPC_STREAM,
           [number, Uint8Array, ArrowInsertOptions | undefined],
@@ -174,14 +230,22 @@ export type WorkerTaskVariant =
     | WorkerTask<WorkerRequestType.INSERT_JSON_FROM_PATH, [number, string, JSONInsertOptions], null>
     | WorkerTask<WorkerRequestType.INSTANTIATE, [string, string | null], null>
     | WorkerTask<WorkerRequestType.OPEN, DuckDBConfig, null>
+    | WorkerTask<WorkerRequestType.OPEN_CURSOR, [ConnectionID, string], CursorInfo>
+    | WorkerTask<WorkerRequestType.OPEN_SNAPSHOT, [string, Uint8Array, DuckDBConfig], null>
     | WorkerTask<WorkerRequestType.PING, null, null>
+    | WorkerTask<WorkerRequestType.RECLAIM_MEMORY, number, number>
     | WorkerTask<WorkerRequestType.REGISTER_FILE_BUFFER, [string, Uint8Array], null>
     | WorkerTask<WorkerRequestType.REGISTER_FILE_HANDLE, [string, any], null>
     | WorkerTask<WorkerRequestType.REGISTER_FILE_URL, [string, string], null>
+    | WorkerTask<WorkerRequestType.REGISTER_FILE_URLS, [WebFileURL[], boolean], null>
     | WorkerTask<WorkerRequestType.GLOB_FILE_INFOS, string, WebFile[]>
     | WorkerTask<WorkerRequestType.RESET, null, null>
+    | WorkerTask<WorkerRequestType.RUN_BATCH, [ConnectionID, string, boolean], Uint8Array>
     | WorkerTask<WorkerRequestType.RUN_PREPARED, [number, number, any[]], Uint8Array>
     | WorkerTask<WorkerRequestType.RUN_QUERY, [ConnectionID, string], Uint8Array>
     | WorkerTask<WorkerRequestType.SEND_PREPARED, [number, number, any[]], Uint8Array>
     | WorkerTask<WorkerRequestType.SEND_QUERY, [ConnectionID, string], Uint8Array>
-    | WorkerTask<WorkerRequestType.TOKENIZE, string, ScriptTokens>;
+    | WorkerTask<WorkerRequestType.TOKENIZE, string, ScriptTokens>
+    | WorkerTask<WorkerRequestType.TOKENIZE_BINARY, string, ScriptTokenUpdate>
+    | WorkerTask<WorkerRequestType.TOKENIZE_EDIT, [number, number, string], ScriptTokenUpdate>
+    | WorkerTask<WorkerRequestType.WARM_FILE, [string, WarmUpTarget, number], number>;
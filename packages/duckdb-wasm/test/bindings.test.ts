@@ -52,6 +52,70 @@ export function testBindings(db: () => duckdb.DuckDBBindings, baseURL: string):
             });
         });
 
+        describe('Batch', () => {
+            it('runs all statements in a single call', async () => {
+                const results = conn.batch(`
+                    CREATE TABLE batch_foo AS SELECT v FROM generate_series(0, 9) t(v);
+                    SELECT count(*)::INTEGER AS c FROM batch_foo;
+                    SELECT * FROM batch_missing;
+                    SELECT 42::INTEGER AS v;
+                `);
+                expect(results.length).toBe(3);
+                expect(results[1].table!.toArray()[0].c).toBe(10);
+                expect(results[2].error).toContain('batch_missing');
+            });
+            it('continues after errors', async () => {
+                const results = conn.batch('SELECT * FROM batch_missing; SELECT 42::INTEGER AS v', false);
+                expect(results.length).toBe(2);
+                expect(results[0].table).toBeUndefined();
+                expect(results[1].table!.toArray()[0].v).toBe(42);
+            });
+        });
+
+        describe('Cursor', () => {
+            it('fetches row ranges in any order', async () => {
+                const cursor = conn.openCursor('SELECT v::INTEGER AS v FROM generate_series(0, 99999) t(v) ORDER BY v');
+                expect(cursor.rowCount).toBe(100000);
+                for (const offset of [50000, 0, 99990]) {
+                    const rows = cursor.fetchRows(offset, 20);
+                    expect(rows.length).toBe(Math.min(20, 100000 - offset));
+                    expect(rows.toArray()[0].v).toBe(offset);
+                }
+                cursor.close();
+                expect(() => cursor.fetchRows(0, 1)).toThrow();
+            });
+        });
+
+        describe('Incremental View', () => {
+            it('folds arrow appends', async () => {
+                conn.query('CREATE TABLE incremental_facts (g INTEGER, v INTEGER)');
+                conn.createIncrementalView({
+                    name: 'incremental_totals',
+                    table: 'incremental_facts',
+                    groupBy: ['g'],
+                    aggregates: [
+                        { function: duckdb.IncrementalAggregateFunction.SUM, column: 'v', name: 's' },
+                        { function: duckdb.IncrementalAggregateFunction.COUNT, name: 'n' },
+                    ],
+                });
+                for (let i = 0; i < 20; ++i) {
+                    conn.insertArrowVectors(
+                        { g: arrow.Int32Vector.from([0, 1, 0]), v: arrow.Int32Vector.from([i, 1, 1]) },
+                        { name: 'incremental_facts', create: false },
+                    );
+                }
+                const rows = conn
+                    .query('SELECT g, s::INTEGER AS s, n::INTEGER AS n FROM incremental_totals ORDER BY g')
+                    .toArray();
+                expect(rows.map(r => [r.g, r.s, r.n])).toEqual([
+                    [0, 210, 40],
+                    [1, 20, 20],
+                ]);
+                conn.dropIncrementalView('incremental_totals');
+                expect(() => conn.query('SELECT * FROM incremental_totals')).toThrow();
+            });
+        });
+
         describe('Prepared Statement', () => {
             it('Materialized', async () => {
                 const stmt = conn.prepare('SELECT v::INTEGER + ? AS v FROM generate_series(0, 10000) as t(v);');
@@ -14,6 +14,15 @@ export function testTokenization(db: () => duckdb.DuckDBBindings): void {
                 types: [4, 3, 4, 0],
             });
         });
+        it('Incremental', async () => {
+            let tokens = duckdb.applyScriptTokenUpdate({ offsets: [], types: [] }, db().tokenizeBinary('SELECT 1'));
+            expect(tokens).toEqual({ offsets: [0, 7], types: [4, 1] });
+            tokens = duckdb.applyScriptTokenUpdate(tokens, db().retokenize(8, 0, ' FROM region'));
+            expect(tokens).toEqual(db().tokenize('SELECT 1 FROM region'));
+            tokens = duckdb.applyScriptTokenUpdate(tokens, db().retokenize(7, 1, '*'));
+            expect(tokens).toEqual(db().tokenize('SELECT * FROM region'));
+            expect(() => db().retokenize(100, 0, 'x')).toThrow();
+        });
     });
 }
 
@@ -31,5 +40,11 @@ export function testTokenizationAsync(db: () => duckdb.AsyncDuckDB): void {
                 types: [4, 3, 4, 0],
             });
         });
+        it('Incremental', async () => {
+            const update = await db().tokenizeBinary('SELECT * FROM region');
+            let tokens = duckdb.applyScriptTokenUpdate({ offsets: [], types: [] }, update);
+            tokens = duckdb.applyScriptTokenUpdate(tokens, await db().retokenize(14, 6, 'nation'));
+            expect(tokens).toEqual(await db().tokenize('SELECT * FROM nation'));
+        });
     });
 }